@@ -0,0 +1,45 @@
+// Tests that columnstore indexes can only be created under featureCompatibilityVersion 4.2, and
+// that downgrading the featureCompatibilityVersion to 4.0 fails while one exists.
+
+(function() {
+    "use strict";
+
+    load("jstests/libs/feature_compatibility_version.js");
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const adminDB = conn.getDB("admin");
+    const testDB = conn.getDB("test");
+    const coll = testDB.columnstore_index_fcv;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0, a: 1, b: 2}));
+
+    checkFCV(adminDB, latestFCV);
+    assert.commandWorked(coll.createIndex({a: "columnstore", b: "columnstore"}));
+
+    // The downgrade is refused while the columnstore index exists, and leaves the server
+    // downgrading.
+    assert.commandFailedWithCode(
+        adminDB.runCommand({setFeatureCompatibilityVersion: lastStableFCV}),
+        ErrorCodes.IllegalOperation);
+    checkFCV(adminDB, lastStableFCV, lastStableFCV);
+
+    // No new columnstore index can be created until the upgrade completes.
+    assert.commandFailedWithCode(coll.createIndex({b: "columnstore"}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    // Once the index is dropped the downgrade succeeds.
+    assert.commandWorked(coll.dropIndex({a: "columnstore", b: "columnstore"}));
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: lastStableFCV}));
+    checkFCV(adminDB, lastStableFCV);
+
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: latestFCV}));
+    checkFCV(adminDB, latestFCV);
+    assert.commandWorked(coll.createIndex({a: "columnstore"}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -44,6 +44,7 @@
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/legacy_request_builder.h"
 #include "mongo/rpc/metadata/client_metadata.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/reply_interface.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -242,6 +243,183 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         });
 }
 
+Future<executor::RemoteCommandResponse> AsyncDBClient::runPipelinedCommandRequest(
+    executor::RemoteCommandRequest request) {
+    auto clkSource = _svcCtx->getPreciseClockSource();
+    auto start = clkSource->now();
+    auto opMsgRequest = OpMsgRequest::fromDBAndBody(
+        std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
+    return makeReadyFutureWith([&] {
+               invariant(_negotiatedProtocol);
+               uassert(50951,
+                       "Pipelining commands requires OP_MSG",
+                       *_negotiatedProtocol == rpc::Protocol::kOpMsg);
+
+               auto requestMsg = opMsgRequest.serialize();
+               OpMsg::setFlag(&requestMsg, OpMsg::kConcurrentProcessingAllowed);
+               return _pipelinedCall(std::move(requestMsg));
+           })
+        .then([start, clkSource](Message response) {
+            auto reply = rpc::UniqueReply(response, rpc::makeReply(&response));
+            auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+            return executor::RemoteCommandResponse(*reply, duration);
+        })
+        .onError([start, clkSource](Status status) {
+            auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+            return executor::RemoteCommandResponse(status, duration);
+        });
+}
+
+size_t AsyncDBClient::numPipelinedCommands() const {
+    stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+    return _pendingReplies.size();
+}
+
+Future<Message> AsyncDBClient::_pipelinedCall(Message request) {
+    auto swm = _compressorManager.compressMessage(request);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    request = std::move(swm.getValue());
+    auto msgId = nextMessageId();
+    request.header().setId(msgId);
+    request.header().setResponseToMsgId(0);
+
+    auto pf = makePromiseFuture<Message>();
+    bool startSending;
+    bool startReceiving;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+        if (!_pipelineStatus.isOK()) {
+            return _pipelineStatus;
+        }
+
+        // Register for the reply before the request can possibly be sent.
+        _pendingReplies.emplace(msgId, std::move(pf.promise));
+        _sendQueue.push_back(std::move(request));
+        startSending = !std::exchange(_sending, true);
+        startReceiving = !std::exchange(_receiving, true);
+    }
+
+    if (startSending) {
+        _sendPipelined();
+    }
+    if (startReceiving) {
+        _receivePipelined();
+    }
+    return std::move(pf.future);
+}
+
+void AsyncDBClient::_sendPipelined() {
+    // Writes which complete immediately are handled in this loop rather than by recursing from
+    // their continuations, since the queue may be long.
+    while (true) {
+        Message toSend;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+            if (_sendQueue.empty() || !_pipelineStatus.isOK()) {
+                _sending = false;
+                return;
+            }
+            toSend = std::move(_sendQueue.front());
+            _sendQueue.pop_front();
+        }
+
+        auto sent = _session->asyncSinkMessage(std::move(toSend));
+        if (!sent.isReady()) {
+            std::move(sent).getAsync([self = shared_from_this()](Status status) {
+                if (!status.isOK()) {
+                    return self->_failPipeline(status);
+                }
+                self->_sendPipelined();
+            });
+            return;
+        }
+
+        auto status = sent.getNoThrow();
+        if (!status.isOK()) {
+            return _failPipeline(status);
+        }
+    }
+}
+
+void AsyncDBClient::_receivePipelined() {
+    while (true) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+            if (_pendingReplies.empty() || !_pipelineStatus.isOK()) {
+                _receiving = false;
+                return;
+            }
+        }
+
+        auto received = _session->asyncSourceMessage();
+        if (!received.isReady()) {
+            std::move(received).getAsync([self = shared_from_this()](StatusWith<Message> swm) {
+                if (self->_onPipelinedReply(std::move(swm))) {
+                    self->_receivePipelined();
+                }
+            });
+            return;
+        }
+
+        if (!_onPipelinedReply(std::move(received).getNoThrow())) {
+            return;
+        }
+    }
+}
+
+bool AsyncDBClient::_onPipelinedReply(StatusWith<Message> swm) {
+    if (swm.isOK() && swm.getValue().operation() == dbCompressed) {
+        swm = _compressorManager.decompressMessage(swm.getValue());
+    }
+    if (!swm.isOK()) {
+        _failPipeline(swm.getStatus());
+        return false;
+    }
+
+    auto& response = swm.getValue();
+    boost::optional<Promise<Message>> promise;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+        auto it = _pendingReplies.find(response.header().getResponseToMsgId());
+        if (it != _pendingReplies.end()) {
+            promise.emplace(std::move(it->second));
+            _pendingReplies.erase(it);
+        }
+    }
+
+    if (!promise) {
+        _failPipeline({ErrorCodes::ProtocolError,
+                       str::stream() << "Received a reply to unknown request "
+                                     << response.header().getResponseToMsgId()});
+        return false;
+    }
+
+    promise->emplaceValue(std::move(response));
+    return true;
+}
+
+void AsyncDBClient::_failPipeline(Status status) {
+    stdx::unordered_map<int32_t, Promise<Message>> pendingReplies;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+        if (!_pipelineStatus.isOK()) {
+            return;
+        }
+        _pipelineStatus = status;
+        _sendQueue.clear();
+        pendingReplies.swap(_pendingReplies);
+    }
+
+    // Replies can no longer be matched reliably, so the session can't be used for anything else.
+    _session->end();
+    for (auto& pending : pendingReplies) {
+        pending.second.setError(status);
+    }
+}
+
 void AsyncDBClient::cancel(const transport::BatonHandle& baton) {
     _session->cancelAsyncOperations(baton);
 }
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/service_context.h"
@@ -36,6 +37,8 @@
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -63,6 +66,21 @@ public:
     Future<rpc::UniqueReply> runCommand(OpMsgRequest request,
                                         const transport::BatonHandle& baton = nullptr);
 
+    /**
+     * Runs a command without waiting for the replies to the commands sent before it. Replies are
+     * matched to their requests by 'responseTo', so the remote may process the commands
+     * concurrently and answer them in any order. A network error fails every outstanding command
+     * and ends the session. Requires OP_MSG, and must not be mixed with the other ways of running
+     * commands on the same client.
+     */
+    Future<executor::RemoteCommandResponse> runPipelinedCommandRequest(
+        executor::RemoteCommandRequest request);
+
+    /**
+     * Returns the number of pipelined commands which have not been answered yet.
+     */
+    size_t numPipelinedCommands() const;
+
     Future<void> authenticate(const BSONObj& params);
 
     Future<void> initWireVersion(const std::string& appName,
@@ -79,6 +97,11 @@ public:
 
 private:
     Future<Message> _call(Message request, const transport::BatonHandle& baton = nullptr);
+    Future<Message> _pipelinedCall(Message request);
+    void _sendPipelined();
+    void _receivePipelined();
+    bool _onPipelinedReply(StatusWith<Message> swm);
+    void _failPipeline(Status status);
     BSONObj _buildIsMasterRequest(const std::string& appName);
     void _parseIsMasterResponse(BSONObj request,
                                 const std::unique_ptr<rpc::ReplyInterface>& response);
@@ -88,6 +111,15 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    // State of pipelined commands. The session is written by at most one send loop and read by at
+    // most one receive loop at a time.
+    mutable stdx::mutex _pipelineMutex;
+    std::deque<Message> _sendQueue;
+    stdx::unordered_map<int32_t, Promise<Message>> _pendingReplies;
+    bool _sending = false;
+    bool _receiving = false;
+    Status _pipelineStatus = Status::OK();
 };
 
 }  // namespace mongo
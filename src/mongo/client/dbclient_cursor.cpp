@@ -128,7 +128,14 @@ Message DBClientCursor::_assembleInit() {
                 // QueryRequest doesn't handle $readPreference.
                 cmd = BSONObjBuilder(std::move(cmd)).append(readPref).obj();
             }
-            return assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            auto msg = assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            // Let the server start streaming straight away, saving the round trip of the first
+            // 'getMore'. The server reuses the batch size of the 'find' for the stream, so only
+            // do this when one was given.
+            if (opts & QueryOption_Exhaust && msg.operation() == dbMsg && nextBatchSize() != 0) {
+                OpMsg::setFlag(&msg, OpMsg::kExhaustAllowed);
+            }
+            return msg;
         }
         // else use legacy OP_QUERY request.
         // Legacy OP_QUERY request does not support UUIDs.
@@ -159,7 +166,7 @@ Message DBClientCursor::_assembleGetMore() {
         auto msg = assembleCommandRequest(_client, ns.db(), opts, gmr.toBSON());
         // Set the exhaust flag if needed.
         if (opts & QueryOption_Exhaust && msg.operation() == dbMsg) {
-            OpMsg::setFlag(&msg, OpMsg::kExhaustSupported);
+            OpMsg::setFlag(&msg, OpMsg::kExhaustAllowed);
         }
         return msg;
     } else {
@@ -185,7 +185,7 @@ TEST_F(DBClientCursorTest, DBClientCursorHandlesOpMsgExhaustCorrectly) {
     ASSERT_EQ(StringData(msg.body.firstElement().fieldName()), "getMore");
     ASSERT_EQ(msg.body["getMore"].type(), BSONType::NumberLong);
     ASSERT_EQ(msg.body["getMore"].numberLong(), cursorId);
-    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustSupported));
+    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustAllowed));
     ASSERT_BSONOBJ_EQ(docObj(1), cursor.next());
     ASSERT_BSONOBJ_EQ(docObj(2), cursor.next());
 
@@ -206,6 +206,45 @@ TEST_F(DBClientCursorTest, DBClientCursorHandlesOpMsgExhaustCorrectly) {
     ASSERT(cursor.isDead());
 }
 
+TEST_F(DBClientCursorTest, DBClientCursorStartsOpMsgExhaustWithFindCommand) {
+
+    // Set up the DBClientCursor and a mock client connection.
+    DBClientConnectionForTest conn;
+    const NamespaceString nss("test", "coll");
+    DBClientCursor cursor(
+        &conn, NamespaceStringOrUUID(nss), Query().obj, 0, 0, nullptr, QueryOption_Exhaust, 0);
+    cursor.setBatchSize(2);
+
+    // Set up a mock 'find' response which already starts the exhaust stream.
+    const long long cursorId = 42;
+    Message findResponseMsg = mockFindResponse(nss, cursorId, {docObj(1), docObj(2)});
+    OpMsg::setFlag(&findResponseMsg, OpMsg::kMoreToCome);
+
+    conn.setCallResponse(findResponseMsg);
+    ASSERT(cursor.init());
+
+    // Verify that the initial 'find' request was sent with the exhaust flag set, since it carries
+    // a batch size for the server to reuse.
+    auto m = conn.getLastSentMessage();
+    ASSERT(!m.empty());
+    auto msg = OpMsg::parse(m);
+    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustAllowed));
+    ASSERT_EQ(msg.body.getStringField("find"), nss.coll());
+    ASSERT_EQ(msg.body["batchSize"].number(), 2);
+    ASSERT_BSONOBJ_EQ(docObj(1), cursor.next());
+    ASSERT_BSONOBJ_EQ(docObj(2), cursor.next());
+
+    // The remote server is already streaming results, so no 'getMore' request should be sent.
+    auto terminalDoc = BSON("_id"
+                            << "terminal");
+    conn.setRecvResponse(mockGetMoreResponse(nss, 0, {terminalDoc}));
+    conn.clearLastSentMessage();
+    ASSERT(cursor.more());
+    ASSERT(conn.getLastSentMessage().empty());
+    ASSERT_BSONOBJ_EQ(terminalDoc, cursor.next());
+    ASSERT(cursor.isDead());
+}
+
 TEST_F(DBClientCursorTest, DBClientCursorResendsGetMoreIfMoreToComeFlagIsOmittedInExhaustMessage) {
 
     // Set up the DBClientCursor and a mock client connection.
@@ -248,7 +287,7 @@ TEST_F(DBClientCursorTest, DBClientCursorResendsGetMoreIfMoreToComeFlagIsOmitted
     ASSERT_EQ(msg.body["getMore"].type(), BSONType::NumberLong);
     ASSERT_EQ(msg.body["getMore"].numberLong(), cursorId);
     ASSERT_EQ(msg.body["batchSize"].number(), 2);
-    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustSupported));
+    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustAllowed));
     ASSERT_BSONOBJ_EQ(docObj(1), cursor.next());
     ASSERT_BSONOBJ_EQ(docObj(2), cursor.next());
 
@@ -269,7 +308,7 @@ TEST_F(DBClientCursorTest, DBClientCursorResendsGetMoreIfMoreToComeFlagIsOmitted
     ASSERT_EQ(StringData(msg.body.firstElement().fieldName()), "getMore");
     ASSERT_EQ(msg.body["getMore"].type(), BSONType::NumberLong);
     ASSERT_EQ(msg.body["getMore"].numberLong(), cursorId);
-    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustSupported));
+    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustAllowed));
     ASSERT_BSONOBJ_EQ(docObj(3), cursor.next());
     ASSERT_BSONOBJ_EQ(docObj(4), cursor.next());
 
@@ -219,6 +219,7 @@ MONGO_INITIALIZER(AuthorizationBuiltinRoles)(InitializerContext* context) {
         << ActionType::killAnyCursor
         << ActionType::killAnySession
         << ActionType::killop
+        << ActionType::raiseAdmissionPriority
         << ActionType::replSetResizeOplog
         << ActionType::resync;  // clusterManager gets this also
 
@@ -0,0 +1,348 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/cache_prewarmer.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/db/storage/hot_set_manifest.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/periodic_runner.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+// How often, in seconds, to record the hot set manifest. 0 disables recording.
+int hotSetRecordIntervalSecs = 0;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> HotSetRecordIntervalSecsSetting(
+    ServerParameterSet::getGlobal(), "hotSetRecordIntervalSecs", &hotSetRecordIntervalSecs);
+
+// The number of collections and indexes kept in the hot set manifest.
+int hotSetMaxEntries = 100;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> HotSetMaxEntriesSetting(
+    ServerParameterSet::getGlobal(), "hotSetMaxEntries", &hotSetMaxEntries);
+
+// The weight each recording gives to the scores of the previous ones.
+const double kHotSetScoreDecay = 0.5;
+
+// Set by stopCachePrewarmer() to make prewarming threads stop between batches.
+AtomicBool prewarmStopRequested{false};
+
+// The thread running a background prewarm, joined by stopCachePrewarmer().
+stdx::mutex backgroundPrewarmMutex;
+stdx::thread backgroundPrewarmThread;
+
+class CachePrewarmModeParameter
+    : public ExportedServerParameter<std::string, ServerParameterType::kStartupOnly> {
+public:
+    CachePrewarmModeParameter(std::string* value)
+        : ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "cachePrewarmMode", value) {}
+
+    Status validate(const std::string& potentialNewValue) final {
+        if (potentialNewValue != "off" && potentialNewValue != "blocking" &&
+            potentialNewValue != "background") {
+            return Status(ErrorCodes::BadValue,
+                          "cachePrewarmMode must be one of 'off', 'blocking' or 'background'");
+        }
+        return Status::OK();
+    }
+};
+
+std::string cachePrewarmMode = "off";
+CachePrewarmModeParameter cachePrewarmModeSetting(&cachePrewarmMode);
+
+int cachePrewarmThreads = 4;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> CachePrewarmThreadsSetting(
+    ServerParameterSet::getGlobal(), "cachePrewarmThreads", &cachePrewarmThreads);
+
+// Stop prewarming once this many megabytes have been read. 0 means no limit, in which case the
+// least hot entries may evict the hottest ones if the hot set does not fit in the cache.
+int cachePrewarmMaxMB = 0;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> CachePrewarmMaxMBSetting(
+    ServerParameterSet::getGlobal(), "cachePrewarmMaxMB", &cachePrewarmMaxMB);
+
+bool canUseHotSetManifest(ServiceContext* serviceContext) {
+    return !storageGlobalParams.readOnly && !serviceContext->getStorageEngine()->isEphemeral();
+}
+
+/**
+ * Turns the cumulative operation counts from Top and the index usage trackers into per-interval
+ * deltas, and folds them into the manifest.
+ */
+class HotSetRecorder {
+public:
+    HotSetRecorder(HotSetManifest manifest) : _manifest(std::move(manifest)) {}
+
+    void record(OperationContext* opCtx) {
+        Top::UsageMap usage;
+        Top::get(opCtx->getServiceContext()).cloneMap(usage);
+
+        std::vector<HotSetManifest::Entry> deltas;
+        for (const auto& collectionUsage : usage) {
+            const NamespaceString nss(collectionUsage.first);
+            if (!nss.isNormal()) {
+                continue;
+            }
+            _addDelta(nss.ns(), "", collectionUsage.second.total.count, &deltas);
+
+            AutoGetCollectionForRead autoColl(opCtx, nss);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                continue;
+            }
+            for (const auto& indexUsage : collection->infoCache()->getIndexUsageStats()) {
+                _addDelta(nss.ns(), indexUsage.first, indexUsage.second.accesses.load(), &deltas);
+            }
+        }
+
+        _manifest.addUsage(deltas, kHotSetScoreDecay, static_cast<std::size_t>(hotSetMaxEntries));
+        Status status = _manifest.writeToPath(storageGlobalParams.dbpath);
+        if (!status.isOK()) {
+            warning() << "Failed to record the hot set manifest: " << status;
+        }
+    }
+
+private:
+    void _addDelta(const std::string& ns,
+                   const std::string& indexName,
+                   long long count,
+                   std::vector<HotSetManifest::Entry>* deltas) {
+        long long& lastCount = _lastCounts[{ns, indexName}];
+        // Counters restart from zero when a collection is dropped and recreated.
+        const long long delta = count >= lastCount ? count - lastCount : count;
+        lastCount = count;
+        if (delta > 0) {
+            deltas->push_back({ns, indexName, static_cast<double>(delta)});
+        }
+    }
+
+    HotSetManifest _manifest;
+    std::map<std::pair<std::string, std::string>, long long> _lastCounts;
+};
+
+/**
+ * Scans one collection or index of the hot set. Returns the number of bytes read, stopping early
+ * once 'remainingBytes' drops to zero.
+ */
+long long prewarmEntry(OperationContext* opCtx,
+                       const HotSetManifest::Entry& entry,
+                       AtomicInt64* remainingBytes) {
+    const NamespaceString nss(entry.ns);
+    AutoGetCollectionForRead autoColl(opCtx, nss);
+    Collection* collection = autoColl.getCollection();
+    if (!collection) {
+        return 0;
+    }
+
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
+    if (entry.indexName.empty()) {
+        exec = InternalPlanner::collectionScan(
+            opCtx, nss.ns(), collection, PlanExecutor::YIELD_AUTO);
+    } else {
+        const IndexDescriptor* descriptor =
+            collection->getIndexCatalog()->findIndexByName(opCtx, entry.indexName);
+        if (!descriptor) {
+            return 0;
+        }
+        // Only the index itself is scanned; the documents it points to are warmed by the
+        // collection's own entry if it is hot enough.
+        KeyPattern keyPattern(descriptor->keyPattern());
+        exec = InternalPlanner::indexScan(
+            opCtx,
+            collection,
+            descriptor,
+            Helpers::toKeyFormat(keyPattern.extendRangeBound({}, false)),
+            Helpers::toKeyFormat(keyPattern.extendRangeBound({}, true)),
+            BoundInclusion::kIncludeBothStartAndEndKeys,
+            PlanExecutor::YIELD_AUTO);
+    }
+
+    long long bytesRead = 0;
+    BSONObj obj;
+    while (remainingBytes->load() > 0 && exec->getNext(&obj, nullptr) == PlanExecutor::ADVANCED) {
+        if (prewarmStopRequested.load()) {
+            break;
+        }
+        bytesRead += obj.objsize();
+        remainingBytes->subtractAndFetch(obj.objsize());
+    }
+    return bytesRead;
+}
+
+void prewarm(ServiceContext* serviceContext, const HotSetManifest& manifest) {
+    const auto& entries = manifest.getEntries();
+    const long long maxBytes = cachePrewarmMaxMB > 0
+        ? static_cast<long long>(cachePrewarmMaxMB) * 1024 * 1024
+        : std::numeric_limits<long long>::max();
+
+    AtomicInt64 remainingBytes(maxBytes);
+    AtomicWord<std::size_t> nextEntry(0);
+    AtomicInt64 entriesWarmed(0);
+
+    log() << "Prewarming the cache from " << entries.size() << " hot set entries on "
+          << cachePrewarmThreads << " threads";
+    Timer timer;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < std::max(1, cachePrewarmThreads); ++i) {
+        threads.emplace_back([&, i] {
+            Client::initThread(str::stream() << "CachePrewarmer-" << i);
+            ON_BLOCK_EXIT([] { Client::destroy(); });
+
+            for (std::size_t index = nextEntry.fetchAndAdd(1);
+                 index < entries.size() && remainingBytes.load() > 0 &&
+                 !prewarmStopRequested.load() && !globalInShutdownDeprecated();
+                 index = nextEntry.fetchAndAdd(1)) {
+                const auto& entry = entries[index];
+                try {
+                    auto opCtx = cc().makeOperationContext();
+                    const long long bytes = prewarmEntry(opCtx.get(), entry, &remainingBytes);
+                    entriesWarmed.fetchAndAdd(1);
+                    LOG(1) << "Prewarmed " << bytes << " bytes of " << entry.ns
+                           << (entry.indexName.empty() ? "" : " index " + entry.indexName);
+                } catch (const DBException& ex) {
+                    if (ErrorCodes::isShutdownError(ex.code())) {
+                        return;
+                    }
+                    warning() << "Failed to prewarm " << entry.ns
+                              << (entry.indexName.empty() ? "" : " index " + entry.indexName)
+                              << ": " << ex.toStatus();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    log() << "Cache prewarming read " << (maxBytes - remainingBytes.load()) / (1024 * 1024)
+          << "MB from " << entriesWarmed.load() << " hot set entries in " << timer.millis()
+          << "ms";
+}
+
+}  // namespace
+
+void startHotSetRecorder(ServiceContext* serviceContext) {
+    if (hotSetRecordIntervalSecs <= 0 || !canUseHotSetManifest(serviceContext)) {
+        return;
+    }
+
+    // Start from the previous manifest, so that a restart does not forget the working set.
+    auto swManifest = HotSetManifest::readFromPath(storageGlobalParams.dbpath);
+    auto recorder = std::make_shared<HotSetRecorder>(
+        swManifest.isOK() ? std::move(swManifest.getValue()) : HotSetManifest());
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job("HotSetRecorder",
+                                    [recorder](Client* client) {
+                                        // The opCtx destructor handles unsetting itself from the
+                                        // Client.
+                                        auto opCtx = client->makeOperationContext();
+                                        try {
+                                            recorder->record(opCtx.get());
+                                        } catch (const DBException& ex) {
+                                            warning() << "Failed to record the hot set manifest: "
+                                                      << ex.toStatus();
+                                        }
+                                    },
+                                    Seconds(hotSetRecordIntervalSecs));
+
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+void prewarmCacheFromHotSet(ServiceContext* serviceContext) {
+    if (cachePrewarmMode == "off" || !canUseHotSetManifest(serviceContext)) {
+        return;
+    }
+
+    auto swManifest = HotSetManifest::readFromPath(storageGlobalParams.dbpath);
+    if (!swManifest.isOK()) {
+        if (swManifest.getStatus() != ErrorCodes::NonExistentPath) {
+            warning() << "Not prewarming the cache, failed to read the hot set manifest: "
+                      << swManifest.getStatus();
+        }
+        return;
+    }
+
+    if (cachePrewarmMode == "blocking") {
+        prewarm(serviceContext, swManifest.getValue());
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(backgroundPrewarmMutex);
+    invariant(!backgroundPrewarmThread.joinable());
+    backgroundPrewarmThread =
+        stdx::thread([ serviceContext, manifest = std::move(swManifest.getValue()) ] {
+            prewarm(serviceContext, manifest);
+        });
+}
+
+void stopCachePrewarmer() {
+    prewarmStopRequested.store(true);
+
+    stdx::lock_guard<stdx::mutex> lk(backgroundPrewarmMutex);
+    if (backgroundPrewarmThread.joinable()) {
+        log() << "Waiting for cache prewarming to stop";
+        backgroundPrewarmThread.join();
+    }
+}
+
+}  // namespace mongo
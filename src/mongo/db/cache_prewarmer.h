@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Starts a periodic background job that records which collections and indexes served the most
+ * operations, based on Top and each collection's index usage statistics, into the hot set manifest
+ * in the data directory. Runs every 'hotSetRecordIntervalSecs' seconds; does nothing if that is 0,
+ * or if the storage engine is read-only or ephemeral.
+ *
+ * This function should only ever be called once, during mongod server startup (db.cpp).
+ * The PeriodicRunner will handle shutting down the job on shutdown, no extra handling necessary.
+ */
+void startHotSetRecorder(ServiceContext* serviceContext);
+
+/**
+ * Loads the collections and indexes listed in the hot set manifest into the storage engine cache
+ * by scanning them on 'cachePrewarmThreads' threads, hottest first, until 'cachePrewarmMaxMB' has
+ * been read.
+ *
+ * With 'cachePrewarmMode' set to "blocking" this returns once prewarming is done, so that calling
+ * it before the node starts listening keeps reads off a cold cache. With "background" it returns
+ * immediately and the node serves traffic while prewarming. With "off", the default, it does
+ * nothing.
+ *
+ * This function should only ever be called once, during mongod server startup (db.cpp).
+ */
+void prewarmCacheFromHotSet(ServiceContext* serviceContext);
+
+/**
+ * Stops a background prewarm started by prewarmCacheFromHotSet() and waits for its threads to
+ * exit. Called during shutdown, after operations have been killed and before the global lock is
+ * taken for storage engine shutdown.
+ */
+void stopCachePrewarmer();
+
+}  // namespace mongo
@@ -204,6 +204,8 @@ public:
 
         virtual bool requiresIdIndex() const = 0;
 
+        virtual bool isClustered() const = 0;
+
         virtual Snapshotted<BSONObj> docFor(OperationContext* opCtx, const RecordId& loc) const = 0;
 
         virtual bool findDoc(OperationContext* opCtx,
@@ -398,6 +400,15 @@ public:
         return this->_impl().requiresIdIndex();
     }
 
+    /**
+     * Returns true if the documents of this collection are stored keyed by their _id, in which
+     * case the RecordId of a document is clusteredkey::keyForId() of its _id and there is no _id
+     * index.
+     */
+    inline bool isClustered() const {
+        return this->_impl().isClustered();
+    }
+
     inline Snapshotted<BSONObj> docFor(OperationContext* const opCtx, const RecordId& loc) const {
         return Snapshotted<BSONObj>(opCtx->recoveryUnit()->getSnapshotId(),
                                     this->getRecordStore()->dataFor(opCtx, loc).releaseToBson());
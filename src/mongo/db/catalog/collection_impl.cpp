@@ -150,6 +150,7 @@ CollectionImpl::CollectionImpl(Collection* _this_init,
       _recordStore(recordStore),
       _dbce(dbce),
       _needCappedLock(supportsDocLocking() && _recordStore->isCapped() && _ns.db() != "local"),
+      _clustered(_details->getCollectionOptions(opCtx).clustered),
       _infoCache(_this_init, _ns),
       _indexCatalog(_this_init, this->getCatalogEntry()->getMaxAllowedIndexes()),
       _collator(parseCollation(opCtx, _ns, _details->getCollectionOptions(opCtx).collation)),
@@ -200,6 +201,11 @@ bool CollectionImpl::requiresIdIndex() const {
         return false;
     }
 
+    if (_clustered) {
+        // The record store is keyed by _id.
+        return false;
+    }
+
     if (_ns.isSystem()) {
         StringData shortName = _ns.coll().substr(_ns.coll().find('.') + 1);
         if (shortName == "indexes" || shortName == "namespaces" || shortName == "profile") {
@@ -338,10 +344,10 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
     }
 
     // Should really be done in the collection object at creation and updated on index create.
-    const bool hasIdIndex = _indexCatalog.findIdIndex(opCtx);
+    const bool requiresId = _clustered || _indexCatalog.findIdIndex(opCtx);
 
     for (auto it = begin; it != end; it++) {
-        if (hasIdIndex && it->doc["_id"].eoo()) {
+        if (requiresId && it->doc["_id"].eoo()) {
             return Status(ErrorCodes::InternalError,
                           str::stream()
                               << "Collection::insertDocument got document without _id for ns:"
@@ -106,6 +106,10 @@ public:
 
     bool requiresIdIndex() const final;
 
+    bool isClustered() const final {
+        return _clustered;
+    }
+
     Snapshotted<BSONObj> docFor(OperationContext* opCtx, const RecordId& loc) const final {
         return Snapshotted<BSONObj>(opCtx->recoveryUnit()->getSnapshotId(),
                                     _recordStore->dataFor(opCtx, loc).releaseToBson());
@@ -396,6 +400,7 @@ private:
     RecordStore* const _recordStore;
     DatabaseCatalogEntry* const _dbce;
     const bool _needCappedLock;
+    const bool _clustered;
     CollectionInfoCache _infoCache;
     IndexCatalog _indexCatalog;
 
@@ -107,6 +107,10 @@ public:
         std::abort();
     }
 
+    bool isClustered() const {
+        std::abort();
+    }
+
     Snapshotted<BSONObj> docFor(OperationContext* opCtx, const RecordId& loc) const {
         std::abort();
     }
@@ -37,6 +37,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -176,6 +177,19 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             flagsSet = true;
         } else if (fieldName == "temp") {
             temp = e.trueValue();
+        } else if (fieldName == "clustered") {
+            clustered = e.trueValue();
+        } else if (fieldName == "fieldNameDictionary") {
+            fieldNameDictionary = e.trueValue();
+        } else if (fieldName == "timeseries") {
+            if (e.type() != mongo::Object) {
+                return {ErrorCodes::TypeMismatch, "'timeseries' has to be a document."};
+            }
+            auto swOptions = TimeseriesOptions::parse(e.Obj());
+            if (!swOptions.isOK()) {
+                return swOptions.getStatus();
+            }
+            timeseries = swOptions.getValue().toBSON();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -266,6 +280,33 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (clustered) {
+        if (capped) {
+            return Status(ErrorCodes::InvalidOptions, "A clustered collection cannot be capped");
+        }
+        if (autoIndexId != DEFAULT || !idIndex.isEmpty()) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "A clustered collection cannot specify an _id index");
+        }
+        // Records are keyed by the binary value of the _id, so strings that a collation would
+        // consider equal could not be found through each other.
+        if (!collation.isEmpty() && collation["locale"].str() != "simple") {
+            return Status(ErrorCodes::InvalidOptions,
+                          "A clustered collection cannot have a non-simple collation");
+        }
+    }
+
+    if (fieldNameDictionary && (capped || clustered || !viewOn.empty())) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "A collection using a field name dictionary cannot be capped, clustered or "
+                      "a view");
+    }
+
+    if (!timeseries.isEmpty() && (capped || clustered || !viewOn.empty())) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "A time-series collection cannot be capped, clustered or a view");
+    }
+
     return Status::OK();
 }
 
@@ -302,6 +343,16 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
     if (temp)
         builder->appendBool("temp", true);
 
+    if (clustered)
+        builder->appendBool("clustered", true);
+
+    if (fieldNameDictionary)
+        builder->appendBool("fieldNameDictionary", true);
+
+    if (!timeseries.isEmpty()) {
+        builder->append("timeseries", timeseries);
+    }
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -383,6 +434,18 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (clustered != other.clustered) {
+        return false;
+    }
+
+    if (fieldNameDictionary != other.fieldNameDictionary) {
+        return false;
+    }
+
+    if (timeseries.woCompare(other.timeseries) != 0) {
+        return false;
+    }
+
     if (storageEngine.woCompare(other.storageEngine) != 0) {
         return false;
     }
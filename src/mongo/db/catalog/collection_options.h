@@ -126,6 +126,18 @@ struct CollectionOptions {
 
     bool temp = false;
 
+    // Store documents keyed by their _id rather than by a generated RecordId, so that _id lookups
+    // go directly to the record store and no separate _id index is kept.
+    bool clustered = false;
+
+    // Store documents with their field names replaced by short tokens from a per-collection
+    // dictionary, see FieldNameDictionary.
+    bool fieldNameDictionary = false;
+
+    // The 'timeseries' option of the buckets collection of a time-series collection, see
+    // TimeseriesOptions. Always owned or empty.
+    BSONObj timeseries;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
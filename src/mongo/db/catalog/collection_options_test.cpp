@@ -252,6 +252,73 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(options.parse(fromjson("{pipeline: [{$match: {}}]}")));
 }
 
+TEST(CollectionOptions, ClusteredParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{clustered: true}")));
+    ASSERT_TRUE(options.clustered);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{clustered: true}"));
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, ClusteredRejectsCappedAndIdIndexOptions) {
+    CollectionOptions options;
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, capped: true, size: 1024}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, autoIndexId: false}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, idIndex: {key: {_id: 1}, name: '_id_'}}"))
+                  .code(),
+              ErrorCodes::InvalidOptions);
+}
+
+TEST(CollectionOptions, ClusteredRejectsNonSimpleCollation) {
+    CollectionOptions options;
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, collation: {locale: 'en'}}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_OK(options.parse(fromjson("{clustered: true, collation: {locale: 'simple'}}")));
+}
+
+TEST(CollectionOptions, FieldNameDictionaryParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{fieldNameDictionary: true}")));
+    ASSERT_TRUE(options.fieldNameDictionary);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{fieldNameDictionary: true}"));
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, FieldNameDictionaryRejectsCappedAndClustered) {
+    CollectionOptions options;
+    ASSERT_EQ(options.parse(fromjson("{fieldNameDictionary: true, capped: true, size: 1024}"))
+                  .code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(options.parse(fromjson("{fieldNameDictionary: true, clustered: true}")).code(),
+              ErrorCodes::InvalidOptions);
+}
+
+TEST(CollectionOptions, TimeseriesParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', metaField: 'm'}}")));
+    ASSERT_BSONOBJ_EQ(options.timeseries,
+                      BSON("timeField"
+                           << "t"
+                           << "metaField"
+                           << "m"
+                           << "bucketMaxSpanSeconds"
+                           << 3600LL));
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, TimeseriesRejectsInvalidOptions) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {metaField: 'm'}}")));
+    ASSERT_EQ(options.parse(fromjson("{timeseries: {timeField: 't'}, clustered: true}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(
+        options.parse(fromjson("{timeseries: {timeField: 't'}, capped: true, size: 1024}")).code(),
+        ErrorCodes::InvalidOptions);
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     CollectionOptions options;
     auto status = options.parse(fromjson("{invalidOption: 1}"));
@@ -44,11 +44,65 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/logger/redaction.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 namespace {
+/**
+ * Creates the time-series collection 'nss' as a view over a "system.buckets" collection that holds
+ * the bucketed measurements. Must be called with the database locked in MODE_X.
+ */
+Status createTimeseries(OperationContext* opCtx,
+                        Database* db,
+                        const NamespaceString& nss,
+                        CollectionOptions options,
+                        const BSONObj& idIndex) {
+    if (!options.validator.isEmpty()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "A time-series collection cannot have a validator");
+    }
+
+    const auto bucketsNs = nss.makeTimeseriesBucketsNamespace();
+    auto timeseriesOptions = TimeseriesOptions::parse(options.timeseries);
+    if (!timeseriesOptions.isOK()) {
+        return timeseriesOptions.getStatus();
+    }
+
+    CollectionOptions viewOptions;
+    viewOptions.viewOn = bucketsNs.coll().toString();
+    viewOptions.pipeline = timeseriesOptions.getValue().makeViewPipeline();
+    viewOptions.collation = options.collation;
+
+    {
+        WriteUnitOfWork wuow(opCtx);
+        db->getOrCreateCollection(opCtx, NamespaceString(db->getSystemViewsName()));
+        wuow.commit();
+    }
+
+    WriteUnitOfWork wunit(opCtx);
+
+    const bool createDefaultIndexes = true;
+    Status status = Database::userCreateNS(
+        opCtx, db, bucketsNs.ns(), std::move(options), createDefaultIndexes, idIndex);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    status = Database::userCreateNS(opCtx, db, nss.ns(), std::move(viewOptions));
+    if (!status.isOK()) {
+        return status;
+    }
+
+    wunit.commit();
+
+    // Measurements of a previous collection with the same name must not go to its buckets.
+    BucketCatalog::get(opCtx).clear(bucketsNs);
+    return Status::OK();
+}
+
 /**
  * Shared part of the implementation of the createCollection versions for replicated and regular
  * collection creation.
@@ -103,6 +157,12 @@ Status createCollection(OperationContext* opCtx,
             return status;
         }
 
+        // Time-series collections are only expanded into their buckets collection and view when
+        // created by a user; replication creates each of them on its own.
+        if (!collectionOptions.timeseries.isEmpty() && kind == CollectionOptions::parseForCommand) {
+            return createTimeseries(opCtx, ctx.db(), nss, std::move(collectionOptions), idIndex);
+        }
+
         if (collectionOptions.isView()) {
             // If the `system.views` collection does not exist, create it in a separate
             // WriteUnitOfWork.
@@ -744,6 +744,17 @@ void DatabaseImpl::_checkCanCreateCollection(OperationContext* opCtx,
 
     uassert(17316, "cannot create a blank collection", nss.coll() > 0);
     uassert(28838, "cannot create a non-capped oplog collection", options.capped || !nss.isOplog());
+    uassert(ErrorCodes::InvalidOptions,
+            "the storage engine does not support clustered collections",
+            !options.clustered ||
+                opCtx->getServiceContext()->getStorageEngine()->supportsClusteredCollections());
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "cannot create " << nss.ns() << " as a clustered collection",
+            !options.clustered || (nss.isNormal() && !nss.isSystem()));
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "cannot create " << nss.ns()
+                          << " with a field name dictionary",
+            !options.fieldNameDictionary || (nss.isNormal() && !nss.isSystem()));
     uassert(ErrorCodes::DatabaseDropPending,
             str::stream() << "Cannot create collection " << nss.ns()
                           << " - database is in the process of being dropped.",
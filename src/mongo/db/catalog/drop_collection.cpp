@@ -106,6 +106,18 @@ Status dropCollection(OperationContext* opCtx,
             if (!status.isOK()) {
                 return status;
             }
+
+            // Dropping a time-series collection also drops the collection holding its buckets.
+            // The buckets collection drop is replicated on its own, so only do this on primaries.
+            const auto bucketsNs = collectionName.makeTimeseriesBucketsNamespace();
+            if (opCtx->writesAreReplicated() && view->viewOn() == bucketsNs &&
+                db->getCollection(opCtx, bucketsNs)) {
+                BackgroundOperation::assertNoBgOpInProgForNs(bucketsNs.ns());
+                status = db->dropCollectionEvenIfSystem(opCtx, bucketsNs, dropOpTime);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
         }
         wunit.commit();
 
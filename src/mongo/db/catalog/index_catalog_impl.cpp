@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -609,7 +610,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
 
     const bool isSparse = spec["sparse"].trueValue();
 
-    if (pluginName == IndexNames::ALLPATHS) {
+    if (pluginName == IndexNames::ALLPATHS || pluginName == IndexNames::COLUMNSTORE) {
         if (isSparse) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
@@ -629,6 +630,13 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
         }
     }
 
+    if (pluginName == IndexNames::COLUMNSTORE && spec.hasField("partialFilterExpression")) {
+        // Every document must have a row in the column store for a column scan to be complete.
+        return Status(ErrorCodes::CannotCreateIndex,
+                      str::stream() << "Index type '" << pluginName
+                                    << "' does not support the partialFilterExpression option");
+    }
+
     // Ensure if there is a filter, its valid.
     BSONElement filterElement = spec.getField("partialFilterExpression");
     if (filterElement) {
@@ -665,6 +673,11 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
     }
 
     if (IndexDescriptor::isIdIndexPattern(key)) {
+        if (_collection->isClustered()) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          "a clustered collection is keyed by _id and cannot have an _id index");
+        }
+
         BSONElement uniqueElt = spec["unique"];
         if (uniqueElt && !uniqueElt.trueValue()) {
             return Status(ErrorCodes::CannotCreateIndex, "_id index cannot be non-unique");
@@ -1318,24 +1331,34 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
-    for (auto bsonRecord : bsonRecords) {
-        int64_t inserted;
-        invariant(bsonRecord.id != RecordId());
+    // Index the records in runs that share a commit timestamp, so that every key generated for a
+    // run reaches the storage engine as a single batch.
+    auto runBegin = bsonRecords.begin();
+    while (runBegin != bsonRecords.end()) {
+        auto runEnd = std::find_if(runBegin, bsonRecords.end(), [&](const BsonRecord& bsonRecord) {
+            return bsonRecord.ts != runBegin->ts;
+        });
 
-        if (!bsonRecord.ts.isNull()) {
-            Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecord.ts);
+        if (!runBegin->ts.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(runBegin->ts);
             if (!status.isOK())
                 return status;
         }
 
-        Status status = index->accessMethod()->insert(
-            opCtx, *bsonRecord.docPtr, bsonRecord.id, options, &inserted);
+        std::vector<BsonRecord> run(runBegin, runEnd);
+        for (const auto& bsonRecord : run) {
+            invariant(bsonRecord.id != RecordId());
+        }
+
+        int64_t inserted;
+        Status status = index->accessMethod()->insertRecords(opCtx, run, options, &inserted);
         if (!status.isOK())
             return status;
 
         if (keysInsertedOut) {
             *keysInsertedOut += inserted;
         }
+        runBegin = runEnd;
     }
     return Status::OK();
 }
@@ -82,6 +82,8 @@ public:
 
         virtual Status doneInserting(std::set<RecordId>* dupsOut = NULL) = 0;
 
+        virtual Status drainBackgroundWrites() = 0;
+
         virtual void commit(stdx::function<void(const BSONObj& spec)> onCreateFn) = 0;
 
         virtual void abortWithoutCleanup() = 0;
@@ -226,6 +228,19 @@ public:
         return this->_impl().doneInserting(dupsOut);
     }
 
+    /**
+     * Applies the writes that concurrent operations made to the collection while a hybrid
+     * background build was running. Does nothing for other builds.
+     *
+     * Call this after insertAllDocumentsInCollection() while holding an exclusive lock on the
+     * collection, so that no further writes can arrive before commit().
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     */
+    inline Status drainBackgroundWrites() {
+        return this->_impl().drainBackgroundWrites();
+    }
+
     /**
      * Marks the index ready for use. Should only be called as the last method after
      * doneInserting() or insertAllDocumentsInCollection() return success.
@@ -32,6 +32,10 @@
 
 #include "mongo/db/catalog/index_create_impl.h"
 
+#include <algorithm>
+#include <deque>
+#include <utility>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -49,8 +53,10 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -74,6 +80,14 @@ MONGO_FAIL_POINT_DEFINE(hangAfterIndexBuildOf);
 
 AtomicInt32 maxIndexBuildMemoryUsageMegabytes(500);
 
+// Background builds bulk load their indexes and apply concurrent writes from a side table
+// afterwards, instead of inserting each key into the live index.
+MONGO_EXPORT_SERVER_PARAMETER(useHybridIndexBuilds, bool, true);
+
+// Memory the side writes of a hybrid build may occupy before the build is aborted, shared between
+// the indexes it builds.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildSideWritesMemoryUsageMegabytes, int, 500);
+
 MONGO_REGISTER_SHIM(MultiIndexBlock::makeImpl)
 (OperationContext* const opCtx, Collection* const collection, PrivateTo<MultiIndexBlock>)
     ->std::unique_ptr<MultiIndexBlock::Impl> {
@@ -101,6 +115,28 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// Number of threads a foreground index build uses to generate and sort keys. A value of 1 builds on
+// the calling thread.
+AtomicInt32 maxIndexBuildThreads(4);
+
+class ExportedMaxIndexBuildThreadsParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedMaxIndexBuildThreadsParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), "maxIndexBuildThreads", &maxIndexBuildThreads) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "maxIndexBuildThreads must be between 1 and 64 inclusive");
+        }
+
+        return Status::OK();
+    }
+
+} exportedMaxIndexBuildThreadsParameter;
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -136,6 +172,197 @@ private:
     MultiIndexBlockImpl* const _indexer;
 };
 
+/**
+ * Generates and sorts index keys for a foreground build on a pool of worker threads.
+ *
+ * The collection scan hands documents to insert(), which batches them up for the workers. Each
+ * worker feeds its own BulkBuilder per index, so keys are generated and sorted runs are spilled
+ * without any coordination between workers. finish() waits for the workers and folds their
+ * builders into the MultiIndexBlockImpl's, whose done() then merges all of the sorted runs.
+ */
+class MultiIndexBlockImpl::ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    ParallelKeyGenerator(MultiIndexBlockImpl* indexer, size_t numWorkers) : _indexer(indexer) {
+        const auto& indexes = _indexer->_indexes;
+        const size_t workerMemoryUsageBytes =
+            _indexer->_eachIndexBuildMaxMemoryUsageBytes / numWorkers;
+        _builders.resize(numWorkers);
+        for (auto& builders : _builders) {
+            for (const auto& index : indexes) {
+                builders.push_back(index.real->initiateBulk(workerMemoryUsageBytes));
+            }
+        }
+
+        for (size_t i = 0; i < numWorkers; ++i) {
+            _workers.emplace_back([this, i] { _workerLoop(i); });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _abandoned = true;
+        }
+        _workAvailable.notify_all();
+        _spaceAvailable.notify_all();
+        _joinWorkers();
+    }
+
+    /**
+     * Queues 'doc' for key generation. Returns the error of a failed worker, if any.
+     */
+    Status insert(const BSONObj& doc, const RecordId& loc) {
+        _pending.bytes += doc.objsize();
+        _pending.docs.emplace_back(doc.getOwned(), loc);
+        if (_pending.docs.size() < kMaxBatchDocs && _pending.bytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+        return _flushPending();
+    }
+
+    /**
+     * Waits for all queued documents to be processed, then hands each worker's BulkBuilders over
+     * to the corresponding index's BulkBuilder.
+     */
+    Status finish() {
+        if (!_pending.docs.empty()) {
+            Status status = _flushPending();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inputDone = true;
+        }
+        _workAvailable.notify_all();
+        _joinWorkers();
+
+        if (!_status.isOK()) {
+            return _status;
+        }
+
+        auto& indexes = _indexer->_indexes;
+        for (auto& builders : _builders) {
+            for (size_t i = 0; i < indexes.size(); ++i) {
+                indexes[i].bulk->absorb(std::move(builders[i]));
+            }
+        }
+        _builders.clear();
+        return Status::OK();
+    }
+
+private:
+    static constexpr size_t kMaxBatchDocs = 1000;
+    static constexpr int kMaxBatchBytes = 1024 * 1024;
+    static constexpr size_t kMaxQueuedBatchesPerWorker = 2;
+
+    struct Batch {
+        std::vector<std::pair<BSONObj, RecordId>> docs;
+        int bytes = 0;
+    };
+
+    Status _flushPending() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _spaceAvailable.wait(lk, [&] {
+            return !_status.isOK() ||
+                _queue.size() < kMaxQueuedBatchesPerWorker * _workers.size();
+        });
+        if (!_status.isOK()) {
+            return _status;
+        }
+        _queue.push_back(std::move(_pending));
+        _pending = Batch();
+        lk.unlock();
+        _workAvailable.notify_one();
+        return Status::OK();
+    }
+
+    void _workerLoop(size_t worker) {
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _workAvailable.wait(lk, [&] {
+                    return _abandoned || !_status.isOK() || _inputDone || !_queue.empty();
+                });
+                if (_abandoned || !_status.isOK() || _queue.empty()) {
+                    return;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _spaceAvailable.notify_one();
+
+            Status status = _generateKeys(worker, batch);
+            if (!status.isOK()) {
+                {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    if (_status.isOK()) {
+                        _status = status;
+                    }
+                }
+                _workAvailable.notify_all();
+                _spaceAvailable.notify_all();
+                return;
+            }
+        }
+    }
+
+    Status _generateKeys(size_t worker, const Batch& batch) {
+        const auto& indexes = _indexer->_indexes;
+        auto& builders = _builders[worker];
+        try {
+            for (const auto& entry : batch.docs) {
+                for (size_t i = 0; i < indexes.size(); ++i) {
+                    if (indexes[i].filterExpression &&
+                        !indexes[i].filterExpression->matchesBSON(entry.first)) {
+                        continue;
+                    }
+                    // BulkBuilder::insert() only generates and sorts keys, so it does not need
+                    // an OperationContext.
+                    Status status =
+                        builders[i]->insert(nullptr, entry.first, entry.second, indexes[i].options);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    }
+
+    void _joinWorkers() {
+        for (auto& worker : _workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    MultiIndexBlockImpl* const _indexer;
+
+    // One BulkBuilder per index for each worker, only touched by that worker until finish().
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> _builders;
+    std::vector<stdx::thread> _workers;
+
+    // Documents not yet handed to the workers. Only touched by the scanning thread.
+    Batch _pending;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    std::deque<Batch> _queue;
+    bool _inputDone = false;
+    bool _abandoned = false;
+    Status _status = Status::OK();
+};
+
 MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* collection)
     : _collection(collection),
       _opCtx(opCtx),
@@ -232,6 +459,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         // Any foreground indexes make all indexes be built in the foreground.
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
     }
+    _buildIsHybrid = _buildInBackground && useHybridIndexBuilds.load();
 
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
@@ -241,6 +469,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
             static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
             indexSpecs.size();
     }
+    _eachIndexBuildMaxMemoryUsageBytes = eachIndexBuildMaxMemoryUsageBytes;
 
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
@@ -263,11 +492,19 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
-            // Bulk build process requires foreground building as it assumes nothing is changing
-            // under it.
+        if (!_buildInBackground || _buildIsHybrid) {
+            // Bulk build process assumes nothing is changing under it. Foreground builds ensure
+            // that with an exclusive lock, and hybrid builds by diverting concurrent writes to
+            // the index into a side table until the bulk load is done.
             index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
         }
+        if (_buildIsHybrid) {
+            const auto sideWritesMaxMemoryUsageBytes =
+                static_cast<std::size_t>(maxIndexBuildSideWritesMemoryUsageMegabytes.load()) *
+                1024 * 1024 / indexSpecs.size();
+            index.real->setIndexBuildInterceptor(
+                stdx::make_unique<IndexBuildInterceptor>(sideWritesMaxMemoryUsageBytes));
+        }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
 
@@ -281,6 +518,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (index.bulk)
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+        if (_buildIsHybrid)
+            log() << "\t recording concurrent writes to apply after the bulk load";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -362,6 +601,17 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // Nothing but the scan feeds the bulk builders, so key generation can run behind the scan on
+    // other threads.
+    const size_t numThreads = static_cast<size_t>(maxIndexBuildThreads.load());
+    const bool allBulk = std::all_of(_indexes.begin(), _indexes.end(), [](const auto& index) {
+        return static_cast<bool>(index.bulk);
+    });
+    if (allBulk && numThreads > 1) {
+        _parallelKeyGenerator = stdx::make_unique<ParallelKeyGenerator>(this, numThreads);
+    }
+    ON_BLOCK_EXIT([this] { _parallelKeyGenerator.reset(); });
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -416,6 +666,15 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
             progress->hit();
             n++;
             retries = 0;
+
+            // Concurrent writes pile up in memory until the bulk load is done, so give up on the
+            // build instead of letting them grow without bound.
+            if (_buildIsHybrid) {
+                Status memStatus = _checkSideWritesMemoryUsage();
+                if (!memStatus.isOK()) {
+                    return memStatus;
+                }
+            }
         } catch (const WriteConflictException&) {
             CurOp::get(_opCtx)->debug().additiveMetrics.incrementWriteConflicts(1);
             retries++;  // logAndBackoff expects this to be 1 on first call.
@@ -460,16 +719,34 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
 
     progress->finished();
 
+    if (_parallelKeyGenerator) {
+        Status status = _parallelKeyGenerator->finish();
+        _parallelKeyGenerator.reset();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     Status ret = doneInserting();
     if (!ret.isOK())
         return ret;
 
+    // Catch up on the writes made during the scan and bulk load while concurrent writers are
+    // still allowed, so that the final drain under the exclusive lock has little left to do.
+    ret = drainBackgroundWrites();
+    if (!ret.isOK())
+        return ret;
+
     log() << "build index done.  scanned " << n << " total records. " << t.seconds() << " secs";
 
     return Status::OK();
 }
 
 Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
+    if (_parallelKeyGenerator) {
+        return _parallelKeyGenerator->insert(doc, loc);
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
             continue;
@@ -491,6 +768,10 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
 
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     invariant(!_opCtx->lockState()->inAWriteUnitOfWork());
+
+
+    // The bulk loads write to storage, so they stay on this thread, under the locks the build
+    // holds. A foreground build holds its database exclusively, so no other thread could lock it.
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].bulk == NULL)
             continue;
@@ -509,6 +790,34 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::_checkSideWritesMemoryUsage() const {
+    for (const auto& index : _indexes) {
+        if (auto interceptor = index.real->getIndexBuildInterceptor()) {
+            Status status = interceptor->checkMemoryUsage();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::drainBackgroundWrites() {
+    invariant(!_opCtx->lockState()->inAWriteUnitOfWork());
+    if (!_buildIsHybrid) {
+        return Status::OK();
+    }
+
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        Status status = _indexes[i].real->drainIndexBuildSideWrites(
+            _opCtx, _indexes[i].options, _allowInterruption);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
 void MultiIndexBlockImpl::abortWithoutCleanup() {
     _indexes.clear();
     _needToCleanup = false;
@@ -528,6 +837,15 @@ void MultiIndexBlockImpl::commit(stdx::function<void(const BSONObj& spec)> onCre
             onCreateFn(_indexes[i].block->getSpec());
         }
 
+        // Once the index is marked ready, writes must go to it directly. Commit requires an
+        // exclusive lock, so no writes can be recorded between the last drain and here.
+        if (auto interceptor = _indexes[i].real->getIndexBuildInterceptor()) {
+            invariant(interceptor->areAllWritesApplied());
+            LOG(1) << "\t applied " << interceptor->getNumApplied()
+                   << " concurrent writes to index: " << _indexes[i].block->getIndexName();
+            _indexes[i].real->setIndexBuildInterceptor(nullptr);
+        }
+
         _indexes[i].block->success();
 
         // The bulk builder will track multikey information itself. Non-bulk builders re-use the
@@ -155,6 +155,14 @@ public:
      */
     Status doneInserting(std::set<RecordId>* dupsOut = nullptr) override;
 
+    /**
+     * Applies the side writes recorded for each index of a hybrid build. Does nothing for other
+     * builds.
+     *
+     * Should be called while holding an exclusive lock on the collection, before commit().
+     */
+    Status drainBackgroundWrites() override;
+
     /**
      * Marks the index ready for use. Should only be called as the last method after
      * doneInserting() or insertAllDocumentsInCollection() return success.
@@ -189,6 +197,7 @@ public:
 private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
+    class ParallelKeyGenerator;
 
     struct IndexToBuild {
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
@@ -200,8 +209,20 @@ private:
         InsertDeleteOptions options;
     };
 
+    /**
+     * Returns ExceededMemoryLimit if the side writes recorded for any index of a hybrid build
+     * have outgrown their memory bound.
+     */
+    Status _checkSideWritesMemoryUsage() const;
+
     std::vector<IndexToBuild> _indexes;
 
+    // Memory budget given to each index's bulk builder.
+    std::size_t _eachIndexBuildMaxMemoryUsageBytes = 0;
+
+    // Set while insertAllDocumentsInCollection() hands documents off to key generation threads.
+    std::unique_ptr<ParallelKeyGenerator> _parallelKeyGenerator;
+
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
 
     // Pointers not owned here and must outlive 'this'
@@ -209,6 +230,9 @@ private:
     OperationContext* _opCtx;
 
     bool _buildInBackground;
+    // Set for background builds that bulk load the indexes while concurrent writes are recorded
+    // in side tables, rather than inserting every key into the live index.
+    bool _buildIsHybrid = false;
     bool _allowInterruption;
     bool _ignoreUnique;
 
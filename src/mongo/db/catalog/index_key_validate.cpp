@@ -38,6 +38,7 @@
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/all_paths_key_generator.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
@@ -80,6 +81,7 @@ static std::set<StringData> allowedFieldNames = {
     IndexDescriptor::kDropDuplicatesFieldName,
     IndexDescriptor::kExpireAfterSecondsFieldName,
     IndexDescriptor::kGeoHaystackBucketSize,
+    IndexDescriptor::kHashVersionFieldName,
     IndexDescriptor::kIndexNameFieldName,
     IndexDescriptor::kIndexVersionFieldName,
     IndexDescriptor::kKeyPatternFieldName,
@@ -187,6 +189,13 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
             return Status(code, "all paths indexes do not allow compounding");
         }
 
+        // A columnstore index stores one column per top-level field; it has no notion of
+        // subdocument columns.
+        if (pluginName == IndexNames::COLUMNSTORE &&
+            mongoutils::str::contains(keyElement.fieldName(), '.')) {
+            return Status(code, "columnstore indexes may only contain top-level fields");
+        }
+
         // Ensure that the fields on which we are building the index are valid: a field must not
         // begin with a '$' unless it is part of an allPaths, DBRef or text index, and a field path
         // cannot contain an empty field. If a field cannot be created or updated, it should not be
@@ -288,13 +297,13 @@ StatusWith<BSONObj> validateIndexSpec(
                 return keyPatternValidateStatus;
             }
 
+            const auto pluginName = IndexNames::findPluginName(
+                indexSpec.getObjectField(IndexDescriptor::kKeyPatternFieldName));
             if ((featureCompatibility.getVersion() <
                  ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42) &&
-                (IndexNames::findPluginName(indexSpec.getObjectField(
-                     IndexDescriptor::kKeyPatternFieldName)) == IndexNames::ALLPATHS)) {
+                (pluginName == IndexNames::ALLPATHS || pluginName == IndexNames::COLUMNSTORE)) {
                 return {ErrorCodes::CannotCreateIndex,
-                        mongoutils::str::stream() << "Unknown index plugin '"
-                                                  << IndexNames::ALLPATHS
+                        mongoutils::str::stream() << "Unknown index plugin '" << pluginName
                                                   << "'"};
             }
             hasKeyPatternField = true;
@@ -403,6 +412,37 @@ StatusWith<BSONObj> validateIndexSpec(
             if (!statusWithMatcher.isOK()) {
                 return statusWithMatcher.getStatus();
             }
+        } else if (IndexDescriptor::kHashVersionFieldName == indexSpecElemFieldName) {
+            const auto key = indexSpec.getObjectField(IndexDescriptor::kKeyPatternFieldName);
+            if (IndexNames::findPluginName(key) != IndexNames::HASHED) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' is only allowed in a '"
+                                      << IndexNames::HASHED
+                                      << "' index"};
+            }
+            if (!indexSpecElem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' must be a number, but got "
+                                      << typeName(indexSpecElem.type())};
+            }
+            auto hashVersion = representAs<int>(indexSpecElem.number());
+            if (!hashVersion || !BSONElementHasher::isSupportedHashVersion(*hashVersion)) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "Unsupported " << IndexDescriptor::kHashVersionFieldName
+                                      << ": "
+                                      << indexSpecElem.toString(false, false)};
+            }
+            if (*hashVersion != BSONElementHasher::kMD5HashVersion &&
+                featureCompatibility.getVersion() <
+                    ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' can only be "
+                                      << BSONElementHasher::kMD5HashVersion
+                                      << " before featureCompatibilityVersion 4.2"};
+            }
         } else if (IndexDescriptor::kPathProjectionFieldName == indexSpecElemFieldName) {
             const auto key = indexSpec.getObjectField(IndexDescriptor::kKeyPatternFieldName);
             if (IndexNames::findPluginName(key) != IndexNames::ALLPATHS) {
@@ -1007,5 +1007,104 @@ TEST(IndexSpecAllPaths, FailsWhenExclusionWithSubpath) {
     ASSERT_EQ(result.getStatus().code(), ErrorCodes::FailedToParse);
 }
 
+TEST(IndexSpecHashVersion, AcceptsMurmur3HashVersionForHashedIndex) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 1),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_OK(result.getStatus());
+}
+
+TEST(IndexSpecHashVersion, FailsWhenIndexIsNotHashed) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a" << 1) << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 1),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::BadValue);
+}
+
+TEST(IndexSpecHashVersion, FailsWhenHashVersionIsNotANumber) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << "1"),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::TypeMismatch);
+}
+
+TEST(IndexSpecHashVersion, FailsWhenHashVersionIsUnsupported) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 2),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexSpecHashVersion, FailsWithImproperFeatureCompatabilityVersion) {
+    TestCommandFcvGuard guard;
+    serverGlobalParams.featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo42);
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 1),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexSpecColumnStore, SucceedsWithFeatureCompatibilityVersion42) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a"
+                                                       << "columnstore")
+                                               << "name"
+                                               << "indexName"),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_OK(result.getStatus());
+}
+
+TEST(IndexSpecColumnStore, FailsWithImproperFeatureCompatabilityVersion) {
+    TestCommandFcvGuard guard;
+    for (auto version : {ServerGlobalParams::FeatureCompatibility::Version::kFullyDowngradedTo40,
+                         ServerGlobalParams::FeatureCompatibility::Version::kDowngradingTo40,
+                         ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo42}) {
+        serverGlobalParams.featureCompatibility.setVersion(version);
+        auto result = validateIndexSpec(kDefaultOpCtx,
+                                        BSON("key" << BSON("a"
+                                                           << "columnstore")
+                                                   << "name"
+                                                   << "indexName"),
+                                        kTestNamespace,
+                                        serverGlobalParams.featureCompatibility);
+        ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/key_string.h"
@@ -142,6 +143,10 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
+    // A columnstore index is ordered by its stored keys, which embed the RecordId before the
+    // value, so the keys returned by its cursors are not expected to be in order.
+    const bool checkOrder = descriptor->getAccessMethodName() != IndexNames::COLUMNSTORE;
+
     std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
@@ -150,7 +155,7 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
         std::unique_ptr<KeyString> indexKeyString =
             stdx::make_unique<KeyString>(version, indexEntry->key, ord, indexEntry->loc);
         // Ensure that the index entries are in increasing or decreasing order.
-        if (!isFirstEntry && *indexKeyString < *prevIndexKeyString) {
+        if (checkOrder && !isFirstEntry && *indexKeyString < *prevIndexKeyString) {
             if (results->valid) {
                 results->errors.push_back(
                     "one or more indexes are not in strictly ascending or descending "
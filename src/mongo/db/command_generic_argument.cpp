@@ -50,11 +50,12 @@ struct SpecialArgRecord {
 // If that changes, it should be added. When you add to this list, consider whether you
 // should also change the filterCommandRequestForPassthrough() function.
 // clang-format off
-static constexpr std::array<SpecialArgRecord, 25> specials{{
+static constexpr std::array<SpecialArgRecord, 26> specials{{
     //                                       /-isGeneric
     //                                       |  /-stripFromRequest
     //                                       |  |  /-stripFromReply
     {"$audit"_sd,                            1, 1, 0},
+    {"admissionPriority"_sd,                 1, 1, 0},
     {"$client"_sd,                           1, 1, 0},
     {"$configServerState"_sd,                1, 1, 1},
     {"$db"_sd,                               1, 1, 0},
@@ -153,6 +153,7 @@ struct CommandHelpers {
         // If that changes, it should be added. When you add to this list, consider whether you
         // should also change the filterCommandRequestForPassthrough() function.
         return arg == "$audit" ||                        //
+            arg == "admissionPriority" ||                //
             arg == "$client" ||                          //
             arg == "$configServerState" ||               //
             arg == "$db" ||                              //
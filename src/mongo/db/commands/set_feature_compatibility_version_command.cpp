@@ -30,8 +30,10 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/coll_mod.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
@@ -39,9 +41,13 @@
 #include "mongo/db/commands/feature_compatibility_version_parser.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/hasher.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/s/config/sharding_catalog_manager.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/database_version_helpers.h"
@@ -56,6 +62,68 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(featureCompatibilityDowngrade);
 MONGO_FAIL_POINT_DEFINE(featureCompatibilityUpgrade);
+
+/**
+ * Fails if an index is stored in a format that 4.0 binaries cannot read. Once the downgrade has
+ * started, rebuilding such an index creates it in a format they can read. Hashed indexes using a
+ * hash version other than MD5 must be dropped instead, since their keys depend on it, as must
+ * columnstore indexes, which 4.0 binaries do not know.
+ */
+void checkIndexesReadableBy40(OperationContext* opCtx) {
+    std::vector<std::string> dbNames;
+    opCtx->getServiceContext()->getStorageEngine()->listDatabases(&dbNames);
+    for (auto&& dbName : dbNames) {
+        AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+        Database* const db = autoDb.getDb();
+        if (!db) {
+            continue;
+        }
+
+        for (auto collectionIt = db->begin(); collectionIt != db->end(); ++collectionIt) {
+            Collection* coll = *collectionIt;
+            Lock::CollectionLock collLock(opCtx->lockState(), coll->ns().ns(), MODE_IS);
+            auto it = coll->getIndexCatalog()->getIndexIterator(opCtx, true);
+            while (it.more()) {
+                const IndexDescriptor* desc = it.next();
+                uassert(ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot downgrade featureCompatibilityVersion to 4.0 "
+                                         "while index '"
+                                      << desc->indexName()
+                                      << "' on "
+                                      << coll->ns().ns()
+                                      << " uses a format 4.0 binaries cannot read. Rebuild the "
+                                         "index, then set featureCompatibilityVersion to 4.0 "
+                                         "again.",
+                        !it.accessMethod(desc)->requiresFCV42());
+
+                uassert(ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot downgrade featureCompatibilityVersion to 4.0 "
+                                         "while columnstore index '"
+                                      << desc->indexName()
+                                      << "' exists on "
+                                      << coll->ns().ns()
+                                      << ". Drop the index, then set featureCompatibilityVersion "
+                                         "to 4.0 again.",
+                        desc->getAccessMethodName() != IndexNames::COLUMNSTORE);
+
+                const auto hashVersion = desc->infoObj()[IndexDescriptor::kHashVersionFieldName];
+                uassert(ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot downgrade featureCompatibilityVersion to 4.0 "
+                                         "while hashed index '"
+                                      << desc->indexName()
+                                      << "' on "
+                                      << coll->ns().ns()
+                                      << " uses "
+                                      << hashVersion.toString()
+                                      << ". Drop the index, then set featureCompatibilityVersion "
+                                         "to 4.0 again.",
+                        !hashVersion.isNumber() ||
+                            hashVersion.numberInt() == BSONElementHasher::kMD5HashVersion);
+            }
+        }
+    }
+}
+
 /**
  * Sets the minimum allowed version for the cluster. If it is 4.0, then the node should not use 4.2
  * features.
@@ -212,6 +280,8 @@ public:
                 Lock::GlobalLock lk(opCtx, MODE_S);
             }
 
+            checkIndexesReadableBy40(opCtx);
+
             // Downgrade shards before config finishes its downgrade.
             if (serverGlobalParams.clusterRole == ClusterRole::ConfigServer) {
                 uassertStatusOK(
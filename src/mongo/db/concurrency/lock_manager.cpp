@@ -34,6 +34,10 @@
 
 #include <third_party/murmurhash3/MurmurHash3.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -41,6 +45,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -410,13 +415,15 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// Balance scalability of intent locks against potential added cost of conflicting locks. There
+// is at least one partition per CPU, so uncontended intent locks taken on different CPUs never
+// share a partition mutex. Conflicting locks only pay for the partitions a resource actually used.
+const unsigned LockManager::_minNumPartitions = 32;
 
-LockManager::LockManager() {
+LockManager::LockManager()
+    : _numPartitions(std::max(_minNumPartitions, stdx::thread::hardware_concurrency())),
+      _partitions(_numPartitions) {
     _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
 }
 
 LockManager::~LockManager() {
@@ -428,7 +435,6 @@ LockManager::~LockManager() {
     }
 
     delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -441,6 +447,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        request->partitionId = _selectPartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -809,8 +816,21 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+unsigned LockManager::_selectPartition(LockRequest* request) const {
+#if defined(__linux__)
+    // sched_getcpu is served from the vDSO and does not enter the kernel. A stale answer after the
+    // thread migrates only costs some sharing, since unlock uses the partition recorded here.
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) % _numPartitions;
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    invariant(request->partitionId < _numPartitions);
+    return &_partitions[request->partitionId];
 }
 
 void LockManager::dump() const {
@@ -1170,6 +1190,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    partitionId = 0;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
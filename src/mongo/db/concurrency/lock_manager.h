@@ -33,6 +33,8 @@
 #include <map>
 #include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -43,6 +45,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -147,9 +150,10 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
+    // Each CPU maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // contention on the regular LockHead in the lock manager, and because partitions are
+    // cache-line aligned, uncontended intent locks taken on different CPUs share no memory.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
@@ -166,7 +170,14 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Chooses the partition for a LockRequest about to be locked in an intent mode, based on the
+     * CPU the calling thread is currently running on.
+     */
+    unsigned _selectPartition(LockRequest* request) const;
+
+    /**
+     * Retrieves the Partition that a particular LockRequest should use for intent locking. Only
+     * valid after _selectPartition has been recorded in the request.
      */
     Partition* _getPartition(LockRequest* request) const;
 
@@ -214,8 +225,12 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    static const unsigned _minNumPartitions;
+    const unsigned _numPartitions;
+    using AlignedPartition = CacheAligned<Partition>;
+    using PartitionVector =
+        std::vector<AlignedPartition, boost::alignment::aligned_allocator<AlignedPartition>>;
+    mutable PartitionVector _partitions;
 };
 
 
@@ -402,6 +402,15 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Index of the LockManager partition chosen for this request when it was first locked in an
+    // intent mode. Partitions are selected by the CPU the locking thread runs on, so the index is
+    // remembered here in order for unlock to find the same partition after the thread migrates.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    unsigned partitionId;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
@@ -28,6 +28,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -951,4 +952,47 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, IntentLocksFromManyThreadsDrainForExclusive) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    // Take intent locks from separate threads so that they land on per-CPU partitions, and
+    // release them below from this thread, which may be running on any other CPU.
+    const int kNumThreads = 16;
+    std::vector<std::unique_ptr<LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (int i = 0; i < kNumThreads; i++) {
+        lockers.push_back(std::make_unique<LockerImpl>());
+        requests.push_back(std::make_unique<LockRequestCombo>(lockers.back().get()));
+    }
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, i] {
+            ASSERT(LOCK_OK == lockMgr.lock(resId, requests[i].get(), i % 2 ? MODE_IS : MODE_IX));
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The exclusive request must drain every partitioned intent lock before it is granted
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    for (int i = 0; i < kNumThreads; i++) {
+        ASSERT_EQ(0, requestX.numNotifies);
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+
+    // Intent locks are partitioned again once the exclusive lock is gone
+    ASSERT(lockMgr.unlock(&requestX));
+    LockRequestCombo requestIS(lockers[0].get());
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(lockMgr.unlock(&requestIS));
+}
+
 }  // namespace mongo
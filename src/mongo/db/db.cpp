@@ -50,6 +50,7 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/cache_prewarmer.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/catalog/database.h"
@@ -606,6 +607,12 @@ ExitCode _initAndListen(int listenPort) {
 
     startClientCursorMonitor();
 
+    startHotSetRecorder(serviceContext);
+
+    // In "blocking" mode this holds off listening, and so serving reads, until the hot set is back
+    // in the storage engine cache.
+    prewarmCacheFromHotSet(serviceContext);
+
     PeriodicTask::startRunningPeriodicTasks();
 
     SessionKiller::set(serviceContext,
@@ -939,6 +946,9 @@ void shutdownTask() {
 #endif
     stopFreeMonitoring();
 
+    // Stop a background cache prewarm before the storage engine goes away.
+    stopCachePrewarmer();
+
     // Shutdown Full-Time Data Capture
     stopMongoDFTDC();
 
@@ -55,6 +55,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/data_protector.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
@@ -139,6 +140,21 @@ RecordId Helpers::findOne(OperationContext* opCtx,
     return RecordId();
 }
 
+namespace {
+
+/**
+ * Returns the RecordId of the document with the given _id in a clustered collection, which is
+ * derived from the _id itself, or a null RecordId if there is no such document.
+ */
+RecordId findByClusteredId(OperationContext* opCtx,
+                           Collection* collection,
+                           const BSONObj& idquery) {
+    auto cursor = collection->getCursor(opCtx);
+    return clusteredkey::findKey(cursor.get(), idquery["_id"]);
+}
+
+}  // namespace
+
 bool Helpers::findById(OperationContext* opCtx,
                        Database* database,
                        StringData ns,
@@ -159,13 +175,14 @@ bool Helpers::findById(OperationContext* opCtx,
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
 
-    if (!desc)
+    if (!desc && !collection->isClustered())
         return false;
 
     if (indexFound)
         *indexFound = 1;
 
-    RecordId loc = catalog->getIndex(desc)->findSingle(opCtx, query["_id"].wrap());
+    RecordId loc = desc ? catalog->getIndex(desc)->findSingle(opCtx, query["_id"].wrap())
+                        : findByClusteredId(opCtx, collection, query);
     if (loc.isNull())
         return false;
     result = collection->docFor(opCtx, loc).value();
@@ -176,6 +193,9 @@ RecordId Helpers::findById(OperationContext* opCtx,
                            Collection* collection,
                            const BSONObj& idquery) {
     verify(collection);
+    if (collection->isClustered())
+        return findByClusteredId(opCtx, collection, idquery);
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
     uassert(13430, "no _id index", desc);
@@ -38,7 +38,9 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/storage/field_name_dictionary_record_store.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -55,6 +57,96 @@ using stdx::make_unique;
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
+namespace {
+
+bool isCompactComparable(const BSONElement& operand) {
+    return operand.type() != Object && operand.type() != Array;
+}
+
+/**
+ * Rewrites the paths of 'expr' in place so that it can be evaluated against the compact form of
+ * documents produced by 'dictionary'. Returns false if 'expr' cannot be evaluated against the
+ * compact form, either because it depends on field names other than through its paths or because
+ * one of its paths has a component which is not in the dictionary.
+ *
+ * The children of an $elemMatch on values apply to array elements, so their paths are left as-is.
+ */
+bool translateForCompactRecords(MatchExpression* expr,
+                                const FieldNameDictionary& dictionary,
+                                bool translatePath) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!translateForCompactRecords(expr->getChild(i), dictionary, translatePath)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            return true;
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            if (!isCompactComparable(
+                    static_cast<ComparisonMatchExpressionBase*>(expr)->getData())) {
+                return false;
+            }
+            break;
+        case MatchExpression::MATCH_IN:
+            for (auto&& equality : static_cast<InMatchExpression*>(expr)->getEqualities()) {
+                if (!isCompactComparable(equality)) {
+                    return false;
+                }
+            }
+            break;
+        case MatchExpression::ELEM_MATCH_OBJECT:
+            if (!translateForCompactRecords(expr->getChild(0), dictionary, true)) {
+                return false;
+            }
+            break;
+        case MatchExpression::ELEM_MATCH_VALUE:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!translateForCompactRecords(expr->getChild(i), dictionary, false)) {
+                    return false;
+                }
+            }
+            break;
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+        case MatchExpression::TYPE_OPERATOR:
+        case MatchExpression::SIZE:
+            break;
+        default:
+            return false;
+    }
+
+    if (!translatePath) {
+        return true;
+    }
+
+    auto pathExpr = static_cast<PathMatchExpression*>(expr);
+    const std::string path = pathExpr->path().toString();
+    auto encodedPath = dictionary.encodePath(path);
+    if (!encodedPath) {
+        return false;
+    }
+    pathExpr->applyRename({{path, *encodedPath}});
+    return true;
+}
+
+}  // namespace
+
 CollectionScan::CollectionScan(OperationContext* opCtx,
                                const CollectionScanParams& params,
                                WorkingSet* workingSet,
@@ -75,6 +167,18 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
         _endCondition = stdx::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
                                                               _endConditionBSON.firstElement());
     }
+
+    auto compactRecordStore =
+        dynamic_cast<const FieldNameDictionaryRecordStore*>(params.collection->getRecordStore());
+    if (_filter && compactRecordStore && !params.tailable && !params.maxTs &&
+        !params.stopApplyingFilterAfterFirstMatch && !params.shouldTrackLatestOplogTimestamp) {
+        auto compactFilter = _filter->shallowClone();
+        if (translateForCompactRecords(
+                compactFilter.get(), compactRecordStore->getDictionary(), true)) {
+            _compactRecordStore = compactRecordStore;
+            _compactFilter = std::move(compactFilter);
+        }
+    }
 }
 
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
@@ -117,7 +221,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
                     getOpCtx());
             }
 
-            _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            _cursor = _compactRecordStore
+                ? _compactRecordStore->getCompactCursor(getOpCtx(), forward)
+                : _params.collection->getCursor(getOpCtx(), forward);
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
@@ -187,12 +293,25 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
     }
 
+    BSONObj obj = record->data.releaseToBson();
+    if (_compactFilter) {
+        ++_specificStats.docsTested;
+        if (!_compactFilter->matchesBSON(obj)) {
+            return PlanStage::NEED_TIME;
+        }
+        obj = _compactRecordStore->getDictionary().decode(obj);
+    }
+
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
-    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), std::move(obj)};
     _workingSet->transitionToRecordIdAndObj(id);
 
+    if (_compactFilter) {
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
     return returnIfMatches(member, id, out);
 }
 
@@ -37,6 +37,7 @@
 
 namespace mongo {
 
+class FieldNameDictionaryRecordStore;
 struct Record;
 class SeekableRecordCursor;
 class WorkingSet;
@@ -98,6 +99,12 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // If the collection stores documents in the compact form of a FieldNameDictionary, and
+    // '_filter' can be evaluated against that form, the record store and the translated filter.
+    // Only the documents which pass '_compactFilter' are then decoded.
+    const FieldNameDictionaryRecordStore* _compactRecordStore = nullptr;
+    std::unique_ptr<MatchExpression> _compactFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/column_scan.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/column_store_access_method.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* ColumnScan::kStageType = "COLUMN_SCAN";
+
+ColumnScan::ColumnScan(OperationContext* opCtx,
+                       const Collection* collection,
+                       const IndexDescriptor* descriptor,
+                       std::vector<std::string> fields,
+                       const MatchExpression* filter,
+                       WorkingSet* workingSet)
+    : PlanStage(kStageType, opCtx),
+      _collection(collection),
+      _iam(static_cast<const ColumnStoreAccessMethod*>(
+          descriptor->getIndexCatalog()->getIndex(descriptor))),
+      _filter(filter),
+      _workingSet(workingSet) {
+    invariant(_iam);
+    for (auto&& field : fields) {
+        const int column = _iam->getKeyGenerator().columnFor(field);
+        invariant(column >= 0);
+        _columns.push_back({field, column, nullptr, boost::none});
+    }
+
+    _specificStats.indexName = descriptor->indexName();
+    _specificStats.keyPattern = descriptor->keyPattern();
+    _specificStats.fields = std::move(fields);
+}
+
+unique_ptr<SortedDataInterface::Cursor> ColumnScan::_makeColumnCursor(int column) {
+    auto cursor = _iam->newCursor(getOpCtx());
+    cursor->setEndPosition(BSON("" << column), true);
+    return cursor;
+}
+
+void ColumnScan::_openCursors() {
+    _recordCursor = _makeColumnCursor(ColumnStoreKeyGenerator::kRecordColumn);
+    for (auto&& column : _columns) {
+        column.cursor = _makeColumnCursor(column.column);
+        column.entry = column.cursor->seek(BSON("" << column.column), true);
+        ++_specificStats.keysExamined;
+    }
+
+    // Position the record cursor last so that a WriteConflictException above leaves it unset.
+    _recordEntry = _recordCursor->seek(BSON("" << ColumnStoreKeyGenerator::kRecordColumn),
+                                       true,
+                                       SortedDataInterface::Cursor::kWantLoc);
+    ++_specificStats.keysExamined;
+}
+
+void ColumnScan::_advanceTo(Column* column, const RecordId& rid) {
+    while (column->entry && column->entry->loc < rid) {
+        column->entry = column->cursor->next();
+        ++_specificStats.keysExamined;
+    }
+}
+
+BSONObj ColumnScan::_buildRow(const RecordId& rid) {
+    BSONObj document;
+    BSONObjBuilder row;
+    for (auto&& column : _columns) {
+        _advanceTo(&column, rid);
+        if (!column.entry || column.entry->loc != rid) {
+            continue;
+        }
+
+        BSONObjIterator key(column.entry->key);
+        key.next();
+        BSONElement value = key.next();
+        if (value.type() == MinKey) {
+            if (document.isEmpty()) {
+                if (!_fetchCursor) {
+                    _fetchCursor = _collection->getCursor(getOpCtx());
+                }
+                auto record = _fetchCursor->seekExact(rid);
+                invariant(record);
+                ++_specificStats.fetches;
+                document = record->data.releaseToBson().getOwned();
+            }
+            value = document[column.field];
+        }
+
+        row.appendAs(value, column.field);
+    }
+    return row.obj();
+}
+
+PlanStage::StageState ColumnScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF)
+        return PlanStage::IS_EOF;
+
+    BSONObj obj;
+    const bool needInit = !_recordCursor;
+    try {
+        if (needInit) {
+            // First call to work().  Perform cursor init.
+            _openCursors();
+        } else if (_advanceRecord) {
+            _recordEntry = _recordCursor->next(SortedDataInterface::Cursor::kWantLoc);
+            ++_specificStats.keysExamined;
+            _advanceRecord = false;
+        }
+
+        if (!_recordEntry) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        // Each column only ever moves forward, so a WriteConflictException part way through
+        // building the row leaves the stage able to build it again once it is retried.
+        obj = _buildRow(_recordEntry->loc);
+    } catch (const WriteConflictException&) {
+        if (needInit) {
+            // Release our cursors and try again next time.
+            _recordCursor.reset();
+            for (auto&& column : _columns) {
+                column.cursor.reset();
+            }
+        }
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    _advanceRecord = true;
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+    member->transitionToOwnedObj();
+
+    ++_specificStats.docsTested;
+    if (!Filter::passes(member, _filter)) {
+        _workingSet->free(id);
+        return PlanStage::NEED_TIME;
+    }
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+bool ColumnScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ColumnScan::doSaveState() {
+    if (_recordCursor)
+        _recordCursor->save();
+    for (auto&& column : _columns) {
+        if (column.cursor)
+            column.cursor->save();
+    }
+    if (_fetchCursor)
+        _fetchCursor->saveUnpositioned();
+}
+
+void ColumnScan::doRestoreState() {
+    if (_recordCursor)
+        _recordCursor->restore();
+    for (auto&& column : _columns) {
+        if (column.cursor)
+            column.cursor->restore();
+    }
+    if (_fetchCursor)
+        _fetchCursor->restore();
+}
+
+void ColumnScan::doDetachFromOperationContext() {
+    if (_recordCursor)
+        _recordCursor->detachFromOperationContext();
+    for (auto&& column : _columns) {
+        if (column.cursor)
+            column.cursor->detachFromOperationContext();
+    }
+    if (_fetchCursor)
+        _fetchCursor->detachFromOperationContext();
+}
+
+void ColumnScan::doReattachToOperationContext() {
+    if (_recordCursor)
+        _recordCursor->reattachToOperationContext(getOpCtx());
+    for (auto&& column : _columns) {
+        if (column.cursor)
+            column.cursor->reattachToOperationContext(getOpCtx());
+    }
+    if (_fetchCursor)
+        _fetchCursor->reattachToOperationContext(getOpCtx());
+}
+
+unique_ptr<PlanStageStats> ColumnScan::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COLUMN_SCAN);
+    ret->specific = make_unique<ColumnScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ColumnScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
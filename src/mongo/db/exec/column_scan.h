@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+class Collection;
+class ColumnStoreAccessMethod;
+class WorkingSet;
+
+/**
+ * Scans the columns of a columnstore index in RecordId order and, for each document in the
+ * collection, reassembles an owned object holding only the requested top-level 'fields'. Returns
+ * the objects which pass 'filter' in OWNED_OBJ state, with fields in the order they were requested.
+ *
+ * The record column of the index drives the scan, so documents missing every requested field are
+ * still returned. Values too large to be held in the index are read from the document.
+ *
+ * Only created through the column scan path of getExecutor(), which ensures that every field read
+ * by the query and its projection is a column of the index.
+ */
+class ColumnScan final : public PlanStage {
+public:
+    ColumnScan(OperationContext* opCtx,
+               const Collection* collection,
+               const IndexDescriptor* descriptor,
+               std::vector<std::string> fields,
+               const MatchExpression* filter,
+               WorkingSet* workingSet);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
+    StageType stageType() const final {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    struct Column {
+        std::string field;
+        int column;
+        std::unique_ptr<SortedDataInterface::Cursor> cursor;
+
+        // The entry the cursor is positioned on; none once the column is exhausted.
+        boost::optional<IndexKeyEntry> entry;
+    };
+
+    // Opens one cursor per column, each bounded to the keys of its own column.
+    void _openCursors();
+
+    // Advances 'column' to the first entry whose RecordId is not before 'rid'.
+    void _advanceTo(Column* column, const RecordId& rid);
+
+    // Builds the object for the current row, fetching the document for values that were too
+    // large to be stored in the index.
+    BSONObj _buildRow(const RecordId& rid);
+
+    std::unique_ptr<SortedDataInterface::Cursor> _makeColumnCursor(int column);
+
+    // Not owned by us.
+    const Collection* _collection;
+    const ColumnStoreAccessMethod* _iam;
+    const MatchExpression* _filter;
+    WorkingSet* _workingSet;
+
+    std::unique_ptr<SortedDataInterface::Cursor> _recordCursor;
+    boost::optional<IndexKeyEntry> _recordEntry;
+
+    // Set once the current row has been returned, so that the next call to work() moves on.
+    bool _advanceRecord = false;
+
+    std::vector<Column> _columns;
+
+    // Opened on first use, to read values that were spilled out of the index.
+    std::unique_ptr<SeekableRecordCursor> _fetchCursor;
+
+    ColumnScanStats _specificStats;
+};
+
+}  // namespace mongo
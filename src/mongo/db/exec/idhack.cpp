@@ -37,6 +37,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 
@@ -57,12 +58,17 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _workingSet(ws),
+      _accessMethod(nullptr),
       _key(query->getQueryObj()["_id"].wrap()),
       _done(false),
       _idBeingPagedIn(WorkingSet::INVALID_ID) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    if (descriptor) {
+        const IndexCatalog* catalog = _collection->getIndexCatalog();
+        _specificStats.indexName = descriptor->indexName();
+        _accessMethod = catalog->getIndex(descriptor);
+    } else {
+        invariant(_collection->isClustered());
+    }
 
     if (NULL != query->getProj()) {
         _addKeyMetadata = query->getProj()->wantIndexKey();
@@ -79,13 +85,18 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _workingSet(ws),
+      _accessMethod(nullptr),
       _key(key),
       _done(false),
       _addKeyMetadata(false),
       _idBeingPagedIn(WorkingSet::INVALID_ID) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    if (descriptor) {
+        const IndexCatalog* catalog = _collection->getIndexCatalog();
+        _specificStats.indexName = descriptor->indexName();
+        _accessMethod = catalog->getIndex(descriptor);
+    } else {
+        invariant(_collection->isClustered());
+    }
 }
 
 IDHackStage::~IDHackStage() {}
@@ -118,8 +129,20 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
 
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
-        // Look up the key by going directly to the index.
-        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
+        RecordId recordId;
+        if (_accessMethod) {
+            // Look up the key by going directly to the index.
+            recordId = _accessMethod->findSingle(getOpCtx(), _key);
+            if (!recordId.isNull()) {
+                ++_specificStats.keysExamined;
+            }
+        } else {
+            // A clustered collection stores the document under its _id, so there is no index to
+            // consult.
+            if (!_recordCursor)
+                _recordCursor = _collection->getCursor(getOpCtx());
+            recordId = clusteredkey::findKey(_recordCursor.get(), _key.firstElement());
+        }
 
         // Key not found.
         if (recordId.isNull()) {
@@ -127,7 +150,6 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
             return PlanStage::IS_EOF;
         }
 
-        ++_specificStats.keysExamined;
         ++_specificStats.docsExamined;
 
         // Create a new WSM for the result document.
@@ -44,6 +44,9 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * For a clustered collection, which has no _id index, 'descriptor' is null and the document is
+ * read directly from the record store.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -102,7 +105,7 @@ private:
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
-    // Not owned here.
+    // Not owned here. Null for a clustered collection.
     const IndexAccessMethod* _accessMethod;
 
     // The value to match against the _id field.
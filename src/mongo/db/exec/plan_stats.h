@@ -213,6 +213,30 @@ struct CollectionScanStats : public SpecificStats {
     boost::optional<Timestamp> maxTs;
 };
 
+struct ColumnScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        ColumnScanStats* specific = new ColumnScanStats(*this);
+        specific->keyPattern = keyPattern.getOwned();
+        return specific;
+    }
+
+    std::string indexName;
+
+    BSONObj keyPattern;
+
+    // The fields read from the index.
+    std::vector<std::string> fields;
+
+    // Number of index keys read across all the columns, including the record column.
+    size_t keysExamined = 0;
+
+    // How many rows did we check against our filter?
+    size_t docsTested = 0;
+
+    // Number of documents fetched because a value was too large to be stored in the index.
+    size_t fetches = 0;
+};
+
 struct CountStats : public SpecificStats {
     CountStats() : nCounted(0), nSkipped(0), recordStoreCount(false) {}
 
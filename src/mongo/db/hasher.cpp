@@ -35,9 +35,12 @@
 #include "mongo/db/hasher.h"
 
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
@@ -79,7 +82,34 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+/**
+ * MurmurHash3 is not incremental, so the canonical representation is gathered into a buffer and
+ * hashed at once.
+ */
+class Murmur3Hasher {
+    MONGO_DISALLOW_COPYING(Murmur3Hasher);
+
+public:
+    explicit Murmur3Hasher(HashSeed seed) : _seed(seed) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buf.appendBuf(keyData, numBytes);
+    }
+
+    long long int finish() {
+        // The digest is stored little-endian, whatever the native byte order.
+        uint64_t out[2];
+        MurmurHash3_x64_128(_buf.buf(), _buf.len(), static_cast<uint32_t>(_seed), out);
+        return ConstDataView(reinterpret_cast<const char*>(out)).read<LittleEndian<long long>>();
+    }
+
+private:
+    HashSeed _seed;
+    StackBufBuilder _buf;
+};
+
+template <typename H>
+void recursiveHash(H* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,6 +152,10 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(o.firstElement(),
+                                         0,
+                                         BSONElementHasher::kMurmur3HashVersion) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 
@@ -137,4 +171,14 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    if (hashVersion == kMD5HashVersion) {
+        return hash64(e, seed);
+    }
+    invariant(hashVersion == kMurmur3HashVersion);
+    Murmur3Hasher h(seed);
+    recursiveHash(&h, e, false);
+    return h.finish();
+}
+
 }  // namespace mongo
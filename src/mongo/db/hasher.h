@@ -54,6 +54,21 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* Versions of the hash function, recorded as "hashVersion" in hashed index specs.
+     * Version 0 is the first 64 bits of an MD5 digest. Version 1 is the first 64 bits of
+     * the x64 128-bit MurmurHash3, which is several times faster to compute. Both versions
+     * hash the same canonical representation of the element.
+     *
+     * WARNING: do not change the hash computed by an existing version.
+     */
+    static const int kMD5HashVersion = 0;
+    static const int kMurmur3HashVersion = 1;
+    static const int kLatestHashVersion = kMurmur3HashVersion;
+
+    static bool isSupportedHashVersion(int hashVersion) {
+        return hashVersion == kMD5HashVersion || hashVersion == kMurmur3HashVersion;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -68,6 +83,10 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* As above, using the hash function of 'hashVersion', which must be supported.
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
 private:
     BSONElementHasher();
 };
@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/hasher.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeHashInput(int64_t numFields) {
+    BSONObjBuilder bob;
+    for (int64_t i = 0; i < numFields; ++i) {
+        bob.append(std::to_string(i), "hashed index and shard key value");
+    }
+    return bob.obj();
+}
+
+void BM_hash64(benchmark::State& state, int hashVersion) {
+    const BSONObj input = BSON("" << makeHashInput(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BSONElementHasher::hash64(
+            input.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED, hashVersion));
+    }
+    state.SetBytesProcessed(state.iterations() * input.objsize());
+}
+
+void BM_hash64MD5(benchmark::State& state) {
+    BM_hash64(state, BSONElementHasher::kMD5HashVersion);
+}
+
+void BM_hash64Murmur3(benchmark::State& state) {
+    BM_hash64(state, BSONElementHasher::kMurmur3HashVersion);
+}
+
+BENCHMARK(BM_hash64MD5)->Arg(0)->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK(BM_hash64Murmur3)->Arg(0)->Arg(1)->Arg(16)->Arg(256);
+
+}  // namespace
+}  // namespace mongo
@@ -359,5 +359,41 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+long long murmur3HashIt(const BSONObj& object, int seed = 0) {
+    return BSONElementHasher::hash64(
+        object.firstElement(), seed, BSONElementHasher::kMurmur3HashVersion);
+}
+
+TEST(BSONElementHasher, MD5HashVersionMatchesDefault) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(
+        BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::kMD5HashVersion),
+        hashIt(o));
+}
+
+TEST(BSONElementHasher, Murmur3HashIsStable) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("check" << 42)), 8715208212397937794LL);
+    ASSERT_EQUALS(murmur3HashIt(BSON("check" << 42), 1), -9087602108468514688LL);
+    ASSERT_EQUALS(murmur3HashIt(BSON("check"
+                                     << "abc")),
+                  1087612813366940559LL);
+}
+
+TEST(BSONElementHasher, Murmur3HashDiffersFromMD5) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_NOT_EQUALS(murmur3HashIt(o), hashIt(o));
+}
+
+TEST(BSONElementHasher, Murmur3HashSquashesLikeMD5) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 3LL)));
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 3.1)));
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << BSON("b" << 4))),
+                  murmur3HashIt(BSON("a" << BSON("b" << 4.1))));
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 4)));
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << BSON_ARRAY(1 << 2))),
+                      murmur3HashIt(BSON("a" << BSON("0" << 1 << "1" << 2))));
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << 4), 0), murmur3HashIt(BSON("a" << 4), 1));
+}
+
 }  // namespace
 }  // namespace mongo
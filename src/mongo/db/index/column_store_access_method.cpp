@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_store_access_method.h"
+
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Translates between the generated form of columnstore keys and the form in which they are stored
+ * by the wrapped SortedDataInterface. See ColumnStoreAccessMethod.
+ */
+class ColumnStoreSortedDataInterface final : public SortedDataInterface {
+public:
+    explicit ColumnStoreSortedDataInterface(SortedDataInterface* sdi) : _sdi(sdi) {}
+
+    SortedDataBuilderInterface* getBulkBuilder(OperationContext* opCtx, bool dupsAllowed) final {
+        // Keys arrive from the external sorter ordered by value rather than by RecordId, so the
+        // underlying bulk loader cannot be used. Insert them one by one instead.
+        return new Builder(opCtx, _sdi.get(), dupsAllowed);
+    }
+
+    Status insert(OperationContext* opCtx,
+                  const BSONObj& key,
+                  const RecordId& loc,
+                  bool dupsAllowed) final {
+        return _sdi->insert(opCtx, ColumnStoreAccessMethod::makeStoredKey(key, loc), loc, true);
+    }
+
+    void unindex(OperationContext* opCtx,
+                 const BSONObj& key,
+                 const RecordId& loc,
+                 bool dupsAllowed) final {
+        _sdi->unindex(opCtx, ColumnStoreAccessMethod::makeStoredKey(key, loc), loc, true);
+    }
+
+    Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& loc) final {
+        // Every stored key contains its RecordId, so stored keys are always unique.
+        return Status::OK();
+    }
+
+    Status compact(OperationContext* opCtx) final {
+        return _sdi->compact(opCtx);
+    }
+
+    void fullValidate(OperationContext* opCtx,
+                      long long* numKeysOut,
+                      ValidateResults* fullResults) const final {
+        _sdi->fullValidate(opCtx, numKeysOut, fullResults);
+    }
+
+    bool appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* output,
+                           double scale) const final {
+        return _sdi->appendCustomStats(opCtx, output, scale);
+    }
+
+    long long getSpaceUsedBytes(OperationContext* opCtx) const final {
+        return _sdi->getSpaceUsedBytes(opCtx);
+    }
+
+    bool isEmpty(OperationContext* opCtx) final {
+        return _sdi->isEmpty(opCtx);
+    }
+
+    Status touch(OperationContext* opCtx) const final {
+        return _sdi->touch(opCtx);
+    }
+
+    long long numEntries(OperationContext* opCtx) const final {
+        return _sdi->numEntries(opCtx);
+    }
+
+    std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* opCtx,
+                                                           bool isForward) const final {
+        return stdx::make_unique<Cursor>(_sdi->newCursor(opCtx, isForward));
+    }
+
+    Status initAsEmpty(OperationContext* opCtx) final {
+        return _sdi->initAsEmpty(opCtx);
+    }
+
+private:
+    class Builder final : public SortedDataBuilderInterface {
+    public:
+        Builder(OperationContext* opCtx, SortedDataInterface* sdi, bool dupsAllowed)
+            : _opCtx(opCtx), _sdi(sdi) {}
+
+        Status addKey(const BSONObj& key, const RecordId& loc) final {
+            return _sdi->insert(
+                _opCtx, ColumnStoreAccessMethod::makeStoredKey(key, loc), loc, true);
+        }
+
+    private:
+        OperationContext* const _opCtx;
+        SortedDataInterface* const _sdi;
+    };
+
+    class Cursor final : public SortedDataInterface::Cursor {
+    public:
+        explicit Cursor(std::unique_ptr<SortedDataInterface::Cursor> cursor)
+            : _cursor(std::move(cursor)) {}
+
+        void setEndPosition(const BSONObj& key, bool inclusive) final {
+            _cursor->setEndPosition(key, inclusive);
+        }
+
+        boost::optional<IndexKeyEntry> next(RequestedInfo parts) final {
+            return _translate(_cursor->next(parts));
+        }
+
+        boost::optional<IndexKeyEntry> seek(const BSONObj& key,
+                                            bool inclusive,
+                                            RequestedInfo parts) final {
+            return _translate(_cursor->seek(key, inclusive, parts));
+        }
+
+        boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
+                                            RequestedInfo parts) final {
+            return _translate(_cursor->seek(seekPoint, parts));
+        }
+
+        void save() final {
+            _cursor->save();
+        }
+
+        void saveUnpositioned() final {
+            _cursor->saveUnpositioned();
+        }
+
+        void restore() final {
+            _cursor->restore();
+        }
+
+        void detachFromOperationContext() final {
+            _cursor->detachFromOperationContext();
+        }
+
+        void reattachToOperationContext(OperationContext* opCtx) final {
+            _cursor->reattachToOperationContext(opCtx);
+        }
+
+    private:
+        static boost::optional<IndexKeyEntry> _translate(boost::optional<IndexKeyEntry> entry) {
+            if (entry && !entry->key.isEmpty()) {
+                entry->key = ColumnStoreAccessMethod::makeGeneratedKey(entry->key);
+            }
+            return entry;
+        }
+
+        const std::unique_ptr<SortedDataInterface::Cursor> _cursor;
+    };
+
+    const std::unique_ptr<SortedDataInterface> _sdi;
+};
+
+}  // namespace
+
+ColumnStoreAccessMethod::ColumnStoreAccessMethod(IndexCatalogEntry* columnStoreState,
+                                                 SortedDataInterface* btree)
+    : IndexAccessMethod(columnStoreState, new ColumnStoreSortedDataInterface(btree)),
+      _keyGen(_descriptor->keyPattern()) {}
+
+BSONObj ColumnStoreAccessMethod::makeStoredKey(const BSONObj& key, const RecordId& loc) {
+    BSONObjIterator it(key);
+    BSONObjBuilder stored;
+    stored.appendAs(it.next(), "");
+    stored.append("", static_cast<long long>(loc.repr()));
+    stored.appendAs(it.next(), "");
+    return stored.obj();
+}
+
+BSONObj ColumnStoreAccessMethod::makeGeneratedKey(const BSONObj& storedKey) {
+    BSONObjIterator it(storedKey);
+    BSONObjBuilder generated;
+    generated.appendAs(it.next(), "");
+    it.next();
+    generated.appendAs(it.next(), "");
+    return generated.obj();
+}
+
+bool ColumnStoreAccessMethod::shouldMarkIndexAsMultikey(const BSONObjSet& keys,
+                                                        const BSONObjSet& multikeyMetadataKeys,
+                                                        const MultikeyPaths& multikeyPaths) const {
+    return false;
+}
+
+void ColumnStoreAccessMethod::doGetKeys(const BSONObj& obj,
+                                        BSONObjSet* keys,
+                                        BSONObjSet* multikeyMetadataKeys,
+                                        MultikeyPaths* multikeyPaths) const {
+    _keyGen.generateKeys(obj, keys);
+}
+
+}  // namespace mongo
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/index/column_store_key_generator.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+/**
+ * Access method for columnstore indexes, created with { a: "columnstore", b: "columnstore", ... }.
+ *
+ * The index holds one column per indexed top-level field. Keys are generated by
+ * ColumnStoreKeyGenerator in the form { '': <column>, '': <value> }, but are stored in the
+ * underlying SortedDataInterface as { '': <column>, '': <RecordId>, '': <value> }, so that each
+ * column is laid out contiguously in RecordId order. A column can therefore be read by a forward
+ * scan that merges on RecordId with the other columns, without touching the collection.
+ *
+ * Cursors returned by newCursor() take seek keys in the stored form (a prefix of
+ * { '': <column>, '': <RecordId> }) and return keys in the generated form. A value of MinKey means
+ * that the value was too large to be stored in the index and must be read from the document.
+ */
+class ColumnStoreAccessMethod : public IndexAccessMethod {
+public:
+    ColumnStoreAccessMethod(IndexCatalogEntry* columnStoreState, SortedDataInterface* btree);
+
+    /**
+     * Returns the stored form of the generated key 'key' for the document at 'loc'.
+     */
+    static BSONObj makeStoredKey(const BSONObj& key, const RecordId& loc);
+
+    /**
+     * Returns the generated form of the stored key 'storedKey'.
+     */
+    static BSONObj makeGeneratedKey(const BSONObj& storedKey);
+
+    /**
+     * Each field is stored whole in a single key, so a columnstore index is never multikey.
+     */
+    bool shouldMarkIndexAsMultikey(const BSONObjSet& keys,
+                                   const BSONObjSet& multikeyMetadataKeys,
+                                   const MultikeyPaths& multikeyPaths) const final;
+
+    const ColumnStoreKeyGenerator& getKeyGenerator() const {
+        return _keyGen;
+    }
+
+private:
+    void doGetKeys(const BSONObj& obj,
+                   BSONObjSet* keys,
+                   BSONObjSet* multikeyMetadataKeys,
+                   MultikeyPaths* multikeyPaths) const final;
+
+    const ColumnStoreKeyGenerator _keyGen;
+};
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_store_key_generator.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+constexpr int ColumnStoreKeyGenerator::kRecordColumn;
+constexpr int ColumnStoreKeyGenerator::kMaxStoredValueSize;
+
+ColumnStoreKeyGenerator::ColumnStoreKeyGenerator(BSONObj keyPattern)
+    : _keyPattern(keyPattern.getOwned()) {
+    for (auto&& elem : _keyPattern) {
+        _fields.push_back(elem.fieldName());
+    }
+}
+
+void ColumnStoreKeyGenerator::generateKeys(const BSONObj& obj, BSONObjSet* keys) const {
+    keys->insert(BSON("" << kRecordColumn << "" << BSONNULL));
+
+    for (int column = 0; column < static_cast<int>(_fields.size()); ++column) {
+        BSONElement value = obj[_fields[column]];
+        if (value.eoo()) {
+            continue;
+        }
+
+        BSONObjBuilder key;
+        key.append("", column);
+        if (value.size() > kMaxStoredValueSize) {
+            key.appendMinKey("");
+        } else {
+            key.appendAs(value, "");
+        }
+        keys->insert(key.obj());
+    }
+}
+
+int ColumnStoreKeyGenerator::columnFor(StringData field) const {
+    for (size_t column = 0; column < _fields.size(); ++column) {
+        if (_fields[column] == field) {
+            return static_cast<int>(column);
+        }
+    }
+    return -1;
+}
+
+}  // namespace mongo
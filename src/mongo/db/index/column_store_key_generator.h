@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+
+namespace mongo {
+
+/**
+ * Generates the keys for a columnstore index, created with a key pattern of the form
+ * { a: "columnstore", b: "columnstore", ... }. Each indexed top-level field is a column, identified
+ * by its ordinal position in the key pattern. A document produces one key per indexed field that it
+ * contains, of the form
+ *      { '': <column ordinal>, '': <field value> }
+ * plus a single record marker key { '': kRecordColumn, '': null }, so that a scan of the record
+ * column visits every document in the collection, including those missing all indexed fields.
+ */
+class ColumnStoreKeyGenerator {
+public:
+    /**
+     * Column ordinal of the record marker key. Sorts before every field column.
+     */
+    static constexpr int kRecordColumn = -1;
+
+    /**
+     * Values whose BSON encoding is larger than this are not stored in the index. Such a value is
+     * replaced by MinKey, which tells readers to fetch the field from the document itself.
+     */
+    static constexpr int kMaxStoredValueSize = 512;
+
+    explicit ColumnStoreKeyGenerator(BSONObj keyPattern);
+
+    /**
+     * Adds the keys for 'obj' to 'keys', as described above.
+     */
+    void generateKeys(const BSONObj& obj, BSONObjSet* keys) const;
+
+    /**
+     * Returns the column ordinal for 'field', or -1 if 'field' is not indexed.
+     */
+    int columnFor(StringData field) const;
+
+    const std::vector<std::string>& fields() const {
+        return _fields;
+    }
+
+private:
+    const BSONObj _keyPattern;
+    std::vector<std::string> _fields;
+};
+
+}  // namespace mongo
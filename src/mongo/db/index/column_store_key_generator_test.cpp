@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_store_key_generator.h"
+
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kRecordColumn = ColumnStoreKeyGenerator::kRecordColumn;
+
+BSONObjSet makeKeys(const BSONObj& keyPattern, const BSONObj& doc) {
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ColumnStoreKeyGenerator(keyPattern).generateKeys(doc, &keys);
+    return keys;
+}
+
+void assertKeysEqual(const BSONObjSet& expected, const BSONObjSet& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    auto it = actual.begin();
+    for (auto&& key : expected) {
+        ASSERT_BSONOBJ_EQ(key, *it++);
+    }
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ProducesOneKeyPerPresentColumnPlusRecordMarker) {
+    auto keys = makeKeys(fromjson("{a: 'columnstore', b: 'columnstore', c: 'columnstore'}"),
+                         fromjson("{_id: 1, a: 5, c: 'x', d: true}"));
+
+    BSONObjSet expected = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expected.insert(BSON("" << kRecordColumn << "" << BSONNULL));
+    expected.insert(BSON("" << 0 << "" << 5));
+    expected.insert(BSON("" << 2 << ""
+                            << "x"));
+    assertKeysEqual(expected, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, DocumentWithoutIndexedFieldsStillHasRecordMarker) {
+    auto keys = makeKeys(fromjson("{a: 'columnstore'}"), fromjson("{_id: 1, z: 1}"));
+
+    BSONObjSet expected = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expected.insert(BSON("" << kRecordColumn << "" << BSONNULL));
+    assertKeysEqual(expected, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ArraysAndSubdocumentsAreStoredWhole) {
+    auto keys = makeKeys(fromjson("{a: 'columnstore', b: 'columnstore'}"),
+                         fromjson("{a: [1, 2, 3], b: {c: 1}}"));
+
+    BSONObjSet expected = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expected.insert(BSON("" << kRecordColumn << "" << BSONNULL));
+    expected.insert(BSON("" << 0 << "" << BSON_ARRAY(1 << 2 << 3)));
+    expected.insert(BSON("" << 1 << "" << BSON("c" << 1)));
+    assertKeysEqual(expected, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, LargeValuesAreReplacedByMinKey) {
+    std::string big(ColumnStoreKeyGenerator::kMaxStoredValueSize, 'x');
+    auto keys = makeKeys(fromjson("{a: 'columnstore'}"), BSON("a" << big));
+
+    BSONObjSet expected = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expected.insert(BSON("" << kRecordColumn << "" << BSONNULL));
+    expected.insert(BSON("" << 0 << "" << MINKEY));
+    assertKeysEqual(expected, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ColumnForReturnsKeyPatternOrdinal) {
+    ColumnStoreKeyGenerator keyGen(fromjson("{a: 'columnstore', b: 'columnstore'}"));
+    ASSERT_EQ(0, keyGen.columnFor("a"));
+    ASSERT_EQ(1, keyGen.columnFor("b"));
+    ASSERT_EQ(-1, keyGen.columnFor("c"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -84,10 +84,9 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
         *seedOut = infoObj["seed"].numberInt();
     }
 
-    // In case we have hashed indexes based on other hash functions in the future, we store
-    // a hashVersion number. If hashVersion changes, "makeSingleHashKey" will need to change
-    // accordingly.  Defaults to 0 if "hashVersion" is not included in the index spec or if
-    // the value of "hashversion" is not a number
+    // Hashed indexes store the version of the hash function they were built with, see
+    // BSONElementHasher. Defaults to 0 (MD5) if "hashVersion" is not included in the index spec
+    // or if the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
 
     // Get the hashfield name
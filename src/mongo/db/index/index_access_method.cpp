@@ -181,33 +181,63 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
                                  const RecordId& loc,
                                  const InsertDeleteOptions& options,
                                  int64_t* numInserted) {
+    return insertRecords(opCtx, {BsonRecord{loc, Timestamp(), &obj}}, options, numInserted);
+}
+
+Status IndexAccessMethod::insertRecords(OperationContext* opCtx,
+                                        const std::vector<BsonRecord>& bsonRecords,
+                                        const InsertDeleteOptions& options,
+                                        int64_t* numInserted) {
     invariant(numInserted);
     *numInserted = 0;
     bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
-    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
-    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
-    MultikeyPaths multikeyPaths;
-    // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+    std::vector<IndexKeyEntry> keysToInsert;
+    std::vector<MultikeyPaths> multikeyPathsToSet;
 
-    // Add all new data keys, and all new multikey metadata keys, into the index. When iterating
-    // over the data keys, each of them should point to the doc's RecordId. When iterating over
-    // the multikey metadata keys, they should point to the reserved 'kMultikeyMetadataKeyId'.
-    for (const auto keySet : {&keys, &multikeyMetadataKeys}) {
-        const auto& recordId = (keySet == &keys ? loc : kMultikeyMetadataKeyId);
-        for (const auto& key : *keySet) {
-            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK())
-                status = _newInterface->insert(opCtx, key, recordId, options.dupsAllowed);
-            if (isFatalError(opCtx, status, key)) {
-                return status;
+    for (const auto& bsonRecord : bsonRecords) {
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        // Delegate to the subclass.
+        getKeys(
+            *bsonRecord.docPtr, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+
+        // Collect all new data keys, and all new multikey metadata keys, for the index. Data keys
+        // point to the doc's RecordId, while multikey metadata keys point to the reserved
+        // 'kMultikeyMetadataKeyId'.
+        for (const auto keySet : {&keys, &multikeyMetadataKeys}) {
+            const auto& recordId = (keySet == &keys ? bsonRecord.id : kMultikeyMetadataKeyId);
+            for (const auto& key : *keySet) {
+                Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
+                if (isFatalError(opCtx, status, key)) {
+                    return status;
+                }
+                if (status.isOK()) {
+                    keysToInsert.emplace_back(key, recordId);
+                }
             }
         }
+
+        *numInserted += keys.size() + multikeyMetadataKeys.size();
+
+        if (shouldMarkIndexAsMultikey(keys, multikeyMetadataKeys, multikeyPaths)) {
+            multikeyPathsToSet.push_back(std::move(multikeyPaths));
+        }
     }
 
-    *numInserted = keys.size() + multikeyMetadataKeys.size();
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(
+            opCtx, IndexBuildInterceptor::Op::kInsert, std::move(keysToInsert));
+    } else {
+        // Hand every key for the batch to the storage engine at once, so that it can sort them
+        // and reuse a single positioned cursor rather than opening one per key.
+        Status status = _newInterface->insertKeys(opCtx, keysToInsert, options.dupsAllowed);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
 
-    if (shouldMarkIndexAsMultikey(keys, multikeyMetadataKeys, multikeyPaths)) {
+    for (const auto& multikeyPaths : multikeyPathsToSet) {
         _btreeState->setMultikey(opCtx, multikeyPaths);
     }
 
@@ -254,12 +284,29 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     getKeys(
         obj, GetKeysMode::kRelaxConstraintsUnfiltered, &keys, multikeyMetadataKeys, multikeyPaths);
 
+    std::vector<IndexKeyEntry> keysToRemove;
+    keysToRemove.reserve(keys.size());
     for (const auto& key : keys) {
-        removeOneKey(opCtx, key, loc, options.dupsAllowed);
+        keysToRemove.emplace_back(key, loc);
     }
 
     *numDeleted = keys.size();
 
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(
+            opCtx, IndexBuildInterceptor::Op::kDelete, std::move(keysToRemove));
+        return Status::OK();
+    }
+
+    try {
+        _newInterface->unindexKeys(opCtx, keysToRemove, options.dupsAllowed);
+    } catch (AssertionException&) {
+        // Retry one key at a time so that the offending key is identified in the log.
+        for (const auto& key : keys) {
+            removeOneKey(opCtx, key, loc, options.dupsAllowed);
+        }
+    }
+
     return Status::OK();
 }
 
@@ -426,11 +473,21 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
-    for (const auto& remKey : ticket.removed) {
-        _newInterface->unindex(opCtx, remKey, ticket.loc, ticket.dupsAllowed);
+    if (_indexBuildInterceptor) {
+        std::vector<IndexKeyEntry> keysToRemove;
+        for (const auto& remKey : ticket.removed) {
+            keysToRemove.emplace_back(remKey, ticket.loc);
+        }
+        _indexBuildInterceptor->sideWrite(
+            opCtx, IndexBuildInterceptor::Op::kDelete, std::move(keysToRemove));
+    } else {
+        for (const auto& remKey : ticket.removed) {
+            _newInterface->unindex(opCtx, remKey, ticket.loc, ticket.dupsAllowed);
+        }
     }
 
     bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    std::vector<IndexKeyEntry> keysToInsert;
 
     // Add all new data keys, and all new multikey metadata keys, into the index. When iterating
     // over the data keys, each of them should point to the doc's RecordId. When iterating over
@@ -440,14 +497,22 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         const auto& recordId = (keySet == &ticket.added ? ticket.loc : kMultikeyMetadataKeyId);
         for (const auto& key : *keySet) {
             Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK())
+            if (status.isOK() && _indexBuildInterceptor) {
+                keysToInsert.emplace_back(key, recordId);
+            } else if (status.isOK()) {
                 status = _newInterface->insert(opCtx, key, recordId, ticket.dupsAllowed);
+            }
             if (isFatalError(opCtx, status, key)) {
                 return status;
             }
         }
     }
 
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(
+            opCtx, IndexBuildInterceptor::Op::kInsert, std::move(keysToInsert));
+    }
+
     if (shouldMarkIndexAsMultikey(
             ticket.newKeys, ticket.newMultikeyMetadataKeys, ticket.newMultikeyPaths)) {
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
@@ -463,19 +528,42 @@ Status IndexAccessMethod::compact(OperationContext* opCtx) {
     return this->_newInterface->compact(opCtx);
 }
 
+bool IndexAccessMethod::requiresFCV42() const {
+    return this->_newInterface->requiresFCV42();
+}
+
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
     size_t maxMemoryUsageBytes) {
     return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
 }
 
+void IndexAccessMethod::setIndexBuildInterceptor(
+    std::unique_ptr<IndexBuildInterceptor> interceptor) {
+    _indexBuildInterceptor = std::move(interceptor);
+}
+
+Status IndexAccessMethod::drainIndexBuildSideWrites(OperationContext* opCtx,
+                                                    const InsertDeleteOptions& options,
+                                                    bool mayInterrupt) {
+    invariant(_indexBuildInterceptor);
+    return _indexBuildInterceptor->drainWritesIntoIndex(
+        opCtx, _newInterface.get(), options.dupsAllowed, mayInterrupt);
+}
+
+namespace {
+SortOptions makeSortOptions(size_t maxMemoryUsageBytes) {
+    return SortOptions()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp")
+        .ExtSortAllowed()
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes);
+}
+}  // namespace
+
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
                                             size_t maxMemoryUsageBytes)
     : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
+          makeSortOptions(maxMemoryUsageBytes),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
       _real(index) {}
 
@@ -510,12 +598,53 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+void IndexAccessMethod::BulkBuilder::absorb(std::unique_ptr<BulkBuilder> other) {
+    invariant(other->_real == _real);
+
+    _absorbedSorters.push_back(std::move(other->_sorter));
+    for (auto& sorter : other->_absorbedSorters) {
+        _absorbedSorters.push_back(std::move(sorter));
+    }
+    _keysInserted += other->_keysInserted;
+
+    if (!other->_indexMultikeyPaths.empty()) {
+        if (_indexMultikeyPaths.empty()) {
+            _indexMultikeyPaths = std::move(other->_indexMultikeyPaths);
+        } else {
+            invariant(_indexMultikeyPaths.size() == other->_indexMultikeyPaths.size());
+            for (size_t i = 0; i < _indexMultikeyPaths.size(); ++i) {
+                _indexMultikeyPaths[i].insert(other->_indexMultikeyPaths[i].begin(),
+                                              other->_indexMultikeyPaths[i].end());
+            }
+        }
+    }
+    _isMultiKey = _isMultiKey || other->_isMultiKey;
+
+    // Metadata keys are deduplicated across builders, since done() adds each exactly once.
+    _multikeyMetadataKeys.insert(other->_multikeyMetadataKeys.begin(),
+                                 other->_multikeyMetadataKeys.end());
+}
+
 IndexAccessMethod::BulkBuilder::Sorter::Iterator* IndexAccessMethod::BulkBuilder::done() {
     for (const auto& key : _multikeyMetadataKeys) {
         _sorter->add(key, kMultikeyMetadataKeyId);
         ++_keysInserted;
     }
-    return _sorter->done();
+
+    if (_absorbedSorters.empty()) {
+        return _sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iterators;
+    iterators.emplace_back(_sorter->done());
+    for (const auto& sorter : _absorbedSorters) {
+        iterators.emplace_back(sorter->done());
+    }
+    const IndexDescriptor* descriptor = _real->_descriptor;
+    return Sorter::Iterator::merge(
+        iterators,
+        makeSortOptions(0),
+        BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()));
 }
 
 Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
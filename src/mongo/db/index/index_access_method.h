@@ -33,6 +33,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -45,6 +46,7 @@ namespace mongo {
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 bool failIndexKeyTooLongParam();
@@ -84,6 +86,17 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Batched form of insert(). Generates the keys for every document in 'bsonRecords' and hands
+     * them to the underlying SortedDataInterface as a single batch. All documents must share the
+     * commit timestamp currently set on the recovery unit; the 'ts' field of each BsonRecord is
+     * ignored. 'numInserted' will be set to the total number of keys added for the batch.
+     */
+    Status insertRecords(OperationContext* opCtx,
+                         const std::vector<BsonRecord>& bsonRecords,
+                         const InsertDeleteOptions& options,
+                         int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -186,6 +199,12 @@ public:
      */
     Status compact(OperationContext* opCtx);
 
+    /**
+     * Returns whether this index must be rebuilt before the featureCompatibilityVersion is
+     * downgraded to 4.0.
+     */
+    bool requiresFCV42() const;
+
     /**
      * Sets this index as multikey with the provided paths.
      */
@@ -215,9 +234,17 @@ public:
             return _isMultiKey;
         }
 
+        /**
+         * Takes over the keys and multikey state accumulated by 'other', a BulkBuilder for the
+         * same index, so that done() returns them merged with this builder's own. This lets
+         * several threads generate and sort keys for one index, each into its own BulkBuilder.
+         */
+        void absorb(std::unique_ptr<BulkBuilder> other);
+
         /**
          * Inserts all multikey metadata keys cached during the BulkBuilder's lifetime into the
-         * underlying Sorter, finalizes it, and returns an iterator over the sorted dataset.
+         * underlying Sorter, finalizes it, and returns an iterator over the sorted dataset. If
+         * other BulkBuilders were absorbed, the iterator merges their sorted runs with this one's.
          */
         Sorter::Iterator* done();
 
@@ -229,6 +256,8 @@ public:
                     size_t maxMemoryUsageBytes);
 
         std::unique_ptr<Sorter> _sorter;
+        // Sorters taken over from absorbed BulkBuilders.
+        std::vector<std::unique_ptr<Sorter>> _absorbedSorters;
         const IndexAccessMethod* _real;
         int64_t _keysInserted = 0;
 
@@ -257,6 +286,25 @@ public:
      */
     std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes);
 
+    /**
+     * Attaches 'interceptor' to this index, so that the key writes of subsequent inserts, removes
+     * and updates are recorded by it rather than applied to the index. Passing nullptr detaches
+     * the current interceptor. Requires that no writes to the collection are in progress.
+     */
+    void setIndexBuildInterceptor(std::unique_ptr<IndexBuildInterceptor> interceptor);
+
+    IndexBuildInterceptor* getIndexBuildInterceptor() const {
+        return _indexBuildInterceptor.get();
+    }
+
+    /**
+     * Applies the side writes recorded by the attached interceptor to the index. See
+     * IndexBuildInterceptor::drainWritesIntoIndex().
+     */
+    Status drainIndexBuildSideWrites(OperationContext* opCtx,
+                                     const InsertDeleteOptions& options,
+                                     bool mayInterrupt);
+
     /**
      * Call this when you are ready to finish your bulk work.
      * Pass in the BulkBuilder returned from initiateBulk.
@@ -377,6 +425,9 @@ private:
                       bool dupsAllowed);
 
     const std::unique_ptr<SortedDataInterface> _newInterface;
+
+    // Set while a hybrid index build is loading this index.
+    std::unique_ptr<IndexBuildInterceptor> _indexBuildInterceptor;
 };
 
 /**
@@ -0,0 +1,217 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_interceptor.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+// Number of side writes applied in each WriteUnitOfWork of a drain.
+const size_t kDrainBatchSize = 1000;
+}  // namespace
+
+void IndexBuildInterceptor::sideWrite(OperationContext* opCtx,
+                                      Op op,
+                                      std::vector<IndexKeyEntry> keys) {
+    if (keys.empty()) {
+        return;
+    }
+
+    invariant(opCtx->lockState()->inAWriteUnitOfWork());
+
+    std::vector<SideWrite> writes;
+    writes.reserve(keys.size());
+    for (auto& entry : keys) {
+        writes.push_back({op, {entry.key.getOwned(), entry.loc}});
+    }
+
+    // Taking the sequence number now, rather than at commit, orders this write after those of
+    // every transaction that committed a write to the same document before this one could.
+    std::uint64_t sequence;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        sequence = _nextSequence++;
+        _uncommitted.insert(sequence);
+    }
+
+    opCtx->recoveryUnit()->onCommit(
+        [this, sequence, writes = std::move(writes)](boost::optional<Timestamp>) mutable {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            for (const auto& write : writes) {
+                _memoryUsageBytes += _memUsage(write);
+            }
+            _numRecorded += writes.size();
+            _sideWrites.emplace(sequence, std::move(writes));
+            _uncommitted.erase(sequence);
+        });
+    opCtx->recoveryUnit()->onRollback([this, sequence] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _uncommitted.erase(sequence);
+    });
+}
+
+Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
+                                                   SortedDataInterface* index,
+                                                   bool dupsAllowed,
+                                                   bool mayInterrupt) {
+    invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+
+    long long applied = 0;
+    while (true) {
+        if (mayInterrupt) {
+            Status status = opCtx->checkForInterruptNoAssert();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
+        // A write that commits later is either still open or has yet to take its sequence number,
+        // so it sorts behind the batch. Only the drain removes writes from the front.
+        std::vector<SideWrite> batch;
+        std::uint64_t lastSequence = 0;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            const auto firstOpen = _uncommitted.empty()
+                ? _sideWrites.end()
+                : _sideWrites.lower_bound(*_uncommitted.begin());
+            for (auto it = _sideWrites.begin(); it != firstOpen && batch.size() < kDrainBatchSize;
+                 ++it) {
+                batch.insert(batch.end(), it->second.begin(), it->second.end());
+                lastSequence = it->first;
+            }
+        }
+        if (batch.empty()) {
+            break;
+        }
+
+        Status status = writeConflictRetry(opCtx, "index build drain", "", [&] {
+            return _applyBatch(opCtx, index, batch, dupsAllowed);
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& write : batch) {
+            _memoryUsageBytes -= _memUsage(write);
+        }
+        _sideWrites.erase(_sideWrites.begin(), _sideWrites.upper_bound(lastSequence));
+        _numApplied += batch.size();
+        applied += batch.size();
+
+        status = _checkMemoryUsage(lk);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    LOG(1) << "index build: drained " << applied << " side writes";
+    return Status::OK();
+}
+
+Status IndexBuildInterceptor::_applyBatch(OperationContext* opCtx,
+                                          SortedDataInterface* index,
+                                          const std::vector<SideWrite>& batch,
+                                          bool dupsAllowed) {
+    WriteUnitOfWork wuow(opCtx);
+
+    // Apply runs of the same operation together, preserving the order between runs.
+    auto runBegin = batch.begin();
+    while (runBegin != batch.end()) {
+        const Op op = runBegin->op;
+        auto runEnd = std::find_if(
+            runBegin, batch.end(), [op](const SideWrite& write) { return write.op != op; });
+
+        std::vector<IndexKeyEntry> keys;
+        keys.reserve(runEnd - runBegin);
+        std::transform(runBegin, runEnd, std::back_inserter(keys), [](const SideWrite& write) {
+            return write.entry;
+        });
+
+        if (op == Op::kInsert) {
+            Status status = index->insertKeys(opCtx, keys, dupsAllowed);
+            if (!status.isOK()) {
+                return status;
+            }
+        } else {
+            index->unindexKeys(opCtx, keys, true /* dupsAllowed */);
+        }
+        runBegin = runEnd;
+    }
+
+    wuow.commit();
+    return Status::OK();
+}
+
+bool IndexBuildInterceptor::areAllWritesApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sideWrites.empty();
+}
+
+Status IndexBuildInterceptor::checkMemoryUsage() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _checkMemoryUsage(lk);
+}
+
+Status IndexBuildInterceptor::_checkMemoryUsage(WithLock) const {
+    if (_memoryUsageBytes <= _maxMemoryUsageBytes) {
+        return Status::OK();
+    }
+    return {ErrorCodes::ExceededMemoryLimit,
+            str::stream() << "Concurrent writes recorded during the index build use "
+                          << _memoryUsageBytes
+                          << " bytes, more than the limit of "
+                          << _maxMemoryUsageBytes
+                          << " bytes"};
+}
+
+long long IndexBuildInterceptor::getNumRecorded() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numRecorded;
+}
+
+long long IndexBuildInterceptor::getNumApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numApplied;
+}
+
+}  // namespace mongo
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class OperationContext;
+class SortedDataInterface;
+
+/**
+ * Holds the index key writes that concurrent operations make to an index while a hybrid index
+ * build scans the collection and bulk loads the index.
+ *
+ * While an IndexAccessMethod has an interceptor attached, its inserts, removes and updates are
+ * recorded here instead of being applied to the index. Once the bulk load is done,
+ * drainWritesIntoIndex() replays them against the index. Writes recorded after the build's scan
+ * has already seen the document are replayed harmlessly: inserting a key that is already present
+ * for the same RecordId, or removing one that is absent, changes nothing.
+ *
+ * Each recorded write takes a sequence number inside the writer's transaction, and the drain
+ * replays writes in that order. A transaction that writes a document can only do so after every
+ * earlier transaction writing that document has committed, so it takes a higher number even if
+ * its commit handlers happen to run first. The drain never passes a number whose transaction is
+ * still open, since that transaction may yet commit.
+ *
+ * The side writes are kept in memory, so the interceptor is given a bound on the bytes they may
+ * occupy. Once concurrent writers push past it, checkMemoryUsage() fails, and the index build is
+ * expected to abort rather than let the buffer keep growing.
+ *
+ * The keys applied by the drain are not timestamped, like those of the bulk load before them. The
+ * index only becomes visible to reads at timestamps after the write that marks it ready, so no
+ * reader can observe the keys at an earlier point in time.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    enum class Op { kInsert, kDelete };
+
+    /**
+     * 'maxMemoryUsageBytes' bounds the memory taken by side writes that are recorded but not yet
+     * applied.
+     */
+    explicit IndexBuildInterceptor(size_t maxMemoryUsageBytes)
+        : _maxMemoryUsageBytes(maxMemoryUsageBytes) {}
+
+    /**
+     * Records 'op' for each of 'keys' under the next sequence number. The writes become visible
+     * to drainWritesIntoIndex() when the caller's WriteUnitOfWork commits, and are discarded if it
+     * rolls back. Must be called inside of a WriteUnitOfWork.
+     */
+    void sideWrite(OperationContext* opCtx, Op op, std::vector<IndexKeyEntry> keys);
+
+    /**
+     * Applies the committed side writes, in sequence order, to 'index' in batches that each commit
+     * in their own WriteUnitOfWork, stopping at the first write whose transaction is still open.
+     * Keys are inserted with 'dupsAllowed' and removed matching on RecordId, since the index is not
+     * yet ready.
+     *
+     * Writes that commit while the drain is running are applied too, so callers that need all
+     * writes applied must block writers, e.g. by holding an exclusive collection lock. Fails with
+     * ExceededMemoryLimit if those writes outpace the drain past the memory bound.
+     *
+     * Must not be called inside of a WriteUnitOfWork.
+     */
+    Status drainWritesIntoIndex(OperationContext* opCtx,
+                                SortedDataInterface* index,
+                                bool dupsAllowed,
+                                bool mayInterrupt);
+
+    /**
+     * Returns true if every side write committed so far has been applied to the index.
+     */
+    bool areAllWritesApplied() const;
+
+    /**
+     * Returns ExceededMemoryLimit if the side writes waiting to be applied occupy more memory than
+     * this interceptor was allowed.
+     */
+    Status checkMemoryUsage() const;
+
+    long long getNumRecorded() const;
+    long long getNumApplied() const;
+
+private:
+    struct SideWrite {
+        Op op;
+        IndexKeyEntry entry;
+    };
+
+    static size_t _memUsage(const SideWrite& write) {
+        return sizeof(SideWrite) + write.entry.key.objsize();
+    }
+
+    Status _checkMemoryUsage(WithLock) const;
+
+    Status _applyBatch(OperationContext* opCtx,
+                       SortedDataInterface* index,
+                       const std::vector<SideWrite>& batch,
+                       bool dupsAllowed);
+
+    mutable stdx::mutex _mutex;
+
+    // Committed side writes that have not been applied yet, keyed by sequence number.
+    std::map<std::uint64_t, std::vector<SideWrite>> _sideWrites;
+
+    // Sequence numbers taken by transactions that have neither committed nor rolled back.
+    std::set<std::uint64_t> _uncommitted;
+    std::uint64_t _nextSequence = 0;
+
+    size_t _memoryUsageBytes = 0;
+    const size_t _maxMemoryUsageBytes;
+    long long _numRecorded = 0;
+    long long _numApplied = 0;
+};
+
+}  // namespace mongo
@@ -42,6 +42,7 @@ const string IndexNames::TEXT = "text";
 const string IndexNames::HASHED = "hashed";
 const string IndexNames::BTREE = "";
 const string IndexNames::ALLPATHS = "allPaths";
+const string IndexNames::COLUMNSTORE = "columnstore";
 
 const StringMap<IndexType> kIndexNameToType = {
     {IndexNames::GEO_2D, INDEX_2D},
@@ -50,6 +51,7 @@ const StringMap<IndexType> kIndexNameToType = {
     {IndexNames::TEXT, INDEX_TEXT},
     {IndexNames::HASHED, INDEX_HASHED},
     {IndexNames::ALLPATHS, INDEX_ALLPATHS},
+    {IndexNames::COLUMNSTORE, INDEX_COLUMNSTORE},
 };
 
 // static
@@ -74,6 +76,7 @@ bool IndexNames::isKnownName(const string& name) {
     return name == IndexNames::GEO_2D || name == IndexNames::GEO_2DSPHERE ||
         name == IndexNames::GEO_HAYSTACK || name == IndexNames::TEXT ||
         name == IndexNames::HASHED || name == IndexNames::BTREE ||
+        name == IndexNames::COLUMNSTORE ||
         (getTestCommandsEnabled() && name == IndexNames::ALLPATHS);
 }
 
@@ -47,6 +47,7 @@ enum IndexType {
     INDEX_2DSPHERE,
     INDEX_TEXT,
     INDEX_HASHED,
+    INDEX_COLUMNSTORE,
 };
 
 /**
@@ -57,6 +58,7 @@ class IndexNames {
 public:
     static const std::string ALLPATHS;
     static const std::string BTREE;
+    static const std::string COLUMNSTORE;
     static const std::string GEO_2D;
     static const std::string GEO_2DSPHERE;
     static const std::string GEO_HAYSTACK;
@@ -49,6 +49,7 @@ constexpr StringData NamespaceString::kAdminDb;
 constexpr StringData NamespaceString::kLocalDb;
 constexpr StringData NamespaceString::kConfigDb;
 constexpr StringData NamespaceString::kSystemDotViewsCollectionName;
+constexpr StringData NamespaceString::kTimeseriesBucketsCollectionPrefix;
 constexpr StringData NamespaceString::kOrphanCollectionPrefix;
 constexpr StringData NamespaceString::kOrphanCollectionDb;
 
@@ -106,6 +107,8 @@ bool NamespaceString::isLegalClientSystemNS() const {
 
     if (coll() == kSystemDotViewsCollectionName)
         return true;
+    if (isTimeseriesBucketsCollection())
+        return true;
 
     return false;
 }
@@ -152,6 +155,15 @@ boost::optional<NamespaceString> NamespaceString::getTargetNSForGloballyManagedN
     return NamespaceString{db(), coll().substr(indexOfNextDot + 1)};
 }
 
+NamespaceString NamespaceString::makeTimeseriesBucketsNamespace() const {
+    return NamespaceString(db(), kTimeseriesBucketsCollectionPrefix.toString() + coll());
+}
+
+NamespaceString NamespaceString::getTimeseriesViewNamespace() const {
+    dassert(isTimeseriesBucketsCollection());
+    return NamespaceString(db(), coll().substr(kTimeseriesBucketsCollectionPrefix.size()));
+}
+
 bool NamespaceString::isDropPendingNamespace() const {
     return coll().startsWith(dropPendingNSPrefix);
 }
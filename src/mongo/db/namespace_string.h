@@ -60,6 +60,9 @@ public:
     // Name for the system views collection
     static constexpr StringData kSystemDotViewsCollectionName = "system.views"_sd;
 
+    // Prefix for the collections holding the buckets of a time-series collection
+    static constexpr StringData kTimeseriesBucketsCollectionPrefix = "system.buckets."_sd;
+
     // Prefix for orphan collections
     static constexpr StringData kOrphanCollectionPrefix = "orphan."_sd;
     static constexpr StringData kOrphanCollectionDb = "local"_sd;
@@ -237,6 +240,9 @@ public:
     bool isSystemDotViews() const {
         return coll() == kSystemDotViewsCollectionName;
     }
+    bool isTimeseriesBucketsCollection() const {
+        return coll().startsWith(kTimeseriesBucketsCollectionPrefix);
+    }
     bool isServerConfigurationCollection() const {
         return (db() == kAdminDb) && (coll() == "system.version");
     }
@@ -307,6 +313,21 @@ public:
      */
     boost::optional<NamespaceString> getTargetNSForGloballyManagedNamespace() const;
 
+    /**
+     * Returns the namespace of the collection that stores the buckets of the time-series
+     * collection with this name.
+     *
+     * Example:
+     *     test.weather -> test.system.buckets.weather
+     */
+    NamespaceString makeTimeseriesBucketsNamespace() const;
+
+    /**
+     * Given a NamespaceString for which isTimeseriesBucketsCollection() returns true, returns the
+     * namespace of the time-series view defined on it.
+     */
+    NamespaceString getTimeseriesViewNamespace() const;
+
     /**
      * Returns true if this namespace refers to a drop-pending collection.
      */
@@ -362,6 +362,18 @@ TEST(NamespaceStringTest, makeListIndexesNSIsCorrect) {
     ASSERT_EQUALS(NamespaceString("DB.COLL"), ns.getTargetNSForListIndexes());
 }
 
+TEST(NamespaceStringTest, makeTimeseriesBucketsNamespaceIsCorrect) {
+    NamespaceString ns = NamespaceString("DB.COLL").makeTimeseriesBucketsNamespace();
+    ASSERT_EQUALS("DB", ns.db());
+    ASSERT_EQUALS("system.buckets.COLL", ns.coll());
+    ASSERT(ns.isValid());
+    ASSERT(ns.isSystem());
+    ASSERT(ns.isTimeseriesBucketsCollection());
+    ASSERT(ns.isLegalClientSystemNS());
+    ASSERT_EQUALS(NamespaceString("DB.COLL"), ns.getTimeseriesViewNamespace());
+    ASSERT_FALSE(NamespaceString("DB.COLL").isTimeseriesBucketsCollection());
+}
+
 TEST(NamespaceStringTest, EmptyNSStringReturnsEmptyColl) {
     NamespaceString nss{};
     ASSERT_TRUE(nss.isEmpty());
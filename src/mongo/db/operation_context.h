@@ -43,6 +43,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
@@ -332,6 +333,17 @@ public:
         return _writesAreReplicated;
     }
 
+    /**
+     * Returns the priority with which this operation queues for storage engine tickets.
+     */
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+
     /**
      * Marks this operation as killed so that subsequent calls to checkForInterrupt and
      * checkForInterruptNoAssert by the thread executing the operation will start returning the
@@ -514,6 +526,8 @@ private:
     Timer _elapsedTime;
 
     bool _writesAreReplicated = true;
+
+    AdmissionPriority _admissionPriority = AdmissionPriority::kNormal;
 };
 
 namespace repl {
@@ -36,6 +36,7 @@
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -69,7 +70,10 @@
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/db/views/view.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/cannot_implicitly_create_collection_info.h"
@@ -475,8 +479,41 @@ SingleWriteResult makeWriteResultForInsertOrDeleteRetry() {
     return res;
 }
 
+/**
+ * Returns the options of the time-series collection 'ns', or boost::none if 'ns' is not the view
+ * of a time-series collection.
+ */
+boost::optional<TimeseriesOptions> getTimeseriesOptions(OperationContext* opCtx,
+                                                        const NamespaceString& ns) {
+    if (ns.isSystem()) {
+        return boost::none;
+    }
+
+    AutoGetCollection collection(opCtx, ns, MODE_IS, AutoGetCollection::kViewsPermitted);
+    auto view = collection.getView();
+    if (!view || view->viewOn() != ns.makeTimeseriesBucketsNamespace()) {
+        return boost::none;
+    }
+
+    Lock::CollectionLock bucketsLock(opCtx->lockState(), view->viewOn().ns(), MODE_IS);
+    auto buckets = collection.getDb()->getCollection(opCtx, view->viewOn());
+    if (!buckets) {
+        return boost::none;
+    }
+
+    auto options = buckets->getCatalogEntry()->getCollectionOptions(opCtx);
+    if (options.timeseries.isEmpty()) {
+        return boost::none;
+    }
+    return uassertStatusOK(TimeseriesOptions::parse(options.timeseries));
+}
+
 }  // namespace
 
+static WriteResult performTimeseriesInserts(OperationContext* opCtx,
+                                            const write_ops::Insert& wholeOp,
+                                            const TimeseriesOptions& options);
+
 WriteResult performInserts(OperationContext* opCtx,
                            const write_ops::Insert& wholeOp,
                            bool fromMigrate) {
@@ -515,6 +552,12 @@ WriteResult performInserts(OperationContext* opCtx,
         return performCreateIndexes(opCtx, wholeOp);
     }
 
+    if (!fromMigrate) {
+        if (auto timeseriesOptions = getTimeseriesOptions(opCtx, wholeOp.getNamespace())) {
+            return performTimeseriesInserts(opCtx, wholeOp, *timeseriesOptions);
+        }
+    }
+
     DisableDocumentValidationIfTrue docValidationDisabler(
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
@@ -686,6 +729,331 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
     return result;
 }
 
+namespace {
+
+/**
+ * A measurement inserted into a time-series collection.
+ */
+struct TimeseriesMeasurement {
+    // Position of the measurement in the insert command.
+    size_t opIndex;
+    BSONObj doc;
+    Date_t time;
+
+    // The meta value of the measurement, as an object holding a single "meta" element, or empty.
+    BSONObj meta;
+};
+
+/**
+ * The measurements that are appended to a bucket by one write.
+ */
+struct BucketWrite {
+    OID bucketId;
+    bool isNew;
+    long long windowStart;
+    BSONObj meta;
+
+    // Pairs of the position of a measurement within the bucket and the measurement.
+    std::vector<std::pair<int, const TimeseriesMeasurement*>> measurements;
+};
+
+StatusWith<TimeseriesMeasurement> parseMeasurement(const TimeseriesOptions& options,
+                                                   size_t opIndex,
+                                                   const BSONObj& doc) {
+    TimeseriesMeasurement measurement{opIndex, doc, Date_t(), BSONObj()};
+    bool hasTime = false;
+    for (auto&& elem : doc) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName.empty() || fieldName[0] == '$' ||
+            fieldName.find('.') != std::string::npos) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Invalid field name in time-series measurement: "
+                                  << fieldName};
+        }
+        if (fieldName == options.timeField) {
+            if (elem.type() != Date) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'" << options.timeField
+                                      << "' must be a date in time-series measurements"};
+            }
+            measurement.time = elem.date();
+            hasTime = true;
+        } else if (options.metaField && fieldName == *options.metaField) {
+            measurement.meta = elem.wrap(TimeseriesOptions::kBucketMetaFieldName);
+        }
+    }
+    if (!hasTime) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Time-series measurements must have a '" << options.timeField
+                              << "' field"};
+    }
+    return measurement;
+}
+
+/**
+ * Returns the update that writes 'write' into its bucket. A new bucket is upserted whole, while
+ * an existing one only gets the new entries of its columns and its control fields bumped.
+ */
+write_ops::UpdateOpEntry makeBucketUpdate(const TimeseriesOptions& options,
+                                          const BucketWrite& write) {
+    Date_t maxTime = Date_t::min();
+    std::map<std::string, std::vector<std::pair<int, BSONElement>>> columns;
+    for (auto&& entry : write.measurements) {
+        maxTime = std::max(maxTime, entry.second->time);
+        for (auto&& elem : entry.second->doc) {
+            auto fieldName = elem.fieldNameStringData();
+            if (fieldName == options.timeField ||
+                (options.metaField && fieldName == *options.metaField)) {
+                continue;
+            }
+            columns[fieldName.toString()].emplace_back(entry.first, elem);
+        }
+    }
+
+    // Times are stored as deltas from the start of the window, which is the minimum time of
+    // the bucket, so that they pack into small integers rather than full dates.
+    auto timeDelta = [&](const TimeseriesMeasurement& measurement) {
+        return measurement.time.toMillisSinceEpoch() - write.windowStart;
+    };
+
+    const std::string controlMaxTime = str::stream()
+        << TimeseriesOptions::kBucketControlFieldName << "."
+        << TimeseriesOptions::kBucketControlMaxFieldName << "." << options.timeField;
+
+    BSONObjBuilder update;
+    if (write.isNew) {
+        update.append("_id", write.bucketId);
+        {
+            BSONObjBuilder control(update.subobjStart(TimeseriesOptions::kBucketControlFieldName));
+            control.append(TimeseriesOptions::kBucketControlVersionFieldName,
+                           TimeseriesOptions::kBucketVersion);
+            control.append(
+                TimeseriesOptions::kBucketControlMinFieldName,
+                BSON(options.timeField << Date_t::fromMillisSinceEpoch(write.windowStart)));
+            control.append(TimeseriesOptions::kBucketControlMaxFieldName,
+                           BSON(options.timeField << maxTime));
+        }
+        if (!write.meta.isEmpty()) {
+            update.append(write.meta.firstElement());
+        }
+
+        BSONObjBuilder data(update.subobjStart(TimeseriesOptions::kBucketDataFieldName));
+        {
+            BSONObjBuilder column(data.subobjStart(options.timeField));
+            for (auto&& entry : write.measurements) {
+                column.append(std::to_string(entry.first), timeDelta(*entry.second));
+            }
+        }
+        for (auto&& column : columns) {
+            BSONObjBuilder columnBuilder(data.subobjStart(column.first));
+            for (auto&& value : column.second) {
+                columnBuilder.appendAs(value.second, std::to_string(value.first));
+            }
+        }
+    } else {
+        {
+            BSONObjBuilder set(update.subobjStart("$set"));
+            const std::string dataPrefix = TimeseriesOptions::kBucketDataFieldName.toString() + ".";
+            for (auto&& entry : write.measurements) {
+                set.append(dataPrefix + options.timeField + "." + std::to_string(entry.first),
+                           timeDelta(*entry.second));
+            }
+            for (auto&& column : columns) {
+                for (auto&& value : column.second) {
+                    set.appendAs(value.second,
+                                 dataPrefix + column.first + "." + std::to_string(value.first));
+                }
+            }
+        }
+        update.append("$max", BSON(controlMaxTime << maxTime));
+    }
+
+    write_ops::UpdateOpEntry op;
+    op.setQ(BSON("_id" << write.bucketId));
+    op.setU(update.obj());
+    op.setUpsert(write.isNew);
+    return op;
+}
+
+/**
+ * Appends 'measurements' to the open buckets of their series and records the outcome of each in
+ * 'errors', indexed by the position of the measurement in the insert command.
+ *
+ * If 'ordered', only consecutive measurements for the same bucket are written together, the writes
+ * happen in the order of 'measurements', and they stop at the first failure. The measurements
+ * after it are left without an entry in 'errors'. Returns false if the writes stopped early.
+ */
+bool writeMeasurements(OperationContext* opCtx,
+                       const NamespaceString& bucketsNs,
+                       const TimeseriesOptions& options,
+                       const std::vector<const TimeseriesMeasurement*>& measurements,
+                       std::vector<boost::optional<Status>>* errors,
+                       LastOpFixer* lastOpFixer,
+                       bool ordered,
+                       bool retryStaleBuckets) {
+    auto& catalog = BucketCatalog::get(opCtx);
+
+    std::vector<BucketWrite> writes;
+    std::map<OID, size_t> writeForBucket;
+    for (auto measurement : measurements) {
+        const auto windowStart = options.windowStart(measurement->time);
+        auto result = catalog.insert(bucketsNs, measurement->meta, windowStart);
+        auto it = writeForBucket.find(result.bucketId);
+        if (it == writeForBucket.end() || (ordered && it->second != writes.size() - 1)) {
+            writeForBucket[result.bucketId] = writes.size();
+            writes.push_back({result.bucketId, result.isNew, windowStart, measurement->meta, {}});
+            it = writeForBucket.find(result.bucketId);
+        }
+        writes[it->second].measurements.emplace_back(result.index, measurement);
+    }
+
+    // The measurements reserved in the catalog for writes that will not happen would leave gaps in
+    // their buckets, so those buckets are closed.
+    auto abandonWritesFrom = [&](size_t first) {
+        for (size_t i = first; i < writes.size(); ++i) {
+            catalog.abandon(bucketsNs, writes[i].meta, writes[i].bucketId);
+        }
+    };
+
+    std::vector<const TimeseriesMeasurement*> stale;
+    for (size_t i = 0; i < writes.size(); ++i) {
+        auto&& write = writes[i];
+        auto& parentCurOp = *CurOp::get(opCtx);
+        const Command* cmd = parentCurOp.getCommand();
+        CurOp curOp(opCtx);
+        {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            curOp.setCommand_inlock(cmd);
+        }
+        ON_BLOCK_EXIT([&] { finishCurOp(opCtx, &curOp); });
+
+        boost::optional<Status> status;
+        try {
+            lastOpFixer->startingOp();
+            auto result = performSingleUpdateOp(
+                opCtx, bucketsNs, kUninitializedStmtId, makeBucketUpdate(options, write));
+            lastOpFixer->finishedOpSuccessfully();
+
+            if (result.getN() == 0) {
+                // The bucket document is gone or was never written, so the catalog is stale.
+                catalog.abandon(bucketsNs, write.meta, write.bucketId);
+                if (retryStaleBuckets) {
+                    std::vector<const TimeseriesMeasurement*> retry;
+                    for (auto&& entry : write.measurements) {
+                        retry.push_back(entry.second);
+                    }
+                    if (!ordered) {
+                        stale.insert(stale.end(), retry.begin(), retry.end());
+                        continue;
+                    }
+                    // Retry in place, so that the writes stay in order.
+                    if (!writeMeasurements(
+                            opCtx, bucketsNs, options, retry, errors, lastOpFixer, true, false)) {
+                        abandonWritesFrom(i + 1);
+                        return false;
+                    }
+                    continue;
+                }
+                status = Status(ErrorCodes::NoMatchingDocument,
+                                str::stream() << "Bucket " << write.bucketId << " of "
+                                              << bucketsNs.ns() << " no longer exists");
+            }
+        } catch (const DBException& ex) {
+            if (ErrorCodes::isInterruption(ex.code())) {
+                throw;
+            }
+            catalog.abandon(bucketsNs, write.meta, write.bucketId);
+            LastError::get(opCtx->getClient()).setLastError(ex.code(), ex.reason());
+            curOp.debug().errInfo = ex.toStatus();
+            status = ex.toStatus();
+        }
+
+        for (auto&& entry : write.measurements) {
+            (*errors)[entry.second->opIndex] = status;
+        }
+
+        if (ordered && status && !status->isOK()) {
+            abandonWritesFrom(i + 1);
+            return false;
+        }
+    }
+
+    if (!stale.empty()) {
+        writeMeasurements(opCtx, bucketsNs, options, stale, errors, lastOpFixer, false, false);
+    }
+    return true;
+}
+
+}  // namespace
+
+/**
+ * Inserts the measurements of 'wholeOp' into the buckets collection of a time-series collection.
+ *
+ * An unordered insert groups the measurements by the bucket they go to and writes each bucket
+ * once. An ordered insert only groups consecutive measurements for the same bucket, and stops at
+ * the first invalid measurement or failed bucket write, so that every measurement it reports as
+ * not inserted was not.
+ */
+static WriteResult performTimeseriesInserts(OperationContext* opCtx,
+                                            const write_ops::Insert& wholeOp,
+                                            const TimeseriesOptions& options) {
+    uassert(ErrorCodes::OperationNotSupportedInTransaction,
+            "Inserts into a time-series collection cannot be retryable or in a transaction",
+            !opCtx->getTxnNumber());
+
+    const auto bucketsNs = wholeOp.getNamespace().makeTimeseriesBucketsNamespace();
+    const auto& docs = wholeOp.getDocuments();
+    const bool ordered = wholeOp.getWriteCommandBase().getOrdered();
+
+    DisableDocumentValidationIfTrue docValidationDisabler(
+        opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
+    LastOpFixer lastOpFixer(opCtx, bucketsNs);
+
+    std::vector<boost::optional<Status>> errors(docs.size());
+    std::vector<TimeseriesMeasurement> measurements;
+    measurements.reserve(docs.size());
+    size_t numOps = docs.size();
+    for (size_t i = 0; i < docs.size(); ++i) {
+        auto measurement = parseMeasurement(options, i, docs[i]);
+        if (!measurement.isOK()) {
+            errors[i] = measurement.getStatus();
+            if (ordered) {
+                numOps = i + 1;
+                break;
+            }
+            continue;
+        }
+        measurements.push_back(std::move(measurement.getValue()));
+    }
+
+    std::vector<const TimeseriesMeasurement*> toWrite;
+    toWrite.reserve(measurements.size());
+    for (auto&& measurement : measurements) {
+        toWrite.push_back(&measurement);
+    }
+    writeMeasurements(opCtx, bucketsNs, options, toWrite, &errors, &lastOpFixer, ordered, true);
+
+    WriteResult out;
+    out.results.reserve(numOps);
+    size_t numInserted = 0;
+    for (size_t i = 0; i < numOps; ++i) {
+        globalOpCounters.gotInsert();
+        if (errors[i]) {
+            out.results.emplace_back(*errors[i]);
+            if (ordered) {
+                break;
+            }
+            continue;
+        }
+        SingleWriteResult result;
+        result.setN(1);
+        out.results.emplace_back(std::move(result));
+        ++numInserted;
+    }
+    CurOp::get(opCtx)->debug().additiveMetrics.incrementNinserted(numInserted);
+    return out;
+}
+
 WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& wholeOp) {
     // Update performs its own retries, so we should not be in a WriteUnitOfWork unless run in a
     // transaction.
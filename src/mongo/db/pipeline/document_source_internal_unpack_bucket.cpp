@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/base/parse_number.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+
+namespace {
+
+/**
+ * Places the elements of the column 'column' at the positions given by their field names.
+ */
+std::vector<BSONElement> loadColumn(const BSONObj& column) {
+    std::vector<BSONElement> values;
+    for (auto&& elem : column) {
+        int index;
+        if (!parseNumberFromStringWithBase(elem.fieldNameStringData(), 10, &index).isOK() ||
+            index < 0) {
+            continue;
+        }
+        if (static_cast<size_t>(index) >= values.size()) {
+            values.resize(index + 1);
+        }
+        values[index] = elem;
+    }
+    return values;
+}
+
+std::string controlPath(StringData bound, StringData timeField) {
+    return str::stream() << TimeseriesOptions::kBucketControlFieldName << "." << bound << "."
+                         << timeField;
+}
+
+}  // namespace
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << kStageName << " must take a nested object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    auto options = uassertStatusOK(TimeseriesOptions::parse(elem.embeddedObject()));
+    return new DocumentSourceInternalUnpackBucket(expCtx, std::move(options));
+}
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, TimeseriesOptions options)
+    : DocumentSource(expCtx), _options(std::move(options)) {}
+
+void DocumentSourceInternalUnpackBucket::_loadBucket() {
+    _index = 0;
+    _timeColumn.clear();
+    _columns.clear();
+
+    auto control = _bucket[TimeseriesOptions::kBucketControlFieldName];
+    auto minTime = control.isABSONObj()
+        ? control.Obj()[TimeseriesOptions::kBucketControlMinFieldName]
+        : BSONElement();
+    uassert(50939,
+            str::stream() << "Time-series bucket has no minimum time: " << _bucket["_id"],
+            minTime.isABSONObj() && minTime.Obj()[_options.timeField].type() == Date);
+    _minTime = minTime.Obj()[_options.timeField].date().toMillisSinceEpoch();
+
+    _meta = _options.metaField ? _bucket[TimeseriesOptions::kBucketMetaFieldName] : BSONElement();
+
+    auto data = _bucket[TimeseriesOptions::kBucketDataFieldName];
+    if (!data.isABSONObj()) {
+        return;
+    }
+    for (auto&& column : data.Obj()) {
+        if (!column.isABSONObj()) {
+            continue;
+        }
+        if (column.fieldNameStringData() == _options.timeField) {
+            _timeColumn = loadColumn(column.Obj());
+        } else {
+            _columns.emplace_back(column.fieldName(), loadColumn(column.Obj()));
+        }
+    }
+}
+
+Document DocumentSourceInternalUnpackBucket::_nextMeasurement() {
+    MutableDocument measurement(_columns.size() + 2);
+    measurement.addField(_options.timeField,
+                         Value(Date_t::fromMillisSinceEpoch(
+                             _minTime + _timeColumn[_index].safeNumberLong())));
+    if (!_meta.eoo()) {
+        measurement.addField(*_options.metaField, Value(_meta));
+    }
+    for (auto&& column : _columns) {
+        if (_index < column.second.size() && !column.second[_index].eoo()) {
+            measurement.addField(column.first, Value(column.second[_index]));
+        }
+    }
+    ++_index;
+    return measurement.freeze();
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (true) {
+        // Positions that were handed out but never written leave holes in the columns.
+        while (_index < _timeColumn.size() && _timeColumn[_index].eoo()) {
+            ++_index;
+        }
+        if (_index < _timeColumn.size()) {
+            return _nextMeasurement();
+        }
+
+        auto next = pSource->getNext();
+        if (!next.isAdvanced()) {
+            return next;
+        }
+        _bucket = next.releaseDocument().toBson();
+        _loadBucket();
+    }
+}
+
+void DocumentSourceInternalUnpackBucket::_translatePredicate(const BSONObj& query,
+                                                             BSONArrayBuilder* predicates) const {
+    for (auto&& elem : query) {
+        auto fieldName = elem.fieldNameStringData();
+
+        if (fieldName == "$and" && elem.type() == Array) {
+            for (auto&& clause : elem.Obj()) {
+                if (clause.type() == Object) {
+                    _translatePredicate(clause.Obj(), predicates);
+                }
+            }
+        } else if (fieldName == _options.timeField) {
+            // A measurement lies between the start of the window of its bucket and the maximum
+            // time of the bucket, so bounds on its time are bounds on those.
+            const auto minPath = controlPath(TimeseriesOptions::kBucketControlMinFieldName,
+                                             _options.timeField);
+            const auto maxPath = controlPath(TimeseriesOptions::kBucketControlMaxFieldName,
+                                             _options.timeField);
+            auto translateComparison = [&](StringData op, const BSONElement& operand) {
+                if (operand.type() != Date) {
+                    return;
+                }
+                if (op == "$eq" || op == "$gt" || op == "$gte") {
+                    predicates->append(BSON(maxPath << BSON("$gte" << operand.date())));
+                }
+                if (op == "$eq" || op == "$lt" || op == "$lte") {
+                    predicates->append(BSON(minPath << BSON("$lte" << operand.date())));
+                }
+            };
+
+            if (elem.type() != Object) {
+                translateComparison("$eq"_sd, elem);
+            } else if (StringData(elem.Obj().firstElementFieldName()).startsWith("$")) {
+                for (auto&& comparison : elem.Obj()) {
+                    translateComparison(comparison.fieldNameStringData(), comparison);
+                }
+            }
+        } else if (_options.metaField &&
+                   (fieldName == *_options.metaField ||
+                    fieldName.startsWith(*_options.metaField + "."))) {
+            // All the measurements of a bucket share its meta value.
+            BSONObjBuilder predicate;
+            predicate.appendAs(elem,
+                               TimeseriesOptions::kBucketMetaFieldName.toString() +
+                                   fieldName.substr(_options.metaField->size()).toString());
+            predicates->append(predicate.obj());
+        }
+    }
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::createBucketPredicate(const BSONObj& query) const {
+    BSONArrayBuilder predicates;
+    _translatePredicate(query, &predicates);
+    auto arr = predicates.arr();
+    if (arr.isEmpty()) {
+        return BSONObj();
+    }
+    return BSON("$and" << arr);
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get());
+    if (!nextMatch || _triedBucketLevelPushdown) {
+        return std::next(itr);
+    }
+    _triedBucketLevelPushdown = true;
+
+    auto bucketPredicate = createBucketPredicate(nextMatch->getQuery());
+    if (bucketPredicate.isEmpty()) {
+        return std::next(itr);
+    }
+
+    // Give the new $match a chance to be optimized with the stages before it.
+    auto bucketMatch =
+        container->insert(itr, DocumentSourceMatch::create(bucketPredicate, pExpCtx));
+    return bucketMatch == container->begin() ? bucketMatch : std::prev(bucketMatch);
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{{getSourceName(), Value(_options.toBSON())}});
+}
+
+}  // namespace mongo
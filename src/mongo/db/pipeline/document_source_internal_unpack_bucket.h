@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+
+namespace mongo {
+
+/**
+ * Turns the bucket documents of a time-series collection back into the measurements they hold. The
+ * views of time-series collections consist of this stage alone.
+ *
+ * When a $match follows, the parts of its predicate on the time and meta fields are translated
+ * into a predicate on the bucket documents and placed in front of this stage, so that buckets
+ * which cannot hold a matching measurement are never unpacked and the predicate can use indexes
+ * of the buckets collection. The original $match stays after this stage to filter measurements.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = TimeseriesOptions::kUnpackBucketStageName;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       TimeseriesOptions options);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kNotAllowed,
+                TransactionRequirement::kAllowed};
+    }
+
+    GetNextResult getNext() final;
+
+    /**
+     * Returns a predicate on bucket documents that accepts every bucket holding a measurement
+     * that matches 'query', or an empty object if no part of 'query' can be translated.
+     */
+    BSONObj createBucketPredicate(const BSONObj& query) const;
+
+protected:
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+private:
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Loads the columns of '_bucket' so that its measurements can be read by position.
+     */
+    void _loadBucket();
+
+    Document _nextMeasurement();
+
+    void _translatePredicate(const BSONObj& query, BSONArrayBuilder* predicates) const;
+
+    const TimeseriesOptions _options;
+
+    // The bucket being unpacked and its columns, indexed by the position of the measurements.
+    BSONObj _bucket;
+    long long _minTime = 0;
+    BSONElement _meta;
+    std::vector<BSONElement> _timeColumn;
+    std::vector<std::pair<std::string, std::vector<BSONElement>>> _columns;
+    size_t _index = 0;
+
+    // The bucket-level $match is only generated for the first $match that follows this stage.
+    bool _triedBucketLevelPushdown = false;
+};
+
+}  // namespace mongo
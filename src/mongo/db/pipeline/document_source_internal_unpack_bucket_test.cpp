@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceInternalUnpackBucketTest = AggregationContextFixture;
+
+const Date_t kWindowStart = Date_t::fromMillisSinceEpoch(3600 * 1000);
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> makeUnpack(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto spec = BSON("$_internalUnpackBucket" << BSON("timeField"
+                                                      << "t"
+                                                      << "metaField"
+                                                      << "m"));
+    return static_cast<DocumentSourceInternalUnpackBucket*>(
+        DocumentSourceInternalUnpackBucket::createFromBson(spec.firstElement(), expCtx).get());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksMeasurements) {
+    auto bucket = BSON("_id" << OID::gen() << "control"
+                             << BSON("version" << 1 << "min" << BSON("t" << kWindowStart) << "max"
+                                               << BSON("t" << kWindowStart + Milliseconds(2)))
+                             << "meta"
+                             << "sensor"
+                             << "data"
+                             << BSON("t" << BSON("0" << 0LL << "2" << 2LL) << "x"
+                                         << BSON("0" << 1 << "2" << 3)
+                                         << "y"
+                                         << BSON("2" << 4)));
+    auto source = DocumentSourceMock::create(Document(bucket));
+    auto unpack = makeUnpack(getExpCtx());
+    unpack->setSource(source.get());
+
+    // Position 1 was never written, so there are only two measurements.
+    auto next = unpack->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("t" << kWindowStart << "m"
+                                         << "sensor"
+                                         << "x"
+                                         << 1)));
+    next = unpack->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("t" << kWindowStart + Milliseconds(2) << "m"
+                                         << "sensor"
+                                         << "x"
+                                         << 3
+                                         << "y"
+                                         << 4)));
+    ASSERT(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, TranslatesTimeAndMetaPredicates) {
+    auto unpack = makeUnpack(getExpCtx());
+    auto predicate = unpack->createBucketPredicate(
+        BSON("t" << BSON("$gte" << kWindowStart) << "m.region"
+                 << "eu"
+                 << "x"
+                 << BSON("$gt" << 5)));
+    auto expected = BSON("$and" << BSON_ARRAY(BSON("control.max.t" << BSON("$gte" << kWindowStart))
+                                              << BSON("meta.region"
+                                                      << "eu")));
+    ASSERT_BSONOBJ_EQ(predicate, expected);
+
+    ASSERT_BSONOBJ_EQ(
+        unpack->createBucketPredicate(BSON("t" << kWindowStart)),
+        BSON("$and" << BSON_ARRAY(BSON("control.max.t" << BSON("$gte" << kWindowStart))
+                                  << BSON("control.min.t" << BSON("$lte" << kWindowStart)))));
+
+    // Only dates can bound the time of a bucket.
+    ASSERT_BSONOBJ_EQ(unpack->createBucketPredicate(BSON("t" << BSON("$lt" << 5) << "x" << 1)),
+                      BSONObj());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, PushesBucketPredicateBeforeUnpacking) {
+    auto expCtx = getExpCtx();
+    auto unpack = makeUnpack(expCtx);
+    auto match = DocumentSourceMatch::create(BSON("m"
+                                                  << "sensor"),
+                                             expCtx);
+    auto pipeline = uassertStatusOK(Pipeline::create({unpack, match}, expCtx));
+    pipeline->optimizePipeline();
+
+    auto& sources = pipeline->getSources();
+    ASSERT_EQ(3U, sources.size());
+    auto bucketMatch = dynamic_cast<DocumentSourceMatch*>(sources.front().get());
+    ASSERT(bucketMatch);
+    ASSERT_BSONOBJ_EQ(bucketMatch->getQuery(),
+                      BSON("$and" << BSON_ARRAY(BSON("meta"
+                                                     << "sensor"))));
+    ASSERT_EQ(unpack.get(), std::next(sources.begin())->get());
+    ASSERT(dynamic_cast<DocumentSourceMatch*>(sources.back().get()));
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, DoesNotPushDownUnrelatedPredicates) {
+    auto expCtx = getExpCtx();
+    auto unpack = makeUnpack(expCtx);
+    auto match = DocumentSourceMatch::create(BSON("x" << 1), expCtx);
+    auto pipeline = uassertStatusOK(Pipeline::create({unpack, match}, expCtx));
+    pipeline->optimizePipeline();
+    ASSERT_EQ(2U, pipeline->getSources().size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -152,6 +152,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_COUNT_SCAN == type) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->keysExamined;
     } else if (STAGE_DISTINCT_SCAN == type) {
         const DistinctScanStats* spec = static_cast<const DistinctScanStats*>(specific);
         return spec->keysExamined;
@@ -173,6 +176,9 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->fetches;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -201,6 +207,10 @@ void addStageSummaryStr(const PlanStage* stage, StringBuilder& sb) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         const KeyPattern keyPattern{spec->keyPattern};
         sb << " " << keyPattern;
+    } else if (STAGE_COLUMN_SCAN == stage->stageType()) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        const KeyPattern keyPattern{spec->keyPattern};
+        sb << " " << keyPattern;
     } else if (STAGE_DISTINCT_SCAN == stage->stageType()) {
         const DistinctScanStats* spec = static_cast<const DistinctScanStats*>(specific);
         const KeyPattern keyPattern{spec->keyPattern};
@@ -366,6 +376,18 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
+    } else if (STAGE_COLUMN_SCAN == stats.stageType) {
+        ColumnScanStats* spec = static_cast<ColumnScanStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("docsExamined", spec->fetches);
+            bob->appendNumber("rowsTested", spec->docsTested);
+        }
+
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("indexName", spec->indexName);
+        bob->append("fields", spec->fields);
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
@@ -958,6 +980,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IndexScanStats* ixscanStats =
                 static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
             statsOut->indexesUsed.insert(ixscanStats->indexName);
+        } else if (STAGE_COLUMN_SCAN == stages[i]->stageType()) {
+            const ColumnScanStats* columnScanStats =
+                static_cast<const ColumnScanStats*>(stages[i]->getSpecificStats());
+            statsOut->indexesUsed.insert(columnScanStats->indexName);
         } else if (STAGE_COUNT_SCAN == stages[i]->stageType()) {
             const CountScan* countScan = static_cast<const CountScan*>(stages[i]);
             const CountScanStats* countScanStats =
@@ -45,9 +45,10 @@ namespace mongo {
 
 using std::set;
 
-BSONObj ExpressionMapping::hash(const BSONElement& value) {
+BSONObj ExpressionMapping::hash(const BSONElement& value, int hashVersion) {
     BSONObjBuilder bob;
-    bob.append("", BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+    bob.append("",
+               BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED, hashVersion));
     return bob.obj();
 }
 
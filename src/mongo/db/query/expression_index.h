@@ -32,6 +32,7 @@
 
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds_builder.h"  // For OrderedIntervalList
@@ -48,7 +49,11 @@ namespace mongo {
  */
 class ExpressionMapping {
 public:
-    static BSONObj hash(const BSONElement& value);
+    /**
+     * Returns the hashed index key of 'value' using the given version of the hash function.
+     */
+    static BSONObj hash(const BSONElement& value,
+                        int hashVersion = BSONElementHasher::kMD5HashVersion);
 
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
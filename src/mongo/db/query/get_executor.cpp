@@ -32,15 +32,18 @@
 
 #include "mongo/db/query/get_executor.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <limits>
 #include <memory>
+#include <set>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/column_scan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/eof.h"
@@ -51,6 +54,7 @@
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/update.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -129,6 +133,11 @@ void fillOutPlannerParams(OperationContext* opCtx,
     IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
+        if (desc->getAccessMethodName() == IndexNames::COLUMNSTORE) {
+            // Columnstore indexes cannot answer index scans; they are only used by the column
+            // scan fast path in prepareExecution().
+            continue;
+        }
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
         plannerParams->indices.push_back(IndexEntry(desc->keyPattern(),
                                                     desc->getAccessMethodName(),
@@ -243,6 +252,117 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+bool hasCollectionScan(const QuerySolutionNode* node) {
+    if (STAGE_COLLSCAN == node->getType()) {
+        return true;
+    }
+    for (auto&& child : node->children) {
+        if (hasCollectionScan(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Adds to 'fields' the top-level field read by each predicate of 'node'. Returns false if some
+ * predicate may read more than the fields named by its path, as $where or $expr do.
+ */
+bool getColumnScanFilterFields(const MatchExpression* node, std::set<std::string>* fields) {
+    switch (node->getCategory()) {
+        case MatchExpression::MatchCategory::kLogical:
+            break;
+        case MatchExpression::MatchCategory::kLeaf:
+        case MatchExpression::MatchCategory::kArrayMatching:
+            if (node->path().empty()) {
+                return false;
+            }
+            // A column holds the whole value of its field, so predicates on subfields are
+            // answered by the same column.
+            fields->insert(FieldRef(node->path()).getPart(0).toString());
+            return true;
+        case MatchExpression::MatchCategory::kOther:
+            return false;
+    }
+
+    for (size_t i = 0; i < node->numChildren(); ++i) {
+        if (!getColumnScanFilterFields(node->getChild(i), fields)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * If a columnstore index holds every field read by 'canonicalQuery' and its projection, returns a
+ * plan which reads those fields from the index columns instead of fetching whole documents.
+ * Otherwise returns nullptr.
+ */
+unique_ptr<PlanStage> buildColumnScan(OperationContext* opCtx,
+                                      Collection* collection,
+                                      const CanonicalQuery& canonicalQuery,
+                                      size_t plannerOptions,
+                                      WorkingSet* ws) {
+    const ParsedProjection* proj = canonicalQuery.getProj();
+    const QueryRequest& qr = canonicalQuery.getQueryRequest();
+    if (!proj || proj->requiresDocument() || proj->hasDottedFieldPath() ||
+        proj->wantIndexKey() || proj->wantSortKey() || proj->wantTextScore() ||
+        proj->wantGeoNearDistance() || proj->wantGeoNearPoint()) {
+        return nullptr;
+    }
+    if (!qr.getSort().isEmpty() || qr.getSkip() || qr.getLimit() || qr.getNToReturn() ||
+        !qr.getMin().isEmpty() || !qr.getMax().isEmpty() || !qr.getHint().isEmpty() ||
+        qr.showRecordId() || qr.isTailable() ||
+        (plannerOptions &
+         (QueryPlannerParams::IS_COUNT | QueryPlannerParams::INCLUDE_SHARD_FILTER))) {
+        return nullptr;
+    }
+
+    std::set<std::string> fields;
+    for (auto&& field : proj->getRequiredFields()) {
+        fields.insert(field.toString());
+    }
+    if (!getColumnScanFilterFields(canonicalQuery.root(), &fields)) {
+        return nullptr;
+    }
+
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        if (desc->getAccessMethodName() != IndexNames::COLUMNSTORE) {
+            continue;
+        }
+        const BSONObj& keyPattern = desc->keyPattern();
+        if (!std::all_of(fields.begin(), fields.end(), [&](const std::string& field) {
+                return keyPattern.hasField(field);
+            })) {
+            continue;
+        }
+
+        // Put _id first, where it would be in the documents themselves.
+        std::vector<std::string> columns;
+        if (fields.count("_id")) {
+            columns.push_back("_id");
+        }
+        for (auto&& field : fields) {
+            if (field != "_id") {
+                columns.push_back(field);
+            }
+        }
+
+        unique_ptr<PlanStage> root = make_unique<ColumnScan>(
+            opCtx, collection, desc, std::move(columns), canonicalQuery.root(), ws);
+
+        ProjectionStageParams params;
+        params.projObj = proj->getProjObj();
+        params.collator = canonicalQuery.getCollator();
+        params.projImpl = ProjectionStageParams::SIMPLE_DOC;
+        return make_unique<ProjectionStage>(opCtx, params, ws, root.release());
+    }
+
+    return nullptr;
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -287,8 +407,9 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 
     const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
 
-    // If we have an _id index we can use an idhack plan.
-    if (descriptor && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
+    // If we have an _id index or the collection is keyed by _id we can use an idhack plan.
+    if ((descriptor || collection->isClustered()) &&
+        IDHackStage::supportsQuery(collection, *canonicalQuery)) {
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
@@ -431,6 +552,18 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // A collection scan reads and decodes every document in full. If a columnstore index holds
+    // all the fields the query needs, read just those columns instead.
+    if (1 == solutions.size() && hasCollectionScan(solutions[0]->root.get())) {
+        if (auto columnScanRoot = buildColumnScan(
+                opCtx, collection, *canonicalQuery, plannerParams.options, ws)) {
+            LOG(2) << "Using column scan: " << redact(canonicalQuery->toStringShort());
+
+            return PrepareExecutionResult(
+                std::move(canonicalQuery), nullptr, std::move(columnScanRoot));
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -798,8 +931,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
         const bool hasCollectionDefaultCollation = request->getCollation().isEmpty() ||
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+        if ((descriptor || collection->isClustered()) &&
+            CanonicalQuery::isSimpleIdQuery(unparsedQuery) && request->getProj().isEmpty() &&
+            hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             PlanStage* idHackStage = new IDHackStage(
@@ -936,8 +1070,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
         const bool hasCollectionDefaultCollation = CollatorInterface::collatorsMatch(
             parsedUpdate->getCollator(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+        if ((descriptor || collection->isClustered()) &&
+            CanonicalQuery::isSimpleIdQuery(unparsedQuery) && request->getProj().isEmpty() &&
+            hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             // Working set 'ws' is discarded. InternalPlanner::updateWithIdHack() makes its own
@@ -1440,7 +1575,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDistinct(
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
-        if (desc->keyPattern().hasField(parsedDistinct->getKey())) {
+        if (desc->keyPattern().hasField(parsedDistinct->getKey()) &&
+            desc->getAccessMethodName() != IndexNames::COLUMNSTORE) {
             plannerParams.indices.push_back(IndexEntry(desc->keyPattern(),
                                                        desc->getAccessMethodName(),
                                                        desc->isMultikey(opCtx),
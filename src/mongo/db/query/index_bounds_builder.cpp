@@ -116,6 +116,24 @@ const Interval kHashedUndefinedInterval = IndexBoundsBuilder::makePointInterval(
 const Interval kHashedNullInterval =
     IndexBoundsBuilder::makePointInterval(ExpressionMapping::hash(kNullElementObj.firstElement()));
 
+// Returns the version of the hash function of a hashed index, which is 0 when not specified.
+int getHashVersion(const IndexEntry& index) {
+    return index.infoObj["hashVersion"].numberInt();
+}
+
+// Returns the point interval for the hash of 'elementObj' in a hashed index, where
+// 'defaultInterval' is the precomputed interval for the default hash function.
+Interval makeHashedPointInterval(const BSONObj& elementObj,
+                                 const Interval& defaultInterval,
+                                 const IndexEntry& index) {
+    const int hashVersion = getHashVersion(index);
+    if (hashVersion == BSONElementHasher::kMD5HashVersion) {
+        return defaultInterval;
+    }
+    return IndexBoundsBuilder::makePointInterval(
+        ExpressionMapping::hash(elementObj.firstElement(), hashVersion));
+}
+
 void makeNullEqualityBounds(const IndexEntry& index,
                             bool isHashed,
                             OrderedIntervalList* oil,
@@ -125,11 +143,12 @@ void makeNullEqualityBounds(const IndexEntry& index,
     *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
 
     // There are two values that could possibly be equal to null in an index: undefined and null.
-    oil->intervals.push_back(isHashed
-                                 ? kHashedUndefinedInterval
-                                 : IndexBoundsBuilder::makePointInterval(kUndefinedElementObj));
-    oil->intervals.push_back(isHashed ? kHashedNullInterval
-                                      : IndexBoundsBuilder::makePointInterval(kNullElementObj));
+    oil->intervals.push_back(
+        isHashed ? makeHashedPointInterval(kUndefinedElementObj, kHashedUndefinedInterval, index)
+                 : IndexBoundsBuilder::makePointInterval(kUndefinedElementObj));
+    oil->intervals.push_back(
+        isHashed ? makeHashedPointInterval(kNullElementObj, kHashedNullInterval, index)
+                 : IndexBoundsBuilder::makePointInterval(kNullElementObj));
     // Just to be sure, make sure the bounds are in the right order if the hash values are opposite.
     IndexBoundsBuilder::unionize(oil);
 }
@@ -932,7 +951,7 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (BSONType::Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(), getHashVersion(index));
         }
 
         verify(dataObj.isOwned());
@@ -875,6 +875,48 @@ TEST(IndexBoundsBuilderTest, TranslateExprEqualHashedIndex) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateEqualityUsesHashVersionOfHashedIndex) {
+    BSONObj keyPattern = fromjson("{a: 'hashed'}");
+    BSONElement elt = keyPattern.firstElement();
+    IndexEntry testIndex{keyPattern,
+                         false,
+                         false,
+                         false,
+                         "a_hashed",
+                         nullptr,
+                         BSON("key" << keyPattern << "hashVersion" << 1)};
+    BSONObj obj = BSON("a" << 4);
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+
+    BSONObj expectedHash = ExpressionMapping::hash(BSON("" << 4).firstElement(),
+                                                   BSONElementHasher::kMurmur3HashVersion);
+    ASSERT_BSONOBJ_NE(expectedHash, ExpressionMapping::hash(BSON("" << 4).firstElement()));
+    BSONObjBuilder intervalBuilder;
+    intervalBuilder.append("", expectedHash.firstElement().numberLong());
+    intervalBuilder.append("", expectedHash.firstElement().numberLong());
+    BSONObj intervalObj = intervalBuilder.obj();
+
+    ASSERT_EQUALS(oil.intervals.size(), 1U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(intervalObj, true, true)));
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+
+    // Equality to null looks up the hashes of both undefined and null.
+    oil = OrderedIntervalList();
+    expr.reset(parseMatchExpression(BSON("a" << BSONNULL)));
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.intervals.size(), 2U);
+    for (auto&& valueObj : {BSON("" << BSONUndefined), BSON("" << BSONNULL)}) {
+        BSONObj hash = ExpressionMapping::hash(valueObj.firstElement(),
+                                               BSONElementHasher::kMurmur3HashVersion);
+        ASSERT_TRUE(oil.intervals[0].equals(IndexBoundsBuilder::makePointInterval(hash)) ||
+                    oil.intervals[1].equals(IndexBoundsBuilder::makePointInterval(hash)));
+    }
+}
+
 TEST(IndexBoundsBuilderTest, TranslateExprEqualToNullIsInexactFetch) {
     BSONObj keyPattern = BSON("a" << 1);
     BSONElement elt = keyPattern.firstElement();
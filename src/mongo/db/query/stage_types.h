@@ -39,6 +39,10 @@ enum StageType {
     STAGE_CACHED_PLAN,
     STAGE_COLLSCAN,
 
+    // Reads the needed fields from the columns of a columnstore index rather than from the
+    // documents themselves.
+    STAGE_COLUMN_SCAN,
+
     // This stage sits at the root of the query tree and counts up the number of results
     // returned by its child.
     STAGE_COUNT,
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 
 namespace mongo {
 namespace repl {
@@ -81,6 +82,8 @@ std::unique_ptr<ThreadPool> OplogApplier::makeWriterPool(int threadCount) {
     options.poolName = "repl writer worker Pool";
     options.maxThreads = options.minThreads = static_cast<size_t>(threadCount);
     options.onCreateThread = [](const std::string&) {
+        bindCurrentThreadToNextNumaNode();
+
         // Only do this once per thread
         if (!Client::getCurrent()) {
             Client::initThreadIfNotAlready();
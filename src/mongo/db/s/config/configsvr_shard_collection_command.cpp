@@ -317,7 +317,8 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
     //         ii. is not a sparse index, partial index, or index with a non-simple collation
     //         iii. contains no null values
     //         iv. is not multikey (maybe lift this restriction later)
-    //         v. if a hashed index, has default seed (lift this restriction later)
+    //         v. if a hashed index, has default seed and hash version (lift this restriction
+    //            later)
     //
     // 3. If the proposed shard key is specified as unique, there must exist a useful,
     //    unique index exactly equal to the proposedKey (not just a prefix).
@@ -364,6 +365,16 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
                                   << idx["seed"].numberInt(),
                     !shardKeyPattern.isHashedPattern() || idx["seed"].eoo() ||
                         idx["seed"].numberInt() == BSONElementHasher::DEFAULT_HASH_SEED);
+            // Chunk ranges of hashed shard keys are computed with the MD5 hash, so the index
+            // must hash the same way.
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "can't shard collection " << nss.ns()
+                                  << " with hashed shard key "
+                                  << proposedKey
+                                  << " because the hashed index uses hashVersion "
+                                  << idx["hashVersion"].numberInt(),
+                    !shardKeyPattern.isHashedPattern() || idx["hashVersion"].eoo() ||
+                        idx["hashVersion"].numberInt() == BSONElementHasher::kMD5HashVersion);
             hasUsefulIndexForKey = true;
         }
     }
@@ -146,6 +146,7 @@ void scheduleCleanup(executor::TaskExecutor* executor,
             Client::initThreadIfNotAlready("Collection Range Deleter");
             auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
             auto opCtx = uniqueOpCtx.get();
+            opCtx->setAdmissionPriority(AdmissionPriority::kLow);
 
             const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
 
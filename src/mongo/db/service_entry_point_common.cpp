@@ -72,6 +72,7 @@
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_config_optime_gossip.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_entry_point_common.h"
 #include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/counters.h"
@@ -81,6 +82,7 @@
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/metadata.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/config_server_metadata.h"
 #include "mongo/rpc/metadata/logical_time_metadata.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
@@ -95,6 +97,8 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/stringutils.h"
 
 namespace mongo {
 
@@ -139,6 +143,87 @@ const StringMap<int> sessionCheckoutWhitelist = {{"abortTransaction", 1},
                                                  {"voteAbortTransaction", 1},
                                                  {"voteCommitTransaction", 1}};
 
+/**
+ * A list of application names, as sent in the client metadata, whose operations queue for storage
+ * engine tickets with a given admission priority. Set as an array or a comma-separated string.
+ */
+class AdmissionPriorityAppNamesParameter : public ServerParameter {
+    MONGO_DISALLOW_COPYING(AdmissionPriorityAppNamesParameter);
+
+public:
+    explicit AdmissionPriorityAppNamesParameter(const std::string& name)
+        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true) {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONArrayBuilder arr(b.subarrayStart(name));
+        for (const auto& appName : _appNames) {
+            arr.append(appName.first);
+        }
+        arr.done();
+    }
+
+    Status set(const BSONElement& newValueElement) override {
+        std::vector<std::string> appNames;
+        if (!newValueElement.coerce(&appNames)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << name() << " has to be an array of application names"};
+        }
+        _set(appNames);
+        return Status::OK();
+    }
+
+    Status setFromString(const std::string& str) override {
+        std::vector<std::string> appNames;
+        splitStringDelim(str, &appNames, ',');
+        _set(appNames);
+        return Status::OK();
+    }
+
+    bool contains(StringData appName) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _appNames.find(appName) != _appNames.end();
+    }
+
+private:
+    void _set(const std::vector<std::string>& appNames) {
+        StringMap<bool> newAppNames;
+        for (const auto& appName : appNames) {
+            newAppNames[appName] = true;
+        }
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _appNames = std::move(newAppNames);
+    }
+
+    mutable stdx::mutex _mutex;
+    StringMap<bool> _appNames;
+};
+
+AdmissionPriorityAppNamesParameter lowAdmissionPriorityAppNames("lowAdmissionPriorityAppNames");
+AdmissionPriorityAppNamesParameter highAdmissionPriorityAppNames("highAdmissionPriorityAppNames");
+
+/**
+ * Returns the admission priority configured for the application name of 'client', if any.
+ */
+AdmissionPriority getAdmissionPriorityForClient(Client* client) {
+    const auto& clientMetadata = ClientMetadataIsMasterState::get(client).getClientMetadata();
+    if (!clientMetadata) {
+        return AdmissionPriority::kNormal;
+    }
+
+    const StringData appName = clientMetadata.get().getApplicationName();
+    if (appName.empty()) {
+        return AdmissionPriority::kNormal;
+    }
+    if (highAdmissionPriorityAppNames.contains(appName)) {
+        return AdmissionPriority::kHigh;
+    }
+    if (lowAdmissionPriorityAppNames.contains(appName)) {
+        return AdmissionPriority::kLow;
+    }
+    return AdmissionPriority::kNormal;
+}
+
 bool shouldActivateFailCommandFailPoint(const BSONObj& data, StringData cmdName) {
     if (cmdName == "configureFailPoint"_sd)  // Banned even if in failCommands.
         return false;
@@ -691,6 +776,7 @@ void execCommandDatabase(OperationContext* opCtx,
 
         BSONElement cmdOptionMaxTimeMSField;
         BSONElement allowImplicitCollectionCreationField;
+        BSONElement admissionPriorityField;
         BSONElement helpField;
 
         StringMap<int> topLevelFields;
@@ -700,6 +786,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 cmdOptionMaxTimeMSField = element;
             } else if (fieldName == "allowImplicitCollectionCreation") {
                 allowImplicitCollectionCreationField = element;
+            } else if (fieldName == "admissionPriority") {
+                admissionPriorityField = element;
             } else if (fieldName == CommandHelpers::kHelpFieldName) {
                 helpField = element;
             } else if (fieldName == QueryRequest::queryOptionMaxTimeMS) {
@@ -793,6 +881,27 @@ void execCommandDatabase(OperationContext* opCtx,
             opCtx->setDeadlineAfterNowBy(Milliseconds{maxTimeMS}, ErrorCodes::MaxTimeMSExpired);
         }
 
+        // The 'admissionPriority' command option overrides the priority derived from the
+        // application name. Any client may lower the priority of its own operations, but raising it
+        // lets them take tickets ahead of other clients. The option only applies on this node: it
+        // is stripped from requests forwarded to other nodes, including by mongos, since those run
+        // as the internal user.
+        if (admissionPriorityField) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "admissionPriority must be a string",
+                    admissionPriorityField.type() == String);
+            const auto priority =
+                uassertStatusOK(parseAdmissionPriority(admissionPriorityField.valueStringData()));
+            uassert(ErrorCodes::Unauthorized,
+                    "not authorized to raise the admission priority of an operation",
+                    priority <= opCtx->getAdmissionPriority() ||
+                        AuthorizationSession::get(opCtx->getClient())
+                            ->isAuthorizedForActionsOnResource(
+                                ResourcePattern::forClusterResource(),
+                                ActionType::raiseAdmissionPriority));
+            opCtx->setAdmissionPriority(priority);
+        }
+
         auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
         auto txnParticipant = TransactionParticipant::get(opCtx);
         if (!opCtx->getClient()->isInDirectClient() || !txnParticipant ||
@@ -1270,6 +1379,7 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
     } else {
         LastError::get(c).startRequest();
         AuthorizationSession::get(c)->startRequest(opCtx);
+        opCtx->setAdmissionPriority(getAdmissionPriorityForClient(&c));
 
         // We should not be holding any locks at this point
         invariant(!opCtx->lockState()->isLocked());
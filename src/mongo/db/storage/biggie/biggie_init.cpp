@@ -29,7 +29,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/path.hpp>
+
 #include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
@@ -41,6 +44,13 @@ namespace mongo {
 namespace biggie {
 
 namespace {
+// Keep the data across restarts by writing a snapshot of it into the dbpath on clean shutdown.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(biggieSnapshotOnShutdown, bool, false);
+
+// With biggieSnapshotOnShutdown, also write the snapshot every this many seconds while running,
+// so that an unclean shutdown only loses the writes since the last one. 0 disables it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(biggieSnapshotIntervalSecs, int, 0);
+
 class BiggieStorageEngineFactory : public StorageEngine::Factory {
 public:
     virtual StorageEngine* create(const StorageGlobalParams& params,
@@ -48,7 +58,12 @@ public:
         KVStorageEngineOptions options;
         options.directoryPerDB = params.directoryperdb;
         options.forRepair = params.repair;
-        return new KVStorageEngine(new KVEngine(), options);
+        std::string snapshotPath;
+        if (biggieSnapshotOnShutdown) {
+            snapshotPath = (boost::filesystem::path(params.dbpath) / "biggie.snapshot").string();
+        }
+        return new KVStorageEngine(
+            new KVEngine(std::move(snapshotPath), biggieSnapshotIntervalSecs), options);
     }
 
     virtual StringData getCanonicalName() const {
@@ -30,6 +30,10 @@
 
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+
+#include "mongo/base/data_view.h"
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/snapshot_window_options.h"
@@ -39,11 +43,154 @@
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/platform/basic.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 
 namespace mongo {
 namespace biggie {
+namespace {
+// Identifies the format of a snapshot file. A snapshot is this header followed by every key and
+// value in the store in order, each one prefixed with its length.
+const char kSnapshotHeader[] = "biggie snapshot v1";
+
+void writeLength(std::ostream& out, uint64_t length) {
+    char buf[sizeof(uint64_t)];
+    DataView(buf).write<LittleEndian<uint64_t>>(length);
+    out.write(buf, sizeof(buf));
+}
+
+bool readString(std::istream& in, std::string* out) {
+    char buf[sizeof(uint64_t)];
+    if (!in.read(buf, sizeof(buf)))
+        return false;
+    out->resize(ConstDataView(buf).read<LittleEndian<uint64_t>>());
+    return static_cast<bool>(in.read(&(*out)[0], out->size()));
+}
+}  // namespace
+
+KVEngine::KVEngine(std::string snapshotPath, int snapshotIntervalSecs)
+    : ::mongo::KVEngine(), _snapshotPath(std::move(snapshotPath)) {
+    if (_snapshotPath.empty())
+        return;
+
+    if (boost::filesystem::exists(_snapshotPath)) {
+        Status status = loadSnapshot(_snapshotPath);
+        uassert(50938,
+                str::stream() << "Failed to load biggie snapshot: " << status.reason(),
+                status.isOK());
+        log() << "Loaded " << _master->size() << " entries from biggie snapshot "
+              << _snapshotPath;
+    }
+
+    if (snapshotIntervalSecs > 0) {
+        _snapshotter = stdx::thread(
+            [this, snapshotIntervalSecs] { _snapshotterThread(Seconds(snapshotIntervalSecs)); });
+    }
+}
+
+KVEngine::~KVEngine() {
+    _stopSnapshotter();
+}
+
+void KVEngine::_snapshotterThread(Seconds interval) {
+    setThreadName("BiggieSnapshotter");
+    stdx::unique_lock<stdx::mutex> lk(_snapshotterMutex);
+    while (!_snapshotterCV.wait_for(
+        lk, interval.toSystemDuration(), [&] { return _snapshotterShuttingDown; })) {
+        lk.unlock();
+        // The master branch only ever holds whole commits, so any snapshot of it is consistent.
+        Status status = writeSnapshot(_snapshotPath);
+        if (!status.isOK()) {
+            warning() << "Failed to write biggie snapshot: " << status;
+        } else {
+            LOG(1) << "Wrote biggie snapshot to " << _snapshotPath;
+        }
+        lk.lock();
+    }
+}
+
+void KVEngine::_stopSnapshotter() {
+    if (!_snapshotter.joinable())
+        return;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_snapshotterMutex);
+        _snapshotterShuttingDown = true;
+    }
+    _snapshotterCV.notify_all();
+    _snapshotter.join();
+}
+
+void KVEngine::cleanShutdown() {
+    if (_snapshotPath.empty())
+        return;
+
+    // Both write through the same temporary file, so the periodic snapshots must stop first.
+    _stopSnapshotter();
+
+    Status status = writeSnapshot(_snapshotPath);
+    if (!status.isOK()) {
+        error() << "Failed to write biggie snapshot: " << status;
+        return;
+    }
+    log() << "Wrote biggie snapshot to " << _snapshotPath;
+}
+
+Status KVEngine::writeSnapshot(const std::string& path) const {
+    const std::string tempPath = path + ".tmp";
+    std::shared_ptr<StringStore> master = getMaster();
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(kSnapshotHeader, sizeof(kSnapshotHeader));
+        for (const auto& entry : *master) {
+            writeLength(out, entry.first.size());
+            out.write(entry.first.data(), entry.first.size());
+            writeLength(out, entry.second.size());
+            out.write(entry.second.data(), entry.second.size());
+        }
+        out.flush();
+        if (!out) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Error writing snapshot file " << tempPath};
+        }
+    }
+
+    // Only replace the previous snapshot once the new one is complete.
+    boost::system::error_code ec;
+    boost::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        return {ErrorCodes::FileRenameFailed,
+                str::stream() << "Error renaming " << tempPath << " to " << path << ": "
+                              << ec.message()};
+    }
+    return Status::OK();
+}
+
+Status KVEngine::loadSnapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char header[sizeof(kSnapshotHeader)];
+    if (!in.read(header, sizeof(header)) ||
+        memcmp(header, kSnapshotHeader, sizeof(kSnapshotHeader)) != 0) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << path << " is not a biggie snapshot file"};
+    }
+
+    auto store = std::make_unique<StringStore>();
+    std::string key;
+    std::string value;
+    while (in.peek() != std::char_traits<char>::eof()) {
+        if (!readString(in, &key) || !readString(in, &value)) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Biggie snapshot file " << path << " is truncated"};
+        }
+        store->insert(StringStore::value_type(key, value));
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    setMaster_inlock(std::move(store));
+    return Status::OK();
+}
 
 mongo::RecoveryUnit* KVEngine::newRecoveryUnit() {
     return new RecoveryUnit(this, nullptr);
@@ -58,7 +205,8 @@ Status KVEngine::createRecordStore(OperationContext* opCtx,
                                    StringData ident,
                                    const CollectionOptions& options) {
     log() << "Creating Ident in KVEngine with ident: " << ident;
-    _idents.insert(ident);
+    stdx::lock_guard<stdx::mutex> lk(_identsLock);
+    _idents.insert(ident.toString());
     return Status::OK();
 }
 
@@ -67,7 +215,9 @@ std::unique_ptr<::mongo::RecordStore> KVEngine::getRecordStore(OperationContext*
                                                                StringData ident,
                                                                const CollectionOptions& options) {
     // TODO: deal with options.
-    return std::make_unique<RecordStore>(ns, ident);
+    auto recordStore = std::make_unique<RecordStore>(ns, ident);
+    recordStore->initHighestRecordId(*getMaster());
+    return std::move(recordStore);
 }
 
 void KVEngine::setMaster_inlock(std::unique_ptr<StringStore> newMaster) {
@@ -31,11 +31,16 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 
 #include "mongo/db/storage/biggie/biggie_record_store.h"
 #include "mongo/db/storage/biggie/biggie_sorted_impl.h"
 #include "mongo/db/storage/biggie/store.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 namespace biggie {
@@ -45,13 +50,19 @@ class JournalListener;
  */
 class KVEngine : public ::mongo::KVEngine {
     std::shared_ptr<StringStore> _master = std::make_shared<StringStore>();
-    std::set<StringData> _idents;  // TODO : replace with a query to _master.
+    stdx::mutex _identsLock;
+    std::set<std::string> _idents;  // TODO : replace with a query to _master.
     mutable stdx::mutex _masterLock;
 
 public:
-    KVEngine() : ::mongo::KVEngine() {}
+    /**
+     * If 'snapshotPath' is not empty, the engine starts from the snapshot stored there, if any,
+     * and writes a new snapshot there on clean shutdown. A positive 'snapshotIntervalSecs' also
+     * writes one in the background at that interval, bounding what a crash loses.
+     */
+    explicit KVEngine(std::string snapshotPath = "", int snapshotIntervalSecs = 0);
 
-    virtual ~KVEngine() {}
+    virtual ~KVEngine();
 
     virtual mongo::RecoveryUnit* newRecoveryUnit();
 
@@ -77,8 +88,12 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Units of work commit by merging into the master branch, and the merge rejects concurrent
+     * changes to the same keys with a WriteConflictException.
+     */
     virtual bool supportsDocLocking() const {
-        return false;  // TODO : do this later.
+        return true;
     }
 
     virtual bool supportsDirectoryPerDB() const {
@@ -122,7 +137,7 @@ public:
         return std::vector<std::string>();
     }
 
-    virtual void cleanShutdown(){};
+    virtual void cleanShutdown();
 
     void setJournalListener(mongo::JournalListener* jl) final {}
 
@@ -148,7 +163,27 @@ public:
         return _masterLock;
     }
 
+    /**
+     * Writes the committed contents of the store to 'path', replacing it atomically.
+     */
+    Status writeSnapshot(const std::string& path) const;
+
+    /**
+     * Replaces the contents of the store with a snapshot written by writeSnapshot().
+     */
+    Status loadSnapshot(const std::string& path);
+
 private:
+    void _snapshotterThread(Seconds interval);
+    void _stopSnapshotter();
+
+    const std::string _snapshotPath;
+
+    stdx::mutex _snapshotterMutex;
+    stdx::condition_variable _snapshotterCV;
+    bool _snapshotterShuttingDown = false;  // Guarded by _snapshotterMutex.
+    stdx::thread _snapshotter;
+
     std::shared_ptr<void> _catalogInfo;
     int _cachePressureForTest;
 };
@@ -97,6 +97,14 @@ RecordStore::RecordStore(StringData ns,
       _postfix(createKey(_ident, std::numeric_limits<int64_t>::max())),
       _cappedCallback(cappedCallback) {}
 
+void RecordStore::initHighestRecordId(const StringStore& store) {
+    // The last key before '_postfix' holds the highest RecordId, if it belongs to this store.
+    StringStore::const_reverse_iterator it(store.lower_bound(_postfix));
+    if (it != store.rend() && it->first >= _prefix) {
+        _highest_record_id.store(extractRecordId(it->first) + 1);
+    }
+}
+
 const char* RecordStore::name() const {
     return "biggie";
 }
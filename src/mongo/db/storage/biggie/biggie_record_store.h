@@ -130,6 +130,12 @@ public:
                                         long long numRecords,
                                         long long dataSize);
 
+    /**
+     * Continues numbering records after the highest RecordId this store already has in 'store',
+     * such as when the engine was started from a snapshot.
+     */
+    void initHighestRecordId(const StringStore& store);
+
 private:
     AtomicInt64 _highest_record_id{1};
     std::string generateKey(const uint8_t* key, size_t key_len) const;
@@ -35,28 +35,43 @@
 #include <mutex>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 namespace biggie {
+namespace {
+AtomicUInt64 nextSnapshotId{1};
+}  // namespace
 
 RecoveryUnit::RecoveryUnit(KVEngine* parentKVEngine, stdx::function<void()> cb)
-    : _waitUntilDurableCallback(cb), _KVEngine(parentKVEngine) {}
+    : _waitUntilDurableCallback(cb),
+      _KVEngine(parentKVEngine),
+      _mySnapshotId(nextSnapshotId.fetchAndAdd(1)) {}
 
 void RecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {}
 
 void RecoveryUnit::commitUnitOfWork() {
-    while (true) {
+    // A unit of work that never read or wrote anything has nothing to install.
+    while (_workingCopy) {
         std::shared_ptr<StringStore> master = _KVEngine->getMaster();
-        try {
-            _workingCopy->merge3(*_mergeBase, *master);
-        } catch (const merge_conflict_exception&) {
-            throw WriteConflictException();
+        // Commits are optimistic: merge in whatever was committed since this unit of work forked,
+        // outside of the lock, and only take it to install the result. If nothing was committed
+        // in between, the working copy can be installed as is. Otherwise the merge rejects only
+        // changes to the same keys, and once it succeeds 'master' becomes the base, so that losing
+        // the race to install only requires merging the commits that won it.
+        if (master != _mergeBase) {
+            try {
+                _workingCopy->merge3(*_mergeBase, *master);
+            } catch (const merge_conflict_exception&) {
+                throw WriteConflictException();
+            }
+            _mergeBase = master;
         }
         stdx::lock_guard<stdx::mutex> lkOnMaster(_KVEngine->getMasterLock());
         if (_KVEngine->getMaster_inlock() == master) {
             _KVEngine->setMaster_inlock(std::move(_workingCopy));
-            _mergeBase.reset();
+            _releaseSnapshot();
             break;
         }
     }
@@ -71,8 +86,7 @@ void RecoveryUnit::commitUnitOfWork() {
 }
 
 void RecoveryUnit::abortUnitOfWork() {
-    _workingCopy.reset();
-    _mergeBase.reset();
+    _releaseSnapshot();
     try {
         for (Changes::reverse_iterator it = _changes.rbegin(), end = _changes.rend(); it != end;
              ++it) {
@@ -91,9 +105,13 @@ bool RecoveryUnit::waitUntilDurable() {
 }
 
 void RecoveryUnit::abandonSnapshot() {
+    _releaseSnapshot();
+}
+
+void RecoveryUnit::_releaseSnapshot() {
     _mergeBase.reset();
     _workingCopy.reset();
-    // TODO : check if we need to add something later.
+    _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
 }
 
 void RecoveryUnit::registerChange(Change* change) {
@@ -101,7 +119,7 @@ void RecoveryUnit::registerChange(Change* change) {
 }
 
 SnapshotId RecoveryUnit::getSnapshotId() const {
-    return SnapshotId();
+    return SnapshotId(_mySnapshotId);
 }
 
 bool RecoveryUnit::forkIfNeeded() {
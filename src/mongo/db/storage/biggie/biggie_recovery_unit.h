@@ -50,6 +50,9 @@ class RecoveryUnit : public ::mongo::RecoveryUnit {
     std::shared_ptr<StringStore> _mergeBase;
     // Constructed with _mergeBase for now, could change later.
     std::unique_ptr<StringStore> _workingCopy;
+    // Changes whenever _mergeBase is released, so callers can tell that documents they read
+    // earlier may have been modified by concurrent writers since.
+    uint64_t _mySnapshotId;
 
 public:
     RecoveryUnit(KVEngine* parentKVEngine, stdx::function<void()> cb = nullptr);
@@ -82,6 +85,9 @@ private:
     typedef std::shared_ptr<Change> ChangePtr;
     typedef std::vector<ChangePtr> Changes;
 
+    // Releases the working copy and merge base, which starts a new snapshot.
+    void _releaseSnapshot();
+
     Changes _changes;
 };
 
@@ -44,6 +44,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/shared_buffer.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <memory>
@@ -301,21 +302,62 @@ SortedDataInterface::SortedDataInterface(const Ordering& ordering, bool isUnique
     // Similarly, this is the string representation of the KeyString for something greater than
     // all other elements in this ident.
     _KSForIdentEnd = combineKeyAndRID(BSONObj(), RecordId::min(), _identEnd, ordering);
+
+    // The unique markers of this ident sort between ident + \3 and ident + \4.
+    _uniqueMarkerPrefix = ident.toString().append(1, '\3');
+    _KSForUniqueMarkerStart =
+        combineKeyAndRID(BSONObj(), RecordId::min(), _uniqueMarkerPrefix, ordering);
+    _KSForUniqueMarkerEnd = combineKeyAndRID(
+        BSONObj(), RecordId::min(), ident.toString().append(1, '\4'), ordering);
+}
+
+std::string SortedDataInterface::_uniqueMarkerKey(const BSONObj& key) const {
+    return combineKeyAndRID(key, RecordId::min(), _uniqueMarkerPrefix, _order);
 }
 
 Status SortedDataInterface::insert(OperationContext* opCtx,
                                    const BSONObj& key,
                                    const RecordId& loc,
                                    bool dupsAllowed) {
+    return _insert(getRecoveryUnitBranch_forking(opCtx), key, loc, dupsAllowed);
+}
+
+Status SortedDataInterface::insertKeys(OperationContext* opCtx,
+                                       const std::vector<IndexKeyEntry>& keys,
+                                       bool dupsAllowed) {
+    // Fork the working copy once for the whole batch, and insert in index order so that
+    // consecutive inserts share the longest possible path through the radix tree.
+    StringStore* workingCopy = getRecoveryUnitBranch_forking(opCtx);
+
+    std::vector<const IndexKeyEntry*> sorted;
+    sorted.reserve(keys.size());
+    for (const auto& entry : keys) {
+        sorted.push_back(&entry);
+    }
+    IndexEntryComparison comparison(_order);
+    std::sort(sorted.begin(),
+              sorted.end(),
+              [&](const IndexKeyEntry* lhs, const IndexKeyEntry* rhs) {
+                  return comparison(*lhs, *rhs);
+              });
+
+    for (const IndexKeyEntry* entry : sorted) {
+        Status status = _insert(workingCopy, entry->key, entry->loc, dupsAllowed);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
+Status SortedDataInterface::_insert(StringStore* workingCopy,
+                                    const BSONObj& key,
+                                    const RecordId& loc,
+                                    bool dupsAllowed) {
     // The KeyString representation of the key.
     std::unique_ptr<KeyString> workingCopyInternalKs = keyToKeyString(key, _order);
-    // The KeyString of prefix (which is ident + \1), key, loc.
-    std::unique_ptr<KeyString> workingCopyOuterKs = combineKeyAndRIDKS(key, loc, _prefix, _order);
-    // The string representation.
+    // The string representation of prefix (which is ident + \1), key, loc.
     std::string workingCopyInsertKey = combineKeyAndRID(key, loc, _prefix, _order);
 
-    StringStore* workingCopy = getRecoveryUnitBranch_forking(opCtx);
-
     if (workingCopy->find(workingCopyInsertKey) != workingCopy->end()) {
         return Status::OK();
     }
@@ -350,6 +392,14 @@ Status SortedDataInterface::insert(OperationContext* opCtx,
         std::string(reinterpret_cast<const char*>(workingCopyInternalKs->getTypeBits().getBuffer()),
                     workingCopyInternalKs->getTypeBits().getSize());
     workingCopy->insert(StringStore::value_type(workingCopyInsertKey, internalTbString));
+
+    if (_isUnique && !dupsAllowed) {
+        // Rewrite the marker so that a concurrent insert of the same key conflicts with this one,
+        // even though the check above could not see it.
+        std::string markerKey = _uniqueMarkerKey(key);
+        workingCopy->erase(markerKey);
+        workingCopy->insert(StringStore::value_type(markerKey, std::to_string(loc.repr())));
+    }
     return Status::OK();
 }
 
@@ -359,7 +409,21 @@ void SortedDataInterface::unindex(OperationContext* opCtx,
                                   bool dupsAllowed) {
     std::string workingCopyInsertKey = combineKeyAndRID(key, loc, _prefix, _order);
     StringStore* workingCopy = getRecoveryUnitBranch_forking(opCtx);
-    workingCopy->erase(workingCopyInsertKey);
+    if (workingCopy->erase(workingCopyInsertKey) && _isUnique) {
+        workingCopy->erase(_uniqueMarkerKey(key));
+    }
+}
+
+void SortedDataInterface::unindexKeys(OperationContext* opCtx,
+                                      const std::vector<IndexKeyEntry>& keys,
+                                      bool dupsAllowed) {
+    StringStore* workingCopy = getRecoveryUnitBranch_forking(opCtx);
+    for (const auto& entry : keys) {
+        if (workingCopy->erase(combineKeyAndRID(entry.key, entry.loc, _prefix, _order)) &&
+            _isUnique) {
+            workingCopy->erase(_uniqueMarkerKey(entry.key));
+        }
+    }
 }
 
 // This function is, as of now, not in the interface, but there exists a server ticket to add
@@ -373,6 +437,16 @@ Status SortedDataInterface::truncate(OperationContext* opCtx) {
         workingCopy->erase(workingCopyLowerBound->first);
         ++workingCopyLowerBound;
     }
+
+    std::vector<std::string> markerKeys;
+    for (auto it = workingCopy->lower_bound(_KSForUniqueMarkerStart);
+         it != workingCopy->end() && it->first.compare(_KSForUniqueMarkerEnd) < 0;
+         ++it) {
+        markerKeys.push_back(it->first);
+    }
+    for (const auto& markerKey : markerKeys) {
+        workingCopy->erase(markerKey);
+    }
     return Status::OK();
 }
 
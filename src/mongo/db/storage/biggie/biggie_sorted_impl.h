@@ -78,6 +78,12 @@ public:
                          const BSONObj& key,
                          const RecordId& loc,
                          bool dupsAllowed) override;
+    virtual Status insertKeys(OperationContext* opCtx,
+                              const std::vector<IndexKeyEntry>& keys,
+                              bool dupsAllowed) override;
+    virtual void unindexKeys(OperationContext* opCtx,
+                             const std::vector<IndexKeyEntry>& keys,
+                             bool dupsAllowed) override;
     virtual Status dupKeyCheck(OperationContext* opCtx,
                                const BSONObj& key,
                                const RecordId& loc) override;
@@ -164,6 +170,15 @@ public:
     };
 
 private:
+    // Inserts a single entry into an already forked working copy.
+    Status _insert(StringStore* workingCopy,
+                   const BSONObj& key,
+                   const RecordId& loc,
+                   bool dupsAllowed);
+
+    // Returns the key of the marker that a unique index keeps for 'key'.
+    std::string _uniqueMarkerKey(const BSONObj& key) const;
+
     const Ordering _order;
     // These two are the same as before.
     std::string _prefix;
@@ -171,6 +186,12 @@ private:
     // These are the keystring representations of the _prefix and the _identEnd.
     std::string _KSForIdentStart;
     std::string _KSForIdentEnd;
+    // Unique indexes keep one marker entry per key, past _KSForIdentEnd, which every insert of
+    // that key rewrites. Since the index entries themselves include the RecordId, this is what
+    // makes two concurrent inserts of the same key with different RecordIds conflict at commit.
+    std::string _uniqueMarkerPrefix;
+    std::string _KSForUniqueMarkerStart;
+    std::string _KSForUniqueMarkerEnd;
     // This stores whether or not the end position is inclusive.
     bool _isUnique;
     // This stores whethert or not dups are allowed.
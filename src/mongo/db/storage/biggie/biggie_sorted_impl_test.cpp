@@ -28,6 +28,7 @@
 
 #include "mongo/db/storage/biggie/biggie_sorted_impl.h"
 #include "mongo/base/init.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
 #include "mongo/db/storage/biggie/biggie_recovery_unit.h"
 #include "mongo/db/storage/biggie/store.h"
@@ -63,6 +64,26 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+TEST(BiggieSortedDataInterface, ConcurrentInsertsOfSameUniqueKeyConflict) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    const std::unique_ptr<mongo::SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/true));
+
+    auto client1 = harnessHelper->serviceContext()->makeClient("client1");
+    auto client2 = harnessHelper->serviceContext()->makeClient("client2");
+    auto opCtx1 = harnessHelper->newOperationContext(client1.get());
+    auto opCtx2 = harnessHelper->newOperationContext(client2.get());
+
+    // Neither unit of work can see the other's entry, so both pass the duplicate key check.
+    WriteUnitOfWork uow1(opCtx1.get());
+    WriteUnitOfWork uow2(opCtx2.get());
+    ASSERT_OK(sorted->insert(opCtx1.get(), key1, loc1, false));
+    ASSERT_OK(sorted->insert(opCtx2.get(), key1, loc2, false));
+
+    uow1.commit();
+    ASSERT_THROWS(uow2.commit(), WriteConflictException);
+}
 }  // namespace
 }  // namespace biggie
 }  // namespace mongo
@@ -28,11 +28,12 @@
 
 #pragma once
 
-#include <array>
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <cstring>
 #include <exception>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string.h>
 #include <vector>
@@ -151,24 +152,19 @@ public:
 
                 // Check the children right of the node that the iterator was at already. This way,
                 // there will be no backtracking in the traversal.
-                for (auto iter = oldKey + 1 + node->children.begin(); iter != node->children.end();
-                     ++iter) {
-
-                    // If the node has a child, then the sub-tree must have a node with data that
-                    // has not yet been visited.
-                    if (*iter != nullptr) {
-
-                        // If the current node has data, return it and exit. If not, continue
-                        // following the nodes to find the next one with data. It is necessary to go
-                        // to the left-most node in this sub-tree.
-                        if ((*iter)->data != boost::none) {
-                            _current = iter->get();
-                            return;
-                        }
-                        _current = iter->get();
+                //
+                // If the node has such a child, then the sub-tree must have a node with data that
+                // has not yet been visited.
+                if (Node* child = node->children.firstChildFrom(oldKey + 1)) {
+
+                    // If the current node has data, return it and exit. If not, continue
+                    // following the nodes to find the next one with data. It is necessary to go
+                    // to the left-most node in this sub-tree.
+                    _current = child;
+                    if (child->data == boost::none) {
                         _traverseLeftSubtree();
-                        return;
                     }
+                    return;
                 }
             }
             return;
@@ -179,12 +175,7 @@ public:
             // '_current' is root. However, it cannot return the root, and hence at least 1
             // iteration of the while loop is required.
             do {
-                for (auto child : _current->children) {
-                    if (child != nullptr) {
-                        _current = child.get();
-                        break;
-                    }
-                }
+                _current = _current->children.firstChild();
             } while (_current->data == boost::none);
         }
 
@@ -301,14 +292,12 @@ public:
 
                 // After moving up in the tree, continue searching for neighboring nodes to see if
                 // they have data, moving from right to left.
-                for (int i = oldKey - 1; i >= 0; i--) {
-                    if (node->children[i] != nullptr) {
-                        // If there is a sub-tree found, it must have data, therefore it's necessary
-                        // to traverse to the right most node.
-                        _current = node->children[i].get();
-                        _traverseRightSubtree();
-                        return;
-                    }
+                if (Node* child = node->children.lastChildBefore(oldKey)) {
+                    // If there is a sub-tree found, it must have data, therefore it's necessary
+                    // to traverse to the right most node.
+                    _current = child;
+                    _traverseRightSubtree();
+                    return;
                 }
 
                 // If there were no sub-trees that contained data, and the 'current' node has data,
@@ -322,15 +311,9 @@ public:
         void _traverseRightSubtree() {
             // This function traverses the given tree to the right most leaf of the subtree where
             // 'current' is the root.
-            do {
-                for (auto iter = _current->children.rbegin(); iter != _current->children.rend();
-                     ++iter) {
-                    if (*iter != nullptr) {
-                        _current = iter->get();
-                        break;
-                    }
-                }
-            } while (!_current->isLeaf());
+            while (!_current->isLeaf()) {
+                _current = _current->children.lastChild();
+            }
         }
 
         // "_root" is a copy of the root of the tree over which this is iterating.
@@ -431,7 +414,7 @@ public:
         size_t depth = 0;
         while (depth < key.size()) {
             uint8_t c = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[c];
+            node = node->children.get(c);
 
             if (node == nullptr) {
                 return 0;
@@ -461,7 +444,7 @@ public:
             if (isUniquelyOwned) {
                 // If this node is uniquely owned, simply set that child node to null and
                 // "cut" off that branch of our tree
-                last->children[firstChar] = nullptr;
+                last->children.set(firstChar, nullptr);
                 last->decrement(sizeOfRemovedNode);
                 _compressOnlyChild(last);
 
@@ -476,7 +459,7 @@ public:
                 std::shared_ptr<Node> child = std::make_shared<Node>(*last);
                 child->_numSubtreeElems = last->_numSubtreeElems - 1;
                 child->_sizeSubtreeElems = last->_sizeSubtreeElems - sizeOfRemovedNode;
-                child->children[firstChar] = nullptr;
+                child->children.set(firstChar, nullptr);
 
                 // 'last' may only have one child, in which case we need to evaluate
                 // whether or not this node is redundant.
@@ -493,7 +476,7 @@ public:
                     node = std::make_shared<Node>(*last);
                     node->_numSubtreeElems = last->_numSubtreeElems - 1;
                     node->_sizeSubtreeElems = last->_sizeSubtreeElems - sizeOfRemovedNode;
-                    node->children[firstChar] = child;
+                    node->children.set(firstChar, child);
                     child = node;
                 }
                 _root = node;
@@ -528,16 +511,11 @@ public:
         if (this->empty())
             return RadixStore::rend();
 
-        auto node = _root;
+        Node* node = _root.get();
         while (!node->isLeaf()) {
-            for (auto iter = node->children.rbegin(); iter != node->children.rend(); ++iter) {
-                if (*iter != nullptr) {
-                    node = *iter;
-                    break;
-                }
-            }
+            node = node->children.lastChild();
         }
-        return RadixStore::const_reverse_iterator(_root, node.get());
+        return RadixStore::const_reverse_iterator(_root, node);
     }
 
     const_iterator end() const noexcept {
@@ -577,11 +555,12 @@ public:
             // 'unsigned char' or 'uint8_t'). Then only it can be assigned to an unsigned int.
             unsigned char c = static_cast<unsigned char>(charKey[depth]);
             idx = c;
-            if (node->children[idx] == nullptr) {
+            Node* child = node->children.get(c).get();
+            if (child == nullptr) {
                 break;
             }
 
-            node = node->children[idx].get();
+            node = child;
             // We may eventually need to search this node's parent for larger children
             idx += 1;
             size_t mismatchIdx = _comparePrefix(node->trieKey, charKey + depth, key.size() - depth);
@@ -632,22 +611,14 @@ public:
             node = context.back();
             context.pop_back();
 
-            for (auto iter = idx + node->children.begin(); iter != node->children.end(); ++iter) {
-                if (*iter != nullptr) {
-                    // There exists a node with a key larger than the one given, traverse to
-                    // this node which will be the left-most node in this sub-tree.
-                    node = iter->get();
-                    while (node->data == boost::none) {
-                        for (auto iter = node->children.begin(); iter != node->children.end();
-                             ++iter) {
-                            if (*iter != nullptr) {
-                                node = iter->get();
-                                break;
-                            }
-                        }
-                    }
-                    return const_iterator(_root, node);
+            if (Node* child = node->children.firstChildFrom(idx)) {
+                // There exists a node with a key larger than the one given, traverse to
+                // this node which will be the left-most node in this sub-tree.
+                node = child;
+                while (node->data == boost::none) {
+                    node = node->children.firstChild();
                 }
+                return const_iterator(_root, node);
             }
 
             if (node->trieKey.empty()) {
@@ -688,26 +659,355 @@ public:
     }
 
 private:
+    /**
+     * The children of a Node, keyed by the first byte of each child's trieKey.
+     *
+     * As in an adaptive radix tree, the layout follows the number of children so that a node costs
+     * space in proportion to its fan-out rather than always holding 256 pointers: up to 4 or 16
+     * children are kept in sorted key and pointer arrays, up to 48 behind a 256-byte index, and
+     * only the densest nodes use a direct array of 256 pointers. Leaves allocate nothing. Copying a
+     * node, as copy-on-write does for every node on a modified path, therefore only copies and
+     * reference counts the children that exist.
+     */
+    class Children {
+    public:
+        Children() = default;
+
+        Children(const Children& other) : _kind(other._kind), _count(other._count) {
+            if (other._count == 0) {
+                _kind = Kind::kNode4;
+                return;
+            }
+            _allocate(_kind);
+            std::copy_n(other._keys.get(), _keysCapacity(_kind), _keys.get());
+            const size_t numSlots = _kind == Kind::kNode256 ? 256 : _count;
+            std::copy_n(other._ptrs.get(), numSlots, _ptrs.get());
+        }
+
+        Children& operator=(const Children& other) {
+            if (this != &other) {
+                Children copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        Children(Children&& other) = default;
+        Children& operator=(Children&& other) = default;
+
+        bool empty() const {
+            return _count == 0;
+        }
+
+        size_t size() const {
+            return _count;
+        }
+
+        /**
+         * Returns the child whose trieKey starts with 'key', or a null pointer.
+         */
+        const std::shared_ptr<Node>& get(uint8_t key) const {
+            static const std::shared_ptr<Node> kNoChild;
+            const std::shared_ptr<Node>* slot = _find(key);
+            return slot ? *slot : kNoChild;
+        }
+
+        /**
+         * Sets the child whose trieKey starts with 'key'. Setting a null pointer removes it.
+         */
+        void set(uint8_t key, std::shared_ptr<Node> child) {
+            if (child == nullptr) {
+                _erase(key);
+                return;
+            }
+            if (std::shared_ptr<Node>* slot = _find(key)) {
+                *slot = std::move(child);
+                return;
+            }
+            if (!_ptrs) {
+                _allocate(Kind::kNode4);
+            } else if (_count == _capacity(_kind)) {
+                _resize(_nextKind(_kind));
+            }
+            _insert(key, std::move(child));
+        }
+
+        /**
+         * Returns the child with the smallest key that is at least 'from', or nullptr.
+         */
+        Node* firstChildFrom(unsigned from) const {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16:
+                    for (size_t i = 0; i < _count; ++i) {
+                        if (_keys[i] >= from)
+                            return _ptrs[i].get();
+                    }
+                    return nullptr;
+                case Kind::kNode48:
+                    for (unsigned key = from; key < 256; ++key) {
+                        if (_keys[key])
+                            return _ptrs[_keys[key] - 1].get();
+                    }
+                    return nullptr;
+                case Kind::kNode256:
+                    for (unsigned key = from; key < 256; ++key) {
+                        if (_ptrs[key])
+                            return _ptrs[key].get();
+                    }
+                    return nullptr;
+            }
+            return nullptr;
+        }
+
+        /**
+         * Returns the child with the largest key that is less than 'before', or nullptr.
+         */
+        Node* lastChildBefore(unsigned before) const {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16:
+                    for (size_t i = _count; i > 0; --i) {
+                        if (_keys[i - 1] < before)
+                            return _ptrs[i - 1].get();
+                    }
+                    return nullptr;
+                case Kind::kNode48:
+                    for (unsigned key = std::min(before, 256u); key > 0; --key) {
+                        if (_keys[key - 1])
+                            return _ptrs[_keys[key - 1] - 1].get();
+                    }
+                    return nullptr;
+                case Kind::kNode256:
+                    for (unsigned key = std::min(before, 256u); key > 0; --key) {
+                        if (_ptrs[key - 1])
+                            return _ptrs[key - 1].get();
+                    }
+                    return nullptr;
+            }
+            return nullptr;
+        }
+
+        Node* firstChild() const {
+            return firstChildFrom(0);
+        }
+
+        Node* lastChild() const {
+            return lastChildBefore(256);
+        }
+
+        /**
+         * Returns the keys of all children in increasing order.
+         */
+        std::vector<uint8_t> keys() const {
+            std::vector<uint8_t> result;
+            result.reserve(_count);
+            forEach([&](uint8_t key, const std::shared_ptr<Node>&) { result.push_back(key); });
+            return result;
+        }
+
+        /**
+         * Calls 'f' with the key and pointer of each child in increasing key order.
+         */
+        template <typename F>
+        void forEach(F&& f) const {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16:
+                    for (size_t i = 0; i < _count; ++i) {
+                        f(_keys[i], _ptrs[i]);
+                    }
+                    return;
+                case Kind::kNode48:
+                    for (unsigned key = 0; key < 256 && _count; ++key) {
+                        if (_keys[key])
+                            f(static_cast<uint8_t>(key), _ptrs[_keys[key] - 1]);
+                    }
+                    return;
+                case Kind::kNode256:
+                    for (unsigned key = 0; key < 256 && _count; ++key) {
+                        if (_ptrs[key])
+                            f(static_cast<uint8_t>(key), _ptrs[key]);
+                    }
+                    return;
+            }
+        }
+
+    private:
+        // Named after the most children each layout holds.
+        enum class Kind : uint8_t { kNode4, kNode16, kNode48, kNode256 };
+
+        static size_t _capacity(Kind kind) {
+            switch (kind) {
+                case Kind::kNode4:
+                    return 4;
+                case Kind::kNode16:
+                    return 16;
+                case Kind::kNode48:
+                    return 48;
+                case Kind::kNode256:
+                    return 256;
+            }
+            return 0;
+        }
+
+        static size_t _keysCapacity(Kind kind) {
+            switch (kind) {
+                case Kind::kNode4:
+                    return 4;
+                case Kind::kNode16:
+                    return 16;
+                case Kind::kNode48:
+                    return 256;
+                case Kind::kNode256:
+                    return 0;
+            }
+            return 0;
+        }
+
+        static Kind _nextKind(Kind kind) {
+            return kind == Kind::kNode4 ? Kind::kNode16
+                                        : kind == Kind::kNode16 ? Kind::kNode48 : Kind::kNode256;
+        }
+
+        void _allocate(Kind kind) {
+            _kind = kind;
+            const size_t keysCapacity = _keysCapacity(kind);
+            _keys.reset(keysCapacity ? new uint8_t[keysCapacity]() : nullptr);
+            _ptrs.reset(new std::shared_ptr<Node>[_capacity(kind)]);
+        }
+
+        std::shared_ptr<Node>* _find(uint8_t key) const {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16:
+                    for (size_t i = 0; i < _count; ++i) {
+                        if (_keys[i] == key)
+                            return &_ptrs[i];
+                    }
+                    return nullptr;
+                case Kind::kNode48:
+                    return _keys[key] ? &_ptrs[_keys[key] - 1] : nullptr;
+                case Kind::kNode256:
+                    return _ptrs[key] ? &_ptrs[key] : nullptr;
+            }
+            return nullptr;
+        }
+
+        // Adds a child for a key that is not present. There must be room for it.
+        void _insert(uint8_t key, std::shared_ptr<Node> child) {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16: {
+                    size_t pos = _count;
+                    while (pos > 0 && _keys[pos - 1] > key) {
+                        _keys[pos] = _keys[pos - 1];
+                        _ptrs[pos] = std::move(_ptrs[pos - 1]);
+                        --pos;
+                    }
+                    _keys[pos] = key;
+                    _ptrs[pos] = std::move(child);
+                    break;
+                }
+                case Kind::kNode48:
+                    _ptrs[_count] = std::move(child);
+                    _keys[key] = _count + 1;
+                    break;
+                case Kind::kNode256:
+                    _ptrs[key] = std::move(child);
+                    break;
+            }
+            ++_count;
+        }
+
+        void _erase(uint8_t key) {
+            switch (_kind) {
+                case Kind::kNode4:
+                case Kind::kNode16: {
+                    size_t pos = 0;
+                    while (pos < _count && _keys[pos] != key) {
+                        ++pos;
+                    }
+                    if (pos == _count)
+                        return;
+                    for (; pos + 1 < _count; ++pos) {
+                        _keys[pos] = _keys[pos + 1];
+                        _ptrs[pos] = std::move(_ptrs[pos + 1]);
+                    }
+                    _ptrs[_count - 1].reset();
+                    break;
+                }
+                case Kind::kNode48: {
+                    if (!_keys[key])
+                        return;
+                    // Keep the slots dense by moving the last one into the hole.
+                    const size_t hole = _keys[key] - 1;
+                    const size_t last = _count - 1;
+                    if (hole != last) {
+                        _ptrs[hole] = std::move(_ptrs[last]);
+                        for (unsigned other = 0; other < 256; ++other) {
+                            if (_keys[other] == last + 1) {
+                                _keys[other] = hole + 1;
+                                break;
+                            }
+                        }
+                    }
+                    _ptrs[last].reset();
+                    _keys[key] = 0;
+                    break;
+                }
+                case Kind::kNode256:
+                    if (!_ptrs[key])
+                        return;
+                    _ptrs[key].reset();
+                    break;
+            }
+            --_count;
+
+            // Shrink with some slack below each smaller capacity, so that a node hovering around
+            // a boundary doesn't resize on every insert and erase.
+            if (_count == 0) {
+                *this = Children();
+            } else if (_kind == Kind::kNode256 && _count <= 36) {
+                _resize(Kind::kNode48);
+            } else if (_kind == Kind::kNode48 && _count <= 12) {
+                _resize(Kind::kNode16);
+            } else if (_kind == Kind::kNode16 && _count <= 3) {
+                _resize(Kind::kNode4);
+            }
+        }
+
+        void _resize(Kind kind) {
+            Children resized;
+            resized._allocate(kind);
+            forEach([&](uint8_t key, const std::shared_ptr<Node>& child) {
+                resized._insert(key, std::move(const_cast<std::shared_ptr<Node>&>(child)));
+            });
+            *this = std::move(resized);
+        }
+
+        Kind _kind = Kind::kNode4;
+        uint16_t _count = 0;
+        // kNode4 and kNode16: the sorted keys of the children, parallel to '_ptrs'.
+        // kNode48: indexed by key, the position in '_ptrs' plus one, or zero if absent.
+        std::unique_ptr<uint8_t[]> _keys;
+        // kNode256: indexed by key. Otherwise only the first '_count' entries are in use.
+        std::unique_ptr<std::shared_ptr<Node>[]> _ptrs;
+    };
+
     class Node {
         friend class RadixStore;
 
     public:
-        Node() {
-            children.fill(nullptr);
-        }
+        Node() = default;
 
         Node(std::vector<uint8_t> key) : trieKey(key) {
-            children.fill(nullptr);
             _numSubtreeElems = 0;
             _sizeSubtreeElems = 0;
         }
 
-        bool isLeaf() {
-            for (auto child : children) {
-                if (child != nullptr)
-                    return false;
-            }
-            return true;
+        bool isLeaf() const {
+            return children.empty();
         }
 
         void decrement(int sizeOfNode) {
@@ -722,7 +1022,7 @@ private:
 
         std::vector<uint8_t> trieKey;
         boost::optional<value_type> data;
-        std::array<std::shared_ptr<Node>, 256> children;
+        Children children;
 
     private:
         size_type _numSubtreeElems;
@@ -756,11 +1056,9 @@ private:
         }
         ret.push_back('\n');
 
-        for (auto child : node->children) {
-            if (child != nullptr) {
-                ret.append(_walkTree(child.get(), depth + 1));
-            }
-        }
+        node->children.forEach([&](uint8_t, const std::shared_ptr<Node>& child) {
+            ret.append(_walkTree(child.get(), depth + 1));
+        });
         return ret;
     }
 
@@ -779,21 +1077,23 @@ private:
                 return _root.get();
         }
 
+        // Follow raw pointers: the tree can't change under a const lookup, so there is no need to
+        // pay for reference counting every node on the path.
         uint8_t childFirstChar = static_cast<uint8_t>(charKey[depth]);
-        auto node = _root->children[childFirstChar];
+        Node* node = _root->children.get(childFirstChar).get();
 
         while (node != nullptr) {
             size_t mismatchIdx = _comparePrefix(node->trieKey, charKey + depth, key.size() - depth);
             if (mismatchIdx != node->trieKey.size()) {
                 return nullptr;
             } else if (mismatchIdx == key.size() - depth && node->data != boost::none) {
-                return node.get();
+                return node;
             }
 
             depth += node->trieKey.size();
 
             childFirstChar = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[childFirstChar];
+            node = node->children.get(childFirstChar).get();
         }
 
         return nullptr;
@@ -826,7 +1126,7 @@ private:
         int depth = 0;
 
         uint8_t childFirstChar = static_cast<uint8_t>(charKey[depth]);
-        std::shared_ptr<Node> node = _root->children[childFirstChar];
+        std::shared_ptr<Node> node = _root->children.get(childFirstChar);
         std::shared_ptr<Node> old = node;
 
         // Copy root if it is not uniquely owned.
@@ -850,7 +1150,7 @@ private:
                 node = std::make_shared<Node>(*old.get());
                 node->_numSubtreeElems = old->_numSubtreeElems;
                 node->_sizeSubtreeElems = old->_sizeSubtreeElems;
-                prev->children[old->trieKey.front()] = node;
+                prev->children.set(old->trieKey.front(), node);
             }
 
             // 'node' is uniquely owned at this point, so we are free to modify it.
@@ -881,7 +1181,7 @@ private:
 
                 // Change the current node's trieKey and make a child of the new node.
                 newKey = _makeKey(node->trieKey, mismatchIdx, node->trieKey.size() - mismatchIdx);
-                newNode->children[newKey.front()] = node;
+                newNode->children.set(newKey.front(), node);
                 node->trieKey = newKey;
 
                 return std::pair<const_iterator, bool>(it, true);
@@ -905,10 +1205,10 @@ private:
             depth += node->trieKey.size();
             childFirstChar = static_cast<const uint8_t>(charKey[depth]);
             prev = node;
-            node = node->children[childFirstChar];
+            node = node->children.get(childFirstChar);
 
             if (old != nullptr) {
-                old = old->children[childFirstChar];
+                old = old->children.get(childFirstChar);
             }
         }
 
@@ -956,11 +1256,11 @@ private:
             newNode->_numSubtreeElems = 1;
             newNode->_sizeSubtreeElems = value->second.size();
         }
-        if (node->children[key.front()] != nullptr) {
-            newNode->_numSubtreeElems = node->children[key.front()]->_numSubtreeElems;
-            newNode->_sizeSubtreeElems = node->children[key.front()]->_sizeSubtreeElems;
+        if (const auto& existing = node->children.get(key.front())) {
+            newNode->_numSubtreeElems = existing->_numSubtreeElems;
+            newNode->_sizeSubtreeElems = existing->_sizeSubtreeElems;
         }
-        node->children[key.front()] = newNode;
+        node->children.set(key.front(), newNode);
         return newNode;
     }
 
@@ -987,7 +1287,7 @@ private:
 
         while (depth < key.size()) {
             uint8_t c = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[c].get();
+            node = node->children.get(c).get();
             context.push_back(node);
             depth = depth + node->trieKey.size();
         }
@@ -1028,15 +1328,12 @@ private:
         }
 
         // Determine if this node has only one child.
-        std::shared_ptr<Node> onlyChild = nullptr;
-        for (size_t i = 0; i < node->children.size(); ++i) {
-            if (node->children[i] != nullptr) {
-                if (onlyChild != nullptr) {
-                    return;
-                }
-                onlyChild = node->children[i];
-            }
+        if (node->children.size() != 1) {
+            return;
         }
+        // Hold a reference, since replacing this node's children below releases the child.
+        const uint8_t onlyChildKey = node->children.firstChild()->trieKey.front();
+        std::shared_ptr<Node> onlyChild = node->children.get(onlyChildKey);
 
         // Append the child's key onto the parent.
         for (char item : onlyChild->trieKey) {
@@ -1099,7 +1396,7 @@ private:
         for (; idx < context.size(); idx++) {
             node = context[idx];
             newNode = std::make_shared<Node>(*node.get());
-            parent->children[node->trieKey.front()] = newNode;
+            parent->children.set(node->trieKey.front(), newNode);
             parent = newNode;
             context[idx] = newNode;
         }
@@ -1199,12 +1496,26 @@ private:
         // properly update parent nodes in our recursive stack.
         int sizeDelta = 0;
         int numDelta = 0;
+        const size_t depth = context.size();
         context.push_back(current);
 
-        for (unsigned int key = 0; key < 256; ++key) {
-            std::shared_ptr<Node> node = current->children[key];
-            std::shared_ptr<Node> baseNode = base->children[key];
-            std::shared_ptr<Node> otherNode = other->children[key];
+        // Only the keys with a child in at least one of the three trees need to be examined.
+        std::vector<uint8_t> keys = current->children.keys();
+        for (const auto& tree : {base, other}) {
+            auto treeKeys = tree->children.keys();
+            std::vector<uint8_t> merged;
+            std::set_union(keys.begin(),
+                           keys.end(),
+                           treeKeys.begin(),
+                           treeKeys.end(),
+                           std::back_inserter(merged));
+            keys = std::move(merged);
+        }
+
+        for (uint8_t key : keys) {
+            std::shared_ptr<Node> node = current->children.get(key);
+            std::shared_ptr<Node> baseNode = base->children.get(key);
+            std::shared_ptr<Node> otherNode = other->children.get(key);
             bool unique = node != otherNode && node != baseNode;
 
             // If the current tree does not have this node, check if the other trees do.
@@ -1212,11 +1523,11 @@ private:
                 if (baseNode == nullptr && otherNode != nullptr) {
                     // If base and 'this' do NOT have this branch, but other does, then
                     // merge in the other's branch.
-                    sizeDelta += other->children[key]->_sizeSubtreeElems;
-                    numDelta += other->children[key]->_numSubtreeElems;
+                    sizeDelta += otherNode->_sizeSubtreeElems;
+                    numDelta += otherNode->_numSubtreeElems;
 
                     current = _makeBranchUnique(context);
-                    current->children[key] = other->children[key];
+                    current->children.set(key, otherNode);
                 } else if (baseNode != nullptr && otherNode != nullptr && baseNode == otherNode) {
                     // Don't do anything since it means that master + base have a branch
                     // that current does not, indicating that current removed that branch.
@@ -1237,22 +1548,20 @@ private:
                     } else if (baseNode != nullptr && otherNode == nullptr) {
                         // Other has a deleted branch that must also be removed from 'this'
                         // tree.
-                        sizeDelta -= current->children[key]->_sizeSubtreeElems;
-                        numDelta -= current->children[key]->_numSubtreeElems;
+                        sizeDelta -= node->_sizeSubtreeElems;
+                        numDelta -= node->_numSubtreeElems;
 
                         current = _makeBranchUnique(context);
-                        current->children[key] = nullptr;
+                        current->children.set(key, nullptr);
 
                     } else if (baseNode != nullptr && otherNode != nullptr && baseNode == node) {
                         // If other and current point to the same node, then master changed
                         // something.
-                        sizeDelta += other->children[key]->_sizeSubtreeElems -
-                            current->children[key]->_sizeSubtreeElems;
-                        numDelta += other->children[key]->_numSubtreeElems -
-                            current->children[key]->_numSubtreeElems;
+                        sizeDelta += otherNode->_sizeSubtreeElems - node->_sizeSubtreeElems;
+                        numDelta += otherNode->_numSubtreeElems - node->_numSubtreeElems;
 
                         current = _makeBranchUnique(context);
-                        current->children[key] = other->children[key];
+                        current->children.set(key, otherNode);
                     }
                 } else {
                     // current node is a unique pointer
@@ -1277,6 +1586,11 @@ private:
                                 _merge3Helper(node, baseNode, otherNode, context);
                             numDelta += diff.first;
                             sizeDelta += diff.second;
+
+                            // The recursive merge may have copied this branch to make it unique,
+                            // in which case 'current' is no longer the node in the tree.
+                            current = context[depth];
+                            context.resize(depth + 1);
                         } else {
                             _mergeHandleConflict(node, baseNode, otherNode);
                         }
@@ -1299,20 +1613,15 @@ private:
         return std::make_pair(numDelta, sizeDelta);
     }
 
-    Node* _begin(const std::shared_ptr<Node> root) const noexcept {
-        auto node = root;
+    Node* _begin(const std::shared_ptr<Node>& root) const noexcept {
+        Node* node = root.get();
         while (node->data == boost::none) {
             if (node->children.empty())
                 return nullptr;
 
-            for (auto child : node->children) {
-                if (child != nullptr) {
-                    node = child;
-                    break;
-                }
-            }
+            node = node->children.firstChild();
         }
-        return node.get();
+        return node;
     }
 
     std::shared_ptr<Node> _root;
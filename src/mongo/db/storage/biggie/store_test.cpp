@@ -1647,6 +1647,88 @@ TEST_F(RadixStoreTest, PathCompressionTest) {
               "\n food*"
               "\n  ie*\n");
 }
+
+TEST_F(RadixStoreTest, WideNodeGrowAndShrinkTest) {
+    // Give a single node every possible child, so that it passes through each child layout on the
+    // way up, then remove them again in an interleaved order on the way down.
+    for (int c = 255; c >= 0; --c) {
+        std::string key = "a" + std::string(1, static_cast<char>(c));
+        thisStore.insert(value_type(key, std::to_string(c)));
+    }
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(256));
+
+    int expectedChar = 0;
+    for (auto iter = thisStore.begin(); iter != thisStore.end(); ++iter, ++expectedChar) {
+        ASSERT_EQ(iter->second, std::to_string(expectedChar));
+    }
+    ASSERT_EQ(expectedChar, 256);
+
+    expectedChar = 255;
+    for (auto iter = thisStore.rbegin(); iter != thisStore.rend(); ++iter, --expectedChar) {
+        ASSERT_EQ(iter->second, std::to_string(expectedChar));
+    }
+    ASSERT_EQ(expectedChar, -1);
+
+    for (int c = 0; c < 256; c += 2) {
+        ASSERT_EQ(thisStore.erase("a" + std::string(1, static_cast<char>(c))),
+                  StringStore::size_type(1));
+    }
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(128));
+
+    for (int c = 1; c < 256; c += 2) {
+        std::string key = "a" + std::string(1, static_cast<char>(c));
+        auto iter = thisStore.find(key);
+        ASSERT_TRUE(iter != thisStore.end());
+        ASSERT_EQ(iter->second, std::to_string(c));
+
+        auto lower = thisStore.lower_bound("a" + std::string(1, static_cast<char>(c - 1)));
+        ASSERT_TRUE(lower == iter);
+    }
+
+    for (int c = 1; c < 253; c += 2) {
+        thisStore.erase("a" + std::string(1, static_cast<char>(c)));
+    }
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(2));
+
+    // With a single child left, the node is compressed into it.
+    thisStore.erase("a" + std::string(1, static_cast<char>(253)));
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(1));
+    ASSERT_EQ(thisStore.begin()->first, "a" + std::string(1, static_cast<char>(255)));
+    ASSERT_EQ(thisStore.to_string_for_test(), "\n a\xFF*\n");
+}
+
+TEST_F(RadixStoreTest, MergeWideNodesTest) {
+    for (int c = 0; c < 64; ++c) {
+        baseStore.insert(value_type("k" + std::string(1, static_cast<char>(c * 4)), "base"));
+    }
+    thisStore = baseStore;
+    otherStore = baseStore;
+
+    // Both sides add disjoint children to the shared node, and each removes some of the originals.
+    for (int c = 0; c < 64; ++c) {
+        thisStore.insert(value_type("k" + std::string(1, static_cast<char>(c * 4 + 1)), "this"));
+        otherStore.insert(value_type("k" + std::string(1, static_cast<char>(c * 4 + 2)), "other"));
+    }
+    for (int c = 0; c < 16; ++c) {
+        thisStore.erase("k" + std::string(1, static_cast<char>(c * 4)));
+        otherStore.erase("k" + std::string(1, static_cast<char>((c + 48) * 4)));
+    }
+
+    thisStore.merge3(baseStore, otherStore);
+
+    expected = baseStore;
+    for (int c = 0; c < 64; ++c) {
+        expected.insert(value_type("k" + std::string(1, static_cast<char>(c * 4 + 1)), "this"));
+        expected.insert(value_type("k" + std::string(1, static_cast<char>(c * 4 + 2)), "other"));
+    }
+    for (int c = 0; c < 16; ++c) {
+        expected.erase("k" + std::string(1, static_cast<char>(c * 4)));
+        expected.erase("k" + std::string(1, static_cast<char>((c + 48) * 4)));
+    }
+
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(160));
+    ASSERT_TRUE(thisStore == expected);
+}
 }  // namespace
 }  // mongo namespace
 }  // biggie namespace
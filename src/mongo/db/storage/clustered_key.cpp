@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_key.h"
+
+#include <cmath>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/mongoutils/str.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
+
+namespace mongo {
+namespace clusteredkey {
+
+MONGO_FAIL_POINT_DEFINE(clusteredKeyHashAlwaysCollides);
+
+namespace {
+// Integral _id values in [-kMaxIntegral, kMaxIntegral) are stored at RecordIds [1, 2^62].
+const int64_t kMaxIntegral = 1LL << 61;
+
+// Every other _id is stored at a RecordId in [kFirstHashedRepr, RecordId::kMinReservedRepr), at
+// most kNumHashedCandidates - 1 past the one its hash maps to.
+const int64_t kFirstHashedRepr = (1LL << 62) + 1;
+const int kNumHashedCandidates = 4;
+const uint64_t kNumHashedReprs =
+    RecordId::kMinReservedRepr - kFirstHashedRepr - (kNumHashedCandidates - 1);
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+/**
+ * Returns the value of 'id' if it is an integral number in the range that maps one-to-one.
+ */
+boost::optional<int64_t> integralValue(const BSONElement& id) {
+    switch (id.type()) {
+        case NumberInt:
+            return static_cast<int64_t>(id._numberInt());
+        case NumberLong: {
+            const int64_t value = id._numberLong();
+            if (value >= -kMaxIntegral && value < kMaxIntegral)
+                return value;
+            return boost::none;
+        }
+        case NumberDouble: {
+            const double value = id._numberDouble();
+            if (std::trunc(value) == value && value >= -kMaxIntegral && value < kMaxIntegral)
+                return static_cast<int64_t>(value);
+            return boost::none;
+        }
+        case NumberDecimal: {
+            std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+            const int64_t value = id._numberDecimal().toLongExact(&signalingFlags);
+            if (signalingFlags == Decimal128::SignalingFlag::kNoFlag && value >= -kMaxIntegral &&
+                value < kMaxIntegral)
+                return value;
+            return boost::none;
+        }
+        default:
+            return boost::none;
+    }
+}
+}  // namespace
+
+StatusWith<RecordId> keyForId(const BSONElement& id) {
+    if (id.type() == Array || id.type() == RegEx || id.type() == Undefined)
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id in a clustered collection cannot be of type "
+                              << typeName(id.type())};
+
+    if (auto value = integralValue(id))
+        return RecordId(*value + kMaxIntegral + 1);
+
+    if (MONGO_FAIL_POINT(clusteredKeyHashAlwaysCollides))
+        return RecordId(kFirstHashedRepr);
+
+    // Numbers that compare equal have the same KeyString, whatever their type, so the hash
+    // agrees with _id equality. The hash is persisted, so it is read in a fixed byte order.
+    BSONObjBuilder builder;
+    builder.appendAs(id, "");
+    const KeyString ks(KeyString::Version::V1, builder.done(), kAllAscending);
+    char hash[16];
+    MurmurHash3_x64_128(ks.getBuffer(), ks.getSize(), 0, hash);
+    const uint64_t hashValue = ConstDataView(hash).read<LittleEndian<uint64_t>>();
+    return RecordId(kFirstHashedRepr + static_cast<int64_t>(hashValue % kNumHashedReprs));
+}
+
+int numCandidateKeys(const RecordId& key) {
+    return isHashedKey(key) ? kNumHashedCandidates : 1;
+}
+
+RecordId findKey(SeekableRecordCursor* cursor, const BSONElement& id) {
+    auto swKey = keyForId(id);
+    if (!swKey.isOK())
+        return RecordId();
+
+    const RecordId key = swKey.getValue();
+    for (int i = 0; i < numCandidateKeys(key); i++) {
+        const RecordId candidate(key.repr() + i);
+        auto record = cursor->seekExact(candidate);
+        if (record && idMatches(record->data.toBson(), id))
+            return candidate;
+    }
+    return RecordId();
+}
+
+bool idMatches(const BSONObj& doc, const BSONElement& id) {
+    const BSONElement docId = doc["_id"];
+    return !docId.eoo() && docId.woCompare(id, 0 /* ignore field names */) == 0;
+}
+
+bool isHashedKey(const RecordId& key) {
+    return key.repr() >= kFirstHashedRepr;
+}
+
+StatusWith<RecordId> extractKey(const char* data, int len) {
+    DEV invariant(validateBSON(data, len, BSONVersion::kLatest).isOK());
+
+    const BSONElement elem = BSONObj(data)["_id"];
+    if (elem.eoo())
+        return {ErrorCodes::BadValue, "no _id field"};
+
+    return keyForId(elem);
+}
+
+}  // namespace clusteredkey
+}  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/util/fail_point_service.h"
+
+namespace mongo {
+class BSONElement;
+class BSONObj;
+class RecordId;
+class SeekableRecordCursor;
+
+namespace clusteredkey {
+
+// Maps every hashed _id to the same RecordId, to test collisions.
+MONGO_FAIL_POINT_DECLARE(clusteredKeyHashAlwaysCollides);
+
+/**
+ * Converts the _id of a document in a clustered collection into the RecordId that the document is
+ * stored under. _id values that compare equal, such as NumberInt(5), NumberLong(5) and 5.0, map to
+ * the same RecordId.
+ *
+ * RecordIds are 64-bit, so only integral numbers of magnitude below 2^61 are mapped one-to-one,
+ * preserving their order. Every other _id, such as an ObjectId or a string, is mapped to a hash
+ * of its KeyString in a higher part of the RecordId range. Distinct _id values can then collide,
+ * so such a document is stored under the first free one of numCandidateKeys() RecordIds starting
+ * at the returned one, and lookups go through findKey().
+ *
+ * Fails with BadValue for values that can't be an _id, such as arrays.
+ */
+StatusWith<RecordId> keyForId(const BSONElement& id);
+
+/**
+ * Returns the number of successive RecordIds, starting at 'key' as returned by keyForId(), that
+ * may hold the document with that _id. Deleting a document frees its RecordId without moving the
+ * others, so a lookup must check all of them.
+ */
+int numCandidateKeys(const RecordId& key);
+
+/**
+ * Returns the RecordId of the document with _id 'id', reading through 'cursor' on a clustered
+ * collection, or a null RecordId if there is no such document.
+ */
+RecordId findKey(SeekableRecordCursor* cursor, const BSONElement& id);
+
+/**
+ * Returns true if 'id' is the _id that 'doc' was stored under, as opposed to another _id with the
+ * same hash.
+ */
+bool idMatches(const BSONObj& doc, const BSONElement& id);
+
+/**
+ * Returns true if 'key' was derived from a hash of the _id rather than from its value.
+ */
+bool isHashedKey(const RecordId& key);
+
+/**
+ * data and len must be the arguments from RecordStore::insert() on a clustered collection.
+ */
+StatusWith<RecordId> extractKey(const char* data, int len);
+
+}  // namespace clusteredkey
+}  // namespace mongo
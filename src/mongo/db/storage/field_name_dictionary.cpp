@@ -0,0 +1,245 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/field_name_dictionary.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+constexpr int FieldNameDictionary::kFormatVersion;
+constexpr size_t FieldNameDictionary::kMaxNames;
+
+namespace {
+
+const StringData kTokenAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"_sd;
+const char kVerbatimPrefix = '_';
+
+bool isAllDigits(StringData name) {
+    if (name.empty()) {
+        return false;
+    }
+    for (char c : name) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string makeToken(uint32_t id) {
+    std::string token;
+    do {
+        token.push_back(kTokenAlphabet[id % kTokenAlphabet.size()]);
+        id /= kTokenAlphabet.size();
+    } while (id > 0);
+    return token;
+}
+
+uint32_t parseToken(StringData token) {
+    uint64_t id = 0;
+    uint64_t scale = 1;
+    for (char c : token) {
+        const size_t digit = kTokenAlphabet.find(c);
+        uassert(50940,
+                str::stream() << "Invalid field name token '" << token << "' in compact record",
+                digit != std::string::npos && scale <= FieldNameDictionary::kMaxNames);
+        id += digit * scale;
+        scale *= kTokenAlphabet.size();
+    }
+    return static_cast<uint32_t>(id);
+}
+
+}  // namespace
+
+FieldNameDictionary::FieldNameDictionary(std::vector<std::string> names) {
+    auto initial = std::make_shared<Names>();
+    for (auto&& name : names) {
+        initial->tokens[name] = static_cast<uint32_t>(initial->byToken.size());
+        initial->byToken.push_back(std::move(name));
+    }
+    _names = std::move(initial);
+}
+
+std::shared_ptr<const FieldNameDictionary::Names> FieldNameDictionary::_getNames() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _names;
+}
+
+std::vector<std::string> FieldNameDictionary::getNames() const {
+    return _getNames()->byToken;
+}
+
+size_t FieldNameDictionary::size() const {
+    return _getNames()->byToken.size();
+}
+
+boost::optional<uint32_t> FieldNameDictionary::_addName(StringData name,
+                                                        std::shared_ptr<const Names>* names) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _names->tokens.find(name);
+    if (it != _names->tokens.end()) {
+        *names = _names;
+        return it->second;
+    }
+    if (_names->byToken.size() >= kMaxNames) {
+        *names = _names;
+        return boost::none;
+    }
+
+    auto updated = std::make_shared<Names>(*_names);
+    const uint32_t token = static_cast<uint32_t>(updated->byToken.size());
+    updated->byToken.push_back(name.toString());
+    updated->tokens[name] = token;
+    _names = updated;
+    *names = std::move(updated);
+    return token;
+}
+
+BSONObj FieldNameDictionary::encode(const BSONObj& obj, size_t* namesNeeded) {
+    auto names = _getNames();
+    *namesNeeded = 0;
+    BSONObjBuilder builder;
+    _encodeObject(obj, false, &builder, &names, namesNeeded);
+    return builder.obj();
+}
+
+void FieldNameDictionary::_encodeObject(const BSONObj& obj,
+                                        bool isArray,
+                                        BSONObjBuilder* builder,
+                                        std::shared_ptr<const Names>* names,
+                                        size_t* namesNeeded) {
+    for (auto&& elem : obj) {
+        const StringData name = elem.fieldNameStringData();
+
+        std::string encodedName;
+        if (isArray || isAllDigits(name)) {
+            encodedName = name.toString();
+        } else {
+            boost::optional<uint32_t> token;
+            auto it = (*names)->tokens.find(name);
+            if (it != (*names)->tokens.end()) {
+                token = it->second;
+            } else {
+                token = _addName(name, names);
+            }
+
+            if (token) {
+                encodedName = makeToken(*token);
+                *namesNeeded = std::max(*namesNeeded, static_cast<size_t>(*token) + 1);
+            } else {
+                encodedName = kVerbatimPrefix + name.toString();
+            }
+        }
+
+        if (elem.type() == Object) {
+            BSONObjBuilder sub(builder->subobjStart(encodedName));
+            _encodeObject(elem.Obj(), false, &sub, names, namesNeeded);
+        } else if (elem.type() == Array) {
+            BSONObjBuilder sub(builder->subarrayStart(encodedName));
+            _encodeObject(elem.Obj(), true, &sub, names, namesNeeded);
+        } else {
+            builder->appendAs(elem, encodedName);
+        }
+    }
+}
+
+BSONObj FieldNameDictionary::decode(const BSONObj& compact) const {
+    auto names = _getNames();
+    BSONObjBuilder builder;
+    _decodeObject(compact, false, &builder, *names);
+    return builder.obj();
+}
+
+void FieldNameDictionary::_decodeObject(const BSONObj& compact,
+                                        bool isArray,
+                                        BSONObjBuilder* builder,
+                                        const Names& names) const {
+    for (auto&& elem : compact) {
+        StringData name = elem.fieldNameStringData();
+        if (!isArray && !name.empty()) {
+            if (name[0] == kVerbatimPrefix) {
+                name = name.substr(1);
+            } else if (!isAllDigits(name)) {
+                const uint32_t token = parseToken(name);
+                uassert(50941,
+                        str::stream() << "Field name token '" << name
+                                      << "' is not in the dictionary",
+                        token < names.byToken.size());
+                name = names.byToken[token];
+            }
+        }
+
+        if (elem.type() == Object) {
+            BSONObjBuilder sub(builder->subobjStart(name));
+            _decodeObject(elem.Obj(), false, &sub, names);
+        } else if (elem.type() == Array) {
+            BSONObjBuilder sub(builder->subarrayStart(name));
+            _decodeObject(elem.Obj(), true, &sub, names);
+        } else {
+            builder->appendAs(elem, name);
+        }
+    }
+}
+
+boost::optional<std::string> FieldNameDictionary::encodePath(StringData path) const {
+    auto names = _getNames();
+    const bool isFull = names->byToken.size() >= kMaxNames;
+
+    FieldRef fieldRef(path);
+    std::string encoded;
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        const StringData part = fieldRef.getPart(i);
+        if (i > 0) {
+            encoded.push_back('.');
+        }
+
+        if (isAllDigits(part)) {
+            encoded.append(part.rawData(), part.size());
+            continue;
+        }
+
+        auto it = names->tokens.find(part);
+        if (it != names->tokens.end()) {
+            encoded.append(makeToken(it->second));
+        } else if (isFull) {
+            encoded.push_back(kVerbatimPrefix);
+            encoded.append(part.rawData(), part.size());
+        } else {
+            return boost::none;
+        }
+    }
+    return encoded;
+}
+
+}  // namespace mongo
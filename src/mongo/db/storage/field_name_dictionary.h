@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A per-collection dictionary mapping field names to short tokens, used to store documents in a
+ * compact form in which every field name is replaced by its token.
+ *
+ * Tokens are strings of ASCII letters, encoding the position of the name in the dictionary. Field
+ * names consisting only of digits, such as array indexes, are stored as-is, so that a path through
+ * an encoded document keeps its meaning when one of its components is numeric. Once the dictionary
+ * holds kMaxNames names, any new name is stored as '_' followed by the name.
+ *
+ * The compact form is itself valid BSON with the same structure and field order as the original
+ * document, so a MatchExpression whose paths have been translated with encodePath(), and whose
+ * operands contain no field names, can be evaluated directly against it.
+ *
+ * Names are only ever added, so a token keeps its meaning for the lifetime of the collection. All
+ * methods are thread-safe.
+ */
+class FieldNameDictionary {
+public:
+    /**
+     * Version of the record format, stored in the catalog entry of collections using it.
+     */
+    static constexpr int kFormatVersion = 1;
+
+    static constexpr size_t kMaxNames = 4096;
+
+    explicit FieldNameDictionary(std::vector<std::string> names = {});
+
+    /**
+     * Returns the compact form of 'obj', adding names not seen before to the dictionary. Sets
+     * 'namesNeeded' to the number of dictionary names needed to decode the result.
+     */
+    BSONObj encode(const BSONObj& obj, size_t* namesNeeded);
+
+    /**
+     * Returns the document whose compact form is 'compact'. Throws if 'compact' uses a token which
+     * is not in the dictionary.
+     */
+    BSONObj decode(const BSONObj& compact) const;
+
+    /**
+     * Returns the dotted path which addresses, in compact documents, what 'path' addresses in the
+     * original ones. Returns boost::none if a component of 'path' has not been seen yet, since it
+     * might be given a token at any time.
+     */
+    boost::optional<std::string> encodePath(StringData path) const;
+
+    /**
+     * Returns the names in the dictionary, in token order.
+     */
+    std::vector<std::string> getNames() const;
+
+    size_t size() const;
+
+private:
+    struct Names {
+        std::vector<std::string> byToken;
+        StringMap<uint32_t> tokens;
+    };
+
+    std::shared_ptr<const Names> _getNames() const;
+
+    // Returns the token for 'name', adding it to the dictionary if needed, or boost::none if the
+    // dictionary is full. Updates 'names' to the latest version of the dictionary.
+    boost::optional<uint32_t> _addName(StringData name, std::shared_ptr<const Names>* names);
+
+    void _encodeObject(const BSONObj& obj,
+                       bool isArray,
+                       BSONObjBuilder* builder,
+                       std::shared_ptr<const Names>* names,
+                       size_t* namesNeeded);
+
+    void _decodeObject(const BSONObj& compact,
+                       bool isArray,
+                       BSONObjBuilder* builder,
+                       const Names& names) const;
+
+    // Guards '_names'. The Names themselves are immutable: adding a name swaps in a new copy, so
+    // that encoding and decoding never hold the mutex while traversing a document.
+    mutable stdx::mutex _mutex;
+    std::shared_ptr<const Names> _names;
+};
+
+}  // namespace mongo
@@ -0,0 +1,341 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/field_name_dictionary_record_store.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+RecordData toRecordData(BSONObj obj) {
+    const int size = obj.objsize();
+    return RecordData(obj.releaseSharedBuffer().constCast(), size);
+}
+
+RecordData decodeRecordData(const FieldNameDictionary& dictionary, const RecordData& compact) {
+    return toRecordData(dictionary.decode(compact.toBson()));
+}
+
+/**
+ * Decodes the records returned by a cursor over the compact documents. A cursor created from a
+ * plain RecordCursor must not be used to seek.
+ */
+class DecodingRecordCursor final : public SeekableRecordCursor {
+public:
+    DecodingRecordCursor(const FieldNameDictionary& dictionary,
+                         std::unique_ptr<RecordCursor> cursor,
+                         SeekableRecordCursor* seekable)
+        : _dictionary(dictionary), _cursor(std::move(cursor)), _seekable(seekable) {}
+
+    boost::optional<Record> next() final {
+        return _decode(_cursor->next());
+    }
+
+    boost::optional<Record> seekExact(const RecordId& id) final {
+        invariant(_seekable);
+        return _decode(_seekable->seekExact(id));
+    }
+
+    void save() final {
+        _cursor->save();
+    }
+
+    void saveUnpositioned() final {
+        if (_seekable) {
+            _seekable->saveUnpositioned();
+        } else {
+            _cursor->save();
+        }
+    }
+
+    bool restore() final {
+        return _cursor->restore();
+    }
+
+    void detachFromOperationContext() final {
+        _cursor->detachFromOperationContext();
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _cursor->reattachToOperationContext(opCtx);
+    }
+
+    void invalidate(OperationContext* opCtx, const RecordId& id) final {
+        _cursor->invalidate(opCtx, id);
+    }
+
+    std::unique_ptr<RecordFetcher> fetcherForNext() const final {
+        return _cursor->fetcherForNext();
+    }
+
+    std::unique_ptr<RecordFetcher> fetcherForId(const RecordId& id) const final {
+        return _seekable ? _seekable->fetcherForId(id) : nullptr;
+    }
+
+private:
+    boost::optional<Record> _decode(boost::optional<Record> record) const {
+        if (record) {
+            record->data = decodeRecordData(_dictionary, record->data);
+        }
+        return record;
+    }
+
+    const FieldNameDictionary& _dictionary;
+    std::unique_ptr<RecordCursor> _cursor;
+    SeekableRecordCursor* _seekable;
+};
+
+std::unique_ptr<RecordCursor> decodingCursor(const FieldNameDictionary& dictionary,
+                                             std::unique_ptr<RecordCursor> cursor) {
+    if (!cursor) {
+        return {};
+    }
+    return stdx::make_unique<DecodingRecordCursor>(dictionary, std::move(cursor), nullptr);
+}
+
+class DecodingValidateAdaptor final : public ValidateAdaptor {
+public:
+    DecodingValidateAdaptor(const FieldNameDictionary& dictionary, ValidateAdaptor* adaptor)
+        : _dictionary(dictionary), _adaptor(adaptor) {}
+
+    Status validate(const RecordId& recordId,
+                    const RecordData& recordData,
+                    size_t* dataSize) final {
+        RecordData decoded;
+        try {
+            decoded = decodeRecordData(_dictionary, recordData);
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return _adaptor->validate(recordId, decoded, dataSize);
+    }
+
+private:
+    const FieldNameDictionary& _dictionary;
+    ValidateAdaptor* _adaptor;
+};
+
+class DecodingCompactAdaptor final : public RecordStoreCompactAdaptor {
+public:
+    DecodingCompactAdaptor(const FieldNameDictionary& dictionary,
+                           RecordStoreCompactAdaptor* adaptor)
+        : _dictionary(dictionary), _adaptor(adaptor) {}
+
+    bool isDataValid(const RecordData& recData) final {
+        try {
+            return _adaptor->isDataValid(decodeRecordData(_dictionary, recData));
+        } catch (const DBException&) {
+            return false;
+        }
+    }
+
+    size_t dataSize(const RecordData& recData) final {
+        return recData.size();
+    }
+
+    void inserted(const RecordData& recData, const RecordId& newLocation) final {
+        _adaptor->inserted(decodeRecordData(_dictionary, recData), newLocation);
+    }
+
+private:
+    const FieldNameDictionary& _dictionary;
+    RecordStoreCompactAdaptor* _adaptor;
+};
+
+}  // namespace
+
+FieldNameDictionaryRecordStore::FieldNameDictionaryRecordStore(
+    std::unique_ptr<RecordStore> recordStore,
+    std::vector<std::string> names,
+    PersistNamesFn persistNames)
+    : RecordStore(recordStore->ns()),
+      _rs(std::move(recordStore)),
+      _dictionary(std::move(names)),
+      _persistNames(std::move(persistNames)),
+      _numPersisted(_dictionary.size()) {}
+
+BSONObj FieldNameDictionaryRecordStore::_encode(OperationContext* opCtx, const BSONObj& obj) {
+    size_t namesNeeded = 0;
+    BSONObj compact = _dictionary.encode(obj, &namesNeeded);
+    if (namesNeeded <= _numPersisted.load()) {
+        return compact;
+    }
+
+    // Persist every name known so far, so that the persisted names are always a prefix of the
+    // dictionary.
+    const auto names = _dictionary.getNames();
+    _persistNames(opCtx, names);
+    const unsigned long long numNames = names.size();
+    opCtx->recoveryUnit()->onCommit([this, numNames](boost::optional<Timestamp>) {
+        auto current = _numPersisted.load();
+        while (current < numNames) {
+            const auto previous = _numPersisted.compareAndSwap(current, numNames);
+            if (previous == current) {
+                break;
+            }
+            current = previous;
+        }
+    });
+    return compact;
+}
+
+bool FieldNameDictionaryRecordStore::findRecord(OperationContext* opCtx,
+                                                const RecordId& loc,
+                                                RecordData* out) const {
+    RecordData compact;
+    if (!_rs->findRecord(opCtx, loc, &compact)) {
+        return false;
+    }
+    *out = decodeRecordData(_dictionary, compact);
+    return true;
+}
+
+StatusWith<RecordId> FieldNameDictionaryRecordStore::insertRecord(OperationContext* opCtx,
+                                                                  const char* data,
+                                                                  int len,
+                                                                  Timestamp timestamp) {
+    BSONObj compact = _encode(opCtx, BSONObj(data));
+    return _rs->insertRecord(opCtx, compact.objdata(), compact.objsize(), timestamp);
+}
+
+Status FieldNameDictionaryRecordStore::insertRecords(OperationContext* opCtx,
+                                                     std::vector<Record>* records,
+                                                     std::vector<Timestamp>* timestamps) {
+    std::vector<BSONObj> compacts;
+    std::vector<Record> compactRecords;
+    compacts.reserve(records->size());
+    compactRecords.reserve(records->size());
+    for (auto&& record : *records) {
+        compacts.push_back(_encode(opCtx, record.data.toBson()));
+        compactRecords.push_back(
+            Record{RecordId(), RecordData(compacts.back().objdata(), compacts.back().objsize())});
+    }
+
+    Status status = _rs->insertRecords(opCtx, &compactRecords, timestamps);
+    if (!status.isOK()) {
+        return status;
+    }
+    for (size_t i = 0; i < records->size(); ++i) {
+        (*records)[i].id = compactRecords[i].id;
+    }
+    return Status::OK();
+}
+
+Status FieldNameDictionaryRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
+                                                                  const DocWriter* const* docs,
+                                                                  const Timestamp* timestamps,
+                                                                  size_t nDocs,
+                                                                  RecordId* idsOut) {
+    // The compact form can only be computed from the whole document, so the documents are built
+    // in a temporary buffer rather than in place.
+    std::vector<Record> records;
+    std::vector<Timestamp> recordTimestamps(timestamps, timestamps + nDocs);
+    records.reserve(nDocs);
+    for (size_t i = 0; i < nDocs; ++i) {
+        const size_t size = docs[i]->documentSize();
+        auto buffer = SharedBuffer::allocate(size);
+        docs[i]->writeDocument(buffer.get());
+        records.push_back(Record{RecordId(), RecordData(std::move(buffer), size)});
+    }
+
+    Status status = insertRecords(opCtx, &records, &recordTimestamps);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (idsOut) {
+        for (size_t i = 0; i < nDocs; ++i) {
+            idsOut[i] = records[i].id;
+        }
+    }
+    return Status::OK();
+}
+
+Status FieldNameDictionaryRecordStore::updateRecord(OperationContext* opCtx,
+                                                    const RecordId& oldLocation,
+                                                    const char* data,
+                                                    int len,
+                                                    UpdateNotifier* notifier) {
+    BSONObj compact = _encode(opCtx, BSONObj(data));
+    return _rs->updateRecord(opCtx, oldLocation, compact.objdata(), compact.objsize(), notifier);
+}
+
+std::unique_ptr<SeekableRecordCursor> FieldNameDictionaryRecordStore::getCursor(
+    OperationContext* opCtx, bool forward) const {
+    auto cursor = _rs->getCursor(opCtx, forward);
+    auto seekable = cursor.get();
+    return stdx::make_unique<DecodingRecordCursor>(_dictionary, std::move(cursor), seekable);
+}
+
+std::unique_ptr<RecordCursor> FieldNameDictionaryRecordStore::getCursorForRepair(
+    OperationContext* opCtx) const {
+    return decodingCursor(_dictionary, _rs->getCursorForRepair(opCtx));
+}
+
+std::unique_ptr<RecordCursor> FieldNameDictionaryRecordStore::getRandomCursor(
+    OperationContext* opCtx) const {
+    return decodingCursor(_dictionary, _rs->getRandomCursor(opCtx));
+}
+
+Status FieldNameDictionaryRecordStore::compact(OperationContext* opCtx,
+                                               RecordStoreCompactAdaptor* adaptor,
+                                               const CompactOptions* options,
+                                               CompactStats* stats) {
+    if (!adaptor) {
+        return _rs->compact(opCtx, nullptr, options, stats);
+    }
+    DecodingCompactAdaptor decodingAdaptor(_dictionary, adaptor);
+    return _rs->compact(opCtx, &decodingAdaptor, options, stats);
+}
+
+Status FieldNameDictionaryRecordStore::validate(OperationContext* opCtx,
+                                                ValidateCmdLevel level,
+                                                ValidateAdaptor* adaptor,
+                                                ValidateResults* results,
+                                                BSONObjBuilder* output) {
+    DecodingValidateAdaptor decodingAdaptor(_dictionary, adaptor);
+    return _rs->validate(opCtx, level, &decodingAdaptor, results, output);
+}
+
+void FieldNameDictionaryRecordStore::appendCustomStats(OperationContext* opCtx,
+                                                       BSONObjBuilder* result,
+                                                       double scale) const {
+    _rs->appendCustomStats(opCtx, result, scale);
+    BSONObjBuilder dictionaryStats(result->subobjStart("fieldNameDictionary"));
+    dictionaryStats.append("version", FieldNameDictionary::kFormatVersion);
+    dictionaryStats.append("names", static_cast<long long>(_dictionary.size()));
+    dictionaryStats.append("persistedNames", static_cast<long long>(_numPersisted.load()));
+}
+
+}  // namespace mongo
@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/storage/field_name_dictionary.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * A RecordStore storing documents in the compact form produced by a FieldNameDictionary, on top of
+ * a storage engine RecordStore.
+ *
+ * Callers see the original documents: writes are encoded, and reads through findRecord() and the
+ * cursors are decoded. Collection scans may instead read the compact documents directly through
+ * getCompactCursor(), and only decode the ones they return.
+ *
+ * New names are persisted, through the callback given on construction, in the same storage
+ * transaction as the first write which uses them. Names added by a transaction which rolls back
+ * remain in the in-memory dictionary, and are persisted along with any later write using them.
+ */
+class FieldNameDictionaryRecordStore final : public RecordStore {
+public:
+    using PersistNamesFn =
+        std::function<void(OperationContext* opCtx, const std::vector<std::string>& names)>;
+
+    FieldNameDictionaryRecordStore(std::unique_ptr<RecordStore> recordStore,
+                                   std::vector<std::string> names,
+                                   PersistNamesFn persistNames);
+
+    const FieldNameDictionary& getDictionary() const {
+        return _dictionary;
+    }
+
+    /**
+     * Returns a cursor over the compact documents.
+     */
+    std::unique_ptr<SeekableRecordCursor> getCompactCursor(OperationContext* opCtx,
+                                                           bool forward = true) const {
+        return _rs->getCursor(opCtx, forward);
+    }
+
+    const char* name() const override {
+        return _rs->name();
+    }
+
+    const std::string& ns() const override {
+        return _rs->ns();
+    }
+
+    const std::string& getIdent() const override {
+        return _rs->getIdent();
+    }
+
+    long long dataSize(OperationContext* opCtx) const override {
+        return _rs->dataSize(opCtx);
+    }
+
+    long long numRecords(OperationContext* opCtx) const override {
+        return _rs->numRecords(opCtx);
+    }
+
+    bool isCapped() const override {
+        return _rs->isCapped();
+    }
+
+    int64_t storageSize(OperationContext* opCtx,
+                        BSONObjBuilder* extraInfo = NULL,
+                        int infoLevel = 0) const override {
+        return _rs->storageSize(opCtx, extraInfo, infoLevel);
+    }
+
+    bool findRecord(OperationContext* opCtx, const RecordId& loc, RecordData* out) const override;
+
+    void deleteRecord(OperationContext* opCtx, const RecordId& dl) override {
+        _rs->deleteRecord(opCtx, dl);
+    }
+
+    StatusWith<RecordId> insertRecord(OperationContext* opCtx,
+                                      const char* data,
+                                      int len,
+                                      Timestamp timestamp) override;
+
+    Status insertRecords(OperationContext* opCtx,
+                         std::vector<Record>* records,
+                         std::vector<Timestamp>* timestamps) override;
+
+    Status insertRecordsWithDocWriter(OperationContext* opCtx,
+                                      const DocWriter* const* docs,
+                                      const Timestamp* timestamps,
+                                      size_t nDocs,
+                                      RecordId* idsOut = nullptr) override;
+
+    Status updateRecord(OperationContext* opCtx,
+                        const RecordId& oldLocation,
+                        const char* data,
+                        int len,
+                        UpdateNotifier* notifier) override;
+
+    /**
+     * Damages computed against a decoded document do not apply to its compact form.
+     */
+    bool updateWithDamagesSupported() const override {
+        return false;
+    }
+
+    StatusWith<RecordData> updateWithDamages(OperationContext* opCtx,
+                                             const RecordId& loc,
+                                             const RecordData& oldRec,
+                                             const char* damageSource,
+                                             const mutablebson::DamageVector& damages) override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
+                                                    bool forward = true) const override;
+
+    std::unique_ptr<RecordCursor> getCursorForRepair(OperationContext* opCtx) const override;
+
+    std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* opCtx) const override;
+
+    Status truncate(OperationContext* opCtx) override {
+        return _rs->truncate(opCtx);
+    }
+
+    void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) override {
+        _rs->cappedTruncateAfter(opCtx, end, inclusive);
+    }
+
+    bool compactSupported() const override {
+        return _rs->compactSupported();
+    }
+
+    bool compactsInPlace() const override {
+        return _rs->compactsInPlace();
+    }
+
+    Status compact(OperationContext* opCtx,
+                   RecordStoreCompactAdaptor* adaptor,
+                   const CompactOptions* options,
+                   CompactStats* stats) override;
+
+    bool isInRecordIdOrder() const override {
+        return _rs->isInRecordIdOrder();
+    }
+
+    Status validate(OperationContext* opCtx,
+                    ValidateCmdLevel level,
+                    ValidateAdaptor* adaptor,
+                    ValidateResults* results,
+                    BSONObjBuilder* output) override;
+
+    void appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* result,
+                           double scale) const override;
+
+    Status touch(OperationContext* opCtx, BSONObjBuilder* output) const override {
+        return _rs->touch(opCtx, output);
+    }
+
+    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const override {
+        _rs->waitForAllEarlierOplogWritesToBeVisible(opCtx);
+    }
+
+    void updateStatsAfterRepair(OperationContext* opCtx,
+                                long long numRecords,
+                                long long dataSize) override {
+        _rs->updateStatsAfterRepair(opCtx, numRecords, dataSize);
+    }
+
+private:
+    // Returns the compact form of 'obj', persisting the dictionary if it gained names needed to
+    // decode it.
+    BSONObj _encode(OperationContext* opCtx, const BSONObj& obj);
+
+    std::unique_ptr<RecordStore> _rs;
+    FieldNameDictionary _dictionary;
+    PersistNamesFn _persistNames;
+
+    // Number of names known to be durable in the catalog.
+    AtomicWord<unsigned long long> _numPersisted;
+};
+
+}  // namespace mongo
@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/field_name_dictionary.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(FieldNameDictionaryTest, RoundTripsNestedDocuments) {
+    FieldNameDictionary dict;
+    BSONObj doc = fromjson(
+        "{_id: 1, name: 'x', sub: {name: 'y', list: [1, {name: 'z', '7': 3}, [2]]}, '12': true}");
+
+    size_t namesNeeded = 0;
+    BSONObj compact = dict.encode(doc, &namesNeeded);
+    ASSERT_EQ(dict.size(), 4U);
+    ASSERT_EQ(namesNeeded, 4U);
+    ASSERT_BSONOBJ_EQ(compact,
+                      fromjson("{A: 1, B: 'x', C: {B: 'y', D: [1, {B: 'z', '7': 3}, [2]]}, "
+                               "'12': true}"));
+    ASSERT_BSONOBJ_EQ(dict.decode(compact), doc);
+}
+
+TEST(FieldNameDictionaryTest, ReusesExistingNames) {
+    FieldNameDictionary dict({"a", "b"});
+    size_t namesNeeded = 0;
+    BSONObj compact = dict.encode(BSON("b" << 1), &namesNeeded);
+    ASSERT_BSONOBJ_EQ(compact, BSON("B" << 1));
+    ASSERT_EQ(namesNeeded, 2U);
+    ASSERT_EQ(dict.size(), 2U);
+
+    compact = dict.encode(BSON("a" << 1 << "c" << 2), &namesNeeded);
+    ASSERT_BSONOBJ_EQ(compact, BSON("A" << 1 << "C" << 2));
+    ASSERT_EQ(namesNeeded, 3U);
+    ASSERT_TRUE(dict.getNames() == (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(FieldNameDictionaryTest, TokensUseMultipleLetters) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 60; ++i) {
+        names.push_back(str::stream() << "f" << i);
+    }
+    FieldNameDictionary dict(names);
+    size_t namesNeeded = 0;
+    BSONObj compact = dict.encode(BSON("f51" << 1 << "f52" << 2 << "f59" << 3), &namesNeeded);
+    ASSERT_BSONOBJ_EQ(compact, BSON("z" << 1 << "AB" << 2 << "HB" << 3));
+    ASSERT_BSONOBJ_EQ(dict.decode(compact), BSON("f51" << 1 << "f52" << 2 << "f59" << 3));
+}
+
+TEST(FieldNameDictionaryTest, StoresNamesVerbatimOnceFull) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < FieldNameDictionary::kMaxNames; ++i) {
+        names.push_back(str::stream() << "f" << i);
+    }
+    FieldNameDictionary dict(names);
+    size_t namesNeeded = 0;
+    BSONObj doc = BSON("f0" << 1 << "extra" << BSON("_id" << 2));
+    BSONObj compact = dict.encode(doc, &namesNeeded);
+    ASSERT_BSONOBJ_EQ(compact, BSON("A" << 1 << "_extra" << BSON("__id" << 2)));
+    ASSERT_EQ(dict.size(), FieldNameDictionary::kMaxNames);
+    ASSERT_BSONOBJ_EQ(dict.decode(compact), doc);
+    ASSERT_EQ(*dict.encodePath("extra._id"), "_extra.__id");
+}
+
+TEST(FieldNameDictionaryTest, EncodePathTranslatesKnownComponents) {
+    FieldNameDictionary dict({"a", "b"});
+    ASSERT_EQ(*dict.encodePath("a"), "A");
+    ASSERT_EQ(*dict.encodePath("b.a"), "B.A");
+    ASSERT_EQ(*dict.encodePath("a.0.b"), "A.0.B");
+    ASSERT_FALSE(dict.encodePath("a.c"));
+}
+
+TEST(FieldNameDictionaryTest, DecodeRejectsUnknownTokens) {
+    FieldNameDictionary dict({"a"});
+    ASSERT_THROWS_CODE(dict.decode(BSON("B" << 1)), AssertionException, 50941);
+    ASSERT_THROWS_CODE(dict.decode(BSON("a-" << 1)), AssertionException, 50940);
+}
+
+}  // namespace
+}  // namespace mongo
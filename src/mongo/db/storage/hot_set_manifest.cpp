@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/hot_set_manifest.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
+#include <utility>
+
+#include "mongo/base/data_type_validated.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+const int kManifestVersion = 1;
+
+const char kVersionField[] = "version";
+const char kEntriesField[] = "entries";
+const char kNsField[] = "ns";
+const char kIndexField[] = "index";
+const char kScoreField[] = "score";
+
+// Entries whose score decays below this are dropped.
+const double kMinScore = 1;
+}  // namespace
+
+const std::string HotSetManifest::kFileName = "hotSet.bson";
+
+StatusWith<HotSetManifest> HotSetManifest::readFromPath(const std::string& dbpath) {
+    const boost::filesystem::path path = boost::filesystem::path(dbpath) / kFileName;
+
+    std::vector<char> buffer;
+    try {
+        if (!boost::filesystem::exists(path)) {
+            return Status(ErrorCodes::NonExistentPath,
+                          str::stream() << "Hot set manifest " << path.string() << " not found.");
+        }
+
+        buffer.resize(boost::filesystem::file_size(path));
+        if (buffer.empty()) {
+            return Status(ErrorCodes::InvalidPath,
+                          str::stream() << "Hot set manifest " << path.string()
+                                        << " cannot be empty.");
+        }
+
+        std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+        ifs.read(&buffer[0], buffer.size());
+        if (!ifs) {
+            return Status(ErrorCodes::FileStreamFailed,
+                          str::stream() << "Unable to read BSON data from " << path.string());
+        }
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "Unexpected error reading BSON data from " << path.string()
+                                    << ": "
+                                    << ex.what());
+    }
+
+    ConstDataRange cdr(&buffer[0], buffer.size());
+    auto swObj = cdr.read<Validated<BSONObj>>();
+    if (!swObj.isOK()) {
+        return swObj.getStatus();
+    }
+    return parse(swObj.getValue());
+}
+
+StatusWith<HotSetManifest> HotSetManifest::parse(const BSONObj& obj) {
+    const BSONElement version = obj[kVersionField];
+    if (!version.isNumber() || version.numberInt() != kManifestVersion) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "Unsupported hot set manifest version: " << version);
+    }
+
+    const BSONElement entries = obj[kEntriesField];
+    if (entries.type() != Array) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "The '" << kEntriesField
+                                    << "' field of the hot set manifest must be an array");
+    }
+
+    HotSetManifest manifest;
+    for (const BSONElement& elem : entries.Obj()) {
+        if (elem.type() != Object) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Hot set manifest entries must be objects: " << elem);
+        }
+        const BSONObj entryObj = elem.Obj();
+
+        Entry entry;
+        const BSONElement ns = entryObj[kNsField];
+        const BSONElement index = entryObj[kIndexField];
+        const BSONElement score = entryObj[kScoreField];
+        if (ns.type() != String || !(index.eoo() || index.type() == String) ||
+            !score.isNumber()) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Invalid hot set manifest entry: " << entryObj);
+        }
+        entry.ns = ns.String();
+        entry.indexName = index.eoo() ? "" : index.String();
+        entry.score = score.numberDouble();
+        manifest._entries.push_back(std::move(entry));
+    }
+
+    std::stable_sort(manifest._entries.begin(),
+                     manifest._entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.score > b.score; });
+    return manifest;
+}
+
+Status HotSetManifest::writeToPath(const std::string& dbpath) const {
+    const boost::filesystem::path tempPath = boost::filesystem::path(dbpath) / (kFileName + ".tmp");
+    const boost::filesystem::path path = boost::filesystem::path(dbpath) / kFileName;
+
+    {
+        std::ofstream ofs(tempPath.c_str(), std::ios_base::out | std::ios_base::binary);
+        if (!ofs) {
+            return Status(ErrorCodes::FileNotOpen,
+                          str::stream() << "Failed to write hot set manifest to "
+                                        << tempPath.string()
+                                        << ": "
+                                        << errnoWithDescription());
+        }
+
+        const BSONObj obj = toBSON();
+        ofs.write(obj.objdata(), obj.objsize());
+        if (!ofs) {
+            return Status(ErrorCodes::OperationFailed,
+                          str::stream() << "Failed to write BSON data to " << tempPath.string()
+                                        << ": "
+                                        << errnoWithDescription());
+        }
+    }
+
+    // The manifest is only advisory, so unlike 'storage.bson' it is not fsynced. The rename keeps
+    // readers from ever seeing a partially written file.
+    try {
+        boost::filesystem::rename(tempPath, path);
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileRenameFailed,
+                      str::stream() << "Unexpected error while renaming temporary hot set manifest "
+                                    << tempPath.string()
+                                    << " to "
+                                    << path.string()
+                                    << ": "
+                                    << ex.what());
+    }
+
+    return Status::OK();
+}
+
+BSONObj HotSetManifest::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append(kVersionField, kManifestVersion);
+    BSONArrayBuilder entries(builder.subarrayStart(kEntriesField));
+    for (const auto& entry : _entries) {
+        BSONObjBuilder entryBuilder(entries.subobjStart());
+        entryBuilder.append(kNsField, entry.ns);
+        if (!entry.indexName.empty()) {
+            entryBuilder.append(kIndexField, entry.indexName);
+        }
+        entryBuilder.append(kScoreField, entry.score);
+    }
+    entries.done();
+    return builder.obj();
+}
+
+void HotSetManifest::addUsage(const std::vector<Entry>& usage,
+                              double decay,
+                              std::size_t maxEntries) {
+    std::map<std::pair<std::string, std::string>, double> scores;
+    for (const auto& entry : _entries) {
+        scores[{entry.ns, entry.indexName}] += entry.score * decay;
+    }
+    for (const auto& entry : usage) {
+        scores[{entry.ns, entry.indexName}] += entry.score;
+    }
+
+    _entries.clear();
+    for (const auto& score : scores) {
+        if (score.second >= kMinScore) {
+            _entries.push_back({score.first.first, score.first.second, score.second});
+        }
+    }
+
+    std::stable_sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+        return a.score > b.score;
+    });
+    if (_entries.size() > maxEntries) {
+        _entries.resize(maxEntries);
+    }
+}
+
+}  // namespace mongo
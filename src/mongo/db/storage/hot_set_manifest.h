@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+/**
+ * A ranked list of the collections and indexes that served the most operations recently, kept in
+ * the file 'hotSet.bson' in the data directory (See --dbpath).
+ *
+ * The hot set recorder adds the operation counts it observes at a regular interval, and the cache
+ * prewarmer reads the file back on startup to decide what to load into the storage engine cache.
+ * Existing scores decay each time usage is added, so the list follows shifts in the working set
+ * without forgetting it over a quiet period or a restart.
+ */
+class HotSetManifest {
+public:
+    static const std::string kFileName;
+
+    struct Entry {
+        std::string ns;
+        // Name of the index, or empty for the documents of the collection.
+        std::string indexName;
+        double score = 0;
+    };
+
+    /**
+     * Reads the manifest in 'dbpath'. Returns NonExistentPath if there is none.
+     */
+    static StatusWith<HotSetManifest> readFromPath(const std::string& dbpath);
+
+    static StatusWith<HotSetManifest> parse(const BSONObj& obj);
+
+    /**
+     * Writes the manifest to 'dbpath', replacing any previous one.
+     */
+    Status writeToPath(const std::string& dbpath) const;
+
+    BSONObj toBSON() const;
+
+    /**
+     * Multiplies every score by 'decay', adds the operation counts in 'usage' to the matching
+     * entries, and keeps the 'maxEntries' highest scoring ones. Entries that decay below one
+     * operation are dropped.
+     */
+    void addUsage(const std::vector<Entry>& usage, double decay, std::size_t maxEntries);
+
+    /**
+     * Entries in order of decreasing score.
+     */
+    const std::vector<Entry>& getEntries() const {
+        return _entries;
+    }
+
+private:
+    std::vector<Entry> _entries;
+};
+
+}  // namespace mongo
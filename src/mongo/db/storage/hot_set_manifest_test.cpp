@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/storage/hot_set_manifest.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using unittest::TempDir;
+
+HotSetManifest::Entry makeEntry(std::string ns, std::string indexName, double score) {
+    HotSetManifest::Entry entry;
+    entry.ns = std::move(ns);
+    entry.indexName = std::move(indexName);
+    entry.score = score;
+    return entry;
+}
+
+TEST(HotSetManifestTest, ReadNonExistentManifest) {
+    auto swManifest = HotSetManifest::readFromPath("no_such_directory");
+    ASSERT_EQUALS(ErrorCodes::NonExistentPath, swManifest.getStatus());
+}
+
+TEST(HotSetManifestTest, WriteToNonexistentDirectory) {
+    ASSERT_NOT_OK(HotSetManifest().writeToPath("no_such_directory"));
+}
+
+TEST(HotSetManifestTest, RoundTripThroughFile) {
+    TempDir tempDir("HotSetManifestTest_RoundTripThroughFile");
+
+    HotSetManifest manifest;
+    manifest.addUsage({makeEntry("test.a", "", 10), makeEntry("test.a", "x_1", 30)}, 1, 10);
+    ASSERT_OK(manifest.writeToPath(tempDir.path()));
+
+    auto swManifest = HotSetManifest::readFromPath(tempDir.path());
+    ASSERT_OK(swManifest.getStatus());
+    ASSERT_BSONOBJ_EQ(manifest.toBSON(), swManifest.getValue().toBSON());
+
+    const auto& entries = swManifest.getValue().getEntries();
+    ASSERT_EQUALS(2U, entries.size());
+    ASSERT_EQUALS("test.a", entries[0].ns);
+    ASSERT_EQUALS("x_1", entries[0].indexName);
+    ASSERT_EQUALS(30, entries[0].score);
+    ASSERT_EQUALS("", entries[1].indexName);
+}
+
+TEST(HotSetManifestTest, ParseSortsEntriesByScore) {
+    auto swManifest = HotSetManifest::parse(
+        fromjson("{version: 1, entries: [{ns: 'test.a', score: 1}, {ns: 'test.b', score: 5}]}"));
+    ASSERT_OK(swManifest.getStatus());
+    ASSERT_EQUALS("test.b", swManifest.getValue().getEntries()[0].ns);
+}
+
+TEST(HotSetManifestTest, ParseRejectsInvalidManifests) {
+    ASSERT_EQUALS(ErrorCodes::FailedToParse,
+                  HotSetManifest::parse(fromjson("{version: 2, entries: []}")).getStatus());
+    ASSERT_EQUALS(ErrorCodes::FailedToParse,
+                  HotSetManifest::parse(fromjson("{version: 1, entries: {}}")).getStatus());
+    ASSERT_EQUALS(
+        ErrorCodes::FailedToParse,
+        HotSetManifest::parse(fromjson("{version: 1, entries: [{ns: 1, score: 1}]}")).getStatus());
+    ASSERT_EQUALS(ErrorCodes::FailedToParse,
+                  HotSetManifest::parse(fromjson("{version: 1, entries: [{ns: 'test.a'}]}"))
+                      .getStatus());
+}
+
+TEST(HotSetManifestTest, AddUsageDecaysAndAccumulatesScores) {
+    HotSetManifest manifest;
+    manifest.addUsage({makeEntry("test.a", "", 100), makeEntry("test.b", "", 40)}, 0.5, 10);
+    manifest.addUsage({makeEntry("test.b", "", 40)}, 0.5, 10);
+
+    const auto& entries = manifest.getEntries();
+    ASSERT_EQUALS(2U, entries.size());
+    ASSERT_EQUALS("test.b", entries[0].ns);
+    ASSERT_EQUALS(60, entries[0].score);
+    ASSERT_EQUALS("test.a", entries[1].ns);
+    ASSERT_EQUALS(50, entries[1].score);
+}
+
+TEST(HotSetManifestTest, AddUsageDropsColdEntriesAndKeepsTheHottest) {
+    HotSetManifest manifest;
+    manifest.addUsage({makeEntry("test.a", "", 1),
+                       makeEntry("test.b", "", 2),
+                       makeEntry("test.c", "", 3),
+                       makeEntry("test.d", "", 4)},
+                      1,
+                      2);
+    ASSERT_EQUALS(2U, manifest.getEntries().size());
+    ASSERT_EQUALS("test.d", manifest.getEntries()[0].ns);
+    ASSERT_EQUALS("test.c", manifest.getEntries()[1].ns);
+
+    // test.c decays to 0.3 and test.d to 0.4, below a single operation.
+    manifest.addUsage({}, 0.1, 2);
+    ASSERT_EQUALS(0U, manifest.getEntries().size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -2194,6 +2194,17 @@ void KeyString::TypeBits::resetFromBuffer(BufReader* reader) {
     memcpy(getDataBuffer(), reader->skip(size), size);
 }
 
+void KeyString::TypeBits::resetFromRawBuffer(const char* data, size_t size) {
+    reset();
+
+    if (!size)
+        return;
+
+    _isAllZeros = false;
+    setRawSize(size);
+    memcpy(getDataBuffer(), data, size);
+}
+
 void KeyString::TypeBits::appendBit(uint8_t oneOrZero) {
     dassert(oneOrZero == 0 || oneOrZero == 1);
 
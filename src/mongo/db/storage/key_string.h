@@ -98,6 +98,12 @@ public:
             return out;
         }
 
+        /**
+         * Resets from data bytes as returned by getRawBuffer(), for callers which delimit the
+         * TypeBits by other means. An empty buffer is the AllZeros state.
+         */
+        void resetFromRawBuffer(const char* data, size_t size);
+
         /**
          * If true, no bits have been set to one. This is true if no bits have been set at all.
          */
@@ -165,6 +171,17 @@ public:
             return !_isAllZeros && getDataBufferLen() > kMaxBytesForShortEncoding;
         }
 
+        /**
+         * These methods return the data bytes alone, without the size byte(s) of the encoding
+         * described on getBuffer(). The AllZeros state is an empty buffer.
+         */
+        const char* getRawBuffer() const {
+            return getDataBuffer();
+        }
+        size_t getRawSize() const {
+            return _isAllZeros ? 0 : getDataBufferLen();
+        }
+
         //
         // Everything below is only for use by KeyString.
         //
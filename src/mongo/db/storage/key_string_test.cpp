@@ -203,6 +203,27 @@ TEST(TypeBitsTest, AppendLotsOfZeroTypeBits) {
     ASSERT(!typeBits.isLongEncoding());
 }
 
+TEST(TypeBitsTest, RawBufferRoundTrip) {
+    // More than a byte of type bits, so that the regular encoding needs a size byte.
+    const BSONObj obj = BSON("" << 1.5 << "" << 2LL << "" << BSONSymbol("sym") << "" << 2.5 << ""
+                                << 3LL << "" << 4.5);
+    const KeyString ks(KeyString::Version::V1, obj, ALL_ASCENDING);
+    const KeyString::TypeBits& typeBits = ks.getTypeBits();
+    ASSERT_FALSE(typeBits.isAllZeros());
+    ASSERT_LT(typeBits.getRawSize(), typeBits.getSize());
+
+    KeyString::TypeBits fromRaw(KeyString::Version::V1);
+    fromRaw.resetFromRawBuffer(typeBits.getRawBuffer(), typeBits.getRawSize());
+    ASSERT_EQ(typeBits.getSize(), fromRaw.getSize());
+    ASSERT_EQ(0, memcmp(typeBits.getBuffer(), fromRaw.getBuffer(), fromRaw.getSize()));
+    ASSERT_BSONOBJ_EQ(obj, KeyString::toBson(ks.getBuffer(), ks.getSize(), ALL_ASCENDING, fromRaw));
+
+    KeyString::TypeBits allZeros(KeyString::Version::V1);
+    ASSERT_EQ(0u, allZeros.getRawSize());
+    fromRaw.resetFromRawBuffer(allZeros.getRawBuffer(), allZeros.getRawSize());
+    ASSERT(fromRaw.isAllZeros());
+}
+
 TEST_F(KeyStringTest, Simple1) {
     BSONObj a = BSON("" << 5);
     BSONObj b = BSON("" << 6);
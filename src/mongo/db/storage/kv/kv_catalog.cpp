@@ -39,6 +39,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/field_name_dictionary.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/recovery_unit.h"
@@ -419,6 +420,11 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
         md.options = options;
         md.prefix = prefix;
         b.append("md", md.toBSON());
+        if (options.fieldNameDictionary) {
+            b.append("recordFormat",
+                     BSON("version" << FieldNameDictionary::kFormatVersion << "fieldNames"
+                                    << BSONArray()));
+        }
         obj = b.obj();
     }
     StatusWith<RecordId> res = _rs->insertRecord(opCtx, obj.objdata(), obj.objsize(), Timestamp());
@@ -521,6 +527,37 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
     fassert(28521, status.isOK());
 }
 
+BSONObj KVCatalog::getRecordFormat(OperationContext* opCtx, StringData ns) const {
+    BSONObj obj = _findEntry(opCtx, ns);
+    const BSONElement recordFormat = obj["recordFormat"];
+    return recordFormat.isABSONObj() ? recordFormat.Obj().getOwned() : BSONObj();
+}
+
+void KVCatalog::putFieldNames(OperationContext* opCtx,
+                              StringData ns,
+                              const std::vector<std::string>& names) {
+    RecordId loc;
+    BSONObj obj = _findEntry(opCtx, ns, &loc);
+    invariant(obj["recordFormat"].isABSONObj());
+
+    {
+        // rebuilt doc
+        BSONObjBuilder b;
+        BSONObjBuilder recordFormat(b.subobjStart("recordFormat"));
+        recordFormat.append("version", FieldNameDictionary::kFormatVersion);
+        recordFormat.append("fieldNames", names);
+        recordFormat.done();
+
+        // add whatever is left
+        b.appendElementsUnique(obj);
+        obj = b.obj();
+    }
+
+    LOG(3) << "recording " << names.size() << " field names for " << ns;
+    Status status = _rs->updateRecord(opCtx, loc, obj.objdata(), obj.objsize(), NULL);
+    fassert(50942, status.isOK());
+}
+
 Status KVCatalog::renameCollection(OperationContext* opCtx,
                                    StringData fromNS,
                                    StringData toNS,
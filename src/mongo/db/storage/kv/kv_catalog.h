@@ -80,6 +80,19 @@ public:
                      StringData ns,
                      BSONCollectionCatalogEntry::MetaData& md);
 
+    /**
+     * Returns the 'recordFormat' subdocument of the catalog entry for 'ns', or an empty object if
+     * the collection stores plain BSON documents.
+     */
+    BSONObj getRecordFormat(OperationContext* opCtx, StringData ns) const;
+
+    /**
+     * Replaces the field names in the 'recordFormat' of a collection using a FieldNameDictionary.
+     */
+    void putFieldNames(OperationContext* opCtx,
+                       StringData ns,
+                       const std::vector<std::string>& names);
+
     Status renameCollection(OperationContext* opCtx,
                             StringData fromNS,
                             StringData toNS,
@@ -62,7 +62,8 @@ public:
      */
     enum class NonRepairableFeature : std::uint64_t {
         kCollation = 1 << 0,
-        kNextFeatureBit = 1 << 1
+        kFieldNameDictionary = 1 << 1,
+        kNextFeatureBit = 1 << 2
     };
 
     using NonRepairableFeatureMask = std::underlying_type<NonRepairableFeature>::type;
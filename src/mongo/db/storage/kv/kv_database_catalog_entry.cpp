@@ -34,6 +34,7 @@
 #include "mongo/db/index/2d_access_method.h"
 #include "mongo/db/index/all_paths_access_method.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/index/column_store_access_method.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/index/hash_access_method.h"
 #include "mongo/db/index/haystack_access_method.h"
@@ -88,6 +89,9 @@ IndexAccessMethod* KVDatabaseCatalogEntry::getIndex(OperationContext* opCtx,
     if (IndexNames::ALLPATHS == type)
         return new AllPathsAccessMethod(index, sdi);
 
+    if (IndexNames::COLUMNSTORE == type)
+        return new ColumnStoreAccessMethod(index, sdi);
+
     log() << "Can't find index for keyPattern " << desc->keyPattern();
     MONGO_UNREACHABLE;
 }
@@ -34,6 +34,7 @@
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/field_name_dictionary_record_store.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
@@ -230,9 +231,18 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
         }
     }
 
+    if (options.fieldNameDictionary) {
+        const auto feature = KVCatalog::FeatureTracker::NonRepairableFeature::kFieldNameDictionary;
+        if (!_engine->getCatalog()->getFeatureTracker()->isNonRepairableFeatureInUse(opCtx,
+                                                                                     feature)) {
+            _engine->getCatalog()->getFeatureTracker()->markNonRepairableFeatureAsInUse(opCtx,
+                                                                                        feature);
+        }
+    }
+
     opCtx->recoveryUnit()->registerChange(new AddCollectionChange(opCtx, this, ns, ident, true));
 
-    auto rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, options, prefix);
+    auto rs = _getRecordStore(opCtx, ns, ident, options, prefix);
     invariant(rs);
 
     _collections[ns.toString()] = new KVCollectionCatalogEntry(
@@ -255,7 +265,7 @@ void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
         rs = nullptr;
     } else {
         BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
-        rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, md.options, md.prefix);
+        rs = _getRecordStore(opCtx, ns, ident, md.options, md.prefix);
         invariant(rs);
     }
 
@@ -315,8 +325,7 @@ Status KVDatabaseCatalogEntryBase::renameCollection(OperationContext* opCtx,
     opCtx->recoveryUnit()->registerChange(
         new AddCollectionChange(opCtx, this, toNS, identTo, false));
 
-    auto rs =
-        _engine->getEngine()->getGroupedRecordStore(opCtx, toNS, identTo, md.options, md.prefix);
+    auto rs = _getRecordStore(opCtx, toNS, identTo, md.options, md.prefix);
 
     // Add the destination collection to _collections before erasing the source collection. This
     // is to ensure that _collections doesn't erroneously appear empty during listDatabases if
@@ -335,6 +344,44 @@ Status KVDatabaseCatalogEntryBase::renameCollection(OperationContext* opCtx,
     return Status::OK();
 }
 
+std::unique_ptr<RecordStore> KVDatabaseCatalogEntryBase::_getRecordStore(
+    OperationContext* opCtx,
+    StringData ns,
+    StringData ident,
+    const CollectionOptions& options,
+    KVPrefix prefix) {
+    auto rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, options, prefix);
+    if (!rs) {
+        return rs;
+    }
+
+    KVCatalog* catalog = _engine->getCatalog();
+    const BSONObj recordFormat = catalog->getRecordFormat(opCtx, ns);
+    if (recordFormat.isEmpty()) {
+        return rs;
+    }
+
+    const int version = recordFormat["version"].numberInt();
+    uassert(50943,
+            str::stream() << "Collection " << ns << " uses record format version " << version
+                          << ", but this version only supports up to version "
+                          << FieldNameDictionary::kFormatVersion,
+            version <= FieldNameDictionary::kFormatVersion);
+
+    std::vector<std::string> names;
+    for (auto&& name : recordFormat["fieldNames"].Obj()) {
+        names.push_back(name.String());
+    }
+
+    const std::string nsString = ns.toString();
+    return stdx::make_unique<FieldNameDictionaryRecordStore>(
+        std::move(rs),
+        std::move(names),
+        [catalog, nsString](OperationContext* opCtx, const std::vector<std::string>& names) {
+            catalog->putFieldNames(opCtx, nsString, names);
+        });
+}
+
 Status KVDatabaseCatalogEntryBase::dropCollection(OperationContext* opCtx, StringData ns) {
     invariant(opCtx->lockState()->isDbLockedForMode(name(), MODE_X));
 
@@ -33,6 +33,7 @@
 #include <string>
 
 #include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
 
 namespace mongo {
 
@@ -91,6 +92,16 @@ protected:
 
     typedef std::map<std::string, KVCollectionCatalogEntry*> CollectionMap;
 
+    /**
+     * Opens the record store for 'ns', wrapping it in a FieldNameDictionaryRecordStore if its
+     * catalog entry has a 'recordFormat'.
+     */
+    std::unique_ptr<RecordStore> _getRecordStore(OperationContext* opCtx,
+                                                 StringData ns,
+                                                 StringData ident,
+                                                 const CollectionOptions& options,
+                                                 KVPrefix prefix);
+
 
     KVStorageEngine* const _engine;  // not owned here
     CollectionMap _collections;
@@ -254,6 +254,17 @@ public:
         return true;
     }
 
+    /**
+     * Returns true if record stores created with CollectionOptions::clustered key each record by
+     * the _id of its document, as given by clusteredkey::extractKey(), and return DuplicateKey
+     * for an insert whose _id already exists.
+     *
+     * This must not change over the lifetime of the engine.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns true if storage engine supports --directoryperdb.
      * See:
@@ -85,7 +85,8 @@ KVStorageEngine::KVStorageEngine(
       _engine(engine),
       _supportsDocLocking(_engine->supportsDocLocking()),
       _supportsDBLocking(_engine->supportsDBLocking()),
-      _supportsCappedCollections(_engine->supportsCappedCollections()) {
+      _supportsCappedCollections(_engine->supportsCappedCollections()),
+      _supportsClusteredCollections(_engine->supportsClusteredCollections()) {
     uassert(28601,
             "Storage engine does not support --directoryperdb",
             !(options.directoryPerDB && !engine->supportsDirectoryPerDB()));
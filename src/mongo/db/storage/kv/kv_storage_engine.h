@@ -100,6 +100,10 @@ public:
         return _supportsCappedCollections;
     }
 
+    bool supportsClusteredCollections() const override {
+        return _supportsClusteredCollections;
+    }
+
     virtual Status closeDatabase(OperationContext* opCtx, StringData db);
 
     virtual Status dropDatabase(OperationContext* opCtx, StringData db);
@@ -224,6 +228,7 @@ private:
     const bool _supportsDocLocking;
     const bool _supportsDBLocking;
     const bool _supportsCappedCollections;
+    const bool _supportsClusteredCollections;
     Timestamp _initialDataTimestamp = Timestamp::kAllowUnstableCheckpointsSentinel;
 
     std::unique_ptr<RecordStore> _catalogRecordStore;
@@ -29,6 +29,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -113,6 +114,44 @@ public:
                          const RecordId& loc,
                          bool dupsAllowed) = 0;
 
+    /**
+     * Insert a batch of entries into the index. This is equivalent to calling insert() on each
+     * element of 'keys' and stops at the first failure, but lets implementations position a
+     * single cursor once and reuse it across the whole batch. 'keys' need not be sorted.
+     *
+     * @param opCtx the transaction under which the inserts take place
+     * @param dupsAllowed true if duplicate keys are allowed, and false
+     *        otherwise
+     *
+     * @return Status::OK() if every insert succeeded, or the first failure otherwise
+     */
+    virtual Status insertKeys(OperationContext* opCtx,
+                              const std::vector<IndexKeyEntry>& keys,
+                              bool dupsAllowed) {
+        for (const auto& entry : keys) {
+            Status status = insert(opCtx, entry.key, entry.loc, dupsAllowed);
+            if (!status.isOK())
+                return status;
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Remove a batch of entries from the index. This is equivalent to calling unindex() on each
+     * element of 'keys'.
+     *
+     * @param opCtx the transaction under which the removes take place
+     * @param dupsAllowed true if duplicate keys are allowed, and false
+     *        otherwise
+     */
+    virtual void unindexKeys(OperationContext* opCtx,
+                             const std::vector<IndexKeyEntry>& keys,
+                             bool dupsAllowed) {
+        for (const auto& entry : keys) {
+            unindex(opCtx, entry.key, entry.loc, dupsAllowed);
+        }
+    }
+
     /**
      * Return ErrorCodes::DuplicateKey if 'key' already exists in 'this'
      * index at a RecordId other than 'loc', and Status::OK() otherwise.
@@ -133,6 +172,14 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Return true if 'this' index is stored in a format that 4.0 binaries cannot read, so that it
+     * must be rebuilt before the featureCompatibilityVersion is downgraded to 4.0.
+     */
+    virtual bool requiresFCV42() const {
+        return false;
+    }
+
     //
     // Information about the tree
     //
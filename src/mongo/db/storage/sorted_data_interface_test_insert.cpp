@@ -31,6 +31,7 @@
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/unittest/unittest.h"
@@ -365,5 +366,59 @@ TEST(SortedDataInterface, InsertMultipleCompoundKeys) {
     }
 }
 
+// Insert an unsorted batch of keys with a single call and verify that every entry is
+// present and can be read back in index order.
+TEST(SortedDataInterface, InsertKeysBatch) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT(sorted->isEmpty(opCtx.get()));
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            std::vector<IndexKeyEntry> keys = {
+                {key3, loc1}, {key1, loc1}, {key2, loc2}, {key1, loc3}};
+            ASSERT_OK(sorted->insertKeys(opCtx.get(), keys, true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(4, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(key1, true), IndexKeyEntry(key1, loc1));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key1, loc3));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key2, loc2));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key3, loc1));
+        ASSERT_EQ(cursor->next(), boost::none);
+    }
+}
+
+// Insert a batch containing the same key at two different RecordIds into a unique index and
+// verify that the batch reports a duplicate key error.
+TEST(SortedDataInterface, InsertKeysBatchDuplicateKey) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(true));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        std::vector<IndexKeyEntry> keys = {{key2, loc1}, {key1, loc2}, {key2, loc3}};
+        ASSERT_EQUALS(ErrorCodes::DuplicateKey, sorted->insertKeys(opCtx.get(), keys, false));
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT(sorted->isEmpty(opCtx.get()));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/unittest/unittest.h"
@@ -283,5 +284,36 @@ TEST(SortedDataInterface, UnindexEmpty) {
     }
 }
 
+// Insert multiple keys and verify that they can be unindexed with a single batch.
+TEST(SortedDataInterface, UnindexKeysBatch) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(false, {{key1, loc1}, {key2, loc2}, {key3, loc3}}));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, sorted->numEntries(opCtx.get()));
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            std::vector<IndexKeyEntry> keys = {{key3, loc3}, {key1, loc1}};
+            sorted->unindexKeys(opCtx.get(), keys, true);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(key1, true), IndexKeyEntry(key2, loc2));
+        ASSERT_EQ(cursor->next(), boost::none);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
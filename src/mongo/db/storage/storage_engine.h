@@ -197,6 +197,14 @@ public:
         return true;
     }
 
+    /**
+     * Returns whether the storage engine supports clustered collections, which store documents
+     * keyed by their _id.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns whether the engine supports a journalling concept or not.
      */
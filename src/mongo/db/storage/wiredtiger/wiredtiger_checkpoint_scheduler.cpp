@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+// A commit rate is a burst when it exceeds the moving average by this factor...
+const double kBurstFactor = 2.0;
+// ...and is at least this high, so that an idle server waking up is not mistaken for one.
+const double kMinBurstCommitsPerSec = 100;
+// Weight of the newest sample in the moving average of the commit rate.
+const double kCommitRateSmoothing = 0.1;
+
+const WiredTigerCheckpointScheduler::Trigger kTriggers[] = {
+    WiredTigerCheckpointScheduler::Trigger::kTime,
+    WiredTigerCheckpointScheduler::Trigger::kDirtyCache,
+    WiredTigerCheckpointScheduler::Trigger::kJournalSize,
+    WiredTigerCheckpointScheduler::Trigger::kRequested,
+};
+}  // namespace
+
+WiredTigerCheckpointScheduler::WiredTigerCheckpointScheduler(Date_t now)
+    : _lastCheckpointEnd(now) {}
+
+WiredTigerCheckpointScheduler::Trigger WiredTigerCheckpointScheduler::evaluate(
+    const Settings& settings, const LoadSample& sample) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const bool bursting = _updateCommitRate(lk, sample);
+    const Milliseconds sinceLastCheckpoint = sample.now - _lastCheckpointEnd;
+
+    // 'syncdelay' is a hard upper bound, regardless of load.
+    if (sinceLastCheckpoint >= settings.maxInterval) {
+        if (_triggeredAt == Date_t()) {
+            _triggeredAt = sample.now;
+        }
+        return Trigger::kTime;
+    }
+
+    if (sinceLastCheckpoint < settings.minInterval) {
+        return Trigger::kNone;
+    }
+
+    const Trigger trigger = _earlyTrigger(lk, settings, sample);
+    if (trigger == Trigger::kNone) {
+        _triggeredAt = Date_t();
+        _deferring = false;
+        return Trigger::kNone;
+    }
+
+    if (_triggeredAt == Date_t()) {
+        _triggeredAt = sample.now;
+    }
+
+    if (bursting && sample.now - _triggeredAt < settings.maxDeferral) {
+        if (!_deferring) {
+            _deferring = true;
+            ++_deferrals;
+        }
+        return Trigger::kNone;
+    }
+
+    return trigger;
+}
+
+bool WiredTigerCheckpointScheduler::_updateCommitRate(WithLock, const LoadSample& sample) {
+    bool bursting = false;
+    if (_havePreviousSample && sample.now > _previousSample.now &&
+        sample.transactionsCommitted >= _previousSample.transactionsCommitted) {
+        const double seconds =
+            durationCount<Milliseconds>(sample.now - _previousSample.now) / 1000.0;
+        const double rate =
+            (sample.transactionsCommitted - _previousSample.transactionsCommitted) / seconds;
+
+        if (_haveCommitRate) {
+            bursting =
+                rate >= kMinBurstCommitsPerSec && rate > kBurstFactor * _averageCommitsPerSec;
+            _averageCommitsPerSec += kCommitRateSmoothing * (rate - _averageCommitsPerSec);
+        } else {
+            _averageCommitsPerSec = rate;
+            _haveCommitRate = true;
+        }
+    }
+
+    _previousSample = sample;
+    _havePreviousSample = true;
+    return bursting;
+}
+
+WiredTigerCheckpointScheduler::Trigger WiredTigerCheckpointScheduler::_earlyTrigger(
+    WithLock, const Settings& settings, const LoadSample& sample) const {
+    if (settings.dirtyCacheTriggerPercent > 0 && sample.maxCacheBytes > 0 &&
+        sample.dirtyCacheBytes * 100 >=
+            sample.maxCacheBytes * static_cast<std::uint64_t>(settings.dirtyCacheTriggerPercent)) {
+        return Trigger::kDirtyCache;
+    }
+
+    if (settings.journalTriggerBytes > 0 &&
+        sample.journalBytesWritten >=
+            _journalBytesAtLastCheckpoint +
+                static_cast<std::uint64_t>(settings.journalTriggerBytes)) {
+        return Trigger::kJournalSize;
+    }
+
+    return Trigger::kNone;
+}
+
+void WiredTigerCheckpointScheduler::onCheckpointCompleted(Trigger trigger,
+                                                          const LoadSample& start,
+                                                          Date_t end) {
+    invariant(trigger != Trigger::kNone);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_checkpointsByTrigger[static_cast<int>(trigger)];
+
+    _lastCheckpointDuration = end - start.now;
+    _checkpointDuration.increment(_lastCheckpointDuration);
+
+    const Date_t triggeredAt = _triggeredAt == Date_t() ? start.now : _triggeredAt;
+    _triggerToStart.increment(start.now - triggeredAt);
+    _triggeredAt = Date_t();
+    _deferring = false;
+
+    _lastCheckpointEnd = end;
+    _journalBytesAtLastCheckpoint = start.journalBytesWritten;
+}
+
+void WiredTigerCheckpointScheduler::onCheckpointSkipped(Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_skipped;
+    _triggeredAt = Date_t();
+    _deferring = false;
+    _lastCheckpointEnd = now;
+}
+
+void WiredTigerCheckpointScheduler::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    BSONObjBuilder bob(builder->subobjStart("checkpoint-scheduler"));
+    {
+        BSONObjBuilder checkpoints(bob.subobjStart("checkpoints"));
+        for (auto trigger : kTriggers) {
+            checkpoints.append(
+                triggerName(trigger),
+                static_cast<long long>(_checkpointsByTrigger[static_cast<int>(trigger)]));
+        }
+        checkpoints.done();
+    }
+    bob.append("deferred checkpoints", static_cast<long long>(_deferrals));
+    bob.append("skipped checkpoints", static_cast<long long>(_skipped));
+    bob.append("last checkpoint duration millis",
+               durationCount<Milliseconds>(_lastCheckpointDuration));
+    bob.append("average commits per second", _averageCommitsPerSec);
+    _checkpointDuration.append("checkpoint durations", true, &bob);
+    _triggerToStart.append("trigger to start delays", true, &bob);
+    bob.done();
+}
+
+StringData WiredTigerCheckpointScheduler::triggerName(Trigger trigger) {
+    switch (trigger) {
+        case Trigger::kNone:
+            return "none"_sd;
+        case Trigger::kTime:
+            return "time"_sd;
+        case Trigger::kDirtyCache:
+            return "dirty cache"_sd;
+        case Trigger::kJournalSize:
+            return "journal size"_sd;
+        case Trigger::kRequested:
+            return "requested"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
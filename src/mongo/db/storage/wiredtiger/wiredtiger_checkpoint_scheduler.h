@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/latency_histogram.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Decides when the checkpoint thread should take its next checkpoint.
+ *
+ * Besides the fixed 'syncdelay' period, which stays an upper bound on the time between
+ * checkpoints, a checkpoint is triggered early once the dirty portion of the cache or the journal
+ * written since the last checkpoint crosses a threshold. Taking smaller checkpoints more often
+ * spreads their I/O out instead of flushing a large backlog at once. Early checkpoints are paced
+ * by a minimum interval, and are deferred while the commit rate is bursting well above its recent
+ * average, for at most a bounded time, so that they do not land on top of a traffic peak.
+ *
+ * The scheduler holds no WiredTiger state. The checkpoint thread feeds it periodic load samples
+ * and reports back each checkpoint it takes, which keeps the policy testable on its own.
+ */
+class WiredTigerCheckpointScheduler {
+    MONGO_DISALLOW_COPYING(WiredTigerCheckpointScheduler);
+
+public:
+    enum class Trigger {
+        kNone,
+        kTime,
+        kDirtyCache,
+        kJournalSize,
+        kRequested,
+    };
+
+    struct Settings {
+        // Upper bound on the time between the end of a checkpoint and the start of the next one.
+        Seconds maxInterval{60};
+        // Lower bound on the time between checkpoints that are triggered early.
+        Seconds minInterval{10};
+        // Trigger a checkpoint once this percentage of the cache is dirty. Zero disables.
+        int dirtyCacheTriggerPercent = 0;
+        // Trigger a checkpoint once this many journal bytes have been written since the previous
+        // one. Zero disables.
+        std::int64_t journalTriggerBytes = 0;
+        // How long an early checkpoint may be held back while the commit rate is bursting.
+        Seconds maxDeferral{0};
+    };
+
+    struct LoadSample {
+        Date_t now;
+        std::uint64_t dirtyCacheBytes = 0;
+        std::uint64_t maxCacheBytes = 0;
+        // Cumulative counters; the scheduler tracks their deltas.
+        std::uint64_t journalBytesWritten = 0;
+        std::uint64_t transactionsCommitted = 0;
+    };
+
+    explicit WiredTigerCheckpointScheduler(Date_t now);
+
+    /**
+     * Returns which condition calls for a checkpoint now, or Trigger::kNone if the thread should
+     * keep waiting. Expected to be called at a regular interval.
+     */
+    Trigger evaluate(const Settings& settings, const LoadSample& sample);
+
+    /**
+     * Records a checkpoint that started at 'start.now' and finished at 'end'. 'start' is the
+     * sample the checkpoint was triggered on, or one taken just before it started.
+     */
+    void onCheckpointCompleted(Trigger trigger, const LoadSample& start, Date_t end);
+
+    /**
+     * Records that a due checkpoint could not be taken at 'now', for example because the stable
+     * timestamp is behind the initial data timestamp. The next one is due a full interval later.
+     */
+    void onCheckpointSkipped(Date_t now);
+
+    /**
+     * Appends per-trigger checkpoint counts, deferral and skip counts, and histograms of checkpoint
+     * durations and of the delays between a trigger firing and its checkpoint starting.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    static StringData triggerName(Trigger trigger);
+
+private:
+    // Returns whether the commit rate in 'sample' is well above the recent average.
+    bool _updateCommitRate(WithLock, const LoadSample& sample);
+
+    Trigger _earlyTrigger(WithLock, const Settings& settings, const LoadSample& sample) const;
+
+    mutable stdx::mutex _mutex;
+
+    // All of the following are guarded by _mutex.
+
+    Date_t _lastCheckpointEnd;
+    std::uint64_t _journalBytesAtLastCheckpoint = 0;
+
+    // The previous sample and a moving average of commits per second, for burst detection.
+    bool _havePreviousSample = false;
+    LoadSample _previousSample;
+    bool _haveCommitRate = false;
+    double _averageCommitsPerSec = 0;
+
+    // When the pending early trigger first fired, or Date_t() if none is pending.
+    Date_t _triggeredAt;
+    // Whether the pending early trigger has been deferred because of a burst.
+    bool _deferring = false;
+
+    std::uint64_t _checkpointsByTrigger[static_cast<int>(Trigger::kRequested) + 1] = {};
+    std::uint64_t _deferrals = 0;
+    std::uint64_t _skipped = 0;
+    Milliseconds _lastCheckpointDuration{0};
+
+    LatencyHistogram _checkpointDuration;
+    LatencyHistogram _triggerToStart;
+};
+
+}  // namespace mongo
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Trigger = WiredTigerCheckpointScheduler::Trigger;
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000 * 1000);
+const std::uint64_t kCacheBytes = 1000 * 1000;
+const std::int64_t kJournalTriggerBytes = 100 * 1000;
+
+WiredTigerCheckpointScheduler::Settings makeSettings() {
+    WiredTigerCheckpointScheduler::Settings settings;
+    settings.maxInterval = Seconds(60);
+    settings.minInterval = Seconds(10);
+    settings.dirtyCacheTriggerPercent = 10;
+    settings.journalTriggerBytes = kJournalTriggerBytes;
+    settings.maxDeferral = Seconds(5);
+    return settings;
+}
+
+WiredTigerCheckpointScheduler::LoadSample makeSample(Seconds sinceStart,
+                                                     std::uint64_t dirtyBytes = 0,
+                                                     std::uint64_t journalBytes = 0,
+                                                     std::uint64_t commits = 0) {
+    WiredTigerCheckpointScheduler::LoadSample sample;
+    sample.now = kStart + sinceStart;
+    sample.dirtyCacheBytes = dirtyBytes;
+    sample.maxCacheBytes = kCacheBytes;
+    sample.journalBytesWritten = journalBytes;
+    sample.transactionsCommitted = commits;
+    return sample;
+}
+
+BSONObj getStats(const WiredTigerCheckpointScheduler& scheduler) {
+    BSONObjBuilder bob;
+    scheduler.appendStats(&bob);
+    return bob.obj()["checkpoint-scheduler"].Obj().getOwned();
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, TimeTriggersAtMaxInterval) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    const auto settings = makeSettings();
+
+    ASSERT(Trigger::kNone == scheduler.evaluate(settings, makeSample(Seconds(59))));
+    ASSERT(Trigger::kTime == scheduler.evaluate(settings, makeSample(Seconds(60))));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, DirtyCacheTriggersAfterMinInterval) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    const auto settings = makeSettings();
+    const std::uint64_t dirty = kCacheBytes / 5;
+
+    ASSERT(Trigger::kNone == scheduler.evaluate(settings, makeSample(Seconds(5), dirty)));
+    ASSERT(Trigger::kDirtyCache == scheduler.evaluate(settings, makeSample(Seconds(10), dirty)));
+    ASSERT(Trigger::kNone ==
+           scheduler.evaluate(settings, makeSample(Seconds(11), kCacheBytes / 20)));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, DisabledTriggersOnlyCheckpointOnTime) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    auto settings = makeSettings();
+    settings.dirtyCacheTriggerPercent = 0;
+    settings.journalTriggerBytes = 0;
+
+    ASSERT(Trigger::kNone ==
+           scheduler.evaluate(settings, makeSample(Seconds(30), kCacheBytes, 1000 * 1000 * 1000)));
+    ASSERT(Trigger::kTime == scheduler.evaluate(settings, makeSample(Seconds(60))));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, JournalSizeIsMeasuredFromLastCheckpoint) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    const auto settings = makeSettings();
+
+    const auto first = makeSample(Seconds(10), 0, kJournalTriggerBytes);
+    ASSERT(Trigger::kJournalSize == scheduler.evaluate(settings, first));
+    scheduler.onCheckpointCompleted(Trigger::kJournalSize, first, first.now + Seconds(1));
+
+    // The journal written before the checkpoint started no longer counts.
+    ASSERT(Trigger::kNone ==
+           scheduler.evaluate(settings, makeSample(Seconds(30), 0, kJournalTriggerBytes + 1)));
+    ASSERT(Trigger::kJournalSize ==
+           scheduler.evaluate(settings, makeSample(Seconds(31), 0, 2 * kJournalTriggerBytes)));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, BurstDefersEarlyCheckpointForBoundedTime) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    const auto settings = makeSettings();
+    const std::uint64_t dirty = kCacheBytes / 5;
+
+    // Establish a steady rate of 1000 commits per second.
+    std::uint64_t commits = 0;
+    for (int i = 1; i < 10; ++i) {
+        commits += 1000;
+        ASSERT(Trigger::kNone ==
+               scheduler.evaluate(settings, makeSample(Seconds(i), 0, 0, commits)));
+    }
+
+    // The rate jumps tenfold just as the dirty cache trigger fires, so the checkpoint waits, but
+    // only for the maximum deferral.
+    int second = 10;
+    for (; second < 15; ++second) {
+        commits += 10 * 1000;
+        ASSERT(Trigger::kNone ==
+               scheduler.evaluate(settings, makeSample(Seconds(second), dirty, 0, commits)));
+    }
+    commits += 10 * 1000;
+    ASSERT(Trigger::kDirtyCache ==
+           scheduler.evaluate(settings, makeSample(Seconds(second), dirty, 0, commits)));
+
+    ASSERT_EQ(1, getStats(scheduler)["deferred checkpoints"].numberLong());
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, BurstNeverDefersPastMaxInterval) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    auto settings = makeSettings();
+    settings.maxDeferral = Seconds(3600);
+
+    ASSERT(Trigger::kNone == scheduler.evaluate(settings, makeSample(Seconds(58), 0, 0, 1000)));
+    ASSERT(Trigger::kNone == scheduler.evaluate(settings, makeSample(Seconds(59), 0, 0, 2000)));
+    ASSERT(Trigger::kTime ==
+           scheduler.evaluate(settings, makeSample(Seconds(60), 0, 0, 2000 + 100 * 1000)));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, SkippedCheckpointRestartsInterval) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+    const auto settings = makeSettings();
+
+    ASSERT(Trigger::kTime == scheduler.evaluate(settings, makeSample(Seconds(60))));
+    scheduler.onCheckpointSkipped(kStart + Seconds(60));
+    ASSERT(Trigger::kNone == scheduler.evaluate(settings, makeSample(Seconds(61))));
+    ASSERT(Trigger::kTime == scheduler.evaluate(settings, makeSample(Seconds(120))));
+
+    const BSONObj stats = getStats(scheduler);
+    ASSERT_EQ(1, stats["skipped checkpoints"].numberLong());
+    ASSERT_EQ(0, stats["checkpoints"]["time"].numberLong());
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, CompletedCheckpointsAreCountedByTrigger) {
+    WiredTigerCheckpointScheduler scheduler(kStart);
+
+    const auto sample = makeSample(Seconds(1));
+    scheduler.onCheckpointCompleted(Trigger::kRequested, sample, sample.now + Seconds(2));
+    scheduler.onCheckpointCompleted(Trigger::kTime, sample, sample.now + Seconds(3));
+
+    const BSONObj stats = getStats(scheduler);
+    ASSERT_EQ(1, stats["checkpoints"]["requested"].numberLong());
+    ASSERT_EQ(1, stats["checkpoints"]["time"].numberLong());
+    ASSERT_EQ(0, stats["checkpoints"]["dirty cache"].numberLong());
+    ASSERT_EQ(3000, stats["last checkpoint duration millis"].numberLong());
+    ASSERT_EQ(2, stats["checkpoint durations"]["ops"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,636 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compressor.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <limits>
+#include <zlib.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+constexpr StringData WiredTigerDictionaryCompressors::kBlockCompressorOption;
+constexpr StringData WiredTigerDictionaryCompressors::kDirectoryName;
+constexpr size_t WiredTigerDictionaryCompressors::kMaxDictionarySize;
+
+namespace {
+
+const auto getDictionaryCompressors =
+    ServiceContext::declareDecoration<WiredTigerDictionaryCompressors>();
+
+const char kExtensionEntry[] = "mongo_addWiredTigerDictionaryCompressors";
+
+// Every compressed block starts with a format byte and the little-endian version of the
+// dictionary it was compressed with, 0 meaning no dictionary.
+const uint8_t kBlockFormat = 1;
+const size_t kBlockHeaderSize = 1 + sizeof(uint32_t);
+
+// Elements no larger than this are candidate dictionary substrings as a whole, larger ones only
+// contribute their type and field name.
+const int kMaxCandidateSize = 64;
+
+using Compressor = WiredTigerDictionaryCompressors::Compressor;
+
+int dictionaryCompress(WT_COMPRESSOR* wtCompressor,
+                       WT_SESSION* session,
+                       uint8_t* src,
+                       size_t srcLen,
+                       uint8_t* dst,
+                       size_t dstLen,
+                       size_t* resultLen,
+                       int* compressionFailed) {
+    auto compressor = reinterpret_cast<Compressor*>(wtCompressor);
+    if (dstLen <= kBlockHeaderSize) {
+        *compressionFailed = 1;
+        return 0;
+    }
+
+    const auto latest = compressor->getLatestDictionary();
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK) {
+        return ENOMEM;
+    }
+    if (latest.second &&
+        deflateSetDictionary(&zs,
+                             reinterpret_cast<const Bytef*>(latest.second->data()),
+                             latest.second->size()) != Z_OK) {
+        deflateEnd(&zs);
+        return EINVAL;
+    }
+
+    zs.next_in = src;
+    zs.avail_in = srcLen;
+    zs.next_out = dst + kBlockHeaderSize;
+    zs.avail_out = dstLen - kBlockHeaderSize;
+    const int ret = deflate(&zs, Z_FINISH);
+    const size_t compressedLen = kBlockHeaderSize + zs.total_out;
+    deflateEnd(&zs);
+
+    // Anything but the end of the stream means the destination buffer was too small.
+    if (ret != Z_STREAM_END || compressedLen >= srcLen) {
+        *compressionFailed = 1;
+        return 0;
+    }
+
+    dst[0] = kBlockFormat;
+    DataView(reinterpret_cast<char*>(dst + 1)).write<LittleEndian<uint32_t>>(latest.first);
+    *resultLen = compressedLen;
+    *compressionFailed = 0;
+    return 0;
+}
+
+int dictionaryDecompress(WT_COMPRESSOR* wtCompressor,
+                         WT_SESSION* session,
+                         uint8_t* src,
+                         size_t srcLen,
+                         uint8_t* dst,
+                         size_t dstLen,
+                         size_t* resultLen) {
+    auto compressor = reinterpret_cast<Compressor*>(wtCompressor);
+    if (srcLen < kBlockHeaderSize || src[0] != kBlockFormat) {
+        return EINVAL;
+    }
+
+    const uint32_t version =
+        ConstDataView(reinterpret_cast<const char*>(src + 1)).read<LittleEndian<uint32_t>>();
+    std::shared_ptr<const std::string> dictionary;
+    if (version != 0) {
+        dictionary = compressor->getDictionary(version);
+        if (!dictionary) {
+            return EINVAL;
+        }
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+        return ENOMEM;
+    }
+    if (dictionary &&
+        inflateSetDictionary(
+            &zs, reinterpret_cast<const Bytef*>(dictionary->data()), dictionary->size()) != Z_OK) {
+        inflateEnd(&zs);
+        return EINVAL;
+    }
+
+    zs.next_in = src + kBlockHeaderSize;
+    zs.avail_in = srcLen - kBlockHeaderSize;
+    zs.next_out = dst;
+    zs.avail_out = dstLen;
+    const int ret = inflate(&zs, Z_FINISH);
+    *resultLen = zs.total_out;
+    inflateEnd(&zs);
+
+    return ret == Z_STREAM_END ? 0 : EIO;
+}
+
+void addCandidates(const BSONObj& obj, StringMap<size_t>* counts) {
+    for (auto&& elem : obj) {
+        ++(*counts)[StringData(elem.rawdata(), 1 + elem.fieldNameSize())];
+        if (elem.size() <= kMaxCandidateSize) {
+            ++(*counts)[StringData(elem.rawdata(), elem.size())];
+        }
+        if (elem.isABSONObj()) {
+            addCandidates(elem.Obj(), counts);
+        }
+    }
+}
+
+}  // namespace
+
+extern "C" MONGO_COMPILER_API_EXPORT int mongo_addWiredTigerDictionaryCompressors(
+    WT_CONNECTION* conn, WT_CONFIG_ARG* config) {
+    return WiredTigerDictionaryCompressors::get(getGlobalServiceContext())
+        ->registerCompressors(conn);
+}
+
+WiredTigerDictionaryCompressors* WiredTigerDictionaryCompressors::get(ServiceContext* service) {
+    return &getDictionaryCompressors(service);
+}
+
+std::string WiredTigerDictionaryCompressors::getExtensionConfig() {
+    return str::stream() << "local=(entry=" << kExtensionEntry << ")";
+}
+
+std::shared_ptr<const std::string> WiredTigerDictionaryCompressors::Compressor::getDictionary(
+    uint32_t version) const {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (version == 0 || version > dictionaries.size()) {
+        return nullptr;
+    }
+    if (versionsRead) {
+        versionsRead->insert(version);
+    }
+    return dictionaries[version - 1];
+}
+
+std::pair<uint32_t, std::shared_ptr<const std::string>>
+WiredTigerDictionaryCompressors::Compressor::getLatestDictionary() const {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (dictionaries.empty()) {
+        return {0, nullptr};
+    }
+    return {static_cast<uint32_t>(dictionaries.size()), dictionaries.back()};
+}
+
+std::string WiredTigerDictionaryCompressors::trainDictionary(const std::vector<BSONObj>& samples,
+                                                             size_t maxSize) {
+    StringMap<size_t> counts;
+    for (auto&& sample : samples) {
+        addCandidates(sample, &counts);
+    }
+
+    // Score each substring by the number of bytes it could save.
+    std::vector<std::pair<size_t, std::string>> candidates;
+    for (auto&& count : counts) {
+        if (count.second > 1) {
+            candidates.emplace_back(count.second * count.first.size(), count.first);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::vector<const std::string*> chosen;
+    size_t size = 0;
+    for (auto&& candidate : candidates) {
+        if (size + candidate.second.size() <= maxSize) {
+            chosen.push_back(&candidate.second);
+            size += candidate.second.size();
+        }
+    }
+
+    std::string dictionary;
+    dictionary.reserve(size);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        dictionary.append(**it);
+    }
+    return dictionary;
+}
+
+Status WiredTigerDictionaryCompressors::load(const std::string& dbpath, bool readOnly) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _directory = (boost::filesystem::path(dbpath) / kDirectoryName.toString()).string();
+    _readOnly = readOnly;
+    _nextId = 0;
+    for (auto&& entry : _compressors) {
+        _retired.push_back(std::move(entry.second));
+    }
+    _compressors.clear();
+
+    boost::system::error_code ec;
+    if (!boost::filesystem::exists(_directory, ec)) {
+        return Status::OK();
+    }
+
+    try {
+        for (auto&& entry : boost::filesystem::directory_iterator(_directory)) {
+            // Files of any other extension are left over by interrupted writes.
+            if (entry.path().extension() != ".bson") {
+                continue;
+            }
+            Status status = _loadCompressor(lk, entry.path().string());
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Unable to list " << _directory << ": " << ex.what()};
+    }
+
+    LOG(1) << "Loaded " << _compressors.size() << " dictionary compressors from " << _directory;
+    return Status::OK();
+}
+
+Status WiredTigerDictionaryCompressors::_loadCompressor(WithLock lk, const std::string& path) {
+    boost::system::error_code ec;
+    std::vector<char> buffer(boost::filesystem::file_size(path, ec));
+    if (ec || buffer.empty()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Unable to determine the size of " << path};
+    }
+    std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+    ifs.read(buffer.data(), buffer.size());
+    if (!ifs) {
+        return {ErrorCodes::FileStreamFailed, str::stream() << "Unable to read " << path};
+    }
+    Status status = validateBSON(buffer.data(), buffer.size(), BSONVersion::kLatest);
+    if (!status.isOK()) {
+        return status.withContext(str::stream() << "Invalid compression dictionaries in " << path);
+    }
+
+    BSONObj obj(buffer.data());
+    try {
+        const long long id = obj["id"].numberLong();
+        uassert(ErrorCodes::BadValue, str::stream() << "Invalid compressor id " << id, id >= 0);
+        Compressor* compressor = _newCompressor(lk, obj["uri"].String(), id);
+        for (auto&& entry : obj["dictionaries"].Obj()) {
+            const BSONObj dictionaryObj = entry.Obj();
+            const long long version = dictionaryObj["version"].numberLong();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Invalid dictionary version " << version,
+                    version > 0 && version <= std::numeric_limits<uint32_t>::max());
+            int len = 0;
+            const char* data = dictionaryObj["data"].binData(len);
+            if (compressor->dictionaries.size() < static_cast<size_t>(version)) {
+                compressor->dictionaries.resize(version);
+            }
+            compressor->dictionaries[version - 1] = std::make_shared<std::string>(data, len);
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus().withContext(str::stream() << "Invalid compression dictionaries in "
+                                                       << path);
+    }
+    return Status::OK();
+}
+
+bool WiredTigerDictionaryCompressors::empty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _compressors.empty();
+}
+
+WiredTigerDictionaryCompressors::Compressor* WiredTigerDictionaryCompressors::_newCompressor(
+    WithLock, StringData uri, long long id) {
+    auto compressor = stdx::make_unique<Compressor>();
+    memset(&compressor->wtCompressor, 0, sizeof(compressor->wtCompressor));
+    compressor->wtCompressor.compress = dictionaryCompress;
+    compressor->wtCompressor.decompress = dictionaryDecompress;
+    compressor->uri = uri.toString();
+    compressor->id = id;
+    compressor->name = str::stream() << "mongodb_dict_" << id;
+    _nextId = std::max(_nextId, id + 1);
+
+    auto ptr = compressor.get();
+    _compressors[uri.toString()] = std::move(compressor);
+    return ptr;
+}
+
+WiredTigerDictionaryCompressors::Compressor* WiredTigerDictionaryCompressors::_findCompressor(
+    WithLock, StringData uri) const {
+    auto it = _compressors.find(uri.toString());
+    return it == _compressors.end() ? nullptr : it->second.get();
+}
+
+std::string WiredTigerDictionaryCompressors::_pathOf(const Compressor& compressor) const {
+    return (boost::filesystem::path(_directory) / (compressor.name + ".bson")).string();
+}
+
+Status WiredTigerDictionaryCompressors::_persist(
+    const Compressor& compressor,
+    const std::vector<std::shared_ptr<const std::string>>* dictionaries) const {
+    std::vector<std::shared_ptr<const std::string>> current;
+    if (!dictionaries) {
+        stdx::lock_guard<stdx::mutex> lk(compressor.mutex);
+        current = compressor.dictionaries;
+        dictionaries = &current;
+    }
+
+    BSONObjBuilder builder;
+    builder.append("id", compressor.id);
+    builder.append("uri", compressor.uri);
+    {
+        BSONArrayBuilder dictionariesBuilder(builder.subarrayStart("dictionaries"));
+        for (size_t i = 0; i < dictionaries->size(); i++) {
+            const auto& dictionary = (*dictionaries)[i];
+            if (!dictionary) {
+                continue;
+            }
+            BSONObjBuilder dictionaryBuilder(dictionariesBuilder.subobjStart());
+            dictionaryBuilder.append("version", static_cast<long long>(i + 1));
+            dictionaryBuilder.appendBinData(
+                "data", dictionary->size(), BinDataGeneral, dictionary->data());
+        }
+    }
+    const BSONObj obj = builder.obj();
+
+    const boost::filesystem::path path(_pathOf(compressor));
+    boost::filesystem::path tempPath(path.string() + ".tmp");
+    {
+        std::ofstream ofs(tempPath.c_str(), std::ios_base::out | std::ios_base::binary);
+        ofs.write(obj.objdata(), obj.objsize());
+        if (!ofs) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Failed to write " << tempPath.string() << ": "
+                                  << errnoWithDescription()};
+        }
+    }
+
+    Status status = fsyncFile(tempPath);
+    if (!status.isOK()) {
+        return status;
+    }
+    boost::system::error_code ec;
+    boost::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        return {ErrorCodes::FileRenameFailed,
+                str::stream() << "Failed to rename " << tempPath.string() << " to "
+                              << path.string()
+                              << ": "
+                              << ec.message()};
+    }
+    return fsyncParentDirectory(path);
+}
+
+int WiredTigerDictionaryCompressors::registerCompressors(WT_CONNECTION* conn) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& entry : _compressors) {
+        Compressor* compressor = entry.second.get();
+        int ret = conn->add_compressor(
+            conn, compressor->name.c_str(), &compressor->wtCompressor, nullptr);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+StatusWith<std::string> WiredTigerDictionaryCompressors::createCompressor(StringData uri) {
+    Compressor* compressor;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (auto existing = _findCompressor(lk, uri)) {
+            return existing->name;
+        }
+        if (_readOnly) {
+            return {ErrorCodes::IllegalOperation,
+                    "Cannot create a dictionary compressor in read-only mode"};
+        }
+
+        const boost::filesystem::path directory(_directory);
+        boost::system::error_code ec;
+        if (boost::filesystem::create_directory(directory, ec)) {
+            Status status = fsyncParentDirectory(directory);
+            if (!status.isOK()) {
+                return status;
+            }
+        } else if (ec) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Failed to create " << _directory << ": " << ec.message()};
+        }
+        compressor = _newCompressor(lk, uri, _nextId);
+    }
+
+    Status status = [&] {
+        stdx::lock_guard<stdx::mutex> persistLock(compressor->persistMutex);
+        return _persist(*compressor);
+    }();
+    if (!status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _compressors.find(uri.toString());
+        if (it != _compressors.end() && it->second.get() == compressor) {
+            _retired.push_back(std::move(it->second));
+            _compressors.erase(it);
+        }
+        return status;
+    }
+    return compressor->name;
+}
+
+int WiredTigerDictionaryCompressors::registerCompressor(WT_CONNECTION* conn, StringData uri) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Compressor* compressor = _findCompressor(lk, uri);
+    invariant(compressor);
+    return conn->add_compressor(conn, compressor->name.c_str(), &compressor->wtCompressor, nullptr);
+}
+
+WT_COMPRESSOR* WiredTigerDictionaryCompressors::getCompressor(StringData uri) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Compressor* compressor = _findCompressor(lk, uri);
+    return compressor ? &compressor->wtCompressor : nullptr;
+}
+
+void WiredTigerDictionaryCompressors::dropCompressor(StringData uri) {
+    Compressor* compressor;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _compressors.find(uri.toString());
+        if (it == _compressors.end()) {
+            return;
+        }
+        compressor = it->second.get();
+        _retired.push_back(std::move(it->second));
+        _compressors.erase(it);
+    }
+
+    stdx::lock_guard<stdx::mutex> persistLock(compressor->persistMutex);
+    compressor->dropped = true;
+    const boost::filesystem::path path(_pathOf(*compressor));
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+    Status status = ec ? Status(ErrorCodes::FileStreamFailed,
+                                str::stream() << "Failed to remove " << path.string() << ": "
+                                              << ec.message())
+                       : fsyncParentDirectory(path);
+    if (!status.isOK()) {
+        warning() << "Failed to remove the dictionary compressor of " << uri << ": " << status;
+    }
+}
+
+boost::optional<uint32_t> WiredTigerDictionaryCompressors::getDictionaryVersion(
+    StringData uri) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Compressor* compressor = _findCompressor(lk, uri);
+    if (!compressor) {
+        return boost::none;
+    }
+    return compressor->getLatestDictionary().first;
+}
+
+Status WiredTigerDictionaryCompressors::train(StringData uri, const std::vector<BSONObj>& samples) {
+    const std::string dictionary = trainDictionary(samples);
+    if (dictionary.empty()) {
+        LOG(1) << "Not training a compression dictionary for " << uri
+               << ": the samples have nothing in common";
+        return Status::OK();
+    }
+
+    Compressor* compressor;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        compressor = _findCompressor(lk, uri);
+        if (!compressor) {
+            return {ErrorCodes::NoSuchKey,
+                    str::stream() << "No dictionary compressor for " << uri};
+        }
+        if (_readOnly) {
+            return {ErrorCodes::IllegalOperation,
+                    "Cannot train a compression dictionary in read-only mode"};
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> persistLock(compressor->persistMutex);
+    if (compressor->dropped) {
+        return {ErrorCodes::NoSuchKey, str::stream() << "No dictionary compressor for " << uri};
+    }
+    std::vector<std::shared_ptr<const std::string>> dictionaries;
+    {
+        stdx::lock_guard<stdx::mutex> compressorLock(compressor->mutex);
+        dictionaries = compressor->dictionaries;
+    }
+    dictionaries.push_back(std::make_shared<std::string>(dictionary));
+
+    // The dictionary must be durable before any block is compressed with it.
+    Status status = _persist(*compressor, &dictionaries);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    size_t version;
+    {
+        stdx::lock_guard<stdx::mutex> compressorLock(compressor->mutex);
+        compressor->dictionaries.push_back(dictionaries.back());
+        version = compressor->dictionaries.size();
+    }
+    log() << "Trained compression dictionary version " << version << " for " << uri << " ("
+          << dictionary.size() << " bytes from " << samples.size() << " documents)";
+    return Status::OK();
+}
+
+Status WiredTigerDictionaryCompressors::pruneDictionaries(
+    StringData uri, const stdx::function<Status()>& readAllBlocks) {
+    Compressor* compressor;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        compressor = _findCompressor(lk, uri);
+        if (!compressor || _readOnly) {
+            return Status::OK();
+        }
+    }
+
+    // Holding the persist mutex keeps the latest version from changing while the blocks are read,
+    // so any block compressed meanwhile uses a version that is kept.
+    stdx::lock_guard<stdx::mutex> persistLock(compressor->persistMutex);
+    if (compressor->dropped) {
+        return Status::OK();
+    }
+    {
+        stdx::lock_guard<stdx::mutex> compressorLock(compressor->mutex);
+        if (compressor->dictionaries.size() < 2) {
+            return Status::OK();
+        }
+        compressor->versionsRead.emplace();
+    }
+
+    Status status = readAllBlocks();
+    std::set<uint32_t> versionsRead;
+    std::vector<std::shared_ptr<const std::string>> dictionaries;
+    {
+        stdx::lock_guard<stdx::mutex> compressorLock(compressor->mutex);
+        versionsRead.swap(*compressor->versionsRead);
+        compressor->versionsRead = boost::none;
+        dictionaries = compressor->dictionaries;
+    }
+    if (!status.isOK()) {
+        return status;
+    }
+
+    size_t pruned = 0;
+    for (uint32_t version = 1; version < dictionaries.size(); version++) {
+        if (dictionaries[version - 1] && !versionsRead.count(version)) {
+            dictionaries[version - 1].reset();
+            pruned++;
+        }
+    }
+    if (pruned == 0) {
+        return Status::OK();
+    }
+
+    status = _persist(*compressor, &dictionaries);
+    if (!status.isOK()) {
+        return status;
+    }
+    {
+        stdx::lock_guard<stdx::mutex> compressorLock(compressor->mutex);
+        compressor->dictionaries.swap(dictionaries);
+    }
+    log() << "Pruned " << pruned << " unused compression dictionaries of " << uri;
+    return Status::OK();
+}
+
+}  // namespace mongo
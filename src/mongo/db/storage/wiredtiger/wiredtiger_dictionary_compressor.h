@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Manages the zlib block compressors which compress the pages of a table using a preset dictionary
+ * trained from documents of that table.
+ *
+ * WiredTiger does not tell a compressor which table a page belongs to, so every table using
+ * dictionary compression has its own named compressor, given as its 'block_compressor'. Each
+ * compressed block starts with the version of the dictionary it was compressed with, so that a
+ * table can be retrained online: new blocks use the latest dictionary while existing blocks remain
+ * readable.
+ *
+ * Recovery can decompress pages during wiredtiger_open, before any table can be read, so each
+ * compressor and its dictionaries are stored in a file of its own in a directory of the dbpath,
+ * which is loaded before wiredtiger_open. The compressors are registered with the connection by an
+ * extension loaded by wiredtiger_open. A dictionary is durable in its table's file before any block
+ * is compressed with it.
+ */
+class WiredTigerDictionaryCompressors {
+public:
+    /**
+     * Value of --wiredTigerCollectionBlockCompressor selecting dictionary compression.
+     */
+    static constexpr StringData kBlockCompressorOption = "zlib-dict"_sd;
+
+    static constexpr StringData kDirectoryName = "WiredTigerDictionaries"_sd;
+
+    /**
+     * The largest useful dictionary, since deflate only looks back 32KB.
+     */
+    static constexpr size_t kMaxDictionarySize = 32 * 1024;
+
+    static WiredTigerDictionaryCompressors* get(ServiceContext* service);
+
+    /**
+     * Returns the entry of the `wiredtiger_open` extension registering the compressors.
+     */
+    static std::string getExtensionConfig();
+
+    /**
+     * Returns a dictionary for compressing documents like 'samples', or an empty string if the
+     * samples have nothing in common. Substrings which occur the most are placed last, since
+     * deflate encodes shorter distances in fewer bits.
+     */
+    static std::string trainDictionary(const std::vector<BSONObj>& samples,
+                                       size_t maxSize = kMaxDictionarySize);
+
+    /**
+     * Replaces the compressors with the ones stored in 'dbpath'. Must be called before
+     * wiredtiger_open.
+     */
+    Status load(const std::string& dbpath, bool readOnly);
+
+    /**
+     * Returns whether any table uses dictionary compression.
+     */
+    bool empty() const;
+
+    /**
+     * Registers every compressor with 'conn'. Called by the extension during wiredtiger_open.
+     */
+    int registerCompressors(WT_CONNECTION* conn);
+
+    /**
+     * Creates and persists a compressor for the table 'uri', and returns its name. Returns the
+     * existing compressor if there is one.
+     */
+    StatusWith<std::string> createCompressor(StringData uri);
+
+    /**
+     * Registers the compressor of the table 'uri' with 'conn'.
+     */
+    int registerCompressor(WT_CONNECTION* conn, StringData uri);
+
+    /**
+     * Returns the compressor of the table 'uri', or nullptr if it has none.
+     */
+    WT_COMPRESSOR* getCompressor(StringData uri);
+
+    /**
+     * Forgets the compressor of the dropped table 'uri', if any.
+     */
+    void dropCompressor(StringData uri);
+
+    /**
+     * Returns the version of the latest dictionary of the table 'uri', 0 if it has not been
+     * trained yet, or boost::none if it does not use dictionary compression.
+     */
+    boost::optional<uint32_t> getDictionaryVersion(StringData uri) const;
+
+    /**
+     * Trains a new dictionary for the table 'uri' from 'samples' and persists it. Blocks written
+     * after this returns are compressed with the new dictionary.
+     */
+    Status train(StringData uri, const std::vector<BSONObj>& samples);
+
+    /**
+     * Forgets the dictionaries of the table 'uri' that none of its blocks was compressed with,
+     * except the latest. 'readAllBlocks' must read every block of the table from disk, as
+     * WT_SESSION::verify does. Nothing is pruned if it fails.
+     */
+    Status pruneDictionaries(StringData uri, const stdx::function<Status()>& readAllBlocks);
+
+    /**
+     * The compressor of a single table.
+     */
+    struct Compressor {
+        // Must be the first member: WiredTiger passes a pointer to it to the callbacks.
+        WT_COMPRESSOR wtCompressor;
+
+        std::string uri;
+        long long id = 0;
+        std::string name;
+
+        // Serializes the writes of the compressor's file, which happen without holding the mutex
+        // of the compressors so that lookups do not wait for them.
+        stdx::mutex persistMutex;
+        bool dropped = false;
+
+        // Dictionary versions start at 1, stored at index version - 1. Pruned versions are null.
+        mutable stdx::mutex mutex;
+        std::vector<std::shared_ptr<const std::string>> dictionaries;
+        // While pruning, the versions of the blocks decompressed.
+        mutable boost::optional<std::set<uint32_t>> versionsRead;
+
+        std::shared_ptr<const std::string> getDictionary(uint32_t version) const;
+        std::pair<uint32_t, std::shared_ptr<const std::string>> getLatestDictionary() const;
+    };
+
+private:
+    Compressor* _newCompressor(WithLock, StringData uri, long long id);
+    Compressor* _findCompressor(WithLock, StringData uri) const;
+    Status _loadCompressor(WithLock, const std::string& path);
+    std::string _pathOf(const Compressor& compressor) const;
+    // Writes the file of 'compressor', which must be locked by its 'persistMutex', with the
+    // dictionaries 'dictionaries' instead of its own if set.
+    Status _persist(const Compressor& compressor,
+                    const std::vector<std::shared_ptr<const std::string>>* dictionaries =
+                        nullptr) const;
+
+    mutable stdx::mutex _mutex;
+    std::string _directory;
+    bool _readOnly = false;
+    long long _nextId = 0;
+
+    // Compressors are never freed, since a connection may still reference them.
+    std::map<std::string, std::unique_ptr<Compressor>> _compressors;
+    std::vector<std::unique_ptr<Compressor>> _retired;
+};
+
+}  // namespace mongo
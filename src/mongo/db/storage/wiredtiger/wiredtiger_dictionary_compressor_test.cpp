@@ -0,0 +1,262 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compressor.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const char kUri[] = "table:collection-0-1";
+const char kOtherUri[] = "table:collection-2-1";
+
+std::vector<BSONObj> makeSamples(int n, int seed = 0) {
+    std::vector<BSONObj> samples;
+    for (int i = 0; i < n; i++) {
+        samples.push_back(BSON("_id" << i << "customerName"
+                                     << "customer" << "shippingAddress"
+                                     << BSON("street" << "Main Street" << "city"
+                                                      << "Springfield"
+                                                      << "zip" << (seed + i) % 1000)
+                                     << "orderStatus"
+                                     << "shipped"
+                                     << "quantity" << i % 7));
+    }
+    return samples;
+}
+
+// Concatenates documents into one buffer, as a WiredTiger page would hold them.
+std::string makePage(const std::vector<BSONObj>& docs) {
+    std::string page;
+    for (auto&& doc : docs) {
+        page.append(doc.objdata(), doc.objsize());
+    }
+    return page;
+}
+
+// Compresses 'page' with 'compressor' and returns the compressed block, or an empty string if
+// compression failed.
+std::string compress(WT_COMPRESSOR* compressor, const std::string& page) {
+    std::vector<uint8_t> src(page.begin(), page.end());
+    std::vector<uint8_t> dst(page.size() * 2 + 64);
+    size_t resultLen = 0;
+    int failed = 0;
+    ASSERT_EQ(0,
+              compressor->compress(compressor,
+                                   nullptr,
+                                   src.data(),
+                                   src.size(),
+                                   dst.data(),
+                                   dst.size(),
+                                   &resultLen,
+                                   &failed));
+    if (failed) {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(dst.data()), resultLen);
+}
+
+std::string decompress(WT_COMPRESSOR* compressor, const std::string& block, size_t pageSize) {
+    std::vector<uint8_t> src(block.begin(), block.end());
+    std::vector<uint8_t> dst(pageSize);
+    size_t resultLen = 0;
+    ASSERT_EQ(0,
+              compressor->decompress(
+                  compressor, nullptr, src.data(), src.size(), dst.data(), dst.size(), &resultLen));
+    return std::string(reinterpret_cast<const char*>(dst.data()), resultLen);
+}
+
+TEST(WiredTigerDictionaryCompressorTest, TrainedDictionaryContainsCommonFieldNames) {
+    std::string dictionary = WiredTigerDictionaryCompressors::trainDictionary(makeSamples(50));
+    ASSERT_NE(std::string::npos, dictionary.find("customerName"));
+    ASSERT_NE(std::string::npos, dictionary.find("shippingAddress"));
+    ASSERT_LTE(dictionary.size(), WiredTigerDictionaryCompressors::kMaxDictionarySize);
+
+    std::string small = WiredTigerDictionaryCompressors::trainDictionary(makeSamples(50), 64);
+    ASSERT_LTE(small.size(), 64U);
+}
+
+TEST(WiredTigerDictionaryCompressorTest, TrainingOnUnrelatedDocumentsYieldsEmptyDictionary) {
+    std::vector<BSONObj> samples{BSON("a" << 1), BSON("b" << 2), BSON("c" << 3)};
+    ASSERT_EQ(std::string(), WiredTigerDictionaryCompressors::trainDictionary(samples));
+}
+
+TEST(WiredTigerDictionaryCompressorTest, DictionaryImprovesCompressionOfSmallPages) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compressor_test");
+    WiredTigerDictionaryCompressors compressors;
+    ASSERT_OK(compressors.load(dbpath.path(), false));
+    ASSERT_TRUE(compressors.empty());
+
+    ASSERT_OK(compressors.createCompressor(kUri).getStatus());
+    ASSERT_FALSE(compressors.empty());
+    ASSERT_EQ(0U, *compressors.getDictionaryVersion(kUri));
+    WT_COMPRESSOR* compressor = compressors.getCompressor(kUri);
+    ASSERT(compressor);
+
+    const std::string page = makePage(makeSamples(4, 500));
+    const std::string plain = compress(compressor, page);
+    ASSERT_NE(std::string(), plain);
+    ASSERT_EQ(page, decompress(compressor, plain, page.size()));
+
+    ASSERT_OK(compressors.train(kUri, makeSamples(100)));
+    ASSERT_EQ(1U, *compressors.getDictionaryVersion(kUri));
+    const std::string trained = compress(compressor, page);
+    ASSERT_NE(std::string(), trained);
+    ASSERT_LT(trained.size(), plain.size());
+    ASSERT_EQ(page, decompress(compressor, trained, page.size()));
+}
+
+TEST(WiredTigerDictionaryCompressorTest, BlocksRemainReadableAfterRetraining) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compressor_test");
+    WiredTigerDictionaryCompressors compressors;
+    ASSERT_OK(compressors.load(dbpath.path(), false));
+    ASSERT_OK(compressors.createCompressor(kUri).getStatus());
+    WT_COMPRESSOR* compressor = compressors.getCompressor(kUri);
+
+    const std::string page = makePage(makeSamples(4, 500));
+    ASSERT_OK(compressors.train(kUri, makeSamples(100)));
+    const std::string first = compress(compressor, page);
+    ASSERT_NE(std::string(), first);
+
+    std::vector<BSONObj> other;
+    for (int i = 0; i < 100; i++) {
+        other.push_back(BSON("sensor" << i % 3 << "reading" << i << "unit"
+                                      << "celsius"));
+    }
+    ASSERT_OK(compressors.train(kUri, other));
+    ASSERT_EQ(2U, *compressors.getDictionaryVersion(kUri));
+
+    ASSERT_EQ(page, decompress(compressor, first, page.size()));
+    const std::string second = compress(compressor, page);
+    ASSERT_NE(std::string(), second);
+    ASSERT_EQ(page, decompress(compressor, second, page.size()));
+}
+
+TEST(WiredTigerDictionaryCompressorTest, CompressorsPersistAcrossLoad) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compressor_test");
+    const std::string page = makePage(makeSamples(4, 500));
+    std::string block;
+    std::string name;
+    {
+        WiredTigerDictionaryCompressors compressors;
+        ASSERT_OK(compressors.load(dbpath.path(), false));
+        auto swName = compressors.createCompressor(kUri);
+        ASSERT_OK(swName.getStatus());
+        name = swName.getValue();
+        ASSERT_OK(compressors.train(kUri, makeSamples(100)));
+        block = compress(compressors.getCompressor(kUri), page);
+        ASSERT_NE(std::string(), block);
+    }
+
+    WiredTigerDictionaryCompressors compressors;
+    ASSERT_OK(compressors.load(dbpath.path(), false));
+    ASSERT_EQ(1U, *compressors.getDictionaryVersion(kUri));
+    ASSERT_EQ(name, compressors.createCompressor(kUri).getValue());
+    ASSERT_EQ(page, decompress(compressors.getCompressor(kUri), block, page.size()));
+
+    compressors.dropCompressor(kUri);
+    ASSERT_FALSE(compressors.getDictionaryVersion(kUri));
+    ASSERT_FALSE(compressors.getCompressor(kUri));
+}
+
+TEST(WiredTigerDictionaryCompressorTest, DroppingACompressorKeepsTheOthers) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compressor_test");
+    std::string otherName;
+    {
+        WiredTigerDictionaryCompressors compressors;
+        ASSERT_OK(compressors.load(dbpath.path(), false));
+        ASSERT_OK(compressors.createCompressor(kUri).getStatus());
+        otherName = compressors.createCompressor(kOtherUri).getValue();
+        ASSERT_OK(compressors.train(kOtherUri, makeSamples(100)));
+        compressors.dropCompressor(kUri);
+    }
+
+    WiredTigerDictionaryCompressors compressors;
+    ASSERT_OK(compressors.load(dbpath.path(), false));
+    ASSERT_FALSE(compressors.getDictionaryVersion(kUri));
+    ASSERT_EQ(1U, *compressors.getDictionaryVersion(kOtherUri));
+    ASSERT_EQ(otherName, compressors.createCompressor(kOtherUri).getValue());
+
+    // A new compressor does not reuse the name of a loaded one.
+    ASSERT_NE(otherName, compressors.createCompressor(kUri).getValue());
+}
+
+TEST(WiredTigerDictionaryCompressorTest, PruningForgetsOnlyUnreadDictionaries) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compressor_test");
+    const std::string page = makePage(makeSamples(4, 500));
+    std::string block;
+    {
+        WiredTigerDictionaryCompressors compressors;
+        ASSERT_OK(compressors.load(dbpath.path(), false));
+        ASSERT_OK(compressors.createCompressor(kUri).getStatus());
+        WT_COMPRESSOR* compressor = compressors.getCompressor(kUri);
+        ASSERT_OK(compressors.train(kUri, makeSamples(100)));
+        block = compress(compressor, page);
+        ASSERT_NE(std::string(), block);
+        ASSERT_OK(compressors.train(kUri, makeSamples(100, 7)));
+
+        // Nothing is pruned if reading the blocks fails, or while a block needs the dictionary.
+        ASSERT_NOT_OK(compressors.pruneDictionaries(
+            kUri, [] { return Status(ErrorCodes::InternalError, "read failed"); }));
+        ASSERT_OK(compressors.pruneDictionaries(kUri, [&] {
+            ASSERT_EQ(page, decompress(compressor, block, page.size()));
+            return Status::OK();
+        }));
+        ASSERT_EQ(page, decompress(compressor, block, page.size()));
+    }
+
+    WiredTigerDictionaryCompressors compressors;
+    ASSERT_OK(compressors.load(dbpath.path(), false));
+    WT_COMPRESSOR* compressor = compressors.getCompressor(kUri);
+    ASSERT_EQ(page, decompress(compressor, block, page.size()));
+
+    ASSERT_OK(compressors.pruneDictionaries(kUri, [] { return Status::OK(); }));
+    ASSERT_EQ(2U, *compressors.getDictionaryVersion(kUri));
+    std::vector<uint8_t> src(block.begin(), block.end());
+    std::vector<uint8_t> dst(page.size());
+    size_t resultLen = 0;
+    ASSERT_EQ(EINVAL,
+              compressor->decompress(
+                  compressor, nullptr, src.data(), src.size(), dst.data(), dst.size(), &resultLen));
+
+    // The latest dictionary is kept across loads.
+    WiredTigerDictionaryCompressors reloaded;
+    ASSERT_OK(reloaded.load(dbpath.path(), false));
+    ASSERT_EQ(2U, *reloaded.getDictionaryVersion(kUri));
+    const std::string latest = compress(reloaded.getCompressor(kUri), page);
+    ASSERT_NE(std::string(), latest);
+    ASSERT_EQ(page, decompress(reloaded.getCompressor(kUri), latest, page.size()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,8 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -61,6 +63,10 @@ std::string WiredTigerExtensions::getOpenExtensionsConfig() const {
 }
 
 void WiredTigerExtensions::addExtension(StringData extensionConfigStr) {
+    if (std::find(_wtExtensions.begin(), _wtExtensions.end(), extensionConfigStr) !=
+        _wtExtensions.end()) {
+        return;
+    }
     _wtExtensions.emplace_back(extensionConfigStr.toString());
 }
 
@@ -47,7 +47,7 @@ public:
     std::string getOpenExtensionsConfig() const;
 
     /**
-     * Add an item to the `wiredtiger_open` extensions list.
+     * Add an item to the `wiredtiger_open` extensions list, unless it is already in it.
      */
     void addExtension(StringData extensionConfigStr);
 
@@ -84,8 +84,8 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            "wiredTigerCollectionBlockCompressor",
                            moe::String,
                            "block compression algorithm for collection data "
-                           "[none|snappy|zlib]")
-        .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
+                           "[none|snappy|zlib|zlib-dict]")
+        .format("(:?none)|(:?snappy)|(:?zlib)|(:?zlib-dict)", "(none/snappy/zlib/zlib-dict)")
         .setDefault(moe::Value(std::string("snappy")));
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.configString",
@@ -102,6 +102,13 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            moe::Bool,
                            "use prefix compression on row-store leaf pages")
         .setDefault(moe::Value(true));
+    wiredTigerOptions
+        .addOptionChaining("storage.wiredTiger.indexConfig.compactKeyFormat",
+                           "wiredTigerIndexCompactKeyFormat",
+                           moe::Bool,
+                           "create new non-unique indexes in the compact key format, which cannot "
+                           "be read by earlier versions")
+        .setDefault(moe::Value(false));
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.indexConfig.configString",
                            "wiredTigerIndexConfigString",
@@ -157,6 +164,10 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         wiredTigerGlobalOptions.useIndexPrefixCompression =
             params["storage.wiredTiger.indexConfig.prefixCompression"].as<bool>();
     }
+    if (params.count("storage.wiredTiger.indexConfig.compactKeyFormat")) {
+        wiredTigerGlobalOptions.useIndexCompactKeyFormat =
+            params["storage.wiredTiger.indexConfig.compactKeyFormat"].as<bool>();
+    }
     if (params.count("storage.wiredTiger.indexConfig.configString")) {
         wiredTigerGlobalOptions.indexConfig =
             params["storage.wiredTiger.indexConfig.configString"].as<std::string>();
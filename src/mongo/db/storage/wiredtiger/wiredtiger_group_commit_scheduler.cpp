@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit_scheduler.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+// The commit window grows by this fraction of the target latency after each shared group.
+const int kWindowGrowthDivisor = 8;
+}  // namespace
+
+WiredTigerGroupCommitScheduler::WiredTigerGroupCommitScheduler(FlushFn flushFn)
+    : _flushFn(std::move(flushFn)) {}
+
+void WiredTigerGroupCommitScheduler::waitForFlush(Microseconds targetLatency) {
+    Timer waitTimer;
+    _requests.fetchAndAdd(1);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    // A flush that is already running may have started before our writes committed, so we must
+    // wait for the one after it.
+    const std::uint64_t target = _startedGeneration + 1;
+    ++_pendingRequests;
+
+    while (_completedGeneration < target) {
+        if (_leaderActive) {
+            _flushFinished.wait(lk);
+            continue;
+        }
+
+        // No group is scheduled: lead the next one.
+        invariant(_startedGeneration == _completedGeneration);
+        _leaderActive = true;
+
+        const Microseconds window = _commitWindow;
+        if (window > Microseconds(0)) {
+            lk.unlock();
+            sleepFor(window);
+            lk.lock();
+        }
+
+        const std::size_t groupSize = _pendingRequests;
+        _pendingRequests = 0;
+        ++_startedGeneration;
+        lk.unlock();
+
+        Timer flushTimer;
+        try {
+            _flushFn();
+        } catch (...) {
+            lk.lock();
+            // Leave the group unflushed; its other members will elect a new leader.
+            --_startedGeneration;
+            _pendingRequests += groupSize - 1;
+            _leaderActive = false;
+            _flushFinished.notify_all();
+            throw;
+        }
+        const Microseconds flushDuration(flushTimer.micros());
+
+        _flushes.fetchAndAdd(1);
+        _flushLatency.increment(flushDuration);
+
+        lk.lock();
+        _completedGeneration = _startedGeneration;
+        _leaderActive = false;
+        _adjustCommitWindow(lk, targetLatency, groupSize, window + flushDuration);
+        _flushFinished.notify_all();
+    }
+    lk.unlock();
+
+    _waitLatency.increment(Microseconds(waitTimer.micros()));
+}
+
+void WiredTigerGroupCommitScheduler::_adjustCommitWindow(WithLock,
+                                                         Microseconds targetLatency,
+                                                         std::size_t groupSize,
+                                                         Microseconds leaderLatency) {
+    if (targetLatency <= Microseconds(0)) {
+        _commitWindow = Microseconds(0);
+        return;
+    }
+
+    // Additive increase while the window is paying off: several callers shared the flush and the
+    // leader still finished within the target. Multiplicative decrease otherwise, so that a burst
+    // ending or the disk slowing down quickly stops adding latency.
+    if (groupSize > 1 && leaderLatency < targetLatency) {
+        const Microseconds step =
+            std::max(Microseconds(1), targetLatency / kWindowGrowthDivisor);
+        _commitWindow = std::min(_commitWindow + step, targetLatency);
+    } else {
+        _commitWindow = _commitWindow / 2;
+    }
+}
+
+Microseconds WiredTigerGroupCommitScheduler::getCommitWindow() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _commitWindow;
+}
+
+void WiredTigerGroupCommitScheduler::appendStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder bob(builder->subobjStart("group-commit"));
+    bob.append("durability requests", static_cast<long long>(_requests.load()));
+    bob.append("journal flushes", static_cast<long long>(_flushes.load()));
+    bob.append("commit window micros", durationCount<Microseconds>(getCommitWindow()));
+    _waitLatency.append("durability waits", true, &bob);
+    _flushLatency.append("flushes", true, &bob);
+    bob.done();
+}
+
+}  // namespace mongo
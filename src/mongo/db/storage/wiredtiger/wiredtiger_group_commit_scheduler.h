@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/latency_histogram.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Coalesces concurrent requests for journal durability into as few flushes as possible.
+ *
+ * Each call to waitForFlush() returns once a flush that started after the call was made has
+ * completed. The first caller to find no flush scheduled becomes the leader for the next group:
+ * it holds the group open for the current commit window so that other callers can join, then runs
+ * the flush function once on behalf of every member. Callers that arrive while a flush is running
+ * join the following group, and wait on a condition variable rather than convoying on a mutex.
+ *
+ * The commit window adapts to load, bounded by the target latency passed to waitForFlush(). It
+ * grows while groups are shared by several callers and the flushes finish within the target, and
+ * shrinks whenever a group has a single member or a wait overshoots the target, so that an idle or
+ * single-threaded workload pays no added latency. A target latency of zero disables the window.
+ */
+class WiredTigerGroupCommitScheduler {
+    MONGO_DISALLOW_COPYING(WiredTigerGroupCommitScheduler);
+
+public:
+    using FlushFn = stdx::function<void()>;
+
+    explicit WiredTigerGroupCommitScheduler(FlushFn flushFn);
+
+    /**
+     * Blocks until a flush that started after this call has completed. If the flush function
+     * throws, the exception propagates to the leader that ran it and the other members of the
+     * group retry with a new leader.
+     */
+    void waitForFlush(Microseconds targetLatency);
+
+    /**
+     * Returns the window the next group leader will hold its group open for.
+     */
+    Microseconds getCommitWindow() const;
+
+    /**
+     * Appends flush and request counts, the current commit window, and histograms of the time
+     * callers spent waiting for durability and of the flushes themselves.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _adjustCommitWindow(WithLock,
+                             Microseconds targetLatency,
+                             std::size_t groupSize,
+                             Microseconds leaderLatency);
+
+    const FlushFn _flushFn;
+
+    mutable stdx::mutex _mutex;
+    // Notified when a flush completes or its leader gives up.
+    stdx::condition_variable _flushFinished;
+
+    // Generation numbers of the most recently started and completed flushes.
+    std::uint64_t _startedGeneration = 0;    // Guarded by _mutex.
+    std::uint64_t _completedGeneration = 0;  // Guarded by _mutex.
+
+    // Whether a leader currently owns the next group, either holding it open or flushing it.
+    bool _leaderActive = false;  // Guarded by _mutex.
+
+    // Number of callers waiting for the group that has not started flushing yet.
+    std::size_t _pendingRequests = 0;  // Guarded by _mutex.
+
+    Microseconds _commitWindow{0};  // Guarded by _mutex.
+
+    AtomicUInt64 _flushes;
+    AtomicUInt64 _requests;
+    LatencyHistogram _waitLatency;
+    LatencyHistogram _flushLatency;
+};
+
+}  // namespace mongo
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit_scheduler.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+long long getStat(const WiredTigerGroupCommitScheduler& scheduler, StringData field) {
+    BSONObjBuilder bob;
+    scheduler.appendStats(&bob);
+    return bob.obj()["group-commit"][field].numberLong();
+}
+
+/**
+ * Holds the first flush open until release() is called, so that tests can queue callers behind
+ * a running flush.
+ */
+class BlockingFlush {
+public:
+    void operator()() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        ++_flushes;
+        _released.wait(lk, [&] { return _isReleased; });
+    }
+
+    void release() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _isReleased = true;
+        _released.notify_all();
+    }
+
+    int getFlushes() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _flushes;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _released;
+    bool _isReleased = false;
+    int _flushes = 0;
+};
+
+/**
+ * Starts one caller and lets its flush block, queues 'numWaiters' more callers behind it, then
+ * releases the flush and waits for every caller to return.
+ */
+void runQueuedBehindFlush(WiredTigerGroupCommitScheduler& scheduler,
+                          BlockingFlush& flush,
+                          Microseconds targetLatency,
+                          int numWaiters) {
+    std::vector<stdx::thread> threads;
+    threads.emplace_back([&] { scheduler.waitForFlush(targetLatency); });
+    while (flush.getFlushes() == 0) {
+        sleepmillis(1);
+    }
+
+    for (int i = 0; i < numWaiters; ++i) {
+        threads.emplace_back([&] { scheduler.waitForFlush(targetLatency); });
+    }
+    while (getStat(scheduler, "durability requests") < numWaiters + 1) {
+        sleepmillis(1);
+    }
+
+    flush.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(WiredTigerGroupCommitSchedulerTest, SingleCallerFlushesOnce) {
+    int flushes = 0;
+    WiredTigerGroupCommitScheduler scheduler([&] { ++flushes; });
+
+    scheduler.waitForFlush(Microseconds(0));
+    ASSERT_EQ(1, flushes);
+    scheduler.waitForFlush(Microseconds(0));
+    ASSERT_EQ(2, flushes);
+
+    ASSERT_EQ(2, getStat(scheduler, "durability requests"));
+    ASSERT_EQ(2, getStat(scheduler, "journal flushes"));
+}
+
+TEST(WiredTigerGroupCommitSchedulerTest, CallersQueuedBehindFlushShareNextFlush) {
+    BlockingFlush flush;
+    WiredTigerGroupCommitScheduler scheduler([&] { flush(); });
+
+    runQueuedBehindFlush(scheduler, flush, Microseconds(0), 8);
+
+    // One flush for the first caller, and a single flush for everyone who queued behind it.
+    ASSERT_EQ(2, flush.getFlushes());
+    ASSERT_EQ(9, getStat(scheduler, "durability requests"));
+    ASSERT_EQ(2, getStat(scheduler, "journal flushes"));
+}
+
+TEST(WiredTigerGroupCommitSchedulerTest, ZeroTargetLatencyDisablesCommitWindow) {
+    BlockingFlush flush;
+    WiredTigerGroupCommitScheduler scheduler([&] { flush(); });
+
+    runQueuedBehindFlush(scheduler, flush, Microseconds(0), 4);
+    ASSERT_EQ(Microseconds(0), scheduler.getCommitWindow());
+}
+
+TEST(WiredTigerGroupCommitSchedulerTest, CommitWindowGrowsForSharedGroupsAndShrinksWhenIdle) {
+    BlockingFlush flush;
+    WiredTigerGroupCommitScheduler scheduler([&] { flush(); });
+    const Microseconds target = Milliseconds(100);
+
+    // The first group has one member, the second is shared by all queued callers.
+    runQueuedBehindFlush(scheduler, flush, target, 4);
+    const Microseconds grown = scheduler.getCommitWindow();
+    ASSERT_GT(grown, Microseconds(0));
+    ASSERT_LTE(grown, target);
+
+    // A lone caller gains nothing from waiting, so the window backs off.
+    scheduler.waitForFlush(target);
+    ASSERT_LT(scheduler.getCommitWindow(), grown);
+}
+
+TEST(WiredTigerGroupCommitSchedulerTest, FailedFlushPropagatesAndDoesNotCountAsDurable) {
+    int attempts = 0;
+    WiredTigerGroupCommitScheduler scheduler([&] {
+        if (++attempts == 1) {
+            uasserted(ErrorCodes::InternalError, "flush failed");
+        }
+    });
+
+    ASSERT_THROWS_CODE(
+        scheduler.waitForFlush(Microseconds(0)), AssertionException, ErrorCodes::InternalError);
+    ASSERT_EQ(0, getStat(scheduler, "journal flushes"));
+
+    scheduler.waitForFlush(Microseconds(0));
+    ASSERT_EQ(2, attempts);
+    ASSERT_EQ(1, getStat(scheduler, "journal flushes"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 
+#include <algorithm>
 #include <set>
 
 #include "mongo/base/checked_cast.h"
@@ -107,12 +108,35 @@ BSONObj stripFieldNames(const BSONObj& query) {
 // Keystring format 7 was used in 3.3.6 - 3.3.8 development releases. 4.2 onwards, unique indexes
 // can be either format version 11 or 12. On upgrading to 4.2, an existing format 6 unique index
 // will upgrade to format 11 and an existing format 8 unique index will upgrade to format 12.
+// Format 13 is a non-unique index in the compact key format: leaf pages always elide the common
+// prefix of adjacent keys, and TypeBits are stored without their size byte(s), since they make
+// up the whole value.
 const int kDataFormatV1KeyStringV0IndexVersionV1 = 6;
 const int kDataFormatV2KeyStringV1IndexVersionV2 = 8;
 const int kDataFormatV3KeyStringV0UniqueIndexVersionV1 = 11;
 const int kDataFormatV4KeyStringV1UniqueIndexVersionV2 = 12;
+const int kDataFormatV5KeyStringV1CompactIndexVersionV2 = 13;
 const int kMinimumIndexVersion = kDataFormatV1KeyStringV0IndexVersionV1;
-const int kMaximumIndexVersion = kDataFormatV4KeyStringV1UniqueIndexVersionV2;
+const int kMaximumIndexVersion = kDataFormatV5KeyStringV1CompactIndexVersionV2;
+
+namespace {
+// Like the timestamp safe unique formats, the compact format cannot be read by 4.0 binaries, so it
+// is only used while the FCV is upgrading or upgraded to 4.2.
+bool useCompactKeyFormat(const IndexDescriptor& desc) {
+    return wiredTigerGlobalOptions.useIndexCompactKeyFormat && !desc.unique() &&
+        desc.version() >= IndexDescriptor::IndexVersion::kV2 &&
+        serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+        serverGlobalParams.featureCompatibility.isVersionUpgradingOrUpgraded();
+}
+
+WiredTigerItem makeTypeBitsItem(const KeyString::TypeBits& typeBits, bool compact) {
+    if (typeBits.isAllZeros()) {
+        return emptyItem;
+    }
+    return compact ? WiredTigerItem(typeBits.getRawBuffer(), typeBits.getRawSize())
+                   : WiredTigerItem(typeBits.getBuffer(), typeBits.getSize());
+}
+}  // namespace
 
 Status WiredTigerIndex::dupKeyError(const BSONObj& key) {
     StringBuilder sb;
@@ -175,6 +199,8 @@ std::string WiredTigerIndex::generateAppMetadataString(const IndexDescriptor& de
         keyStringVersion = desc.version() >= IndexDescriptor::IndexVersion::kV2
             ? kDataFormatV4KeyStringV1UniqueIndexVersionV2
             : kDataFormatV3KeyStringV0UniqueIndexVersionV1;
+    } else if (useCompactKeyFormat(desc)) {
+        keyStringVersion = kDataFormatV5KeyStringV1CompactIndexVersionV2;
     } else {
         keyStringVersion = desc.version() >= IndexDescriptor::IndexVersion::kV2
             ? kDataFormatV2KeyStringV1IndexVersionV2
@@ -202,7 +228,11 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
     // keys (up to 1024 bytes) will not overflow.
     ss << "type=file,internal_page_max=16k,leaf_page_max=16k,";
     ss << "checksum=on,";
-    if (wiredTigerGlobalOptions.useIndexPrefixCompression) {
+    if (useCompactKeyFormat(desc)) {
+        // Elide any common prefix, however short: keys of compound indexes on low-cardinality
+        // leading fields share most of their bytes with their neighbours.
+        ss << "prefix_compression=true,prefix_compression_min=1,";
+    } else if (wiredTigerGlobalOptions.useIndexPrefixCompression) {
         ss << "prefix_compression=true,";
     }
 
@@ -293,10 +323,11 @@ WiredTigerIndex::WiredTigerIndex(OperationContext* ctx,
     }
     _dataFormatVersion = version.getValue();
 
-    // Index data format 6 and 11 correspond to KeyString version V0 and data format 8 and 12
+    // Index data format 6 and 11 correspond to KeyString version V0 and data format 8, 12 and 13
     // correspond to KeyString version V1
     _keyStringVersion = (_dataFormatVersion == kDataFormatV2KeyStringV1IndexVersionV2 ||
-                         _dataFormatVersion == kDataFormatV4KeyStringV1UniqueIndexVersionV2)
+                         _dataFormatVersion == kDataFormatV4KeyStringV1UniqueIndexVersionV2 ||
+                         _dataFormatVersion == kDataFormatV5KeyStringV1CompactIndexVersionV2)
         ? KeyString::Version::V1
         : KeyString::Version::V0;
 }
@@ -332,6 +363,71 @@ void WiredTigerIndex::unindex(OperationContext* opCtx,
     _unindex(opCtx, c, key, id, dupsAllowed);
 }
 
+namespace {
+/**
+ * Returns pointers to the elements of 'keys' in index order, so that a batch of writes walks the
+ * tree left to right and each operation lands on or near the page touched by the previous one.
+ */
+std::vector<const IndexKeyEntry*> sortedKeyEntries(const std::vector<IndexKeyEntry>& keys,
+                                                   Ordering ordering) {
+    std::vector<const IndexKeyEntry*> sorted;
+    sorted.reserve(keys.size());
+    for (const auto& entry : keys) {
+        sorted.push_back(&entry);
+    }
+
+    IndexEntryComparison comparison(ordering);
+    std::sort(sorted.begin(),
+              sorted.end(),
+              [&](const IndexKeyEntry* lhs, const IndexKeyEntry* rhs) {
+                  return comparison(*lhs, *rhs);
+              });
+    return sorted;
+}
+}  // namespace
+
+Status WiredTigerIndex::insertKeys(OperationContext* opCtx,
+                                   const std::vector<IndexKeyEntry>& keys,
+                                   bool dupsAllowed) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    if (keys.empty())
+        return Status::OK();
+
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const IndexKeyEntry* entry : sortedKeyEntries(keys, _ordering)) {
+        invariant(entry->loc.isValid());
+        dassert(!hasFieldNames(entry->key));
+
+        Status status = _insert(opCtx, c, entry->key, entry->loc, dupsAllowed);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
+void WiredTigerIndex::unindexKeys(OperationContext* opCtx,
+                                  const std::vector<IndexKeyEntry>& keys,
+                                  bool dupsAllowed) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    if (keys.empty())
+        return;
+
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    for (const IndexKeyEntry* entry : sortedKeyEntries(keys, _ordering)) {
+        invariant(entry->loc.isValid());
+        dassert(!hasFieldNames(entry->key));
+
+        _unindex(opCtx, c, entry->key, entry->loc, dupsAllowed);
+    }
+}
+
 void WiredTigerIndex::fullValidate(OperationContext* opCtx,
                                    long long* numKeysOut,
                                    ValidateResults* fullResults) const {
@@ -618,9 +714,8 @@ public:
         WiredTigerItem item(data.getBuffer(), data.getSize());
         setKey(_cursor, item.Get());
 
-        WiredTigerItem valueItem = data.getTypeBits().isAllZeros()
-            ? emptyItem
-            : WiredTigerItem(data.getTypeBits().getBuffer(), data.getTypeBits().getSize());
+        WiredTigerItem valueItem =
+            makeTypeBitsItem(data.getTypeBits(), _idx->isCompactKeyFormat());
 
         _cursor->set_value(_cursor, valueItem.Get());
 
@@ -909,6 +1004,10 @@ protected:
         auto ret = c->get_value(c, &item);
         invariant(ret != WT_ROLLBACK && ret != WT_PREPARE_CONFLICT);
         invariantWTOK(ret);
+        if (_idx.isCompactKeyFormat()) {
+            _typeBits.resetFromRawBuffer(static_cast<const char*>(item.data), item.size);
+            return;
+        }
         BufReader br(item.data, item.size);
         _typeBits.resetFromBuffer(&br);
     }
@@ -1235,6 +1334,14 @@ SortedDataBuilderInterface* WiredTigerIndexUnique::getBulkBuilder(OperationConte
     return new UniqueBulkBuilder(this, opCtx, dupsAllowed, _prefix);
 }
 
+bool WiredTigerIndex::requiresFCV42() const {
+    return isCompactKeyFormat();
+}
+
+bool WiredTigerIndex::isCompactKeyFormat() const {
+    return _dataFormatVersion == kDataFormatV5KeyStringV1CompactIndexVersionV2;
+}
+
 bool WiredTigerIndexUnique::isTimestampSafeUniqueIdx() const {
     if (_dataFormatVersion == kDataFormatV1KeyStringV0IndexVersionV1 ||
         _dataFormatVersion == kDataFormatV2KeyStringV1IndexVersionV2) {
@@ -1634,9 +1741,7 @@ Status WiredTigerIndexStandard::_insert(OperationContext* opCtx,
     KeyString key(keyStringVersion(), keyBson, _ordering, id);
     WiredTigerItem keyItem(key.getBuffer(), key.getSize());
 
-    WiredTigerItem valueItem = key.getTypeBits().isAllZeros()
-        ? emptyItem
-        : WiredTigerItem(key.getTypeBits().getBuffer(), key.getTypeBits().getSize());
+    WiredTigerItem valueItem = makeTypeBitsItem(key.getTypeBits(), isCompactKeyFormat());
 
     setKey(c, keyItem.Get());
     c->set_value(c, valueItem.Get());
@@ -100,6 +100,14 @@ public:
                          const RecordId& id,
                          bool dupsAllowed);
 
+    virtual Status insertKeys(OperationContext* opCtx,
+                              const std::vector<IndexKeyEntry>& keys,
+                              bool dupsAllowed);
+
+    virtual void unindexKeys(OperationContext* opCtx,
+                             const std::vector<IndexKeyEntry>& keys,
+                             bool dupsAllowed);
+
     virtual void fullValidate(OperationContext* opCtx,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const;
@@ -118,6 +126,8 @@ public:
 
     virtual Status compact(OperationContext* opCtx);
 
+    virtual bool requiresFCV42() const;
+
     const std::string& uri() const {
         return _uri;
     }
@@ -155,6 +165,12 @@ public:
     virtual bool unique() const = 0;
     virtual bool isTimestampSafeUniqueIdx() const = 0;
 
+    /**
+     * Returns true if the index is in the compact key format, whose values hold TypeBits without
+     * their size byte(s).
+     */
+    bool isCompactKeyFormat() const;
+
     Status dupKeyError(const BSONObj& key);
 
 protected:
@@ -41,6 +41,7 @@
 #define NVALGRIND
 #endif
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
@@ -72,6 +73,7 @@
 #include "mongo/db/storage/storage_file_util.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compressor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
@@ -79,9 +81,11 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
@@ -253,13 +257,64 @@ private:
     AtomicBool _shuttingDown{false};
 };
 
+namespace {
+// How often the checkpoint thread checks whether a checkpoint is due.
+const Milliseconds kCheckpointPollInterval = Seconds(1);
+
+// Take a checkpoint ahead of 'syncdelay' once this percentage of the cache is dirty. 0 disables.
+AtomicInt32 wiredTigerCheckpointDirtyCacheTriggerPercent(10);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointDirtyCacheTriggerPercentSetting(
+        ServerParameterSet::getGlobal(),
+        "wiredTigerCheckpointDirtyCacheTriggerPercent",
+        &wiredTigerCheckpointDirtyCacheTriggerPercent);
+
+// Take a checkpoint ahead of 'syncdelay' once this many megabytes have been written to the journal
+// since the last one. 0 disables.
+AtomicInt32 wiredTigerCheckpointJournalTriggerMB(2048);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointJournalTriggerMBSetting(ServerParameterSet::getGlobal(),
+                                                "wiredTigerCheckpointJournalTriggerMB",
+                                                &wiredTigerCheckpointJournalTriggerMB);
+
+// Minimum time between a checkpoint and an early one triggered by dirty data or journal size.
+AtomicInt32 wiredTigerCheckpointMinIntervalSecs(10);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointMinIntervalSecsSetting(ServerParameterSet::getGlobal(),
+                                               "wiredTigerCheckpointMinIntervalSecs",
+                                               &wiredTigerCheckpointMinIntervalSecs);
+
+// How long an early checkpoint may be deferred while the commit rate is bursting. 0 disables.
+AtomicInt32 wiredTigerCheckpointMaxDeferralSecs(5);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointMaxDeferralSecsSetting(ServerParameterSet::getGlobal(),
+                                               "wiredTigerCheckpointMaxDeferralSecs",
+                                               &wiredTigerCheckpointMaxDeferralSecs);
+
+WiredTigerCheckpointScheduler::Settings getCheckpointSchedulerSettings() {
+    WiredTigerCheckpointScheduler::Settings settings;
+    settings.maxInterval =
+        Seconds(static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+    settings.minInterval = Seconds(std::max(0, wiredTigerCheckpointMinIntervalSecs.load()));
+    settings.dirtyCacheTriggerPercent = wiredTigerCheckpointDirtyCacheTriggerPercent.load();
+    settings.journalTriggerBytes =
+        static_cast<std::int64_t>(wiredTigerCheckpointJournalTriggerMB.load()) * 1024 * 1024;
+    settings.maxDeferral = Seconds(std::max(0, wiredTigerCheckpointMaxDeferralSecs.load()));
+    return settings;
+}
+}  // namespace
+
 class WiredTigerKVEngine::WiredTigerCheckpointThread : public BackgroundJob {
 public:
     explicit WiredTigerCheckpointThread(WiredTigerKVEngine* wiredTigerKVEngine,
-                                        WiredTigerSessionCache* sessionCache)
+                                        WiredTigerSessionCache* sessionCache,
+                                        WiredTigerCheckpointScheduler* scheduler,
+                                        ClockSource* clockSource)
         : BackgroundJob(false /* deleteSelf */),
           _wiredTigerKVEngine(wiredTigerKVEngine),
-          _sessionCache(sessionCache) {}
+          _sessionCache(sessionCache),
+          _scheduler(scheduler),
+          _clockSource(clockSource) {}
 
     virtual string name() const {
         return "WTCheckpointThread";
@@ -272,52 +327,35 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
+            bool requested;
             {
                 stdx::unique_lock<stdx::mutex> lock(_mutex);
                 MONGO_IDLE_THREAD_BLOCK;
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)));
+                _condvar.wait_for(lock, kCheckpointPollInterval.toSystemDuration(), [&] {
+                    return _checkpointRequested;
+                });
+                requested = _checkpointRequested;
+                _checkpointRequested = false;
             }
 
-            const Timestamp stableTimestamp = _wiredTigerKVEngine->getStableTimestamp();
-            const Timestamp initialDataTimestamp = _wiredTigerKVEngine->getInitialDataTimestamp();
             try {
-                // Three cases:
-                //
-                // First, initialDataTimestamp is Timestamp(0, 1) -> Take full checkpoint. This is
-                // when there is no consistent view of the data (i.e: during initial sync).
-                //
-                // Second, stableTimestamp < initialDataTimestamp: Skip checkpoints. The data on
-                // disk is prone to being rolled back. Hold off on checkpoints.  Hope that the
-                // stable timestamp surpasses the data on disk, allowing storage to persist newer
-                // copies to disk.
-                //
-                // Third, stableTimestamp >= initialDataTimestamp: Take stable checkpoint. Steady
-                // state case.
-                if (initialDataTimestamp.asULL() <= 1) {
-                    UniqueWiredTigerSession session = _sessionCache->getSession();
-                    WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
-                } else if (stableTimestamp < initialDataTimestamp) {
-                    LOG_FOR_RECOVERY(2)
-                        << "Stable timestamp is behind the initial data timestamp, skipping "
-                           "a checkpoint. StableTimestamp: "
-                        << stableTimestamp.toString()
-                        << " InitialDataTimestamp: " << initialDataTimestamp.toString();
+                // The scheduler decides when a checkpoint is due based on time, dirty data and
+                // journal growth. Explicit requests (the first stable checkpoint and shutdown)
+                // bypass it.
+                const WiredTigerCheckpointScheduler::LoadSample sample = _sampleLoad();
+                const WiredTigerCheckpointScheduler::Trigger trigger = requested
+                    ? WiredTigerCheckpointScheduler::Trigger::kRequested
+                    : _scheduler->evaluate(getCheckpointSchedulerSettings(), sample);
+                if (trigger == WiredTigerCheckpointScheduler::Trigger::kNone) {
+                    continue;
+                }
+
+                LOG(2) << "Checkpoint triggered by "
+                       << WiredTigerCheckpointScheduler::triggerName(trigger);
+                if (_checkpoint()) {
+                    _scheduler->onCheckpointCompleted(trigger, sample, _clockSource->now());
                 } else {
-                    // 'stableTimestamp' is the smallest possible value at which WT will take a
-                    // stable checkpoint. A newer stable timestamp may be used by WT if one is
-                    // concurrently set.
-                    LOG_FOR_RECOVERY(2) << "Performing stable checkpoint. StableTimestamp: "
-                                        << stableTimestamp;
-
-                    UniqueWiredTigerSession session = _sessionCache->getSession();
-                    WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
-
-                    // Publish the checkpoint time after the checkpoint becomes durable.
-                    _lastStableCheckpointTimestamp.store(stableTimestamp.asULL());
+                    _scheduler->onCheckpointSkipped(_clockSource->now());
                 }
             } catch (const WriteConflictException&) {
                 // Temporary: remove this after WT-3483
@@ -340,9 +378,9 @@ public:
      * Triggers taking the first stable checkpoint, which is when the stable timestamp advances past
      * the initial data timestamp.
      *
-     * The checkpoint thread runs automatically every wiredTigerGlobalOptions.checkpointDelaySecs
-     * seconds. This function avoids potentially waiting that full duration for a stable checkpoint,
-     * initiating one immediately.
+     * The checkpoint thread runs automatically at least every
+     * wiredTigerGlobalOptions.checkpointDelaySecs seconds. This function avoids potentially waiting
+     * that full duration for a stable checkpoint, initiating one immediately.
      *
      * Do not call this function if hasTriggeredFirstStableCheckpoint() returns true.
      */
@@ -355,6 +393,7 @@ public:
             log() << "Triggering the first stable checkpoint. Initial Data: " << initialData
                   << " PrevStable: " << prevStable << " CurrStable: " << currStable;
             stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _checkpointRequested = true;
             _condvar.notify_one();
         }
     }
@@ -369,19 +408,94 @@ public:
             stdx::unique_lock<stdx::mutex> lock(_mutex);
             // Wake up the checkpoint thread early, to take a final checkpoint before shutting
             // down, if one has not coincidentally just been taken.
+            _checkpointRequested = true;
             _condvar.notify_one();
         }
         wait();
     }
 
 private:
+    /**
+     * Reads the cache, journal and transaction statistics the scheduler bases its decisions on.
+     * Statistics that cannot be read are reported as zero.
+     */
+    WiredTigerCheckpointScheduler::LoadSample _sampleLoad() {
+        WiredTigerCheckpointScheduler::LoadSample sample;
+        sample.now = _clockSource->now();
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        auto getStat = [&](int key) -> std::uint64_t {
+            auto value =
+                WiredTigerUtil::getStatisticsValue(s, "statistics:", "statistics=(fast)", key);
+            return value.isOK() ? value.getValue() : 0;
+        };
+        sample.dirtyCacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        sample.maxCacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        sample.journalBytesWritten = getStat(WT_STAT_CONN_LOG_BYTES_WRITTEN);
+        sample.transactionsCommitted = getStat(WT_STAT_CONN_TXN_COMMIT);
+        return sample;
+    }
+
+    /**
+     * Takes a checkpoint appropriate for the current stable and initial data timestamps. Returns
+     * false if the checkpoint had to be skipped.
+     */
+    bool _checkpoint() {
+        const Timestamp stableTimestamp = _wiredTigerKVEngine->getStableTimestamp();
+        const Timestamp initialDataTimestamp = _wiredTigerKVEngine->getInitialDataTimestamp();
+
+        // Three cases:
+        //
+        // First, initialDataTimestamp is Timestamp(0, 1) -> Take full checkpoint. This is when
+        // there is no consistent view of the data (i.e: during initial sync).
+        //
+        // Second, stableTimestamp < initialDataTimestamp: Skip checkpoints. The data on disk is
+        // prone to being rolled back. Hold off on checkpoints.  Hope that the stable timestamp
+        // surpasses the data on disk, allowing storage to persist newer copies to disk.
+        //
+        // Third, stableTimestamp >= initialDataTimestamp: Take stable checkpoint. Steady state
+        // case.
+        if (initialDataTimestamp.asULL() <= 1) {
+            UniqueWiredTigerSession session = _sessionCache->getSession();
+            WT_SESSION* s = session->getSession();
+            invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+            return true;
+        }
+
+        if (stableTimestamp < initialDataTimestamp) {
+            LOG_FOR_RECOVERY(2)
+                << "Stable timestamp is behind the initial data timestamp, skipping "
+                   "a checkpoint. StableTimestamp: "
+                << stableTimestamp.toString()
+                << " InitialDataTimestamp: " << initialDataTimestamp.toString();
+            return false;
+        }
+
+        // 'stableTimestamp' is the smallest possible value at which WT will take a stable
+        // checkpoint. A newer stable timestamp may be used by WT if one is concurrently set.
+        LOG_FOR_RECOVERY(2) << "Performing stable checkpoint. StableTimestamp: "
+                            << stableTimestamp;
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
+
+        // Publish the checkpoint time after the checkpoint becomes durable.
+        _lastStableCheckpointTimestamp.store(stableTimestamp.asULL());
+        return true;
+    }
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
+    WiredTigerCheckpointScheduler* _scheduler;
+    ClockSource* _clockSource;
 
-    stdx::mutex _mutex;  // protects _condvar
-    // The checkpoint thead idles on this condition variable for a particular time duration between
-    // taking checkpoints. It can be triggered early to expediate immediate checkpointing.
+    stdx::mutex _mutex;  // protects _condvar and _checkpointRequested
+    // The checkpoint thead idles on this condition variable between checks of whether a
+    // checkpoint is due. It can be triggered early to expediate immediate checkpointing.
     stdx::condition_variable _condvar;
+    bool _checkpointRequested = false;
 
     AtomicBool _shuttingDown{false};
 
@@ -399,11 +513,16 @@ class TicketServerParameter : public ServerParameter {
     MONGO_DISALLOW_COPYING(TicketServerParameter);
 
 public:
-    TicketServerParameter(TicketHolder* holder, const std::string& name)
-        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true), _holder(holder) {}
+    TicketServerParameter(TicketHolder* holder,
+                          WiredTigerTicketTuner* tuner,
+                          const std::string& name)
+        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true),
+          _holder(holder),
+          _tuner(tuner),
+          _configured(holder->outof()) {}
 
     virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
-        b.append(name, _holder->outof());
+        b.append(name, _configured.load());
     }
 
     virtual Status set(const BSONElement& newValueElement) {
@@ -425,26 +544,204 @@ public:
             return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be > 0");
         }
 
-        return _holder->resize(newNum);
+        Status status = _holder->resize(newNum);
+        if (status.isOK()) {
+            _configured.store(newNum);
+            _tuner->reset(newNum);
+        }
+        return status;
+    }
+
+    /**
+     * Returns the ticket count last set by hand, which adaptive tuning starts from and returns to
+     * when turned off.
+     */
+    int configured() const {
+        return _configured.load();
     }
 
 private:
     TicketHolder* _holder;
+    WiredTigerTicketTuner* _tuner;
+    AtomicInt32 _configured;
 };
 
 TicketHolder openWriteTransaction(128);
+WiredTigerTicketTuner openWriteTransactionTuner(128);
 TicketServerParameter openWriteTransactionParam(&openWriteTransaction,
+                                                &openWriteTransactionTuner,
                                                 "wiredTigerConcurrentWriteTransactions");
 
 TicketHolder openReadTransaction(128);
+WiredTigerTicketTuner openReadTransactionTuner(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
+                                               &openReadTransactionTuner,
                                                "wiredTigerConcurrentReadTransactions");
 
+// Tune the number of read and write tickets to the observed load. The ticket counts return to the
+// values of wiredTigerConcurrentReadTransactions and wiredTigerConcurrentWriteTransactions when
+// tuning is turned off.
+AtomicBool wiredTigerAdaptiveConcurrentTransactions(false);
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsSetting(ServerParameterSet::getGlobal(),
+                                                    "wiredTigerAdaptiveConcurrentTransactions",
+                                                    &wiredTigerAdaptiveConcurrentTransactions);
+
+// The most read or write tickets tuning may grow to.
+AtomicInt32 wiredTigerAdaptiveConcurrentTransactionsMax(1024);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsMaxSetting(
+        ServerParameterSet::getGlobal(),
+        "wiredTigerAdaptiveConcurrentTransactionsMax",
+        &wiredTigerAdaptiveConcurrentTransactionsMax);
+
+// How often the ticket counts are re-evaluated.
+const Milliseconds kTicketTunerInterval = Seconds(1);
+
+// Shrink the ticket counts once the cache reaches the default fill levels at which WiredTiger pulls
+// application threads into eviction. Reads do not dirty the cache, so only writes are held back
+// by dirty data.
+WiredTigerTicketTuner::Settings getTicketTunerSettings(bool write) {
+    WiredTigerTicketTuner::Settings settings;
+    settings.maxTickets =
+        std::max(settings.minTickets, wiredTigerAdaptiveConcurrentTransactionsMax.load());
+    settings.dirtyCacheLimitPercent = write ? 20 : 0;
+    settings.usedCacheLimitPercent = 95;
+    return settings;
+}
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
 }  // namespace
 
+class WiredTigerKVEngine::WiredTigerTicketTunerThread : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTunerThread(WiredTigerSessionCache* sessionCache,
+                                         ClockSource* clockSource)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _clockSource(clockSource) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, kTicketTunerInterval.toSystemDuration(), [&] {
+                    return _shuttingDown.load();
+                });
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            try {
+                _tune();
+            } catch (const AssertionException& exc) {
+                invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    void _tune() {
+        if (!wiredTigerAdaptiveConcurrentTransactions.load()) {
+            _restore(&openReadTransaction, &openReadTransactionTuner, openReadTransactionParam);
+            _restore(&openWriteTransaction, &openWriteTransactionTuner, openWriteTransactionParam);
+            return;
+        }
+
+        const WiredTigerTicketTuner::LoadSample sample = _sampleCache();
+        _apply(&openReadTransaction,
+               &openReadTransactionTuner,
+               getTicketTunerSettings(false /* write */),
+               sample);
+        _apply(&openWriteTransaction,
+               &openWriteTransactionTuner,
+               getTicketTunerSettings(true /* write */),
+               sample);
+    }
+
+    /**
+     * Reads the cache statistics the tuner bases its decisions on. Statistics that cannot be read
+     * are reported as zero.
+     */
+    WiredTigerTicketTuner::LoadSample _sampleCache() {
+        WiredTigerTicketTuner::LoadSample sample;
+        sample.now = _clockSource->now();
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        auto getStat = [&](int key) -> std::uint64_t {
+            auto value =
+                WiredTigerUtil::getStatisticsValue(s, "statistics:", "statistics=(fast)", key);
+            return value.isOK() ? value.getValue() : 0;
+        };
+        sample.dirtyCacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        sample.usedCacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        sample.maxCacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        return sample;
+    }
+
+    void _apply(TicketHolder* holder,
+                WiredTigerTicketTuner* tuner,
+                const WiredTigerTicketTuner::Settings& settings,
+                WiredTigerTicketTuner::LoadSample sample) {
+        sample.ticketsReleased = holder->totalReleased();
+        sample.ticketsInUse = holder->used();
+        sample.waiters = holder->waiting();
+
+        const int target = tuner->evaluate(settings, sample);
+        _resize(holder, target);
+    }
+
+    void _restore(TicketHolder* holder,
+                  WiredTigerTicketTuner* tuner,
+                  const TicketServerParameter& param) {
+        tuner->reset(param.configured());
+        _resize(holder, param.configured());
+    }
+
+    void _resize(TicketHolder* holder, int target) {
+        if (holder->outof() == target) {
+            return;
+        }
+
+        LOG(2) << "Resizing tickets from " << holder->outof() << " to " << target;
+        Status status = holder->resize(target);
+        if (!status.isOK()) {
+            LOG(1) << "Unable to resize tickets: " << status;
+        }
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    ClockSource* _clockSource;
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -462,7 +759,8 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
       _durable(durable),
       _ephemeral(ephemeral),
       _inRepairMode(repair),
-      _readOnly(readOnly) {
+      _readOnly(readOnly),
+      _checkpointScheduler(stdx::make_unique<WiredTigerCheckpointScheduler>(cs->now())) {
     boost::filesystem::path journalPath = path;
     journalPath /= "journal";
     if (_durable) {
@@ -508,6 +806,15 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     }
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())
               ->getTableCreateConfig("system");
+    // The dictionary compressors must be registered before recovery reads any table using them.
+    auto dictionaryCompressors = WiredTigerDictionaryCompressors::get(getGlobalServiceContext());
+    fassert(50944, dictionaryCompressors->load(path, _readOnly));
+    if (!dictionaryCompressors->empty() ||
+        wiredTigerGlobalOptions.collectionBlockCompressor ==
+            WiredTigerDictionaryCompressors::kBlockCompressorOption) {
+        WiredTigerExtensions::get(getGlobalServiceContext())
+            ->addExtension(WiredTigerDictionaryCompressors::getExtensionConfig());
+    }
     ss << WiredTigerExtensions::get(getGlobalServiceContext())->getOpenExtensionsConfig();
     ss << extraOpenOptions;
     if (_readOnly) {
@@ -572,8 +879,8 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
             setStableTimestamp(_recoveryTimestamp);
         }
 
-        _checkpointThread =
-            stdx::make_unique<WiredTigerCheckpointThread>(this, _sessionCache.get());
+        _checkpointThread = stdx::make_unique<WiredTigerCheckpointThread>(
+            this, _sessionCache.get(), _checkpointScheduler.get(), _clockSource);
         _checkpointThread->go();
     }
 
@@ -587,6 +894,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    _ticketTunerThread =
+        stdx::make_unique<WiredTigerTicketTunerThread>(_sessionCache.get(), _clockSource);
+    _ticketTunerThread->go();
 }
 
 
@@ -600,11 +911,15 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
 
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
+    bb.append("adaptiveTuning", wiredTigerAdaptiveConcurrentTransactions.load());
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("waiting", openWriteTransaction.waiting());
+        openWriteTransaction.appendQueueStats(&bbb);
+        openWriteTransactionTuner.appendStats(&bbb);
         bbb.done();
     }
     {
@@ -612,11 +927,18 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("waiting", openReadTransaction.waiting());
+        openReadTransaction.appendQueueStats(&bbb);
+        openReadTransactionTuner.appendStats(&bbb);
         bbb.done();
     }
     bb.done();
 }
 
+void WiredTigerKVEngine::appendCheckpointStats(BSONObjBuilder* builder) const {
+    _checkpointScheduler->appendStats(builder);
+}
+
 void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
     if (!_readOnly)
@@ -626,6 +948,11 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketTunerThread) {
+        log() << "Shutting down ticket tuner thread";
+        _ticketTunerThread->shutdown();
+        log() << "Finished shutting down ticket tuner thread";
+    }
     if (_journalFlusher) {
         log() << "Shutting down journal flusher thread";
         _journalFlusher->shutdown();
@@ -903,6 +1230,20 @@ Status WiredTigerKVEngine::createGroupedRecordStore(OperationContext* opCtx,
     std::string config = result.getValue();
 
     string uri = _uri(ident);
+    if (wiredTigerGlobalOptions.collectionBlockCompressor ==
+            WiredTigerDictionaryCompressors::kBlockCompressorOption &&
+        !NamespaceString::oplog(ns) && !_ephemeral) {
+        // Put the table's own compressor first, so that a user-specified one overrides it.
+        auto dictionaryCompressors = WiredTigerDictionaryCompressors::get(getGlobalServiceContext());
+        auto compressorName = dictionaryCompressors->createCompressor(uri);
+        if (!compressorName.isOK()) {
+            return compressorName.getStatus();
+        }
+        invariantWTOK(dictionaryCompressors->registerCompressor(_conn, uri));
+        config = str::stream() << "block_compressor=" << compressorName.getValue() << ","
+                               << config;
+    }
+
     WT_SESSION* s = session.getSession();
     LOG(2) << "WiredTigerKVEngine::createRecordStore ns: " << ns << " uri: " << uri
            << " config: " << config;
@@ -996,6 +1337,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedCallback = nullptr;
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
+    params.isClustered = options.clustered;
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -1100,6 +1442,7 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
 
     if (ret == 0) {
         // yay, it worked
+        WiredTigerDictionaryCompressors::get(getGlobalServiceContext())->dropCompressor(uri);
         return Status::OK();
     }
 
@@ -1197,6 +1540,7 @@ void WiredTigerKVEngine::dropSomeQueuedIdents() {
             _identToDrop.push_back(uri);
         } else {
             invariantWTOK(ret);
+            WiredTigerDictionaryCompressors::get(getGlobalServiceContext())->dropCompressor(uri);
         }
     }
 }
@@ -1209,6 +1553,10 @@ bool WiredTigerKVEngine::supportsDirectoryPerDB() const {
     return true;
 }
 
+bool WiredTigerKVEngine::supportsClusteredCollections() const {
+    return true;
+}
+
 bool WiredTigerKVEngine::hasIdent(OperationContext* opCtx, StringData ident) const {
     return _hasUri(WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession(), _uri(ident));
 }
@@ -1523,7 +1871,8 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
             _journalFlusher = std::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
             _journalFlusher->go();
         }
-        _checkpointThread = std::make_unique<WiredTigerCheckpointThread>(this, _sessionCache.get());
+        _checkpointThread = std::make_unique<WiredTigerCheckpointThread>(
+            this, _sessionCache.get(), _checkpointScheduler.get(), _clockSource);
         _checkpointThread->go();
     }
 
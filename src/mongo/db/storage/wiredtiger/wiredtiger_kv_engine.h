@@ -41,6 +41,7 @@
 #include "mongo/bson/ordering.h"
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -86,6 +87,8 @@ public:
 
     virtual bool supportsDirectoryPerDB() const override;
 
+    virtual bool supportsClusteredCollections() const override;
+
     virtual bool isDurable() const override {
         return _durable;
     }
@@ -286,6 +289,12 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends statistics about the checkpoints taken by the checkpoint thread and what triggered
+     * them.
+     */
+    void appendCheckpointStats(BSONObjBuilder* builder) const;
+
     bool isCacheUnderPressure(OperationContext* opCtx) const override;
 
     /**
@@ -307,6 +316,7 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketTunerThread;
 
     Status _salvageIfNeeded(const char* uri);
     void _ensureIdentPath(StringData ident);
@@ -377,7 +387,10 @@ private:
     const bool _inRepairMode;
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
+    // Outlives the checkpoint thread, which is restarted by recoverToStableTimestamp().
+    std::unique_ptr<WiredTigerCheckpointScheduler> _checkpointScheduler;
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketTunerThread> _ticketTunerThread;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -33,12 +33,14 @@
 
 #include <cstring>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -81,8 +83,10 @@ void WiredTigerOplogManager::start(OperationContext* opCtx,
                                        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache(),
                                        oplogRecordStore);
 
+    _oplogRecordStore = oplogRecordStore;
     _isRunning = true;
     _shuttingDown = false;
+    ++_runGeneration;
 }
 
 void WiredTigerOplogManager::halt() {
@@ -91,6 +95,14 @@ void WiredTigerOplogManager::halt() {
         invariant(_isRunning);
         _shuttingDown = true;
         _isRunning = false;
+        _oplogRecordStore = nullptr;
+    }
+
+    // Journal flushes on other threads may still be notifying the record store, which is about to
+    // be destroyed.
+    {
+        stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
+        _notifiersDoneCV.wait(lk, [&] { return _inFlightNotifiers == 0; });
     }
 
     if (_oplogJournalThread.joinable()) {
@@ -147,7 +159,12 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
 }
 
 void WiredTigerOplogManager::triggerJournalFlush() {
+    const uint64_t now = curTimeMicros64();
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    if (!_firstUnpublishedCommitMicros) {
+        _firstUnpublishedCommitMicros = now;
+    }
+    _lastUnpublishedCommitMicros = now;
     if (!_opsWaitingForJournal) {
         _opsWaitingForJournal = true;
         _opsWaitingForJournalCV.notify_one();
@@ -177,15 +194,19 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
             auto now = Date_t::now();
             auto deadline = now + journalDelay;
             auto shouldSyncOpsWaitingForJournal = [&] {
-                return _shuttingDown || oplogRecordStore->haveCappedWaiters();
+                // Any other journal flush in the meantime (a j:true write, or the periodic journal
+                // flusher) publishes visibility itself and clears the pending commits, in which
+                // case there is nothing left for this thread to do.
+                return _shuttingDown || !_firstUnpublishedCommitMicros ||
+                    oplogRecordStore->haveCappedWaiters();
             };
 
-            // Eventually it would be more optimal to merge this with the normal journal flushing
-            // and block for oplog tailers to show up. For now this loop will poll once a
-            // millisecond up to the journalDelay to see if we have any waiters yet. This reduces
-            // sync-related I/O on the primary when secondaries are lagged, but will avoid
-            // significant delays in confirming majority writes on replica sets with infrequent
-            // writes.
+            // Journal flushes performed by other threads publish visibility as a side effect, so
+            // this thread only needs to flush when somebody is waiting on the oplog. This loop
+            // polls once a millisecond up to the journalDelay to see if we have any waiters yet.
+            // This reduces sync-related I/O on the primary when secondaries are lagged, but will
+            // avoid significant delays in confirming majority writes on replica sets with
+            // infrequent writes.
             while (now < deadline &&
                    !_opsWaitingForJournalCV.wait_until(
                        lk, now.toSystemTimePoint(), shouldSyncOpsWaitingForJournal)) {
@@ -205,8 +226,14 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         }
         invariant(_opsWaitingForJournal);
         _opsWaitingForJournal = false;
+
+        if (!_firstUnpublishedCommitMicros) {
+            LOG(2) << "oplog visibility was already advanced by another journal flush";
+            continue;
+        }
         lk.unlock();
 
+        const uint64_t fetchedAtMicros = curTimeMicros64();
         const uint64_t newTimestamp = fetchAllCommittedValue(sessionCache->conn());
 
         // The newTimestamp may actually go backward during secondary batch application,
@@ -214,24 +241,90 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         // a non-incrementing timestamp.
         if (newTimestamp <= _oplogReadTimestamp.load()) {
             LOG(2) << "no new oplog entries were made visible: " << newTimestamp;
+            lk.lock();
+            _retirePendingCommits(lk, fetchedAtMicros, /*recordLatency=*/false);
             continue;
         }
 
         // In order to avoid oplog holes after an unclean shutdown, we must ensure this proposed
-        // oplog read timestamp's documents are durable before publishing that timestamp.
+        // oplog read timestamp's documents are durable before publishing that timestamp. The flush
+        // may itself publish a newer value through notifyJournalFlushed().
         sessionCache->waitUntilDurable(/*forceCheckpoint=*/false, false);
 
-        lk.lock();
-        // Publish the new timestamp value.  Avoid going backward.
-        auto oldTimestamp = getOplogReadTimestamp();
-        if (newTimestamp > oldTimestamp) {
-            _setOplogReadTimestamp(lk, newTimestamp);
-        }
-        lk.unlock();
+        _publishDurableTimestamp(stdx::unique_lock<stdx::mutex>(_oplogVisibilityStateMutex),
+                                 newTimestamp,
+                                 fetchedAtMicros);
+    }
+}
 
-        // Wake up any await_data cursors and tell them more data might be visible now.
-        oplogRecordStore->notifyCappedWaitersIfNeeded();
+void WiredTigerOplogManager::notifyJournalFlushed(uint64_t runGeneration,
+                                                  uint64_t allCommittedBeforeFlush,
+                                                  uint64_t fetchedAtMicros) {
+    stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    // A value sampled before a halt() says nothing about the oplog a later start() opened.
+    if (!_isRunning || _shuttingDown || runGeneration != _runGeneration) {
+        return;
     }
+    _publishDurableTimestamp(std::move(lk), allCommittedBeforeFlush, fetchedAtMicros);
+}
+
+void WiredTigerOplogManager::_publishDurableTimestamp(stdx::unique_lock<stdx::mutex> lk,
+                                                      uint64_t newTimestamp,
+                                                      uint64_t fetchedAtMicros) {
+    invariant(lk.owns_lock());
+
+    // Publish the new timestamp value.  Avoid going backward. A value at or behind the current one
+    // still covers the commits that triggered before it was sampled, which are already visible.
+    if (newTimestamp <= getOplogReadTimestamp()) {
+        _retirePendingCommits(lk, fetchedAtMicros, /*recordLatency=*/false);
+        return;
+    }
+    _setOplogReadTimestamp(lk, newTimestamp);
+    _retirePendingCommits(lk, fetchedAtMicros, /*recordLatency=*/true);
+
+    auto oplogRecordStore = _oplogRecordStore;
+    if (!oplogRecordStore) {
+        return;
+    }
+    ++_inFlightNotifiers;
+    lk.unlock();
+
+    // Wake up any await_data cursors and tell them more data might be visible now. halt() waits
+    // for this before the record store can go away.
+    oplogRecordStore->notifyCappedWaitersIfNeeded();
+
+    lk.lock();
+    if (--_inFlightNotifiers == 0) {
+        _notifiersDoneCV.notify_all();
+    }
+}
+
+void WiredTigerOplogManager::_retirePendingCommits(WithLock,
+                                                   uint64_t fetchedAtMicros,
+                                                   bool recordLatency) {
+    // Commits that triggered an update before the all_committed value was sampled are covered by
+    // it. Later commits remain pending; only the most recent one's time is kept for them.
+    if (!_firstUnpublishedCommitMicros || _firstUnpublishedCommitMicros > fetchedAtMicros) {
+        return;
+    }
+    if (recordLatency) {
+        const uint64_t now = curTimeMicros64();
+        _commitToVisibleLatency.increment(
+            Microseconds(static_cast<int64_t>(now - _firstUnpublishedCommitMicros)));
+    }
+    _firstUnpublishedCommitMicros =
+        _lastUnpublishedCommitMicros > fetchedAtMicros ? _lastUnpublishedCommitMicros : 0;
+    if (!_firstUnpublishedCommitMicros) {
+        // Lets the oplogJournal thread skip its own flush.
+        _opsWaitingForJournalCV.notify_one();
+    }
+}
+
+void WiredTigerOplogManager::appendStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder bob(builder->subobjStart("oplog-visibility"));
+    bob.append("oplog read timestamp", Timestamp(getOplogReadTimestamp()));
+    _commitToVisibleLatency.append("commit to visible", true, &bob);
+    bob.done();
 }
 
 std::uint64_t WiredTigerOplogManager::getOplogReadTimestamp() const {
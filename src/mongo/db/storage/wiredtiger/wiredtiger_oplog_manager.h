@@ -35,15 +35,19 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/latency_histogram.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 
 
-// Manages oplog visibility, by periodically querying WiredTiger's all_committed timestamp value and
-// then using that timestamp for all transactions that read the oplog collection.
+// Manages oplog visibility, by querying WiredTiger's all_committed timestamp value and then using
+// that timestamp for all transactions that read the oplog collection. A new value is published
+// whenever a journal flush makes it durable: either by the oplogJournal thread, or directly by
+// whichever thread performed the flush (see notifyJournalFlushed()).
 class WiredTigerOplogManager {
     MONGO_DISALLOW_COPYING(WiredTigerOplogManager);
 
@@ -64,6 +68,12 @@ public:
         return _isRunning && !_shuttingDown;
     }
 
+    // Returns a number identifying the current start() of this manager, or 0 if it isn't running.
+    std::uint64_t getRunGeneration() {
+        stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+        return _isRunning && !_shuttingDown ? _runGeneration : 0;
+    }
+
     // The oplogReadTimestamp is the timestamp used for oplog reads, to prevent readers from
     // reading past uncommitted transactions (which may create "holes" in the oplog after an
     // unclean shutdown).
@@ -73,6 +83,20 @@ public:
     // Triggers the oplogJournal thread to update its oplog read timestamp, by flushing the journal.
     void triggerJournalFlush();
 
+    // Called after a journal flush completes, with an all_committed value that was fetched before
+    // that flush began, and the time in microseconds at which it was fetched. Every write at or
+    // before 'allCommittedBeforeFlush' is durable, so it is published as the oplog read timestamp
+    // immediately rather than waiting for the oplogJournal thread to perform a flush of its own.
+    // 'runGeneration' is getRunGeneration() as of the fetch; the notification is dropped if the
+    // manager has been halted (and possibly restarted) since.
+    void notifyJournalFlushed(uint64_t runGeneration,
+                              uint64_t allCommittedBeforeFlush,
+                              uint64_t fetchedAtMicros);
+
+    // Appends oplog visibility statistics, including the distribution of the delay between a
+    // commit triggering a visibility update and a covering oplog read timestamp being published.
+    void appendStats(BSONObjBuilder* builder) const;
+
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
     // the oplog.)
     void waitForAllEarlierOplogWritesToBeVisible(const WiredTigerRecordStore* oplogRecordStore,
@@ -88,6 +112,16 @@ private:
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
+    // Publishes 'newTimestamp', which must be durable, as the oplog read timestamp if it is ahead
+    // of the current value, and wakes up any await_data cursors. 'lk' is released on return.
+    void _publishDurableTimestamp(stdx::unique_lock<stdx::mutex> lk,
+                                  uint64_t newTimestamp,
+                                  uint64_t fetchedAtMicros);
+
+    // Stops tracking the pending commits that were triggered no later than 'fetchedAtMicros', and
+    // optionally records how long the oldest of them waited to become visible.
+    void _retirePendingCommits(WithLock, uint64_t fetchedAtMicros, bool recordLatency);
+
     stdx::thread _oplogJournalThread;
     mutable stdx::mutex _oplogVisibilityStateMutex;
     mutable stdx::condition_variable
@@ -95,14 +129,31 @@ private:
     mutable stdx::condition_variable
         _opsBecameVisibleCV;  // Signaled when a journal flush is complete.
 
-    bool _isRunning = false;     // Guarded by the oplogVisibilityStateMutex.
-    bool _shuttingDown = false;  // Guarded by oplogVisibilityStateMutex.
+    bool _isRunning = false;      // Guarded by the oplogVisibilityStateMutex.
+    bool _shuttingDown = false;   // Guarded by oplogVisibilityStateMutex.
+    uint64_t _runGeneration = 0;  // Guarded by oplogVisibilityStateMutex.
 
     // This is the RecordId of the newest oplog document in the oplog on startup.  It is used as a
     // floor in waitForAllEarlierOplogWritesToBeVisible().
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
     bool _opsWaitingForJournal = false;         // Guarded by oplogVisibilityStateMutex.
 
+    // The oplog record store whose capped waiters are notified when visibility advances.
+    WiredTigerRecordStore* _oplogRecordStore = nullptr;  // Guarded by oplogVisibilityStateMutex.
+
+    // Number of threads notifying _oplogRecordStore's capped waiters outside of the mutex. halt()
+    // waits for it to drop to zero, so that the record store can't be destroyed under them.
+    int _inFlightNotifiers = 0;  // Guarded by oplogVisibilityStateMutex.
+    stdx::condition_variable _notifiersDoneCV;
+
+    // Wall clock times, in microseconds, of the first and the most recent commits that triggered a
+    // visibility update that has not been published yet. Zero when nothing is pending.
+    uint64_t _firstUnpublishedCommitMicros = 0;  // Guarded by oplogVisibilityStateMutex.
+    uint64_t _lastUnpublishedCommitMicros = 0;   // Guarded by oplogVisibilityStateMutex.
+
+    // Delay between a commit triggering a visibility update and its publication.
+    LatencyHistogram _commitToVisibleLatency;
+
     AtomicUInt64 _oplogReadTimestamp;
 };
 }  // namespace mongo
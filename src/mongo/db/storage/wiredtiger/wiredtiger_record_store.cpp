@@ -49,8 +49,10 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compressor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
@@ -81,6 +83,9 @@ static const int kMaximumRecordStoreVersion = 1;
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion);
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion);
 
+// Number of documents sampled to train a table's compression dictionary.
+const size_t kDictionarySampleCount = 256;
+
 void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     fassert(39999, appMetadata);
@@ -604,7 +609,13 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
         ss << "prefix_compression,";
     }
 
-    ss << "block_compressor=" << wiredTigerGlobalOptions.collectionBlockCompressor << ",";
+    const auto& blockCompressor = wiredTigerGlobalOptions.collectionBlockCompressor;
+    if (blockCompressor != WiredTigerDictionaryCompressors::kBlockCompressorOption) {
+        ss << "block_compressor=" << blockCompressor << ",";
+    } else if (NamespaceString::oplog(ns)) {
+        // The oplog is mostly written and read sequentially, so it does not get a dictionary.
+        ss << "block_compressor=snappy,";
+    }
 
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())->getTableCreateConfig(ns);
 
@@ -661,6 +672,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClustered(params.isClustered),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -683,6 +695,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
         }
     }
 
+    invariant(!(_isClustered && (_isCapped || _isOplog)));
+
     if (_isCapped) {
         invariant(_cappedMaxSize > 0);
         invariant(_cappedMaxDocs == -1 || _cappedMaxDocs > 0);
@@ -698,6 +712,12 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
         sizeRecoveryState(getGlobalServiceContext())
             .markCollectionAsAlwaysNeedsSizeAdjustment(_uri);
     }
+
+    if (!_isEphemeral) {
+        auto compressors = WiredTigerDictionaryCompressors::get(getGlobalServiceContext());
+        auto version = compressors->getDictionaryVersion(_uri);
+        _needsDictionary.store(version && *version == 0);
+    }
 }
 
 WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -855,6 +875,41 @@ RecordData WiredTigerRecordStore::dataFor(OperationContext* opCtx, const RecordI
     return _getData(curwrap);
 }
 
+StatusWith<RecordId> WiredTigerRecordStore::_freeClusteredKey(OperationContext* opCtx,
+                                                              WiredTigerCursor& cursor,
+                                                              const Record& record) {
+    StatusWith<RecordId> swKey = clusteredkey::extractKey(record.data.data(), record.data.size());
+    if (!swKey.isOK())
+        return swKey;
+
+    const BSONElement id = BSONObj(record.data.data())["_id"];
+    WT_CURSOR* c = cursor.get();
+    RecordId freeKey;
+    for (int i = 0; i < clusteredkey::numCandidateKeys(swKey.getValue()); i++) {
+        const RecordId candidate(swKey.getValue().repr() + i);
+        setKey(c, candidate);
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+        if (ret == WT_NOTFOUND) {
+            if (freeKey.isNull())
+                freeKey = candidate;
+            continue;
+        }
+        invariantWTOK(ret);
+
+        if (clusteredkey::idMatches(_getData(cursor).toBson(), id))
+            return {ErrorCodes::DuplicateKey,
+                    str::stream() << "E11000 duplicate key error collection: " << ns()
+                                  << " dup key: "
+                                  << redact(id.wrap())};
+    }
+
+    if (freeKey.isNull())
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Cannot insert _id " << redact(id.wrap()) << " into " << ns()
+                              << ": too many other _id values share its clustered key"};
+    return freeKey;
+}
+
 bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
                                        const RecordId& id,
                                        RecordData* out) const {
@@ -1300,6 +1355,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            // The key depends on the records already stored, so it is chosen as each record is
+            // inserted.
+            continue;
         } else if (_isCapped) {
             record.id = _nextId();
         } else {
@@ -1309,8 +1368,28 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         highestId = record.id;
     }
 
+    if (_isClustered) {
+        // A concurrent insert may take the same free key, so have the insert fail instead of
+        // overwriting the record. Cursors are cached, so restore the setting afterwards.
+        invariantWTOK(c->reconfigure(c, "overwrite=false"));
+    }
+    ON_BLOCK_EXIT([&] {
+        if (_isClustered) {
+            invariantWTOK(c->reconfigure(c, "overwrite=true"));
+        }
+    });
+
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
+        if (_isClustered) {
+            // There is no _id index to reject a duplicate _id, so look for it among the records
+            // stored under its candidate keys.
+            auto swKey = _freeClusteredKey(opCtx, curwrap, record);
+            if (!swKey.isOK())
+                return swKey.getStatus();
+            record.id = swKey.getValue();
+            highestId = std::max(highestId, record.id);
+        }
         Timestamp ts;
         if (timestamps[i].isNull() && _isOplog) {
             // If the timestamp is 0, that probably means someone inserted a document directly
@@ -1346,9 +1425,40 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         _cappedDeleteAsNeeded(opCtx, highestId);
     }
 
+    if (_needsDictionary.load()) {
+        _sampleForDictionary(records, nRecords);
+    }
+
     return Status::OK();
 }
 
+void WiredTigerRecordStore::_sampleForDictionary(const Record* records, size_t nRecords) {
+    std::vector<BSONObj> samples;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_dictionarySamplesMutex);
+        if (!_needsDictionary.load()) {
+            return;
+        }
+        for (size_t i = 0; i < nRecords && _dictionarySamples.size() < kDictionarySampleCount;
+             i++) {
+            _dictionarySamples.push_back(records[i].data.toBson().getOwned());
+        }
+        if (_dictionarySamples.size() < kDictionarySampleCount) {
+            return;
+        }
+        _needsDictionary.store(false);
+        samples.swap(_dictionarySamples);
+    }
+
+    // The samples may come from a transaction that later aborts; they only shape the dictionary.
+    auto compressors = WiredTigerDictionaryCompressors::get(getGlobalServiceContext());
+    Status status = compressors->train(_uri, samples);
+    if (!status.isOK()) {
+        warning() << "Failed to train a compression dictionary for " << ns() << ": "
+                  << redact(status);
+    }
+}
+
 StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* opCtx,
                                                          const char* data,
                                                          int len,
@@ -1535,11 +1645,46 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
     dassert(opCtx->lockState()->isWriteLocked());
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    auto compressors = WiredTigerDictionaryCompressors::get(getGlobalServiceContext());
+    if (!cache->isEphemeral() && compressors->getDictionaryVersion(_uri)) {
+        // Retrain the dictionary from a random sample so that the blocks rewritten by compaction
+        // are compressed against the collection's current contents.
+        std::vector<BSONObj> samples;
+        auto cursor = getRandomCursor(opCtx);
+        while (samples.size() < kDictionarySampleCount) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            samples.push_back(record->data.releaseToBson().getOwned());
+        }
+        cursor.reset();
+        if (!samples.empty()) {
+            Status status = compressors->train(_uri, samples);
+            if (!status.isOK()) {
+                return status;
+            }
+            _needsDictionary.store(false);
+        }
+    }
+
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
         int ret = s->compact(s, getURI().c_str(), "timeout=0");
         invariantWTOK(ret);
+
+        if (compressors->getDictionaryVersion(_uri)) {
+            // Verify reads every block left after compaction, so that the dictionaries none of
+            // them was compressed with can be forgotten.
+            Status status = compressors->pruneDictionaries(_uri, [&] {
+                return wtRCToStatus(WiredTigerUtil::verifyTable(opCtx, _uri));
+            });
+            if (!status.isOK()) {
+                LOG(1) << "Not pruning the compression dictionaries of " << ns() << ": "
+                       << status;
+            }
+        }
     }
     return Status::OK();
 }
@@ -1650,6 +1795,11 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         bob.append("type", type);
     }
 
+    if (auto version = WiredTigerDictionaryCompressors::get(getGlobalServiceContext())
+                           ->getDictionaryVersion(_uri)) {
+        bob.append("compressionDictionaryVersion", static_cast<long long>(*version));
+    }
+
     Status status =
         WiredTigerUtil::exportTableToBSON(s, "statistics:" + getURI(), "statistics=(fast)", &bob);
     if (!status.isOK()) {
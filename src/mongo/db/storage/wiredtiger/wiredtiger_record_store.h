@@ -112,6 +112,7 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        bool isClustered = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -299,6 +300,14 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
+    /**
+     * Returns the first free candidate key for the _id of 'record' in a clustered collection.
+     * Fails with DuplicateKey if a record with that _id is already stored.
+     */
+    StatusWith<RecordId> _freeClusteredKey(OperationContext* opCtx,
+                                           WiredTigerCursor& cursor,
+                                           const Record& record);
+
     RecordId _nextId();
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
@@ -343,6 +352,12 @@ private:
     int64_t _cappedDeleteAsNeeded(OperationContext* opCtx, const RecordId& justInserted);
     int64_t _cappedDeleteAsNeeded_inlock(OperationContext* opCtx, const RecordId& justInserted);
 
+    /**
+     * Collects newly inserted documents as training samples for this table's dictionary
+     * compressor, and trains the first dictionary once enough samples have been gathered.
+     */
+    void _sampleForDictionary(const Record* records, size_t nRecords);
+
     const std::string _uri;
     const uint64_t _tableId;  // not persisted
 
@@ -354,6 +369,8 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if records are keyed by the _id of their document rather than by a generated RecordId.
+    const bool _isClustered;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -376,6 +393,11 @@ private:
 
     // Non-null if this record store is underlying the active oplog.
     std::shared_ptr<OplogStones> _oplogStones;
+
+    // True while this table has a dictionary compressor that has not yet been trained.
+    AtomicWord<bool> _needsDictionary{false};
+    stdx::mutex _dictionarySamplesMutex;  // guards _dictionarySamples
+    std::vector<BSONObj> _dictionarySamples;
 };
 
 
@@ -80,6 +80,12 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
+    _engine->getOplogManager()->appendStats(&bob);
+
+    _engine->appendCheckpointStats(&bob);
+
+    WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendDurabilityStats(&bob);
+
     return bob.obj();
 }
 
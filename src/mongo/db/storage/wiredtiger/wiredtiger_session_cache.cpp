@@ -35,6 +35,8 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
@@ -47,6 +49,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -86,6 +89,17 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+// Upper bound, in microseconds, on how long a group commit leader may hold its group open to let
+// more waitUntilDurable callers share its journal flush. The scheduler adapts the actual window
+// between zero and this value based on load. Zero disables the window, in which case only callers
+// that arrive while a flush is already running are grouped.
+AtomicInt32 wiredTigerGroupCommitTargetLatencyMicros(0);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerGroupCommitTargetLatencyMicrosSetting(ServerParameterSet::getGlobal(),
+                                                    "wiredTigerGroupCommitTargetLatencyMicros",
+                                                    &wiredTigerGroupCommitTargetLatencyMicros);
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch), _cursorEpoch(cursorEpoch), _session(NULL), _cursorGen(0), _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
@@ -198,10 +212,16 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _shuttingDown(0),
+      _groupCommit([this] { _flushForDurability(); }) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _shuttingDown(0),
+      _groupCommit([this] { _flushForDurability(); }) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -266,19 +286,11 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
-    }
-    _lastSyncTime.store(current + 1);
-
-    // Nobody has synched yet, so we have to sync ourselves.
+    _groupCommit.waitForFlush(
+        Microseconds(std::max(0, wiredTigerGroupCommitTargetLatencyMicros.load())));
+}
 
+void WiredTigerSessionCache::_flushForDurability() {
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
     stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
@@ -292,8 +304,22 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
 
     // Use the journal when available, or a checkpoint otherwise.
     if (_engine && _engine->isDurable()) {
+        // Sample the all_committed point before flushing. Every write at or before it is durable
+        // once the flush returns, so it can be made visible to oplog readers right away instead of
+        // waiting for the oplog manager to schedule a flush of its own.
+        WiredTigerOplogManager* oplogManager = _engine->getOplogManager();
+        const uint64_t runGeneration = oplogManager->getRunGeneration();
+        const bool publishOplogVisibility = runGeneration != 0;
+        const uint64_t fetchedAtMicros = curTimeMicros64();
+        const uint64_t allCommitted =
+            publishOplogVisibility ? oplogManager->fetchAllCommittedValue(_conn) : 0;
+
         invariantWTOK(_waitUntilDurableSession->log_flush(_waitUntilDurableSession, "sync=on"));
         LOG(4) << "flushed journal";
+
+        if (publishOplogVisibility) {
+            oplogManager->notifyJournalFlushed(runGeneration, allCommitted, fetchedAtMicros);
+        }
     } else {
         invariantWTOK(_waitUntilDurableSession->checkpoint(_waitUntilDurableSession, NULL));
         LOG(4) << "created checkpoint";
@@ -301,6 +327,10 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     _journalListener->onDurable(token);
 }
 
+void WiredTigerSessionCache::appendDurabilityStats(BSONObjBuilder* builder) const {
+    _groupCommit.appendStats(builder);
+}
+
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx) {
     invariant(opCtx);
     stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
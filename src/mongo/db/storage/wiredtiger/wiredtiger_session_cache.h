@@ -37,6 +37,7 @@
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_group_commit_scheduler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
@@ -208,9 +209,17 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers that do not force a checkpoint are grouped by a group commit scheduler,
+     * so that one flush serves every caller that arrived before it started.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
+    /**
+     * Appends statistics about waitUntilDurable() calls and the journal flushes serving them.
+     */
+    void appendDurabilityStats(BSONObjBuilder* builder) const;
+
     /**
      * Waits until a prepared unit of work has ended (either been commited or aborted). This
      * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
@@ -273,9 +282,8 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicUInt64 _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicUInt32 _lastSyncTime;
-    stdx::mutex _lastSyncMutex;
+    // Groups concurrent waitUntilDurable callers into shared journal flushes.
+    WiredTigerGroupCommitScheduler _groupCommit;
 
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
@@ -290,6 +298,12 @@ private:
     WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
                                                      // (uses connection close to clean up)
 
+    /**
+     * Flushes the journal, or takes a checkpoint when journaling is disabled, and notifies the
+     * journal listener. Only ever run by one group commit leader at a time.
+     */
+    void _flushForDurability();
+
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
@@ -30,14 +30,17 @@
 
 #include <memory>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -46,6 +49,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -68,6 +72,11 @@ public:
     }
 
     std::unique_ptr<SortedDataInterface> newSortedDataInterface(bool unique) final {
+        return newSortedDataInterface(unique, IndexDescriptor::IndexVersion::kV0);
+    }
+
+    std::unique_ptr<SortedDataInterface> newSortedDataInterface(
+        bool unique, IndexDescriptor::IndexVersion version) {
         std::string ns = "test.wt";
         OperationContextNoop opCtx(newRecoveryUnit().release());
 
@@ -76,7 +85,9 @@ public:
                                   << "ns"
                                   << ns
                                   << "unique"
-                                  << unique);
+                                  << unique
+                                  << "v"
+                                  << static_cast<int>(version));
 
         IndexDescriptor desc(NULL, "", spec);
 
@@ -104,6 +115,59 @@ private:
     WiredTigerOplogManager _oplogManager;
 };
 
+TEST(WiredTigerStandardIndexTest, CompactKeyFormatRoundTripsTypeBits) {
+    wiredTigerGlobalOptions.useIndexCompactKeyFormat = true;
+    serverGlobalParams.featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42);
+    ON_BLOCK_EXIT([] {
+        wiredTigerGlobalOptions.useIndexCompactKeyFormat = false;
+        serverGlobalParams.featureCompatibility.reset();
+    });
+
+    MyHarnessHelper harnessHelper;
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper.newSortedDataInterface(false, IndexDescriptor::IndexVersion::kV2));
+    ASSERT(checked_cast<WiredTigerIndex*>(sorted.get())->isCompactKeyFormat());
+    ASSERT(sorted->requiresFCV42());
+
+    // Keys whose TypeBits are all zeros, a single byte, and several bytes.
+    const BSONObj intKey = BSON("" << 1);
+    const BSONObj doubleKey = BSON("" << 2.5);
+    const BSONObj arrayKey = BSON("" << BSON_ARRAY(3.5 << 4LL << 5.5 << 6LL << 7.5 << 8LL));
+    insertToIndex(&harnessHelper,
+                  sorted,
+                  {{intKey, RecordId(1)}, {doubleKey, RecordId(2)}, {arrayKey, RecordId(3)}});
+
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+    auto entry = cursor->seek(kMinBSONKey, true);
+    ASSERT_EQ(entry, IndexKeyEntry(intKey, RecordId(1)));
+    ASSERT(entry->key.binaryEqual(intKey));
+    entry = cursor->next();
+    ASSERT_EQ(entry, IndexKeyEntry(doubleKey, RecordId(2)));
+    ASSERT(entry->key.binaryEqual(doubleKey));
+    entry = cursor->next();
+    ASSERT_EQ(entry, IndexKeyEntry(arrayKey, RecordId(3)));
+    ASSERT(entry->key.binaryEqual(arrayKey));
+    ASSERT(!cursor->next());
+}
+
+TEST(WiredTigerStandardIndexTest, CompactKeyFormatRequiresFCV42) {
+    wiredTigerGlobalOptions.useIndexCompactKeyFormat = true;
+    serverGlobalParams.featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kDowngradingTo40);
+    ON_BLOCK_EXIT([] {
+        wiredTigerGlobalOptions.useIndexCompactKeyFormat = false;
+        serverGlobalParams.featureCompatibility.reset();
+    });
+
+    MyHarnessHelper harnessHelper;
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper.newSortedDataInterface(false, IndexDescriptor::IndexVersion::kV2));
+    ASSERT_FALSE(checked_cast<WiredTigerIndex*>(sorted.get())->isCompactKeyFormat());
+    ASSERT_FALSE(sorted->requiresFCV42());
+}
+
 std::unique_ptr<HarnessHelper> makeHarnessHelper() {
     return stdx::make_unique<MyHarnessHelper>();
 }
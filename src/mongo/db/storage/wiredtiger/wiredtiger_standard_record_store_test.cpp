@@ -43,6 +43,7 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
@@ -294,6 +295,161 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+// Creates the table, then opens it again as a clustered record store.
+unique_ptr<RecordStore> newClusteredRecordStore(WiredTigerHarnessHelper* harnessHelper) {
+    string uri = checked_cast<WiredTigerRecordStore*>(
+                     harnessHelper->newNonCappedRecordStore("a.clustered").get())
+                     ->getURI();
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    WiredTigerRecordStore::Params params;
+    params.ns = "a.clustered"_sd;
+    params.uri = uri;
+    params.engineName = kWiredTigerEngineName;
+    params.isCapped = false;
+    params.isEphemeral = false;
+    params.cappedMaxSize = -1;
+    params.cappedMaxDocs = -1;
+    params.cappedCallback = nullptr;
+    params.sizeStorer = nullptr;
+    params.isClustered = true;
+
+    auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+    ret->postConstructorInit(opCtx.get());
+    return unique_ptr<RecordStore>(ret);
+}
+
+TEST(WiredTigerRecordStoreTest, ClusteredInsertKeysRecordsById) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs = newClusteredRecordStore(harnessHelper.get());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto insert = [&](const BSONObj& doc) {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp());
+        if (res.isOK())
+            uow.commit();
+        return res;
+    };
+
+    auto keyFor = [](const BSONObj& idObj) {
+        return unittest::assertGet(clusteredkey::keyForId(idObj.firstElement()));
+    };
+
+    auto res = insert(BSON("_id" << 5 << "x" << 1));
+    ASSERT_OK(res.getStatus());
+    ASSERT_EQ(keyFor(BSON("" << 5)), res.getValue());
+
+    // Equal numbers of any type share a key, as they would in an _id index.
+    ASSERT_EQ(keyFor(BSON("" << 5)), keyFor(BSON("" << 5LL)));
+    ASSERT_EQ(keyFor(BSON("" << 5)), keyFor(BSON("" << 5.0)));
+    ASSERT_EQ(keyFor(BSON("" << 5)), keyFor(BSON("" << Decimal128(5))));
+    ASSERT_EQ(keyFor(BSON("" << 2.5)), keyFor(BSON("" << Decimal128("2.5"))));
+    ASSERT_EQ(ErrorCodes::DuplicateKey, insert(BSON("_id" << 5LL)).getStatus());
+    ASSERT_EQ(ErrorCodes::DuplicateKey, insert(BSON("_id" << 5.0)).getStatus());
+
+    ASSERT_OK(insert(BSON("_id" << 3LL)).getStatus());
+    ASSERT_OK(insert(BSON("_id" << 0)).getStatus());
+    ASSERT_OK(insert(BSON("_id" << -7)).getStatus());
+    ASSERT_OK(insert(BSON("_id" << OID::gen())).getStatus());
+    ASSERT_OK(insert(BSON("_id"
+                          << "five"))
+                  .getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, insert(BSON("_id" << BSON_ARRAY(1 << 2))).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, insert(BSON("x" << 1)).getStatus());
+
+    // The failed insert must not prevent updates of the existing record in place.
+    {
+        BSONObj updated = BSON("_id" << 5 << "x" << 2);
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(
+            opCtx.get(), res.getValue(), updated.objdata(), updated.objsize(), nullptr));
+        uow.commit();
+    }
+
+    ASSERT_EQ(6, rs->numRecords(opCtx.get()));
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 5 << "x" << 2),
+                      rs->dataFor(opCtx.get(), res.getValue()).toBson());
+
+    // Integral _id values are returned in order, ahead of the hashed ones.
+    auto cursor = rs->getCursor(opCtx.get());
+    for (int id : {-7, 0, 3, 5}) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(keyFor(BSON("" << id)), record->id);
+        ASSERT_EQ(id, record->data.toBson()["_id"].numberInt());
+    }
+    for (int i = 0; i < 2; i++) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT(clusteredkey::isHashedKey(record->id));
+    }
+    ASSERT_FALSE(cursor->next());
+}
+
+TEST(WiredTigerRecordStoreTest, ClusteredInsertChainsCollidingIds) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs = newClusteredRecordStore(harnessHelper.get());
+
+    clusteredkey::clusteredKeyHashAlwaysCollides.setMode(FailPoint::alwaysOn);
+    ON_BLOCK_EXIT([] { clusteredkey::clusteredKeyHashAlwaysCollides.setMode(FailPoint::off); });
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto insert = [&](const BSONObj& doc) {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp());
+        if (res.isOK())
+            uow.commit();
+        return res;
+    };
+    auto find = [&](StringData id) {
+        auto cursor = rs->getCursor(opCtx.get());
+        return clusteredkey::findKey(cursor.get(), BSON("" << id).firstElement());
+    };
+
+    // Distinct _ids with the same hash take successive keys.
+    const RecordId a = unittest::assertGet(insert(BSON("_id"
+                                                       << "a")));
+    const RecordId b = unittest::assertGet(insert(BSON("_id"
+                                                       << "b")));
+    ASSERT(clusteredkey::isHashedKey(a));
+    ASSERT_EQ(RecordId(a.repr() + 1), b);
+    ASSERT_EQ(a, find("a"));
+    ASSERT_EQ(b, find("b"));
+    ASSERT_EQ(RecordId(), find("c"));
+    ASSERT_EQ(ErrorCodes::DuplicateKey,
+              insert(BSON("_id"
+                          << "b"))
+                  .getStatus());
+
+    // Deleting the first document neither hides the second nor lets its _id be inserted twice.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), a);
+        uow.commit();
+    }
+    ASSERT_EQ(RecordId(), find("a"));
+    ASSERT_EQ(b, find("b"));
+    ASSERT_EQ(ErrorCodes::DuplicateKey,
+              insert(BSON("_id"
+                          << "b"))
+                  .getStatus());
+
+    // The freed key is reused, and once every candidate key is taken, inserts fail.
+    const int numCandidates = clusteredkey::numCandidateKeys(a);
+    ASSERT_EQ(a,
+              unittest::assertGet(insert(BSON("_id"
+                                              << "c"))));
+    for (int i = 2; i < numCandidates; i++) {
+        ASSERT_OK(insert(BSON("_id" << std::to_string(i))).getStatus());
+    }
+    ASSERT_EQ(ErrorCodes::OperationFailed,
+              insert(BSON("_id"
+                          << "d"))
+                  .getStatus());
+    ASSERT_EQ(numCandidates, rs->numRecords(opCtx.get()));
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
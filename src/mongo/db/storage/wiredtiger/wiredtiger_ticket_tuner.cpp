@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+// Shrink once the latency estimate is this many times its baseline...
+const double kLatencyTolerance = 2.0;
+// ...by this factor, and by this one when the cache is under pressure.
+const double kLatencyBackoff = 0.9;
+const double kCachePressureBackoff = 0.75;
+// Weight of the newest sample in the latency estimate.
+const double kLatencySmoothing = 0.5;
+// How quickly the baseline rises towards the latency estimate when that is above it.
+const double kBaselineDrift = 0.05;
+
+const WiredTigerTicketTuner::Decision kDecisions[] = {
+    WiredTigerTicketTuner::Decision::kHold,
+    WiredTigerTicketTuner::Decision::kIncrease,
+    WiredTigerTicketTuner::Decision::kLatencyDecrease,
+    WiredTigerTicketTuner::Decision::kCachePressureDecrease,
+};
+
+bool aboveLimit(std::uint64_t bytes, std::uint64_t maxBytes, int limitPercent) {
+    return limitPercent > 0 && maxBytes > 0 &&
+        bytes * 100 >= maxBytes * static_cast<std::uint64_t>(limitPercent);
+}
+}  // namespace
+
+WiredTigerTicketTuner::WiredTigerTicketTuner(int initialTickets) : _target(initialTickets) {}
+
+int WiredTigerTicketTuner::evaluate(const Settings& settings, const LoadSample& sample) {
+    invariant(settings.minTickets > 0 && settings.minTickets <= settings.maxTickets);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _target = std::max(settings.minTickets, std::min(settings.maxTickets, _target));
+
+    const Decision decision = _decide(lk, settings, sample);
+    switch (decision) {
+        case Decision::kHold:
+            break;
+        case Decision::kIncrease:
+            _target += std::max(1, static_cast<int>(std::sqrt(_target)));
+            break;
+        case Decision::kLatencyDecrease:
+            _target = static_cast<int>(_target * kLatencyBackoff);
+            break;
+        case Decision::kCachePressureDecrease:
+            _target = static_cast<int>(_target * kCachePressureBackoff);
+            break;
+    }
+    _target = std::max(settings.minTickets, std::min(settings.maxTickets, _target));
+
+    ++_decisions[static_cast<int>(decision)];
+    _lastDecision = decision;
+    return _target;
+}
+
+WiredTigerTicketTuner::Decision WiredTigerTicketTuner::_decide(WithLock,
+                                                                const Settings& settings,
+                                                                const LoadSample& sample) {
+    if (_havePreviousSample && sample.now > _previousSample.now &&
+        sample.ticketsReleased >= _previousSample.ticketsReleased) {
+        const double seconds =
+            durationCount<Milliseconds>(sample.now - _previousSample.now) / 1000.0;
+        _releasesPerSec = (sample.ticketsReleased - _previousSample.ticketsReleased) / seconds;
+
+        if (_releasesPerSec > 0 && sample.ticketsInUse > 0) {
+            const double latencyMicros = sample.ticketsInUse / _releasesPerSec * 1000 * 1000;
+            if (_haveLatency) {
+                _latencyMicros += kLatencySmoothing * (latencyMicros - _latencyMicros);
+            } else {
+                _latencyMicros = latencyMicros;
+                _baselineLatencyMicros = latencyMicros;
+                _haveLatency = true;
+            }
+
+            if (_latencyMicros < _baselineLatencyMicros) {
+                _baselineLatencyMicros = _latencyMicros;
+            } else {
+                _baselineLatencyMicros +=
+                    kBaselineDrift * (_latencyMicros - _baselineLatencyMicros);
+            }
+        }
+    }
+    _previousSample = sample;
+    _havePreviousSample = true;
+
+    if (aboveLimit(sample.dirtyCacheBytes, sample.maxCacheBytes, settings.dirtyCacheLimitPercent) ||
+        aboveLimit(sample.usedCacheBytes, sample.maxCacheBytes, settings.usedCacheLimitPercent)) {
+        return Decision::kCachePressureDecrease;
+    }
+
+    // Only a limit that is actually reached can be blamed for queueing or slow operations.
+    const bool saturated = sample.waiters > 0 || sample.ticketsInUse >= _target;
+    if (!saturated) {
+        return Decision::kHold;
+    }
+
+    if (_haveLatency && _latencyMicros > kLatencyTolerance * _baselineLatencyMicros) {
+        return Decision::kLatencyDecrease;
+    }
+
+    return Decision::kIncrease;
+}
+
+void WiredTigerTicketTuner::reset(int tickets) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _target = tickets;
+}
+
+void WiredTigerTicketTuner::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    BSONObjBuilder bob(builder->subobjStart("adaptive"));
+    bob.append("targetTickets", _target);
+    bob.append("releasesPerSec", _releasesPerSec);
+    bob.append("latencyMicros", _latencyMicros);
+    bob.append("baselineLatencyMicros", _baselineLatencyMicros);
+    bob.append("lastDecision", decisionName(_lastDecision));
+    {
+        BSONObjBuilder decisions(bob.subobjStart("decisions"));
+        for (auto decision : kDecisions) {
+            decisions.append(decisionName(decision),
+                             static_cast<long long>(_decisions[static_cast<int>(decision)]));
+        }
+        decisions.done();
+    }
+    bob.done();
+}
+
+StringData WiredTigerTicketTuner::decisionName(Decision decision) {
+    switch (decision) {
+        case Decision::kHold:
+            return "hold"_sd;
+        case Decision::kIncrease:
+            return "increase"_sd;
+        case Decision::kLatencyDecrease:
+            return "latencyDecrease"_sd;
+        case Decision::kCachePressureDecrease:
+            return "cachePressureDecrease"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
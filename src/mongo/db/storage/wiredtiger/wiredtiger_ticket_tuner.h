@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Adapts the number of read or write tickets to the load the storage engine is under.
+ *
+ * The tuner is an AIMD controller. While every ticket is in use or operations are queued for one,
+ * and latency is close to its baseline, the ticket count grows additively by about the square root
+ * of the current count. It shrinks multiplicatively when the time operations hold a ticket rises
+ * well above that baseline, and more sharply when the WiredTiger cache fills up to the point where
+ * application threads get pulled into eviction. Latency is estimated with Little's law,
+ * as the tickets in use divided by the rate at which they are released, so no per-operation
+ * timing is needed. The baseline follows the lowest latency seen and drifts slowly back up so
+ * that it tracks changes in the workload.
+ *
+ * The tuner holds no WiredTiger state. A background thread feeds it periodic load samples and
+ * applies the ticket count it returns, which keeps the policy testable on its own.
+ */
+class WiredTigerTicketTuner {
+    MONGO_DISALLOW_COPYING(WiredTigerTicketTuner);
+
+public:
+    enum class Decision {
+        kHold,
+        kIncrease,
+        kLatencyDecrease,
+        kCachePressureDecrease,
+    };
+
+    struct Settings {
+        int minTickets = 5;
+        int maxTickets = 128;
+        // Shrink once dirty data is at this percentage of the cache. Zero disables.
+        int dirtyCacheLimitPercent = 0;
+        // Shrink once the cache is filled to this percentage. Zero disables.
+        int usedCacheLimitPercent = 0;
+    };
+
+    struct LoadSample {
+        Date_t now;
+        // Cumulative count of released tickets; the tuner tracks its delta.
+        std::uint64_t ticketsReleased = 0;
+        int ticketsInUse = 0;
+        int waiters = 0;
+        std::uint64_t dirtyCacheBytes = 0;
+        std::uint64_t usedCacheBytes = 0;
+        std::uint64_t maxCacheBytes = 0;
+    };
+
+    explicit WiredTigerTicketTuner(int initialTickets);
+
+    /**
+     * Returns the number of tickets to use from now on, always within the bounds in 'settings'.
+     * Expected to be called at a regular interval.
+     */
+    int evaluate(const Settings& settings, const LoadSample& sample);
+
+    /**
+     * Resets the target to 'tickets', for when the ticket count was changed by hand.
+     */
+    void reset(int tickets);
+
+    /**
+     * Appends the current target, the latest throughput and latency estimates, and how often each
+     * decision was taken.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    static StringData decisionName(Decision decision);
+
+private:
+    Decision _decide(WithLock, const Settings& settings, const LoadSample& sample);
+
+    mutable stdx::mutex _mutex;
+
+    // All of the following are guarded by _mutex.
+
+    int _target;
+
+    bool _havePreviousSample = false;
+    LoadSample _previousSample;
+
+    double _releasesPerSec = 0;
+    // Smoothed estimate of how long operations hold a ticket, and its slowly rising baseline.
+    bool _haveLatency = false;
+    double _latencyMicros = 0;
+    double _baselineLatencyMicros = 0;
+
+    Decision _lastDecision = Decision::kHold;
+    std::uint64_t _decisions[static_cast<int>(Decision::kCachePressureDecrease) + 1] = {};
+};
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000 * 1000);
+const std::uint64_t kCacheBytes = 1000 * 1000;
+
+WiredTigerTicketTuner::Settings makeSettings(int maxTickets = 128) {
+    WiredTigerTicketTuner::Settings settings;
+    settings.minTickets = 5;
+    settings.maxTickets = maxTickets;
+    settings.dirtyCacheLimitPercent = 20;
+    settings.usedCacheLimitPercent = 95;
+    return settings;
+}
+
+WiredTigerTicketTuner::LoadSample makeSample(Seconds sinceStart,
+                                             std::uint64_t released,
+                                             int inUse,
+                                             int waiters = 0,
+                                             std::uint64_t dirtyBytes = 0) {
+    WiredTigerTicketTuner::LoadSample sample;
+    sample.now = kStart + sinceStart;
+    sample.ticketsReleased = released;
+    sample.ticketsInUse = inUse;
+    sample.waiters = waiters;
+    sample.dirtyCacheBytes = dirtyBytes;
+    sample.usedCacheBytes = dirtyBytes;
+    sample.maxCacheBytes = kCacheBytes;
+    return sample;
+}
+
+BSONObj getStats(const WiredTigerTicketTuner& tuner) {
+    BSONObjBuilder bob;
+    tuner.appendStats(&bob);
+    return bob.obj()["adaptive"].Obj().getOwned();
+}
+
+TEST(WiredTigerTicketTunerTest, IncreasesWhileAllTicketsAreInUse) {
+    WiredTigerTicketTuner tuner(10);
+    const auto settings = makeSettings();
+
+    ASSERT_EQ(13, tuner.evaluate(settings, makeSample(Seconds(0), 0, 10)));
+    ASSERT_EQ(16, tuner.evaluate(settings, makeSample(Seconds(1), 1000, 13)));
+    ASSERT_EQ(20, tuner.evaluate(settings, makeSample(Seconds(2), 2300, 10, 5)));
+}
+
+TEST(WiredTigerTicketTunerTest, HoldsWhileTicketsAreAvailable) {
+    WiredTigerTicketTuner tuner(10);
+    const auto settings = makeSettings();
+
+    ASSERT_EQ(10, tuner.evaluate(settings, makeSample(Seconds(0), 0, 2)));
+    ASSERT_EQ(10, tuner.evaluate(settings, makeSample(Seconds(1), 1000, 9)));
+    ASSERT_EQ("hold", getStats(tuner)["lastDecision"].str());
+}
+
+TEST(WiredTigerTicketTunerTest, DecreasesUnderCachePressure) {
+    WiredTigerTicketTuner tuner(100);
+    const auto settings = makeSettings();
+
+    ASSERT_EQ(75, tuner.evaluate(settings, makeSample(Seconds(0), 0, 100, 10, kCacheBytes / 4)));
+    ASSERT_EQ(56, tuner.evaluate(settings, makeSample(Seconds(1), 0, 10, 0, kCacheBytes / 4)));
+    ASSERT_EQ(56, tuner.evaluate(settings, makeSample(Seconds(2), 0, 10, 0, kCacheBytes / 10)));
+}
+
+TEST(WiredTigerTicketTunerTest, DecreasesWhenLatencyRisesAboveBaseline) {
+    WiredTigerTicketTuner tuner(20);
+    const auto settings = makeSettings(20);
+
+    ASSERT_EQ(20, tuner.evaluate(settings, makeSample(Seconds(0), 0, 20)));
+    // 20 tickets released 2000 times a second are each held for 10ms.
+    ASSERT_EQ(20, tuner.evaluate(settings, makeSample(Seconds(1), 2000, 20)));
+    // A tenth of the throughput at the same concurrency means operations are stalling.
+    ASSERT_EQ(18, tuner.evaluate(settings, makeSample(Seconds(2), 2200, 20)));
+    ASSERT_EQ("latencyDecrease", getStats(tuner)["lastDecision"].str());
+}
+
+TEST(WiredTigerTicketTunerTest, StaysWithinBounds) {
+    WiredTigerTicketTuner tuner(200);
+    const auto settings = makeSettings();
+
+    ASSERT_EQ(96, tuner.evaluate(settings, makeSample(Seconds(0), 0, 0, 0, kCacheBytes)));
+    for (int i = 1; i < 20; ++i) {
+        tuner.evaluate(settings, makeSample(Seconds(i), 0, 0, 0, kCacheBytes));
+    }
+    ASSERT_EQ(5, tuner.evaluate(settings, makeSample(Seconds(20), 0, 0, 0, kCacheBytes)));
+
+    tuner.reset(1000);
+    ASSERT_EQ(128, tuner.evaluate(settings, makeSample(Seconds(21), 0, 0)));
+}
+
+TEST(WiredTigerTicketTunerTest, StatsCountDecisions) {
+    WiredTigerTicketTuner tuner(10);
+    const auto settings = makeSettings();
+
+    tuner.evaluate(settings, makeSample(Seconds(0), 0, 10));
+    tuner.evaluate(settings, makeSample(Seconds(1), 1000, 2));
+    tuner.evaluate(settings, makeSample(Seconds(2), 2000, 2, 0, kCacheBytes));
+
+    const BSONObj stats = getStats(tuner);
+    ASSERT_EQ(9, stats["targetTickets"].numberInt());
+    ASSERT_EQ(1000, stats["releasesPerSec"].numberDouble());
+    ASSERT_EQ(1, stats["decisions"]["increase"].numberLong());
+    ASSERT_EQ(1, stats["decisions"]["hold"].numberLong());
+    ASSERT_EQ(1, stats["decisions"]["cachePressureDecrease"].numberLong());
+    ASSERT_EQ(0, stats["decisions"]["latencyDecrease"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
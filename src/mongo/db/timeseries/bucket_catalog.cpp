@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+const auto getBucketCatalog = ServiceContext::declareDecoration<BucketCatalog>();
+}  // namespace
+
+constexpr int BucketCatalog::kMaxMeasurementsPerBucket;
+
+BucketCatalog& BucketCatalog::get(ServiceContext* serviceContext) {
+    return getBucketCatalog(serviceContext);
+}
+
+BucketCatalog& BucketCatalog::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::string BucketCatalog::_seriesKey(const NamespaceString& bucketsNs, const BSONObj& meta) {
+    std::string key = bucketsNs.ns();
+    key.push_back('\0');
+    key.append(meta.objdata(), meta.objsize());
+    return key;
+}
+
+BucketCatalog::InsertResult BucketCatalog::insert(const NamespaceString& bucketsNs,
+                                                  const BSONObj& meta,
+                                                  long long windowStart) {
+    auto key = _seriesKey(bucketsNs, meta);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _openBuckets.find(key);
+    if (it != _openBuckets.end() && it->second.windowStart == windowStart &&
+        it->second.numMeasurements < kMaxMeasurementsPerBucket) {
+        return {it->second.id, it->second.numMeasurements++, false};
+    }
+
+    // Only the latest bucket of a series is kept open; a measurement that falls into another
+    // window closes it, which bounds the size of the catalog by the number of series.
+    Bucket bucket{OID::gen(), windowStart, 1};
+    _openBuckets[key] = bucket;
+    return {bucket.id, 0, true};
+}
+
+void BucketCatalog::abandon(const NamespaceString& bucketsNs,
+                            const BSONObj& meta,
+                            const OID& bucketId) {
+    auto key = _seriesKey(bucketsNs, meta);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _openBuckets.find(key);
+    if (it != _openBuckets.end() && it->second.id == bucketId) {
+        _openBuckets.erase(it);
+    }
+}
+
+void BucketCatalog::clear(const NamespaceString& bucketsNs) {
+    auto prefix = _seriesKey(bucketsNs, BSONObj());
+    prefix.resize(bucketsNs.ns().size() + 1);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = _openBuckets.begin(); it != _openBuckets.end();) {
+        if (StringData(it->first).startsWith(prefix)) {
+            it = _openBuckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t BucketCatalog::numOpenBuckets() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _openBuckets.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * In-memory catalog of the open bucket of every series of the time-series collections on this
+ * node. A series is identified by the buckets namespace and the meta value of its measurements.
+ *
+ * The catalog only hands out positions in buckets; the caller is responsible for writing the
+ * bucket documents. Since nothing here is durable, a caller that finds that a bucket it was told
+ * to append to does not exist (for example after the collection was dropped, or when the write
+ * that would have created it failed) should call abandon() and insert the measurement again.
+ */
+class BucketCatalog {
+    MONGO_DISALLOW_COPYING(BucketCatalog);
+
+public:
+    // Once a bucket holds this many measurements, the next measurement opens a new bucket.
+    static constexpr int kMaxMeasurementsPerBucket = 1000;
+
+    static BucketCatalog& get(ServiceContext* serviceContext);
+    static BucketCatalog& get(OperationContext* opCtx);
+
+    BucketCatalog() = default;
+
+    struct InsertResult {
+        OID bucketId;
+
+        // Position of the measurement within the bucket.
+        int index;
+
+        // True if the measurement opened a new bucket, whose document does not exist yet.
+        bool isNew;
+    };
+
+    /**
+     * Assigns a position to a measurement with the given meta value (an object holding at most
+     * one element, or empty if there is none) whose time falls into the window starting at
+     * 'windowStart', in milliseconds since the epoch.
+     */
+    InsertResult insert(const NamespaceString& bucketsNs,
+                        const BSONObj& meta,
+                        long long windowStart);
+
+    /**
+     * Forgets the bucket 'bucketId' of the given series, if it is still the open one, so that the
+     * next measurement of the series opens a new bucket.
+     */
+    void abandon(const NamespaceString& bucketsNs, const BSONObj& meta, const OID& bucketId);
+
+    /**
+     * Forgets all the open buckets of the given buckets namespace.
+     */
+    void clear(const NamespaceString& bucketsNs);
+
+    /**
+     * Returns the number of series with an open bucket.
+     */
+    size_t numOpenBuckets() const;
+
+private:
+    struct Bucket {
+        OID id;
+        long long windowStart;
+        int numMeasurements;
+    };
+
+    static std::string _seriesKey(const NamespaceString& bucketsNs, const BSONObj& meta);
+
+    mutable stdx::mutex _mutex;
+
+    // Maps the key of a series, made of its buckets namespace and the binary meta value, to its
+    // open bucket.
+    stdx::unordered_map<std::string, Bucket> _openBuckets;
+};
+
+}  // namespace mongo
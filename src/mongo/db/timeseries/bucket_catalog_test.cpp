@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kBucketsNs("test.system.buckets.weather");
+
+TEST(BucketCatalogTest, MeasurementsOfTheSameSeriesShareABucket) {
+    BucketCatalog catalog;
+    auto meta = BSON("meta"
+                     << "a");
+
+    auto first = catalog.insert(kBucketsNs, meta, 0);
+    ASSERT(first.isNew);
+    ASSERT_EQ(0, first.index);
+
+    auto second = catalog.insert(kBucketsNs, meta, 0);
+    ASSERT_FALSE(second.isNew);
+    ASSERT_EQ(1, second.index);
+    ASSERT_EQ(first.bucketId, second.bucketId);
+
+    auto otherSeries = catalog.insert(kBucketsNs,
+                                      BSON("meta"
+                                           << "b"),
+                                      0);
+    ASSERT(otherSeries.isNew);
+    ASSERT_NE(first.bucketId, otherSeries.bucketId);
+    ASSERT_EQ(2U, catalog.numOpenBuckets());
+}
+
+TEST(BucketCatalogTest, NewWindowOpensANewBucket) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNs, BSONObj(), 0);
+    auto next = catalog.insert(kBucketsNs, BSONObj(), 60000);
+    ASSERT(next.isNew);
+    ASSERT_NE(first.bucketId, next.bucketId);
+    ASSERT_EQ(1U, catalog.numOpenBuckets());
+}
+
+TEST(BucketCatalogTest, FullBucketOpensANewBucket) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNs, BSONObj(), 0);
+    for (int i = 1; i < BucketCatalog::kMaxMeasurementsPerBucket; ++i) {
+        ASSERT_EQ(first.bucketId, catalog.insert(kBucketsNs, BSONObj(), 0).bucketId);
+    }
+    auto next = catalog.insert(kBucketsNs, BSONObj(), 0);
+    ASSERT(next.isNew);
+    ASSERT_NE(first.bucketId, next.bucketId);
+}
+
+TEST(BucketCatalogTest, AbandonAndClear) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNs, BSONObj(), 0);
+    catalog.abandon(kBucketsNs, BSONObj(), first.bucketId);
+    ASSERT_EQ(0U, catalog.numOpenBuckets());
+    auto next = catalog.insert(kBucketsNs, BSONObj(), 0);
+    ASSERT(next.isNew);
+
+    // Abandoning a bucket that is no longer open has no effect.
+    catalog.abandon(kBucketsNs, BSONObj(), first.bucketId);
+    ASSERT_EQ(1U, catalog.numOpenBuckets());
+
+    catalog.insert(NamespaceString("test.system.buckets.other"), BSONObj(), 0);
+    catalog.clear(kBucketsNs);
+    ASSERT_EQ(1U, catalog.numOpenBuckets());
+}
+
+}  // namespace
+}  // namespace mongo
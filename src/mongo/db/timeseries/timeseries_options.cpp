@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/timeseries_options.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+constexpr StringData TimeseriesOptions::kTimeFieldName;
+constexpr StringData TimeseriesOptions::kMetaFieldName;
+constexpr StringData TimeseriesOptions::kBucketMaxSpanSecondsFieldName;
+constexpr StringData TimeseriesOptions::kBucketControlFieldName;
+constexpr StringData TimeseriesOptions::kBucketMetaFieldName;
+constexpr StringData TimeseriesOptions::kBucketDataFieldName;
+constexpr StringData TimeseriesOptions::kBucketControlVersionFieldName;
+constexpr StringData TimeseriesOptions::kBucketControlMinFieldName;
+constexpr StringData TimeseriesOptions::kBucketControlMaxFieldName;
+constexpr StringData TimeseriesOptions::kUnpackBucketStageName;
+
+namespace {
+
+Status validateFieldName(StringData option, const BSONElement& elem) {
+    if (elem.type() != String) {
+        return {ErrorCodes::TypeMismatch,
+                str::stream() << "'timeseries." << option << "' has to be a string"};
+    }
+    auto name = elem.valueStringData();
+    if (name.empty() || name == "_id" || name.find('.') != std::string::npos || name[0] == '$') {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'timeseries." << option
+                              << "' has to be a top-level field name other than _id, got: "
+                              << name};
+    }
+    return Status::OK();
+}
+
+}  // namespace
+
+StatusWith<TimeseriesOptions> TimeseriesOptions::parse(const BSONObj& obj) {
+    TimeseriesOptions options;
+    bool hasTimeField = false;
+
+    for (auto&& elem : obj) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kTimeFieldName) {
+            auto status = validateFieldName(fieldName, elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            options.timeField = elem.str();
+            hasTimeField = true;
+        } else if (fieldName == kMetaFieldName) {
+            auto status = validateFieldName(fieldName, elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            options.metaField = elem.str();
+        } else if (fieldName == kBucketMaxSpanSecondsFieldName) {
+            if (!elem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        "'timeseries.bucketMaxSpanSeconds' has to be a number"};
+            }
+            options.bucketMaxSpanSeconds = elem.safeNumberLong();
+            if (options.bucketMaxSpanSeconds <= 0) {
+                return {ErrorCodes::BadValue, "'timeseries.bucketMaxSpanSeconds' has to be > 0"};
+            }
+        } else {
+            return {ErrorCodes::InvalidOptions,
+                    str::stream() << "The field 'timeseries." << fieldName
+                                  << "' is not a valid time-series option"};
+        }
+    }
+
+    if (!hasTimeField) {
+        return {ErrorCodes::InvalidOptions, "'timeseries' requires a 'timeField'"};
+    }
+    if (options.metaField && *options.metaField == options.timeField) {
+        return {ErrorCodes::InvalidOptions,
+                "'timeseries.metaField' cannot be the same as 'timeseries.timeField'"};
+    }
+
+    return options;
+}
+
+BSONObj TimeseriesOptions::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append(kTimeFieldName, timeField);
+    if (metaField) {
+        builder.append(kMetaFieldName, *metaField);
+    }
+    builder.append(kBucketMaxSpanSecondsFieldName, bucketMaxSpanSeconds);
+    return builder.obj();
+}
+
+BSONArray TimeseriesOptions::makeViewPipeline() const {
+    return BSON_ARRAY(BSON(kUnpackBucketStageName << toBSON()));
+}
+
+long long TimeseriesOptions::windowStart(Date_t time) const {
+    const long long spanMillis = bucketMaxSpanSeconds * 1000;
+    const long long millis = time.toMillisSinceEpoch();
+    // Round towards negative infinity so that times before the epoch get their own windows.
+    long long start = millis - millis % spanMillis;
+    if (millis % spanMillis < 0) {
+        start -= spanMillis;
+    }
+    return start;
+}
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * The 'timeseries' option of a time-series collection.
+ *
+ * A time-series collection is a view over a "system.buckets.<name>" collection. Each document in
+ * the buckets collection groups the measurements that share the same meta value and whose times
+ * fall into the same window of 'bucketMaxSpanSeconds'. The measurements are stored column-wise:
+ *
+ *  {
+ *      _id: <ObjectId>,
+ *      control: {version: 1, min: {<timeField>: <window start>}, max: {<timeField>: <latest>}},
+ *      meta: <meta value>,
+ *      data: {
+ *          <timeField>: {"0": <millis since window start>, "1": ...},
+ *          <field>: {"0": <value>, "1": ...},
+ *          ...
+ *      }
+ *  }
+ */
+struct TimeseriesOptions {
+    static constexpr StringData kTimeFieldName = "timeField"_sd;
+    static constexpr StringData kMetaFieldName = "metaField"_sd;
+    static constexpr StringData kBucketMaxSpanSecondsFieldName = "bucketMaxSpanSeconds"_sd;
+
+    // Field names of the bucket documents.
+    static constexpr StringData kBucketControlFieldName = "control"_sd;
+    static constexpr StringData kBucketMetaFieldName = "meta"_sd;
+    static constexpr StringData kBucketDataFieldName = "data"_sd;
+    static constexpr StringData kBucketControlVersionFieldName = "version"_sd;
+    static constexpr StringData kBucketControlMinFieldName = "min"_sd;
+    static constexpr StringData kBucketControlMaxFieldName = "max"_sd;
+
+    // The aggregation stage that turns bucket documents back into measurements.
+    static constexpr StringData kUnpackBucketStageName = "$_internalUnpackBucket"_sd;
+
+    static constexpr int kBucketVersion = 1;
+    static constexpr long long kDefaultBucketMaxSpanSeconds = 60 * 60;
+
+    /**
+     * Parses and validates the value of the 'timeseries' collection option.
+     */
+    static StatusWith<TimeseriesOptions> parse(const BSONObj& obj);
+
+    BSONObj toBSON() const;
+
+    /**
+     * Returns the pipeline of the view through which the measurements are read.
+     */
+    BSONArray makeViewPipeline() const;
+
+    /**
+     * Returns the start, in milliseconds since the epoch, of the bucket window containing 'time'.
+     */
+    long long windowStart(Date_t time) const;
+
+    std::string timeField;
+    boost::optional<std::string> metaField;
+    long long bucketMaxSpanSeconds = kDefaultBucketMaxSpanSeconds;
+};
+
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/timeseries_options.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(TimeseriesOptionsTest, ParsesAndRoundTrips) {
+    auto options = unittest::assertGet(TimeseriesOptions::parse(
+        BSON("timeField"
+             << "t"
+             << "metaField"
+             << "m"
+             << "bucketMaxSpanSeconds"
+             << 60)));
+    ASSERT_EQ("t", options.timeField);
+    ASSERT(options.metaField);
+    ASSERT_EQ("m", *options.metaField);
+    ASSERT_EQ(60, options.bucketMaxSpanSeconds);
+
+    auto reparsed = unittest::assertGet(TimeseriesOptions::parse(options.toBSON()));
+    ASSERT_BSONOBJ_EQ(options.toBSON(), reparsed.toBSON());
+}
+
+TEST(TimeseriesOptionsTest, DefaultsBucketSpan) {
+    auto options = unittest::assertGet(TimeseriesOptions::parse(BSON("timeField"
+                                                                      << "t")));
+    ASSERT_FALSE(options.metaField);
+    ASSERT_EQ(TimeseriesOptions::kDefaultBucketMaxSpanSeconds, options.bucketMaxSpanSeconds);
+}
+
+TEST(TimeseriesOptionsTest, RejectsInvalidOptions) {
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSONObj()).getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField" << 1)).getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField"
+                                                << "_id"))
+                      .getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField"
+                                                << "a.b"))
+                      .getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField"
+                                                << "t"
+                                                << "metaField"
+                                                << "t"))
+                      .getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField"
+                                                << "t"
+                                                << "bucketMaxSpanSeconds"
+                                                << 0))
+                      .getStatus());
+    ASSERT_NOT_OK(TimeseriesOptions::parse(BSON("timeField"
+                                                << "t"
+                                                << "unknown"
+                                                << 1))
+                      .getStatus());
+}
+
+TEST(TimeseriesOptionsTest, WindowStartRoundsDown) {
+    TimeseriesOptions options;
+    options.timeField = "t";
+    options.bucketMaxSpanSeconds = 60;
+    ASSERT_EQ(120000, options.windowStart(Date_t::fromMillisSinceEpoch(120000)));
+    ASSERT_EQ(120000, options.windowStart(Date_t::fromMillisSinceEpoch(179999)));
+    ASSERT_EQ(-60000, options.windowStart(Date_t::fromMillisSinceEpoch(-1)));
+}
+
+}  // namespace
+}  // namespace mongo
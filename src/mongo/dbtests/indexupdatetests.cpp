@@ -38,9 +38,11 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/dbtests/dbtests.h"
 
 namespace IndexUpdateTests {
@@ -207,6 +209,234 @@ public:
     }
 };
 
+/**
+ * Foreground builds of several indexes generate keys on multiple threads. Every document must
+ * still end up in every index, with multikey state merged from all threads.
+ */
+class InsertBuildMultipleIndexesInParallel : public IndexBuildBase {
+public:
+    void run() {
+        const int nDocs = 5000;
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < nDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << i << "b" << BSON_ARRAY(i << -i))),
+                    nullOpDebug,
+                    true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowInterruption();
+
+        const auto makeSpec = [&](StringData name, const BSONObj& key) {
+            return BSON("name" << name << "ns" << coll->ns().ns() << "key" << key << "v"
+                               << static_cast<int>(kIndexVersion));
+        };
+        const std::vector<BSONObj> specs = {makeSpec("a_1", BSON("a" << 1)),
+                                            makeSpec("b_1", BSON("b" << 1))};
+
+        ASSERT_OK(indexer.init(specs).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        auto indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* aIndex = indexCatalog->findIndexByName(&_opCtx, "a_1");
+        IndexDescriptor* bIndex = indexCatalog->findIndexByName(&_opCtx, "b_1");
+        ASSERT(aIndex);
+        ASSERT(bIndex);
+        ASSERT_FALSE(indexCatalog->isMultikey(&_opCtx, aIndex));
+        ASSERT_TRUE(indexCatalog->isMultikey(&_opCtx, bIndex));
+
+        int64_t numKeys;
+        indexCatalog->getIndex(aIndex)->validate(&_opCtx, &numKeys, nullptr);
+        ASSERT_EQUALS(nDocs, numKeys);
+        indexCatalog->getIndex(bIndex)->validate(&_opCtx, &numKeys, nullptr);
+        // Document 0 has the same key twice, so it only contributes one.
+        ASSERT_EQUALS(2 * nDocs - 1, numKeys);
+    }
+};
+
+/**
+ * Hybrid background builds divert writes made after init() into a side table, and apply them
+ * once the index has been bulk loaded.
+ */
+class InsertBuildHybridAppliesSideWrites : public IndexBuildBase {
+public:
+    void run() {
+        Database* db = _ctx.db();
+        Collection* coll;
+        OpDebug* const nullOpDebug = nullptr;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+            for (int i = 0; i < 100; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        // Writes that arrive while the index is being built insert 50 documents and delete 10.
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            for (int i = 100; i < 150; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+        {
+            std::vector<RecordId> toDelete;
+            auto cursor = coll->getCursor(&_opCtx);
+            while (auto record = cursor->next()) {
+                if (record->data.releaseToBson()["_id"].numberInt() < 10) {
+                    toDelete.push_back(record->id);
+                }
+            }
+            cursor.reset();
+
+            WriteUnitOfWork wunit(&_opCtx);
+            for (const auto& loc : toDelete) {
+                coll->deleteDocument(&_opCtx, kUninitializedStmtId, loc, nullOpDebug);
+            }
+            wunit.commit();
+        }
+
+        auto indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* desc = indexCatalog->findIndexByName(&_opCtx, "a_1", true);
+        ASSERT(desc);
+        IndexAccessMethod* iam = indexCatalog->getIndex(desc);
+        ASSERT(iam->getIndexBuildInterceptor());
+        ASSERT_EQUALS(60, iam->getIndexBuildInterceptor()->getNumRecorded());
+
+        // None of the writes reached the index itself.
+        int64_t numKeys;
+        iam->validate(&_opCtx, &numKeys, nullptr);
+        ASSERT_EQUALS(0, numKeys);
+
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        ASSERT_OK(indexer.drainBackgroundWrites());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        ASSERT_FALSE(iam->getIndexBuildInterceptor());
+        iam->validate(&_opCtx, &numKeys, nullptr);
+        ASSERT_EQUALS(140, numKeys);
+    }
+};
+
+/**
+ * Side writes are drained in the order their transactions took sequence numbers, not the order in
+ * which their commit handlers ran, and never past a transaction that is still open.
+ */
+class InsertBuildHybridDrainsSideWritesInSequenceOrder : public IndexBuildBase {
+public:
+    void run() {
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        auto indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* desc = indexCatalog->findIndexByName(&_opCtx, "a_1", true);
+        ASSERT(desc);
+        IndexAccessMethod* iam = indexCatalog->getIndex(desc);
+        IndexBuildInterceptor* interceptor = iam->getIndexBuildInterceptor();
+        ASSERT(interceptor);
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+
+        // The insert takes its sequence number first, but the delete's transaction commits first.
+        const IndexKeyEntry entry(BSON("" << 1), RecordId(1));
+        auto insertClient = getGlobalServiceContext()->makeClient("sideWriteInsert");
+        auto insertOpCtx = insertClient->makeOperationContext();
+        auto insertWunit = stdx::make_unique<WriteUnitOfWork>(insertOpCtx.get());
+        interceptor->sideWrite(insertOpCtx.get(), IndexBuildInterceptor::Op::kInsert, {entry});
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            interceptor->sideWrite(&_opCtx, IndexBuildInterceptor::Op::kDelete, {entry});
+            wunit.commit();
+        }
+
+        // The delete waits behind the insert's open transaction.
+        ASSERT_OK(indexer.drainBackgroundWrites());
+        ASSERT_EQUALS(1, interceptor->getNumRecorded());
+        ASSERT_EQUALS(0, interceptor->getNumApplied());
+        ASSERT_FALSE(interceptor->areAllWritesApplied());
+
+        insertWunit->commit();
+        insertWunit.reset();
+
+        // Replaying the delete after the insert leaves the key out of the index.
+        ASSERT_OK(indexer.drainBackgroundWrites());
+        ASSERT_EQUALS(2, interceptor->getNumApplied());
+        ASSERT_TRUE(interceptor->areAllWritesApplied());
+
+        int64_t numKeys;
+        iam->validate(&_opCtx, &numKeys, nullptr);
+        ASSERT_EQUALS(0, numKeys);
+
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -765,6 +995,9 @@ public:
         }
         add<InsertBuildEnforceUnique<true>>();
         add<InsertBuildEnforceUnique<false>>();
+        add<InsertBuildMultipleIndexesInParallel>();
+        add<InsertBuildHybridAppliesSideWrites>();
+        add<InsertBuildHybridDrainsSideWritesInSequenceOrder>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
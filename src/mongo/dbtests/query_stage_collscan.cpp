@@ -44,6 +44,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/storage/field_name_dictionary_record_store.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
@@ -400,6 +401,47 @@ public:
     }
 };
 
+//
+// Scan a collection storing its documents in compact form. Filters on known fields are evaluated
+// against the compact documents, the others against the decoded ones.
+//
+
+class QueryStageCollscanFieldNameDictionary : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        DBDirectClient client(&_opCtx);
+        {
+            dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+            client.dropCollection(nss.ns());
+            BSONObj info;
+            ASSERT(client.runCommand(nss.db().toString(),
+                                      BSON("create" << nss.coll() << "fieldNameDictionary" << true),
+                                      info));
+            for (int i = 0; i < numObj(); ++i) {
+                client.insert(nss.ns(), BSON("foo" << i << "sub" << BSON("bar" << i % 2)));
+            }
+        }
+
+        {
+            AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+            ASSERT(dynamic_cast<FieldNameDictionaryRecordStore*>(
+                ctx.getCollection()->getRecordStore()));
+        }
+
+        ASSERT_EQUALS(25,
+                      countResults(CollectionScanParams::FORWARD,
+                                   BSON("foo" << BSON("$lt" << 25))));
+        ASSERT_EQUALS(numObj() / 2,
+                      countResults(CollectionScanParams::BACKWARD, BSON("sub.bar" << 1)));
+        ASSERT_EQUALS(numObj() / 2,
+                      countResults(CollectionScanParams::FORWARD, BSON("sub" << BSON("bar" << 1))));
+        ASSERT_EQUALS(0, countResults(CollectionScanParams::FORWARD, BSON("missing" << 1)));
+
+        BSONObj doc = client.findOne(nss.ns(), BSON("foo" << 3));
+        ASSERT_BSONOBJ_EQ(doc.removeField("_id"), BSON("foo" << 3 << "sub" << BSON("bar" << 1)));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -414,6 +456,7 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
         add<QueryStageCollscanInvalidateUpcomingObjectBackward>();
+        add<QueryStageCollscanFieldNameDictionary>();
     }
 };
 
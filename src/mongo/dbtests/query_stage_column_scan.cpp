@@ -0,0 +1,265 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/column_scan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/column_store_key_generator.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/dbtests/dbtests.h"
+
+namespace QueryStageColumnScan {
+
+using std::unique_ptr;
+using std::vector;
+
+const BSONObj kIndexKeyPattern = BSON("_id"
+                                      << "columnstore"
+                                      << "a"
+                                      << "columnstore"
+                                      << "b"
+                                      << "columnstore");
+
+class ColumnScanBase {
+public:
+    ColumnScanBase() : _client(&_opCtx) {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        _client.dropCollection(ns());
+        ASSERT_OK(dbtests::createIndex(&_opCtx, ns(), kIndexKeyPattern));
+    }
+
+    virtual ~ColumnScanBase() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        _client.dropCollection(ns());
+    }
+
+    void insert(const BSONObj& obj) {
+        _client.insert(ns(), obj);
+    }
+
+    void update(const BSONObj& query, const BSONObj& update) {
+        _client.update(ns(), query, update);
+    }
+
+    const IndexDescriptor* getIndex(Collection* collection) {
+        vector<IndexDescriptor*> indexes;
+        collection->getIndexCatalog()->findIndexesByKeyPattern(
+            &_opCtx, kIndexKeyPattern, false, &indexes);
+        ASSERT_EQ(1U, indexes.size());
+        return indexes[0];
+    }
+
+    unique_ptr<MatchExpression> parseFilter(const BSONObj& filterObj) {
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        auto statusWithMatcher = MatchExpressionParser::parse(filterObj, expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        return std::move(statusWithMatcher.getValue());
+    }
+
+    /**
+     * Works 'scan' until it is EOF, or until 'limit' results have been returned.
+     */
+    vector<BSONObj> getResults(ColumnScan* scan, WorkingSet* ws, size_t limit = 0) {
+        vector<BSONObj> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while ((0 == limit || results.size() < limit) && PlanStage::IS_EOF != state) {
+            state = scan->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws->get(id);
+                ASSERT_EQ(WorkingSetMember::OWNED_OBJ, member->getState());
+                results.push_back(member->obj.value().getOwned());
+                ws->free(id);
+            }
+        }
+        return results;
+    }
+
+    static const char* ns() {
+        return "unittests.QueryStageColumnScan";
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_txnPtr;
+
+private:
+    DBDirectClient _client;
+};
+
+/**
+ * Every document has a row, holding only the requested fields that the document contains.
+ */
+class QueryStageColumnScanReturnsRequestedFields : public ColumnScanBase {
+public:
+    void run() {
+        insert(BSON("_id" << 1 << "a" << 1 << "b" << 1 << "c" << 1));
+        insert(BSON("_id" << 2 << "b" << 2 << "c" << 2));
+        insert(BSON("_id" << 3 << "c" << 3));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+        Collection* collection = ctx.getCollection();
+
+        WorkingSet ws;
+        ColumnScan scan(
+            &_opCtx, collection, getIndex(collection), {"_id", "a"}, nullptr, &ws);
+        auto results = getResults(&scan, &ws);
+
+        ASSERT_EQ(3U, results.size());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "a" << 1), results[0]);
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 2), results[1]);
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 3), results[2]);
+    }
+};
+
+/**
+ * Rows which do not pass the filter are not returned.
+ */
+class QueryStageColumnScanAppliesFilter : public ColumnScanBase {
+public:
+    void run() {
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("_id" << i << "a" << i % 3 << "b" << i));
+        }
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+        Collection* collection = ctx.getCollection();
+
+        auto filter = parseFilter(fromjson("{a: 1, b: {$gt: 4}}"));
+        WorkingSet ws;
+        ColumnScan scan(
+            &_opCtx, collection, getIndex(collection), {"a", "b"}, filter.get(), &ws);
+        auto results = getResults(&scan, &ws);
+
+        ASSERT_EQ(1U, results.size());
+        ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 7), results[0]);
+
+        auto stats = static_cast<const ColumnScanStats*>(scan.getSpecificStats());
+        ASSERT_EQ(10U, stats->docsTested);
+        ASSERT_EQ(0U, stats->fetches);
+    }
+};
+
+/**
+ * Values too large to be held in the index are read from the document.
+ */
+class QueryStageColumnScanFetchesLargeValues : public ColumnScanBase {
+public:
+    void run() {
+        const std::string big(ColumnStoreKeyGenerator::kMaxStoredValueSize * 2, 'x');
+        insert(BSON("_id" << 1 << "a" << big << "b" << 1));
+        insert(BSON("_id" << 2 << "a"
+                          << "small"
+                          << "b"
+                          << 2));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+        Collection* collection = ctx.getCollection();
+
+        WorkingSet ws;
+        ColumnScan scan(&_opCtx, collection, getIndex(collection), {"a", "b"}, nullptr, &ws);
+        auto results = getResults(&scan, &ws);
+
+        ASSERT_EQ(2U, results.size());
+        ASSERT_BSONOBJ_EQ(BSON("a" << big << "b" << 1), results[0]);
+        ASSERT_BSONOBJ_EQ(BSON("a"
+                               << "small"
+                               << "b"
+                               << 2),
+                          results[1]);
+
+        auto stats = static_cast<const ColumnScanStats*>(scan.getSpecificStats());
+        ASSERT_EQ(1U, stats->fetches);
+    }
+};
+
+/**
+ * Changes made while the scan is yielded are seen by the rows it has yet to return.
+ */
+class QueryStageColumnScanUpdateDuringYield : public ColumnScanBase {
+public:
+    void run() {
+        for (int i = 0; i < 5; ++i) {
+            insert(BSON("_id" << i << "a" << i));
+        }
+
+        unique_ptr<WorkingSet> ws = stdx::make_unique<WorkingSet>();
+        unique_ptr<ColumnScan> scan;
+        vector<BSONObj> results;
+        {
+            AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+            Collection* collection = ctx.getCollection();
+            scan = stdx::make_unique<ColumnScan>(
+                &_opCtx, collection, getIndex(collection), vector<std::string>{"a"}, nullptr,
+                ws.get());
+            results = getResults(scan.get(), ws.get(), 2);
+            scan->saveState();
+            _opCtx.recoveryUnit()->abandonSnapshot();
+        }
+
+        update(BSON("_id" << 3), BSON("$set" << BSON("a" << 30)));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+        scan->restoreState();
+        auto rest = getResults(scan.get(), ws.get());
+        results.insert(results.end(), rest.begin(), rest.end());
+
+        ASSERT_EQ(5U, results.size());
+        ASSERT_BSONOBJ_EQ(BSON("a" << 30), results[3]);
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("query_stage_column_scan") {}
+
+    void setupTests() {
+        add<QueryStageColumnScanReturnsRequestedFields>();
+        add<QueryStageColumnScanAppliesFilter>();
+        add<QueryStageColumnScanFetchesLargeValues>();
+        add<QueryStageColumnScanUpdateDuringYield>();
+    }
+};
+
+SuiteInstance<All> queryStageColumnScanAll;
+
+}  // namespace QueryStageColumnScan
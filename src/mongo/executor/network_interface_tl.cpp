@@ -34,6 +34,7 @@
 
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -42,6 +43,13 @@
 
 namespace mongo {
 namespace executor {
+namespace {
+
+// When positive, commands to each host are pipelined over at most this many connections, instead
+// of each command checking a connection out of the pool for itself.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(multiplexedEgressConnectionsPerHost, int, 0);
+
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -56,7 +64,8 @@ NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
       _connPoolOpts(std::move(connPoolOpts)),
       _onConnectHook(std::move(onConnectHook)),
       _metadataHook(std::move(metadataHook)),
-      _inShutdown(false) {}
+      _inShutdown(false),
+      _multiplexedConnectionsPerHost(std::max(multiplexedEgressConnectionsPerHost, 0)) {}
 
 std::string NetworkInterfaceTL::getDiagnosticString() {
     return "DEPRECATED: getDiagnosticString is deprecated in NetworkInterfaceTL";
@@ -111,6 +120,24 @@ void NetworkInterfaceTL::_run() {
     // This returns when the reactor is stopped in shutdown()
     _reactor->run();
 
+    // Fail everything still using or waiting for a multiplexed connection, so that the pool gets
+    // those connections back before it shuts down.
+    for (auto& host : _multiplexedHosts) {
+        for (auto& conn : host.second.conns) {
+            conn->detached = true;
+            conn->conn->indicateFailure(
+                Status(ErrorCodes::ShutdownInProgress, "NetworkInterface shutdown in progress"));
+            conn->client()->end();
+        }
+        for (auto& state : host.second.waiting) {
+            if (!state->done.swap(true)) {
+                state->promise.setError(Status(ErrorCodes::ShutdownInProgress,
+                                               "NetworkInterface shutdown in progress"));
+            }
+        }
+    }
+    _multiplexedHosts.clear();
+
     // Note that the pool will shutdown again when the ConnectionPool dtor runs
     // This prevents new timers from being set, calls all cancels via the factory registry, and
     // destructs all connections for all existing pools.
@@ -209,6 +236,36 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    // The TransportLayer has, for historical reasons returned SocketException for network errors,
+    // but sharding assumes HostUnreachable on network errors.
+    auto toHostUnreachable = [](Status error) -> StatusWith<RemoteCommandResponse> {
+        if (error == ErrorCodes::SocketException) {
+            error = Status(ErrorCodes::HostUnreachable, error.reason());
+        }
+        return error;
+    };
+
+    auto finish = [this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
+        auto duration = now() - state->start;
+        if (!response.isOK()) {
+            onFinish(RemoteCommandResponse(response.getStatus(), duration));
+        } else {
+            const auto& rs = response.getValue();
+            LOG(2) << "Request " << state->request.id << " finished with response: "
+                   << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
+            onFinish(rs);
+        }
+    };
+
+    if (_multiplexedConnectionsPerHost) {
+        // Multiplexed connections are shared by many commands, so all their I/O stays on the
+        // reactor thread rather than moving to any command's baton.
+        _reactor->schedule(transport::Reactor::kPost,
+                           [this, state] { _startMultiplexedCommand(state); });
+        std::move(pf.future).onError(toHostUnreachable).getAsync(std::move(finish));
+        return Status::OK();
+    }
+
     // Interacting with the connection pool can involve more work than just getting a connection
     // out.  In particular, we can end up having to spin up new connections, and fulfilling promises
     // for other requesters.  Returning connections has the same issue.
@@ -241,31 +298,15 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         // TODO: once SERVER-35685 is done, stop using a `std::shared_ptr<Future>` here.
         future = std::make_shared<decltype(pf.future)>(std::move(pf.future)),
         baton,
-        onFinish
+        toHostUnreachable,
+        finish
     ](StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
         makeReadyFutureWith([&] {
             return _onAcquireConn(
                 state, std::move(*future), std::move(*uassertStatusOK(swConn)), baton);
         })
-            .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
-                // The TransportLayer has, for historical reasons returned SocketException for
-                // network errors, but sharding assumes HostUnreachable on network errors.
-                if (error == ErrorCodes::SocketException) {
-                    error = Status(ErrorCodes::HostUnreachable, error.reason());
-                }
-                return error;
-            })
-            .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
-                auto duration = now() - state->start;
-                if (!response.isOK()) {
-                    onFinish(RemoteCommandResponse(response.getStatus(), duration));
-                } else {
-                    const auto& rs = response.getValue();
-                    LOG(2) << "Request " << state->request.id << " finished with response: "
-                           << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
-                    onFinish(rs);
-                }
-            });
+            .onError(toHostUnreachable)
+            .getAsync(finish);
     };
 
     if (baton) {
@@ -403,6 +444,197 @@ void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbH
     _inProgress.erase(cbHandle);
 }
 
+AsyncDBClient* NetworkInterfaceTL::MultiplexedConnection::client() const {
+    return checked_cast<connection_pool_tl::TLConnection*>(conn.get())->client();
+}
+
+void NetworkInterfaceTL::_startMultiplexedCommand(std::shared_ptr<CommandState> state) {
+    if (state->done.load()) {
+        return;
+    }
+
+    if (state->deadline != RemoteCommandRequest::kNoExpirationDate) {
+        // A command can't be taken back once it is on the wire, so on timeout it is only completed
+        // early and its reply dropped. Canceling the shared connection would fail every other
+        // command on it.
+        state->timer = _reactor->makeTimer();
+        state->timer->waitUntil(state->deadline, nullptr).getAsync([this, state](Status status) {
+            if (status == ErrorCodes::CallbackCanceled) {
+                invariant(state->done.load());
+                return;
+            }
+
+            if (state->done.swap(true)) {
+                return;
+            }
+
+            if (getTestCommandsEnabled()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _counters.timedOut++;
+            }
+
+            LOG(2) << "Request " << state->request.id << " timed out"
+                   << ", deadline was " << state->deadline << ", op was "
+                   << redact(state->request.toString());
+            state->promise.setError(
+                Status(ErrorCodes::NetworkInterfaceExceededTimeLimit, "timed out"));
+        });
+    }
+
+    auto& host = _multiplexedHosts[state->request.target];
+
+    std::shared_ptr<MultiplexedConnection> conn;
+    size_t connPipelined = 0;
+    for (const auto& candidate : host.conns) {
+        auto pipelined = candidate->client()->numPipelinedCommands();
+        if (!conn || pipelined < connPipelined) {
+            conn = candidate;
+            connPipelined = pipelined;
+        }
+    }
+
+    // Only open another connection once every existing one is busy.
+    if ((!conn || connPipelined > 0) &&
+        host.conns.size() + host.connecting < _multiplexedConnectionsPerHost) {
+        _openMultiplexedConnection(state->request.target, state->request.timeout);
+    }
+
+    if (!conn) {
+        host.waiting.push_back(std::move(state));
+        return;
+    }
+
+    _runMultiplexedCommand(std::move(conn), std::move(state));
+}
+
+void NetworkInterfaceTL::_openMultiplexedConnection(const HostAndPort& target,
+                                                    Milliseconds timeout) {
+    ++_multiplexedHosts[target].connecting;
+
+    makeReadyFutureWith([&] { return _pool->get(target, timeout); })
+        .then([this](ConnectionPool::ConnectionHandle conn) {
+            auto deleter = conn.get_deleter();
+            return std::make_shared<CommandState::ConnHandle>(
+                conn.release(), CommandState::Deleter{deleter, _reactor});
+        })
+        .getAsync([this, target](StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) {
+            _reactor->schedule(transport::Reactor::kDispatch, [this, target, swConn] {
+                _onMultiplexedConnection(target, swConn);
+            });
+        });
+}
+
+void NetworkInterfaceTL::_onMultiplexedConnection(
+    const HostAndPort& target, StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) {
+    auto& host = _multiplexedHosts[target];
+    --host.connecting;
+
+    if (!swConn.isOK()) {
+        LOG(2) << "Failed to get a multiplexed connection to " << target << ": "
+               << swConn.getStatus();
+
+        // Requests only wait while there is no connection at all, so fail them once the last
+        // attempt to establish one has failed.
+        if (host.conns.empty() && !host.connecting) {
+            auto waiting = std::move(host.waiting);
+            host.waiting.clear();
+            for (auto& state : waiting) {
+                if (!state->done.swap(true)) {
+                    _eraseInUseConn(state->cbHandle);
+                    if (state->timer) {
+                        state->timer->cancel();
+                    }
+                    state->promise.setError(swConn.getStatus());
+                }
+            }
+        }
+        return;
+    }
+
+    auto conn = std::make_shared<MultiplexedConnection>(std::move(*swConn.getValue()));
+    host.conns.push_back(conn);
+
+    auto waiting = std::move(host.waiting);
+    host.waiting.clear();
+    for (auto& state : waiting) {
+        if (!state->done.load()) {
+            _runMultiplexedCommand(conn, std::move(state));
+        }
+    }
+
+    // If nothing was waiting after all, don't keep the connection out of the pool.
+    if (!conn->client()->numPipelinedCommands()) {
+        conn->conn->indicateSuccess();
+        _detachMultiplexedConnection(target, conn);
+    }
+}
+
+void NetworkInterfaceTL::_runMultiplexedCommand(std::shared_ptr<MultiplexedConnection> conn,
+                                                std::shared_ptr<CommandState> state) {
+    auto client = conn->client();
+    client->runPipelinedCommandRequest(state->request)
+        .getAsync([ this, conn = std::move(conn), state = std::move(state) ](
+            StatusWith<RemoteCommandResponse> swr) mutable {
+            _onMultiplexedCommandDone(std::move(conn), std::move(state), std::move(swr));
+        });
+}
+
+void NetworkInterfaceTL::_onMultiplexedCommandDone(std::shared_ptr<MultiplexedConnection> conn,
+                                                   std::shared_ptr<CommandState> state,
+                                                   StatusWith<RemoteCommandResponse> swr) {
+    _eraseInUseConn(state->cbHandle);
+
+    const auto& target = state->request.target;
+    auto status = swr.isOK() ? swr.getValue().status : swr.getStatus();
+    if (!status.isOK()) {
+        // A network error has failed every command on the connection.
+        if (!conn->detached) {
+            conn->conn->indicateFailure(status);
+            _detachMultiplexedConnection(target, conn);
+        }
+    } else if (!conn->detached) {
+        conn->conn->indicateUsed();
+        if (!conn->client()->numPipelinedCommands()) {
+            // Hand idle connections back, so that the pool keeps them healthy and can reap them.
+            conn->conn->indicateSuccess();
+            _detachMultiplexedConnection(target, conn);
+        }
+    }
+
+    if (state->done.swap(true)) {
+        return;
+    }
+
+    if (swr.isOK() && swr.getValue().isOK() && _metadataHook) {
+        auto& response = swr.getValue();
+        response.status =
+            _metadataHook->readReplyMetadata(nullptr, target.toString(), response.data);
+    }
+
+    if (getTestCommandsEnabled()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (swr.isOK() && swr.getValue().status.isOK()) {
+            _counters.succeeded++;
+        } else {
+            _counters.failed++;
+        }
+    }
+
+    if (state->timer) {
+        state->timer->cancel();
+    }
+
+    state->promise.setFromStatusWith(std::move(swr));
+}
+
+void NetworkInterfaceTL::_detachMultiplexedConnection(
+    const HostAndPort& target, const std::shared_ptr<MultiplexedConnection>& conn) {
+    // The connection goes back to the pool once the last command still running on it is done.
+    conn->detached = true;
+    auto& conns = _multiplexedHosts[target].conns;
+    conns.erase(std::remove(conns.begin(), conns.end(), conn), conns.end());
+}
+
 void NetworkInterfaceTL::cancelCommand(const TaskExecutor::CallbackHandle& cbHandle,
                                        const transport::BatonHandle& baton) {
     stdx::unique_lock<stdx::mutex> lk(_inProgressMutex);
@@ -498,6 +730,23 @@ bool NetworkInterfaceTL::onNetworkThread() {
 
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
     _pool->dropConnections(hostAndPort);
+
+    if (_multiplexedConnectionsPerHost) {
+        // Stop sending new commands over the dropped connections. The pool discards each of them
+        // once the commands still running on it are done.
+        _reactor->schedule(transport::Reactor::kPost, [this, hostAndPort] {
+            auto it = _multiplexedHosts.find(hostAndPort);
+            if (it == _multiplexedHosts.end()) {
+                return;
+            }
+            for (auto& conn : it->second.conns) {
+                conn->detached = true;
+                conn->conn->indicateFailure(Status(ErrorCodes::PooledConnectionsDropped,
+                                                   "Multiplexed connection dropped"));
+            }
+            it->second.conns.clear();
+        });
+    }
 }
 
 }  // namespace executor
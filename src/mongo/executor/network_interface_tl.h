@@ -110,6 +110,29 @@ private:
         Promise<RemoteCommandResponse> promise;
     };
 
+    /**
+     * A pooled connection which carries the pipelined commands of many requests at once. It is
+     * kept out of the pool while any of them is outstanding.
+     */
+    struct MultiplexedConnection {
+        explicit MultiplexedConnection(CommandState::ConnHandle conn_) : conn(std::move(conn_)) {}
+
+        AsyncDBClient* client() const;
+
+        CommandState::ConnHandle conn;
+        bool detached = false;
+    };
+
+    /**
+     * The multiplexed connections to one host, and the requests waiting for the first of them to
+     * be established. Only accessed on the reactor thread.
+     */
+    struct MultiplexedHost {
+        std::vector<std::shared_ptr<MultiplexedConnection>> conns;
+        size_t connecting = 0;
+        std::deque<std::shared_ptr<CommandState>> waiting;
+    };
+
     void _run();
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
@@ -117,6 +140,18 @@ private:
                                                  CommandState::ConnHandle conn,
                                                  const transport::BatonHandle& baton);
 
+    void _startMultiplexedCommand(std::shared_ptr<CommandState> state);
+    void _openMultiplexedConnection(const HostAndPort& target, Milliseconds timeout);
+    void _onMultiplexedConnection(const HostAndPort& target,
+                                  StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn);
+    void _runMultiplexedCommand(std::shared_ptr<MultiplexedConnection> conn,
+                                std::shared_ptr<CommandState> state);
+    void _onMultiplexedCommandDone(std::shared_ptr<MultiplexedConnection> conn,
+                                   std::shared_ptr<CommandState> state,
+                                   StatusWith<RemoteCommandResponse> swr);
+    void _detachMultiplexedConnection(const HostAndPort& target,
+                                      const std::shared_ptr<MultiplexedConnection>& conn);
+
     std::string _instanceName;
     ServiceContext* _svcCtx;
     transport::TransportLayer* _tl;
@@ -140,6 +175,11 @@ private:
 
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
+
+    // When non-zero, commands are pipelined over at most this many connections per host rather than
+    // each taking a connection of its own.
+    const size_t _multiplexedConnectionsPerHost;
+    stdx::unordered_map<HostAndPort, MultiplexedHost> _multiplexedHosts;
 };
 
 }  // namespace executor
@@ -46,7 +46,11 @@ struct OpMsg {
 
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
-    static constexpr uint32_t kExhaustSupported = 1 << 16;
+    static constexpr uint32_t kExhaustAllowed = 1 << 16;
+
+    // The sender matches replies to requests by 'responseTo', so the receiver may process this
+    // request concurrently with other requests on the same connection and reply out of order.
+    static constexpr uint32_t kConcurrentProcessingAllowed = 1 << 17;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
@@ -162,7 +166,10 @@ class OpMsgBuilder {
     MONGO_DISALLOW_COPYING(OpMsgBuilder);
 
 public:
-    OpMsgBuilder() {
+    OpMsgBuilder() : _buf(0) {
+        // Build in a pooled buffer, so that the memory of a message that has been sent can be
+        // reused for the next one.
+        _buf.useSharedBuffer(SharedBuffer::allocatePooled(kInitialBufferSize));
         skipHeaderAndFlags();
     }
 
@@ -244,6 +251,8 @@ public:
 private:
     friend class DocSequenceBuilder;
 
+    static constexpr size_t kInitialBufferSize = 512;
+
     enum State {
         kEmpty,
         kDocSequence,
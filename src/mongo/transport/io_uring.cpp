@@ -0,0 +1,310 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+int sysIoUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sysIoUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int sysIoUringRegister(int fd, unsigned opcode, void* arg, unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+unsigned roundUpToPowerOfTwo(unsigned n) {
+    unsigned result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+Status errnoStatus(StringData what, int err) {
+    return Status(ErrorCodes::InternalError,
+                  str::stream() << what << " failed: " << errnoWithDescription(err));
+}
+
+}  // namespace
+
+bool IoUring::isSupported() {
+    auto swRing = create(8, 1, 64);
+    if (!swRing.isOK()) {
+        return false;
+    }
+
+    constexpr size_t kProbeOps = 256;
+    const size_t probeSize = sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op);
+    std::unique_ptr<char[]> probeBuf(new char[probeSize]());
+    auto probe = reinterpret_cast<io_uring_probe*>(probeBuf.get());
+    if (sysIoUringRegister(swRing.getValue()->_fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) {
+        return false;
+    }
+
+    for (auto op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_READ}) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+StatusWith<std::unique_ptr<IoUring>> IoUring::create(unsigned entries,
+                                                     unsigned numBuffers,
+                                                     size_t bufferSize) {
+    std::unique_ptr<IoUring> ring(new IoUring());
+    auto status = ring->_init(entries, numBuffers, bufferSize);
+    if (!status.isOK()) {
+        return status;
+    }
+    return {std::move(ring)};
+}
+
+Status IoUring::_init(unsigned entries, unsigned numBuffers, size_t bufferSize) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_COOP_TASKRUN;
+    _fd = sysIoUringSetup(entries, &params);
+    if (_fd < 0 && errno == EINVAL) {
+        // Kernels before 5.19 don't know about cooperative task running.
+        memset(&params, 0, sizeof(params));
+        _fd = sysIoUringSetup(entries, &params);
+    }
+    if (_fd < 0) {
+        return errnoStatus("io_uring_setup", errno);
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        return Status(ErrorCodes::IllegalOperation, "io_uring is too old to be used");
+    }
+
+    // With IORING_FEAT_SINGLE_MMAP both queues live in the same mapping.
+    _sqRingSize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                           params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    _sqRing = ::mmap(nullptr,
+                     _sqRingSize,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE,
+                     _fd,
+                     IORING_OFF_SQ_RING);
+    if (_sqRing == MAP_FAILED) {
+        _sqRing = nullptr;
+        return errnoStatus("mmap of io_uring rings", errno);
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    auto sqes = ::mmap(nullptr,
+                       _sqesSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       _fd,
+                       IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return errnoStatus("mmap of io_uring submission entries", errno);
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto sqBase = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<unsigned*>(sqBase + params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+    _sqMask = *reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+    _sqLocalTail = _sqSubmitted = *_sqTail;
+
+    // Submission entries are always used in order, so the indirection array is the identity.
+    auto sqArray = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+    for (unsigned i = 0; i < _sqEntries; ++i) {
+        sqArray[i] = i;
+    }
+
+    auto cqBase = sqBase;
+    _cqHead = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+    _cqMask = *reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+    // The provided buffer ring must be page aligned, which anonymous mappings always are.
+    numBuffers = roundUpToPowerOfTwo(numBuffers);
+    _bufRingSize = numBuffers * sizeof(io_uring_buf);
+    auto bufRing = ::mmap(
+        nullptr, _bufRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (bufRing == MAP_FAILED) {
+        return errnoStatus("mmap of io_uring buffer ring", errno);
+    }
+    _bufRing = static_cast<io_uring_buf_ring*>(bufRing);
+    _bufMask = numBuffers - 1;
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(_bufRing);
+    reg.ring_entries = numBuffers;
+    reg.bgid = kBufferGroup;
+    if (sysIoUringRegister(_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return errnoStatus("registering the io_uring buffer ring", errno);
+    }
+
+    _bufferSize = bufferSize;
+    _buffers.reset(new char[numBuffers * bufferSize]);
+    for (unsigned i = 0; i < numBuffers; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+
+    return Status::OK();
+}
+
+IoUring::~IoUring() {
+    if (_bufRing) {
+        ::munmap(_bufRing, _bufRingSize);
+    }
+    if (_sqes) {
+        ::munmap(_sqes, _sqesSize);
+    }
+    if (_sqRing) {
+        ::munmap(_sqRing, _sqRingSize);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    const unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+    if (_sqLocalTail - head >= _sqEntries) {
+        return nullptr;
+    }
+    auto sqe = &_sqes[_sqLocalTail & _sqMask];
+    ++_sqLocalTail;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+Status IoUring::submit(unsigned waitFor) {
+    __atomic_store_n(_sqTail, _sqLocalTail, __ATOMIC_RELEASE);
+    const unsigned toSubmit = _sqLocalTail - _sqSubmitted;
+    if (toSubmit == 0 && waitFor == 0) {
+        return Status::OK();
+    }
+
+    const unsigned flags = waitFor ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = sysIoUringEnter(_fd, toSubmit, waitFor, flags);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0) {
+        // EBUSY and EAGAIN mean the completion queue must be drained before the kernel accepts
+        // more work. The unsubmitted entries stay queued and go out with the next call.
+        if (errno == EBUSY || errno == EAGAIN) {
+            return Status::OK();
+        }
+        return errnoStatus("io_uring_enter", errno);
+    }
+    _sqSubmitted += static_cast<unsigned>(ret);
+    return Status::OK();
+}
+
+void IoUring::recycleBuffer(uint16_t bufferId) {
+    // The kernel header declares 'bufs' through a flexible array wrapper that C++ lays out at a
+    // nonzero offset, so index the entries from the start of the ring instead.
+    auto tail = _bufRing->tail;
+    auto& buf = reinterpret_cast<io_uring_buf*>(_bufRing)[tail & _bufMask];
+    buf.addr = reinterpret_cast<uint64_t>(buffer(bufferId));
+    buf.len = static_cast<uint32_t>(_bufferSize);
+    buf.bid = bufferId;
+    __atomic_store_n(&_bufRing->tail, static_cast<uint16_t>(tail + 1), __ATOMIC_RELEASE);
+}
+
+void IoUring::prepAccept(io_uring_sqe* sqe, int fd, bool multishot, uint64_t userData) {
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    if (multishot) {
+        sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+    }
+    sqe->user_data = userData;
+}
+
+void IoUring::prepRecv(io_uring_sqe* sqe, int fd, bool multishot, uint64_t userData) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    if (multishot) {
+        sqe->ioprio |= IORING_RECV_MULTISHOT;
+    }
+    sqe->user_data = userData;
+}
+
+void IoUring::prepSend(io_uring_sqe* sqe, int fd, const void* buf, size_t len, uint64_t userData) {
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(len);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = userData;
+}
+
+void IoUring::prepRead(io_uring_sqe* sqe, int fd, void* buf, size_t len, uint64_t userData) {
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(len);
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = userData;
+}
+
+void IoUring::prepCancel(io_uring_sqe* sqe, uint64_t targetUserData, uint64_t userData) {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = targetUserData;
+    sqe->user_data = userData;
+}
+
+}  // namespace transport
+}  // namespace mongo
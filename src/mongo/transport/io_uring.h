@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A minimal wrapper around a Linux io_uring instance, talking to the kernel through the raw
+ * io_uring_setup/io_uring_enter/io_uring_register system calls.
+ *
+ * Besides the submission and completion queues, an IoUring owns one provided buffer ring: a pool
+ * of equally sized buffers that the kernel picks from when completing receives submitted with
+ * prepRecv(). Each completion for such a receive names the buffer it filled, which must be
+ * handed back with recycleBuffer() once its contents have been consumed.
+ *
+ * An IoUring is not thread-safe; it is meant to be owned and driven by a single thread.
+ */
+class IoUring {
+    MONGO_DISALLOW_COPYING(IoUring);
+
+public:
+    // The buffer group id of the provided buffer ring.
+    static constexpr uint16_t kBufferGroup = 0;
+
+    /**
+     * Returns whether the running kernel supports everything IoUring needs: provided buffer rings
+     * and the accept, recv, send and read operations.
+     */
+    static bool isSupported();
+
+    /**
+     * Creates a ring with room for 'entries' submissions, along with a provided buffer ring of
+     * 'numBuffers' buffers of 'bufferSize' bytes each. 'entries' and 'numBuffers' are rounded up to
+     * powers of two.
+     */
+    static StatusWith<std::unique_ptr<IoUring>> create(unsigned entries,
+                                                       unsigned numBuffers,
+                                                       size_t bufferSize);
+
+    ~IoUring();
+
+    /**
+     * Returns a zeroed submission queue entry, or nullptr if the submission queue is full. Entries
+     * are not seen by the kernel until the next call to submit().
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * Hands all pending submission queue entries to the kernel in a single system call, and if
+     * 'waitFor' is non-zero, blocks until at least that many completions are available.
+     */
+    Status submit(unsigned waitFor);
+
+    /**
+     * Invokes 'callback' with each available completion queue entry and then releases them back
+     * to the kernel. Returns the number of entries processed.
+     */
+    template <typename Callback>
+    unsigned forEachCompletion(Callback&& callback) {
+        unsigned head = *_cqHead;
+        const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        const unsigned count = tail - head;
+        for (; head != tail; ++head) {
+            callback(_cqes[head & _cqMask]);
+        }
+        __atomic_store_n(_cqHead, tail, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    /**
+     * Returns a pointer to the provided buffer with the given id.
+     */
+    char* buffer(uint16_t bufferId) const {
+        return _buffers.get() + static_cast<size_t>(bufferId) * _bufferSize;
+    }
+
+    size_t bufferSize() const {
+        return _bufferSize;
+    }
+
+    /**
+     * Gives a provided buffer back to the kernel once its contents have been consumed.
+     */
+    void recycleBuffer(uint16_t bufferId);
+
+    /**
+     * Helpers which prepare a submission queue entry for a specific operation. 'userData' is
+     * returned in the corresponding completion queue entries.
+     */
+    static void prepAccept(io_uring_sqe* sqe, int fd, bool multishot, uint64_t userData);
+    static void prepRecv(io_uring_sqe* sqe, int fd, bool multishot, uint64_t userData);
+    static void prepSend(io_uring_sqe* sqe, int fd, const void* buf, size_t len, uint64_t userData);
+    static void prepRead(io_uring_sqe* sqe, int fd, void* buf, size_t len, uint64_t userData);
+    static void prepCancel(io_uring_sqe* sqe, uint64_t targetUserData, uint64_t userData);
+
+private:
+    IoUring() = default;
+
+    Status _init(unsigned entries, unsigned numBuffers, size_t bufferSize);
+
+    int _fd = -1;
+
+    void* _sqRing = nullptr;
+    size_t _sqRingSize = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    unsigned* _sqHead = nullptr;
+    unsigned* _sqTail = nullptr;
+    unsigned _sqMask = 0;
+    unsigned _sqEntries = 0;
+    unsigned _sqLocalTail = 0;
+    unsigned _sqSubmitted = 0;
+
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned _cqMask = 0;
+    io_uring_cqe* _cqes = nullptr;
+
+    io_uring_buf_ring* _bufRing = nullptr;
+    size_t _bufRingSize = 0;
+    unsigned _bufMask = 0;
+    std::unique_ptr<char[]> _buffers;
+    size_t _bufferSize = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
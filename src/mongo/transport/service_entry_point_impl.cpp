@@ -117,6 +117,30 @@ Status ServiceEntryPointImpl::start() {
         return Status::OK();
 }
 
+namespace {
+
+long long currentSecond() {
+    return durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+}
+
+}  // namespace
+
+void ServiceEntryPointImpl::EstablishmentRate::record(long long second) {
+    if (second != currentSecond) {
+        previousCount = second == currentSecond + 1 ? currentCount : 0;
+        currentSecond = second;
+        currentCount = 0;
+    }
+    peakCount = std::max(peakCount, ++currentCount);
+}
+
+size_t ServiceEntryPointImpl::EstablishmentRate::previousSecond(long long second) const {
+    if (second == currentSecond) {
+        return previousCount;
+    }
+    return second == currentSecond + 1 ? currentCount : 0;
+}
+
 void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
     // Setup the restriction environment on the Session, if the Session has local/remote Sockaddrs
     const auto& remoteAddr = session->remote().sockAddr();
@@ -134,6 +158,7 @@ void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
 
     auto ssm = ServiceStateMachine::create(_svcCtx, session, transportMode);
     auto usingMaxConnOverride = false;
+    const auto second = currentSecond();
     {
         stdx::lock_guard<decltype(_sessionsMutex)> lk(_sessionsMutex);
         connectionCount = _sessions.size() + 1;
@@ -146,12 +171,14 @@ void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
             ssmIt = _sessions.emplace(_sessions.begin(), ssm);
             _currentConnections.store(connectionCount);
             _createdConnections.addAndFetch(1);
+            _establishmentRate.record(second);
         }
     }
 
     // Checking if we successfully added a connection above. Separated from the lock so we don't log
     // while holding it.
     if (connectionCount > _maxNumConnections && !usingMaxConnOverride) {
+        _rejectedConnections.addAndFetch(1);
         if (!quiet) {
             log() << "connection refused because too many open connections: " << connectionCount;
         }
@@ -242,6 +269,20 @@ void ServiceEntryPointImpl::appendStats(BSONObjBuilder* bob) const {
     bob->append("current", static_cast<int>(sessionCount));
     bob->append("available", static_cast<int>(_maxNumConnections - sessionCount));
     bob->append("totalCreated", static_cast<int>(_createdConnections.load()));
+    bob->append("totalRejected", static_cast<long long>(_rejectedConnections.load()));
+
+    {
+        size_t lastSecond;
+        size_t peak;
+        {
+            stdx::lock_guard<decltype(_sessionsMutex)> lk(_sessionsMutex);
+            lastSecond = _establishmentRate.previousSecond(currentSecond());
+            peak = _establishmentRate.peakCount;
+        }
+        BSONObjBuilder rate(bob->subobjStart("establishmentRate"));
+        rate.append("lastSecond", static_cast<long long>(lastSecond));
+        rate.append("peakPerSecond", static_cast<long long>(peak));
+    }
 
     if (_adminInternalPool) {
         BSONObjBuilder section(bob->subobjStart("adminConnections"));
@@ -77,6 +77,24 @@ private:
     using SSMList = stdx::list<std::shared_ptr<ServiceStateMachine>>;
     using SSMListIterator = SSMList::iterator;
 
+    /**
+     * Counts the connections established in each wall-clock second, to report the rate at which
+     * connections arrive, e.g. while clients reconnect after a failover.
+     */
+    struct EstablishmentRate {
+        void record(long long second);
+
+        /**
+         * Returns the number of connections established in the second before "second".
+         */
+        size_t previousSecond(long long second) const;
+
+        long long currentSecond = 0;
+        size_t currentCount = 0;
+        size_t previousCount = 0;
+        size_t peakCount = 0;
+    };
+
     ServiceContext* const _svcCtx;
     AtomicWord<std::size_t> _nWorkers;
 
@@ -87,6 +105,10 @@ private:
     size_t _maxNumConnections{DEFAULT_MAX_CONN};
     AtomicWord<size_t> _currentConnections{0};
     AtomicWord<size_t> _createdConnections{0};
+    AtomicWord<size_t> _rejectedConnections{0};
+
+    // Guarded by _sessionsMutex.
+    EstablishmentRate _establishmentRate;
 
     std::unique_ptr<transport::ServiceExecutorReserved> _adminInternalPool;
 };
@@ -42,6 +42,7 @@
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stringutils.h"
@@ -558,6 +559,7 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         std::string threadName = str::stream() << "worker-" << threadId;
         setThreadName(threadName);
     }
+    bindCurrentThreadToNextNumaNode();
 
     log() << "Started new database worker thread " << threadId;
 
@@ -38,6 +38,7 @@
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/transport/thread_idle_callback.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 
 namespace mongo {
@@ -124,6 +125,7 @@ Status ServiceExecutorSynchronous::schedule(Task task,
     LOG(3) << "Starting new executor thread in passthrough mode";
 
     Status status = launchServiceWorkerThread([ this, task = std::move(task) ] {
+        bindCurrentThreadToNextNumaNode();
         _numRunningWorkerThreads.addAndFetch(1);
 
         _localWorkQueue.emplace_back(std::move(task));
@@ -0,0 +1,263 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_uring.h"
+
+#include <map>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/transport_layer_uring.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Minimum number of workers per ring. Zero divides each node's CPUs among the rings on it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringServiceExecutorThreadsPerRing, int, 0);
+
+// Tasks scheduled with MayRecurse may be called recursively if the recursion depth is below this
+// value.
+MONGO_EXPORT_SERVER_PARAMETER(uringServiceExecutorRecursionLimit, int, 8);
+
+// Workers beyond a group's minimum exit after being idle for this long.
+constexpr auto kIdleThreadTimeout = Seconds(10);
+
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "uring"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kGroups = "groups"_sd;
+}  // namespace
+
+thread_local int ServiceExecutorUring::_localGroup = -1;
+thread_local int ServiceExecutorUring::_localRecursionDepth = 0;
+
+ServiceExecutorUring::ServiceExecutorUring(ServiceContext* ctx,
+                                           std::vector<NumaNode> groupNodes,
+                                           bool bindToNodes)
+    : _bindToNodes(bindToNodes) {
+    invariant(!groupNodes.empty());
+
+    std::map<int, size_t> groupsPerNode;
+    for (auto&& node : groupNodes) {
+        ++groupsPerNode[node.id];
+    }
+
+    for (auto&& node : groupNodes) {
+        auto group = stdx::make_unique<WorkerGroup>(node);
+        if (uringServiceExecutorThreadsPerRing > 0) {
+            group->minThreads = static_cast<size_t>(uringServiceExecutorThreadsPerRing);
+        } else {
+            group->minThreads = std::max<size_t>(1, node.cpus.size() / groupsPerNode[node.id]);
+        }
+        _groups.push_back(std::move(group));
+    }
+}
+
+Status ServiceExecutorUring::start() {
+    _stillRunning.store(true);
+
+    for (size_t i = 0; i < _groups.size(); ++i) {
+        auto group = _groups[i].get();
+        stdx::lock_guard<stdx::mutex> lk(group->mutex);
+        while (group->threads < group->minThreads) {
+            auto status = _startWorker(i, group);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorUring::shutdown(Milliseconds timeout) {
+    LOG(3) << "Shutting down uring executor";
+
+    _stillRunning.store(false);
+    for (auto&& group : _groups) {
+        stdx::lock_guard<stdx::mutex> lk(group->mutex);
+        group->workAvailable.notify_all();
+    }
+
+    stdx::unique_lock<stdx::mutex> lock(_shutdownMutex);
+    bool result = _shutdownCondition.wait_for(lock, timeout.toSystemDuration(), [this]() {
+        return _numRunningWorkerThreads.load() == 0;
+    });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "uring executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorUring::schedule(Task task,
+                                      ScheduleFlags flags,
+                                      ServiceExecutorTaskName taskName) {
+    if (!_stillRunning.load()) {
+        return Status{ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    // Workers may run the task directly, like the passthrough executor, to avoid a round trip
+    // through the queue when a message is already waiting. Ring threads never run tasks.
+    if (_localGroup >= 0 && (flags & ScheduleFlags::kMayRecurse) &&
+        (_localRecursionDepth < uringServiceExecutorRecursionLimit.loadRelaxed())) {
+        ++_localRecursionDepth;
+        task();
+        --_localRecursionDepth;
+        return Status::OK();
+    }
+
+    const auto groupId = _pickGroup();
+    auto group = _groups[groupId].get();
+
+    stdx::lock_guard<stdx::mutex> lk(group->mutex);
+    group->tasks.emplace_back(std::move(task));
+    ++group->totalQueued;
+
+    if (group->idleThreads > 0) {
+        group->workAvailable.notify_one();
+        return Status::OK();
+    }
+
+    // Every worker is busy. Deferred tasks can wait for one, anything else gets a new thread.
+    if (flags & ScheduleFlags::kDeferredTask) {
+        return Status::OK();
+    }
+    return _startWorker(groupId, group);
+}
+
+size_t ServiceExecutorUring::_pickGroup() {
+    if (_localGroup >= 0) {
+        return static_cast<size_t>(_localGroup);
+    }
+
+    const auto ringId = TransportLayerUring::currentRingId();
+    if (ringId >= 0 && static_cast<size_t>(ringId) < _groups.size()) {
+        return static_cast<size_t>(ringId);
+    }
+
+    return _nextGroup.fetchAndAdd(1) % _groups.size();
+}
+
+Status ServiceExecutorUring::_startWorker(size_t groupId, WorkerGroup* group) {
+    ++group->threads;
+    _numRunningWorkerThreads.addAndFetch(1);
+
+    auto status = launchServiceWorkerThread([this, groupId, group] {
+        setThreadName(str::stream() << "uringWorker" << groupId);
+        _workerLoop(groupId, group);
+    });
+
+    if (!status.isOK()) {
+        --group->threads;
+        if (_numRunningWorkerThreads.subtractAndFetch(1) == 0) {
+            _shutdownCondition.notify_all();
+        }
+    }
+    return status;
+}
+
+void ServiceExecutorUring::_workerLoop(size_t groupId, WorkerGroup* group) {
+    _localGroup = static_cast<int>(groupId);
+    if (_bindToNodes) {
+        auto status = bindCurrentThreadToNumaNode(group->node);
+        if (!status.isOK()) {
+            warning() << status;
+        }
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(group->mutex);
+    while (_stillRunning.load()) {
+        if (group->tasks.empty()) {
+            ++group->idleThreads;
+            const bool haveWork =
+                group->workAvailable.wait_for(lk, kIdleThreadTimeout.toSystemDuration(), [&] {
+                    return !group->tasks.empty() || !_stillRunning.load();
+                });
+            --group->idleThreads;
+            if (!haveWork && group->threads > group->minThreads) {
+                break;
+            }
+            continue;
+        }
+
+        auto task = std::move(group->tasks.front());
+        group->tasks.pop_front();
+        lk.unlock();
+
+        _localRecursionDepth = 1;
+        task();
+
+        lk.lock();
+        ++group->totalExecuted;
+    }
+    --group->threads;
+    lk.unlock();
+
+    _localGroup = -1;
+    if (_numRunningWorkerThreads.subtractAndFetch(1) == 0) {
+        stdx::lock_guard<stdx::mutex> shutdownLock(_shutdownMutex);
+        _shutdownCondition.notify_all();
+    }
+}
+
+void ServiceExecutorUring::appendStats(BSONObjBuilder* bob) const {
+    int64_t totalQueued = 0;
+    int64_t totalExecuted = 0;
+    BSONArrayBuilder groups;
+    for (auto&& group : _groups) {
+        stdx::lock_guard<stdx::mutex> lk(group->mutex);
+        totalQueued += group->totalQueued;
+        totalExecuted += group->totalExecuted;
+        groups.append(BSON("numaNode" << group->node.id << "threads"
+                                      << static_cast<int>(group->threads)
+                                      << "idleThreads"
+                                      << static_cast<int>(group->idleThreads)
+                                      << "queued"
+                                      << static_cast<int>(group->tasks.size())));
+    }
+
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_numRunningWorkerThreads.loadRelaxed()) << kTotalQueued
+         << totalQueued << kTotalExecuted << totalExecuted << kGroups << groups.arr();
+}
+
+}  // namespace transport
+}  // namespace mongo
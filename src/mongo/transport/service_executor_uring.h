@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/util/numa_topology.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * The service executor used with TransportLayerUring. It keeps one group of worker threads per
+ * io_uring ring, bound to the ring's NUMA node. Tasks scheduled from a ring thread, which is where
+ * sessions' I/O completes, run on that ring's group, so a session's processing stays on the node
+ * that received its messages.
+ *
+ * Each group keeps a minimum number of workers and starts more whenever a task arrives with none
+ * idle, since tasks may block for a long time; workers beyond the minimum exit when idle.
+ */
+class ServiceExecutorUring final : public ServiceExecutor {
+public:
+    ServiceExecutorUring(ServiceContext* ctx, std::vector<NumaNode> groupNodes, bool bindToNodes);
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+private:
+    struct WorkerGroup {
+        explicit WorkerGroup(NumaNode node) : node(std::move(node)) {}
+
+        const NumaNode node;
+        size_t minThreads = 1;
+
+        mutable stdx::mutex mutex;
+        stdx::condition_variable workAvailable;
+        std::deque<Task> tasks;
+        size_t threads = 0;
+        size_t idleThreads = 0;
+        int64_t totalQueued = 0;
+        int64_t totalExecuted = 0;
+    };
+
+    Status _startWorker(size_t groupId, WorkerGroup* group);
+    void _workerLoop(size_t groupId, WorkerGroup* group);
+    size_t _pickGroup();
+
+    static thread_local int _localGroup;
+    static thread_local int _localRecursionDepth;
+
+    const bool _bindToNodes;
+    std::vector<std::unique_ptr<WorkerGroup>> _groups;
+    AtomicWord<size_t> _nextGroup{0};
+
+    AtomicBool _stillRunning{false};
+    AtomicWord<size_t> _numRunningWorkerThreads{0};
+
+    mutable stdx::mutex _shutdownMutex;
+    stdx::condition_variable _shutdownCondition;
+};
+
+}  // namespace transport
+}  // namespace mongo
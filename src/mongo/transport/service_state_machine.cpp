@@ -33,10 +33,15 @@
 #include "mongo/transport/service_state_machine.h"
 
 #include "mongo/config.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/rpc/message.h"
+#include "mongo/rpc/metadata/client_metadata.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
@@ -47,11 +52,13 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -92,27 +99,60 @@ Message makeLegacyExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return Message(b.release());
 }
 
+/**
+ * Builds the 'getMore' request that continues an exhaust stream started by a cursor-generating
+ * command such as 'find' or 'aggregate'. The session and transaction fields of the initial request
+ * are carried over, since a cursor opened in a session may only be iterated in that session.
+ */
+Message makeGetMoreForCursorCommand(const OpMsgRequest& request,
+                                    long long cursorId,
+                                    StringData cursorNs) {
+    const BSONObj cursorOptions = request.body.getObjectField("cursor");
+    const BSONElement batchSize = request.getCommandName() == "find"_sd
+        ? request.body["batchSize"]
+        : cursorOptions["batchSize"];
+
+    BSONObjBuilder bob;
+    bob.append("getMore", cursorId);
+    bob.append("collection", nsToCollectionSubstring(cursorNs));
+    if (batchSize.isNumber() && batchSize.safeNumberLong() > 0) {
+        bob.append("batchSize", batchSize.safeNumberLong());
+    }
+    for (auto fieldName : {"lsid"_sd, "txnNumber"_sd, "autocommit"_sd}) {
+        if (auto elem = request.body[fieldName]) {
+            bob.append(elem);
+        }
+    }
+    bob.append("$db", nsToDatabaseSubstring(cursorNs));
+
+    auto getMoreMsg = OpMsg{bob.obj()}.serialize();
+    OpMsg::setFlag(&getMoreMsg, OpMsg::kExhaustAllowed);
+    return getMoreMsg;
+}
+
 /**
  * Given a request and its already generated response, checks for exhaust flags. If exhaust is
- * allowed, modifies the given request message to produce the subsequent exhaust message, and
- * modifies the response message to indicate it is part of an exhaust stream. Returns the modified
- * request message for it to be used as the subsequent, 'synthetic' exhaust request. Returns an
- * empty message if exhaust is not allowed.
+ * allowed, produces the subsequent exhaust message, and modifies the response message to indicate
+ * it is part of an exhaust stream. Returns the request message to be used as the subsequent,
+ * 'synthetic' exhaust request. Returns an empty message if exhaust is not allowed.
  *
- * Currently only supports exhaust for 'getMore' commands.
+ * An exhaust stream may be started by a 'find', 'aggregate' or 'getMore' command. Every following
+ * request is a 'getMore' on the cursor returned in the reply.
  */
 Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     if (requestMsg.operation() == dbQuery) {
         return makeLegacyExhaustMessage(&requestMsg, *dbresponse);
     }
 
-    if (!OpMsgRequest::isFlagSet(requestMsg, OpMsg::kExhaustSupported)) {
+    if (!OpMsgRequest::isFlagSet(requestMsg, OpMsg::kExhaustAllowed)) {
         return Message();
     }
 
-    // Only support exhaust for 'getMore' commands.
+    // Only support exhaust for commands which return a cursor.
     auto request = OpMsgRequest::parse(requestMsg);
-    if (request.getCommandName() != "getMore"_sd) {
+    const auto commandName = request.getCommandName();
+    const bool isGetMore = commandName == "getMore"_sd;
+    if (!isGetMore && commandName != "find"_sd && commandName != "aggregate"_sd) {
         return Message();
     }
 
@@ -138,6 +178,12 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
         return Message();
     }
 
+    // A 'getMore' is simply replayed, whereas the initial command of the stream is replaced by a
+    // 'getMore' on the cursor it established.
+    if (!isGetMore) {
+        requestMsg = makeGetMoreForCursorCommand(request, cursorId, cursorNs);
+    }
+
     // Indicate that the response is part of an exhaust stream.
     OpMsg::setFlag(&dbresponse->response, OpMsg::kMoreToCome);
 
@@ -149,6 +195,61 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     return requestMsg;
 }
 
+// The maximum number of requests from one connection which are processed at the same time when
+// the client allows concurrent processing. Once reached, the connection is not read from until one
+// of them completes. A value of 0 processes every request in order.
+MONGO_EXPORT_SERVER_PARAMETER(maxConcurrentPipelinedRequestsPerConnection, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "maxConcurrentPipelinedRequestsPerConnection must not be negative");
+        }
+        return Status::OK();
+    });
+
+// The number of threads shared by all connections to process requests concurrently.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(pipelinedRequestMaxThreads, int, 128);
+
+/**
+ * Commands which change the state of the connection they arrive on, rather than only that of the
+ * operation, and so always run in order on the connection's own Client.
+ */
+bool changesConnectionState(StringData commandName) {
+    return commandName == "isMaster"_sd || commandName == "ismaster"_sd ||
+        commandName == "saslStart"_sd || commandName == "saslContinue"_sd ||
+        commandName == "authenticate"_sd || commandName == "logout"_sd ||
+        commandName == "setShardVersion"_sd || commandName == "unsetSharding"_sd;
+}
+
+/**
+ * The threads which process pipelined requests for all the connections of a ServiceContext. The
+ * pool is only started once a client actually pipelines requests.
+ */
+class PipelinedRequestPool {
+public:
+    Status schedule(ThreadPool::Task task) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_pool) {
+            ThreadPool::Options options;
+            options.poolName = "PipelinedRequests";
+            options.threadNamePrefix = "pipelined-";
+            options.minThreads = 0;
+            options.maxThreads = std::max(1, pipelinedRequestMaxThreads);
+            // Pipelined requests may complete in any order, so they don't need a shared queue.
+            options.workStealing = true;
+            _pool = stdx::make_unique<ThreadPool>(std::move(options));
+            _pool->startup();
+        }
+        return _pool->schedule(std::move(task));
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+const auto getPipelinedRequestPool = ServiceContext::declareDecoration<PipelinedRequestPool>();
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -434,6 +535,18 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
     networkCounter.hitLogicalIn(_inMessage.size());
 
+    if (_canProcessConcurrently() && _startPipelinedRequest()) {
+        _state.store(State::Source);
+        _inMessage.reset();
+        return _scheduleNextWithGuard(std::move(guard),
+                                      ServiceExecutor::kDeferredTask,
+                                      transport::ServiceExecutorTaskName::kSSMSourceMessage);
+    }
+
+    // Any other request waits for those handed off before it, so that requests which don't allow
+    // concurrent processing still observe the effects of everything sent ahead of them.
+    _waitForPipelinedRequests();
+
     // Pass sourced Message to handler to generate response.
     auto opCtx = Client::getCurrent()->makeOperationContext();
 
@@ -454,12 +567,14 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         toSink.header().setId(nextMessageId());
         toSink.header().setResponseToMsgId(_inMessage.header().getId());
 
-        // If the incoming message has the exhaust flag set and is a 'getMore' command, then we
+        // If the incoming message has the exhaust flag set and returns a cursor, then we
         // bypass the normal RPC behavior. We will sink the response to the network, but we also
         // synthesize a new 'getMore' request, as if we sourced a new message from the network. This
         // new request is sent to the database once again to be processed. This cycle repeats as
         // long as the associated cursor is not exhausted. Once it is exhausted, we will send a
-        // final response, terminating the exhaust stream.
+        // final response, terminating the exhaust stream. The next request is only synthesized
+        // once the previous response has been sunk, so a slow reader applies backpressure to the
+        // stream and at most one batch per cursor is ever buffered on the server.
         _inMessage = makeExhaustMessage(_inMessage, &dbresponse);
         _inExhaust = !_inMessage.empty();
 
@@ -481,6 +596,141 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
     }
 }
 
+bool ServiceStateMachine::_canProcessConcurrently() {
+    const auto flags = OpMsg::flags(_inMessage);
+    if (!(flags & OpMsg::kConcurrentProcessingAllowed) ||
+        (flags & (OpMsg::kMoreToCome | OpMsg::kExhaustAllowed))) {
+        return false;
+    }
+
+    // Worker threads sink their replies while this thread is already reading the next request.
+    if (_transportMode != transport::Mode::kSynchronous ||
+        !_session()->canSourceAndSinkConcurrently() ||
+        maxConcurrentPipelinedRequestsPerConnection.load() <= 0) {
+        return false;
+    }
+
+    try {
+        return !changesConnectionState(OpMsgRequest::parse(_inMessage).getCommandName());
+    } catch (const DBException&) {
+        // Let the request fail in order, the same way as any other invalid request.
+        return false;
+    }
+}
+
+bool ServiceStateMachine::_startPipelinedRequest() {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_pipelinedMutex);
+        _pipelinedCondVar.wait(lk, [&] {
+            const auto limit = maxConcurrentPipelinedRequestsPerConnection.load();
+            return _pipelinedInProgress < std::max(limit, 1);
+        });
+        ++_pipelinedInProgress;
+    }
+
+    // The worker's Client takes on the users and metadata (which also decides the admission
+    // priority) of the connection's Client. Those only change while requests are processed in
+    // order, after every worker thread has finished, so they are read here by the thread which
+    // owns the connection's Client.
+    std::vector<UserName> userNames;
+    for (auto it = AuthorizationSession::get(Client::getCurrent())->getAuthenticatedUserNames();
+         it.more();
+         it.next()) {
+        userNames.push_back(*it);
+    }
+
+    BSONObj clientMetadata;
+    const auto& metadata =
+        ClientMetadataIsMasterState::get(Client::getCurrent()).getClientMetadata();
+    if (metadata) {
+        clientMetadata = BSON("client" << metadata->getDocument());
+    }
+
+    auto process = [
+        ssm = shared_from_this(),
+        msg = _inMessage,
+        id = _compressorId,
+        userNames = std::move(userNames),
+        clientMetadata = std::move(clientMetadata)
+    ]() mutable {
+        ssm->_processPipelinedRequest(
+            std::move(msg), std::move(id), std::move(userNames), std::move(clientMetadata));
+    };
+    auto status = getPipelinedRequestPool(_serviceContext).schedule(std::move(process));
+    if (status.isOK()) {
+        return true;
+    }
+
+    LOG(1) << "Processing pipelined request in order: " << status;
+    stdx::lock_guard<stdx::mutex> lk(_pipelinedMutex);
+    --_pipelinedInProgress;
+    _pipelinedCondVar.notify_all();
+    return false;
+}
+
+void ServiceStateMachine::_processPipelinedRequest(
+    Message request,
+    boost::optional<MessageCompressorId> compressorId,
+    std::vector<UserName> userNames,
+    BSONObj clientMetadata) {
+    Client::setCurrent(_serviceContext->makeClient(_threadName, _session()));
+    ON_BLOCK_EXIT([this] {
+        Client::releaseCurrent();
+
+        stdx::lock_guard<stdx::mutex> lk(_pipelinedMutex);
+        --_pipelinedInProgress;
+        _pipelinedCondVar.notify_all();
+    });
+
+    try {
+        if (!clientMetadata.isEmpty()) {
+            auto swMetadata = ClientMetadata::parse(clientMetadata.firstElement());
+            uassertStatusOK(swMetadata.getStatus());
+            ClientMetadataIsMasterState::setClientMetadata(&cc(),
+                                                           std::move(swMetadata.getValue()));
+        }
+
+        auto opCtx = cc().makeOperationContext();
+        for (auto&& userName : userNames) {
+            uassertStatusOK(AuthorizationSession::get(cc())->addAndAuthorizeUser(opCtx.get(),
+                                                                                userName));
+        }
+
+        DbResponse dbresponse = _sep->handleRequest(opCtx.get(), request);
+        opCtx.reset();
+
+        Message& toSink = dbresponse.response;
+        if (toSink.empty()) {
+            return;
+        }
+
+        toSink.header().setId(nextMessageId());
+        toSink.header().setResponseToMsgId(request.header().getId());
+        networkCounter.hitLogicalOut(toSink.size());
+
+        if (compressorId) {
+            auto& compressorMgr = MessageCompressorManager::forSession(_session());
+            toSink = uassertStatusOK(compressorMgr.compressMessage(toSink, &compressorId.value()));
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_sinkMutex);
+        uassertStatusOK(_session()->sinkMessage(std::move(toSink)));
+    } catch (const DBException& e) {
+        log() << "DBException handling pipelined request, closing client connection: "
+              << redact(e);
+        _session()->end();
+    } catch (...) {
+        error() << "Exception handling pipelined request, closing client connection: "
+                << exceptionToStatus();
+        _session()->end();
+    }
+}
+
+void ServiceStateMachine::_waitForPipelinedRequests() {
+    stdx::unique_lock<stdx::mutex> lk(_pipelinedMutex);
+    _pipelinedCondVar.wait(lk, [&] { return _pipelinedInProgress == 0; });
+}
+
 void ServiceStateMachine::runNext() {
     return _runNextInGuard(ThreadGuard(this));
 }
@@ -603,9 +853,53 @@ void ServiceStateMachine::_terminateAndLogIfError(Status status) {
     }
 }
 
+void ServiceStateMachine::_cleanupExhaustResources() noexcept try {
+    if (!_inExhaust || _inMessage.empty() || _inMessage.operation() != dbMsg) {
+        return;
+    }
+
+    auto request = OpMsgRequest::parse(_inMessage);
+    if (request.getCommandName() != "getMore"_sd) {
+        return;
+    }
+
+    // A cursor opened inside a multi-statement transaction is reaped along with the transaction.
+    if (request.body.hasField("txnNumber")) {
+        return;
+    }
+
+    const auto cursorId = request.body["getMore"].numberLong();
+    const auto collection = request.body["collection"].str();
+    if (cursorId == 0 || collection.empty()) {
+        return;
+    }
+
+    // The stream is gone, so the cursor would otherwise linger until it times out. Go through the
+    // ServiceEntryPoint so that this works identically on mongod and mongos.
+    auto killCursors = OpMsgRequest::fromDBAndBody(
+        request.getDatabase(),
+        BSON("killCursors" << collection << "cursors" << BSON_ARRAY(cursorId)));
+    auto opCtx = Client::getCurrent()->makeOperationContext();
+    _sep->handleRequest(opCtx.get(), killCursors.serialize());
+} catch (const DBException& ex) {
+    LOG(1) << "Failed to kill the cursor of an interrupted exhaust stream: " << redact(ex);
+}
+
 void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
     _state.store(State::Ended);
 
+    {
+        stdx::unique_lock<stdx::mutex> lk(_pipelinedMutex);
+        if (_pipelinedInProgress) {
+            // Make sure no worker thread stays blocked sinking a reply to a client that has
+            // stopped reading, then let them all finish before the Client goes away.
+            _session()->end();
+            _pipelinedCondVar.wait(lk, [&] { return _pipelinedInProgress == 0; });
+        }
+    }
+
+    _cleanupExhaustResources();
+    _inExhaust = false;
     _inMessage.reset();
 
     // By ignoring the return value of Client::releaseCurrent() we destroy the session.
@@ -31,9 +31,12 @@
 #include <atomic>
 
 #include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/config.h"
+#include "mongo/db/auth/user_name.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -214,6 +217,40 @@ private:
     void _sourceMessage(ThreadGuard guard);
     void _sinkMessage(ThreadGuard guard, Message toSink);
 
+    /*
+     * Returns whether the request in _inMessage may be processed on a worker thread, concurrently
+     * with other requests from the same connection.
+     */
+    bool _canProcessConcurrently();
+
+    /*
+     * Hands the request in _inMessage off to a worker thread, blocking while this connection
+     * already has the maximum number of requests in progress. Returns false if the request could
+     * not be handed off, in which case it must be processed in order.
+     */
+    bool _startPipelinedRequest();
+
+    /*
+     * Processes a request handed off by _startPipelinedRequest() and sinks its reply. Runs on a
+     * worker thread, with a Client of its own which is authenticated as 'userNames' and carries
+     * the 'clientMetadata' of the connection's Client.
+     */
+    void _processPipelinedRequest(Message request,
+                                  boost::optional<MessageCompressorId> compressorId,
+                                  std::vector<UserName> userNames,
+                                  BSONObj clientMetadata);
+
+    /*
+     * Blocks until every request handed off by _startPipelinedRequest() has completed.
+     */
+    void _waitForPipelinedRequests();
+
+    /*
+     * Kills the cursor of an exhaust stream which was interrupted before the cursor was exhausted,
+     * for example because the client closed the connection.
+     */
+    void _cleanupExhaustResources() noexcept;
+
     /*
      * Releases all the resources associated with the session and call the cleanupHook.
      */
@@ -237,6 +274,15 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // The number of requests handed off to worker threads which have not completed yet.
+    stdx::mutex _pipelinedMutex;
+    stdx::condition_variable _pipelinedCondVar;
+    int _pipelinedInProgress = 0;
+
+    // Serializes the replies sunk by worker threads. The SSM's own replies never overlap with
+    // them, since requests processed in order first wait for the worker threads.
+    stdx::mutex _sinkMutex;
+
     AtomicWord<Ownership> _owned{Ownership::kUnowned};
 #if MONGO_CONFIG_DEBUG_BUILD
     AtomicWord<stdx::thread::id> _owningThread;
@@ -73,6 +73,7 @@ public:
     DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
         log() << "In handleRequest";
         _ranHandler = true;
+        _lastRequest = request;
         ASSERT_TRUE(haveClient());
 
         // Build out a dummy OK response, if no custom response message was set. Otherwise, use the
@@ -120,10 +121,17 @@ public:
         return ret;
     }
 
+    const Message& lastRequest() const {
+        return _lastRequest;
+    }
+
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
 
+    // The last request message passed to 'handleRequest'.
+    Message _lastRequest;
+
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
 };
@@ -421,7 +429,7 @@ Message getMoreRequestWithExhaust(const std::string& nss,
                                   const int32_t requestId) {
     Message getMoreMsg = buildOpMsg(BSON("getMore" << cursorId << "collection" << nss));
     getMoreMsg.header().setId(requestId);
-    OpMsg::setFlag(&getMoreMsg, OpMsg::kExhaustSupported);
+    OpMsg::setFlag(&getMoreMsg, OpMsg::kExhaustAllowed);
     return getMoreMsg;
 }
 
@@ -577,20 +585,80 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAndNonOKResponse) {
 }
 
 
-TEST_F(ServiceStateMachineFixture, TestExhaustOnlySupportedForGetMoreCommand) {
-    // Construct a 'find' OP_MSG request with the exhaust flag set. We should ignore exhaust flags
-    // for non 'getMore' commands.
+TEST_F(ServiceStateMachineFixture, TestFindWithExhaust) {
+    // Construct a 'find' OP_MSG request with the exhaust flag set. The exhaust stream should start
+    // with the reply to the 'find' itself.
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
     const std::string nss = "test.coll";
-    Message findWithExhaust = buildOpMsg(BSON("find" << nss));
-    OpMsg::setFlag(&findWithExhaust, OpMsg::kExhaustSupported);
+    const auto lsid = BSON("id" << 1);
+    Message findWithExhaust = buildOpMsg(BSON("find"
+                                              << "coll"
+                                              << "batchSize"
+                                              << 2
+                                              << "lsid"
+                                              << lsid
+                                              << "$db"
+                                              << "test"));
+    findWithExhaust.header().setId(initRequestId);
+    OpMsg::setFlag(&findWithExhaust, OpMsg::kExhaustAllowed);
+
+    // Construct a 'find' response with a non-zero cursor id.
+    BSONObj findResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "firstBatch" << BSONArray()));
+    runSourceAndSinkTest(
+        _tl, _sep, findWithExhaust, buildOpMsg(findResBody), State::Process, State::Process);
+
+    auto msg = _tl->getLastSunk();
+    ASSERT(!msg.empty());
+    ASSERT_EQ(initRequestId, msg.header().getResponseToMsgId());
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(findResBody, OpMsg::parse(msg).body);
 
-    // Construct an OK response.
-    Message findRes = buildOpMsg(BSON(
+    // The next request handed to the database is a 'getMore' on the cursor returned by the 'find',
+    // carrying the batch size and session of the 'find'.
+    BSONObj getMoreResBody = BSON(
+        "ok" << 1 << "cursor" << BSON("id" << 0 << "ns" << nss << "nextBatch" << BSONArray()));
+    _sep->setResponseMessage(buildOpMsg(getMoreResBody));
+
+    log() << "runNext to run the synthesized 'getMore'";
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+
+    const auto& getMoreMsg = _sep->lastRequest();
+    ASSERT(OpMsg::isFlagSet(getMoreMsg, OpMsg::kExhaustAllowed));
+    ASSERT_BSONOBJ_EQ(OpMsgRequest::parse(getMoreMsg).body,
+                      BSON("getMore" << cursorId << "collection"
+                                     << "coll"
+                                     << "batchSize"
+                                     << 2LL
+                                     << "lsid"
+                                     << lsid
+                                     << "$db"
+                                     << "test"));
+
+    msg = _tl->getLastSunk();
+    ASSERT(!msg.empty());
+    ASSERT_FALSE(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(getMoreResBody, OpMsg::parse(msg).body);
+}
+
+TEST_F(ServiceStateMachineFixture, TestExhaustIgnoredForCommandsWithoutCursor) {
+    // Construct an 'insert' OP_MSG request with the exhaust flag set. We should ignore exhaust
+    // flags for commands which do not return a cursor.
+    const std::string nss = "test.coll";
+    Message insertWithExhaust = buildOpMsg(BSON("insert"
+                                                << "coll"
+                                                << "$db"
+                                                << "test"));
+    OpMsg::setFlag(&insertWithExhaust, OpMsg::kExhaustAllowed);
+
+    // Construct an OK response which, unusually, does contain a cursor.
+    Message insertRes = buildOpMsg(BSON(
         "ok" << 1 << "cursor" << BSON("id" << 42 << "ns" << nss << "firstBatch" << BSONArray())));
 
-    // Let the 'find' request be sourced from the network, processed in the database, and
-    // and the response sunk to the TransportLayer.
-    runSourceAndSinkTest(_tl, _sep, findWithExhaust, findRes, State::Process, State::Source);
+    runSourceAndSinkTest(_tl, _sep, insertWithExhaust, insertRes, State::Process, State::Source);
 
     // Check the last sunk message.
     auto msg = _tl->getLastSunk();
@@ -600,6 +668,57 @@ TEST_F(ServiceStateMachineFixture, TestExhaustOnlySupportedForGetMoreCommand) {
     ASSERT_EQ(1, reply.body.getIntField("ok"));
 }
 
+TEST_F(ServiceStateMachineFixture, TestInterruptedExhaustStreamKillsCursor) {
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    Message getMoreWithExhaust = buildOpMsg(BSON("getMore" << cursorId << "collection"
+                                                           << "coll"
+                                                           << "$db"
+                                                           << "test"));
+    OpMsg::setFlag(&getMoreWithExhaust, OpMsg::kExhaustAllowed);
+
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()));
+    Message getMoreRes = buildOpMsg(getMoreResBody);
+    runSourceAndSinkTest(_tl, _sep, getMoreWithExhaust, getMoreRes, State::Process, State::Process);
+
+    // Fail the next sink, as if the client had gone away in the middle of the stream. The session
+    // should end and the cursor should be killed rather than left to time out.
+    _tl->setNextFailure(MockTL::Sink);
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Ended);
+
+    auto killCursors = OpMsgRequest::parse(_sep->lastRequest());
+    ASSERT_BSONOBJ_EQ(killCursors.body,
+                      BSON("killCursors"
+                           << "coll"
+                           << "cursors"
+                           << BSON_ARRAY(cursorId)
+                           << "$db"
+                           << "test"));
+}
+
+TEST_F(ServiceStateMachineFixture, TestConcurrentProcessingNeedsConcurrentSession) {
+    // The mock session can't source and sink at the same time, so a request which allows
+    // concurrent processing is still handled in order, before the next request is sourced.
+    const int32_t requestId = 7;
+    Message pipelined = buildOpMsg(BSON("find"
+                                        << "coll"
+                                        << "$db"
+                                        << "test"));
+    pipelined.header().setId(requestId);
+    OpMsg::setFlag(&pipelined, OpMsg::kConcurrentProcessingAllowed);
+
+    BSONObj resBody = BSON("ok" << 1);
+    runSourceAndSinkTest(_tl, _sep, pipelined, buildOpMsg(resBody), State::Process, State::Source);
+
+    auto msg = _tl->getLastSunk();
+    ASSERT(!msg.empty());
+    ASSERT_EQ(requestId, msg.header().getResponseToMsgId());
+    ASSERT_BSONOBJ_EQ(resBody, OpMsg::parse(msg).body);
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
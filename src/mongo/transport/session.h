@@ -123,6 +123,15 @@ public:
      */
     virtual void cancelAsyncOperations(const transport::BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Returns whether one call to sourceMessage() and one call to sinkMessage() may run at the
+     * same time on different threads. Sessions whose two directions share protocol state, such as
+     * a TLS stream, must return false.
+     */
+    virtual bool canSourceAndSinkConcurrently() const {
+        return false;
+    }
+
     /**
     * This should only be used to detect when the remote host has disappeared without
     * notice. It does NOT work correctly for ensuring that operations complete or fail
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
@@ -75,6 +76,13 @@ using GenericSocket = asio::generic::stream_protocol::socket;
 class TransportLayerASIO::ASIOSession final : public Session {
     MONGO_DISALLOW_COPYING(ASIOSession);
 
+    static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+    // The size of the buffer a message is first received into, leaving room for the SharedBuffer
+    // bookkeeping within a 16KB pooled block. Messages that fit are usually received with a
+    // single read.
+    static constexpr size_t kInitialReceiveBufferSize = 16 * 1024 - 64;
+
 public:
     // If the socket is disconnected while any of these options are being set, this constructor
     // may throw, but it is guaranteed to throw a mongo DBException.
@@ -168,8 +176,17 @@ public:
         }
     }
 
+    bool canSourceAndSinkConcurrently() const override {
+#ifdef MONGO_CONFIG_SSL
+        return !_sslSocket;
+#else
+        return true;
+#endif
+    }
+
     void setTimeout(boost::optional<Milliseconds> timeout) override {
         invariant(!timeout || timeout->count() > 0);
+        stdx::lock_guard<stdx::mutex> lk(_modeMutex);
         _configuredTimeout = timeout;
     }
 
@@ -254,6 +271,7 @@ protected:
 #endif
 
     void ensureSync() {
+        stdx::lock_guard<stdx::mutex> lk(_modeMutex);
         asio::error_code ec;
         if (_blockingMode != Sync) {
             getSocket().non_blocking(false, ec);
@@ -276,6 +294,7 @@ protected:
     }
 
     void ensureAsync() {
+        stdx::lock_guard<stdx::mutex> lk(_modeMutex);
         if (_blockingMode == Async)
             return;
 
@@ -342,17 +361,42 @@ private:
     }
 
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
-        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+        auto buffer = SharedBuffer::allocatePooled(kInitialReceiveBufferSize);
+        size_t received = takeReadAhead(buffer.get(), buffer.capacity());
+
+        if (received < kHeaderSize && canReadSpeculatively()) {
+            // A single receive usually brings in the header along with the whole body. Anything
+            // received past the end of the message is kept for the next call.
+            std::error_code ec;
+            received += _socket.read_some(
+                asio::buffer(buffer.get() + received, buffer.capacity() - received), ec);
+
+            const bool wouldBlock =
+                (ec == asio::error::would_block) || (ec == asio::error::try_again);
+            if (wouldBlock && (_blockingMode == Async)) {
+                if (received == 0) {
+                    // Don't hold on to a receive buffer while the connection is idle.
+                    buffer = {};
+                    return waitForReadable(baton).then(
+                        [this, baton] { return sourceMessageImpl(baton); });
+                }
+            } else if (ec) {
+                return Future<Message>::makeReady(errorCodeToStatus(ec));
+            }
+        }
 
-        auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
-        auto ptr = headerBuffer.get();
-        return read(asio::buffer(ptr, kHeaderSize), baton)
-            .then([ headerBuffer = std::move(headerBuffer), this, baton ]() mutable {
-                if (checkForHTTPRequest(asio::buffer(headerBuffer.get(), kHeaderSize))) {
+        auto headerRead = (received < kHeaderSize)
+            ? read(asio::buffer(buffer.get() + received, kHeaderSize - received), baton)
+            : Future<void>::makeReady();
+        received = std::max(received, kHeaderSize);
+
+        return std::move(headerRead)
+            .then([ buffer = std::move(buffer), received, this, baton ]() mutable {
+                if (checkForHTTPRequest(asio::buffer(buffer.get(), kHeaderSize))) {
                     return sendHTTPResponse(baton);
                 }
 
-                const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
+                const auto msgLen = size_t(MSGHEADER::View(buffer.get()).getMessageLength());
                 if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
                     StringBuilder sb;
                     sb << "recv(): message msgLen " << msgLen << " is invalid. "
@@ -363,19 +407,24 @@ private:
                     return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
                 }
 
-                if (msgLen == kHeaderSize) {
-                    // This probably isn't a real case since all (current) messages have bodies.
+                if (received >= msgLen) {
+                    putBackReadAhead(buffer.get() + msgLen, received - msgLen);
                     if (_isIngressSession) {
                         networkCounter.hitPhysicalIn(msgLen);
                     }
-                    return Future<Message>::makeReady(Message(std::move(headerBuffer)));
+                    return Future<Message>::makeReady(Message(std::move(buffer)));
                 }
 
-                auto buffer = SharedBuffer::allocate(msgLen);
-                memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
+                if (msgLen > buffer.capacity()) {
+                    auto larger = SharedBuffer::allocatePooled(msgLen);
+                    memcpy(larger.get(), buffer.get(), received);
+                    buffer = std::move(larger);
+                }
+                received += takeReadAhead(buffer.get() + received, msgLen - received);
 
-                MsgData::View msgView(buffer.get());
-                return read(asio::buffer(msgView.data(), msgView.dataLen()), baton)
+                // Taken before the buffer is moved into the continuation below.
+                const auto rest = asio::buffer(buffer.get() + received, msgLen - received);
+                return read(rest, baton)
                     .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
                         if (_isIngressSession) {
                             networkCounter.hitPhysicalIn(msgLen);
@@ -385,6 +434,50 @@ private:
             });
     }
 
+    /**
+     * Returns whether sourceMessageImpl() may receive more than a header's worth of bytes at
+     * once.
+     */
+    bool canReadSpeculatively() const {
+#ifdef MONGO_CONFIG_SSL
+        // The first header from an ingress connection has to be read on its own to find out
+        // whether the client is starting a TLS handshake, and reads through the SSL stream are
+        // left to read().
+        return _ranHandshake && !_sslSocket;
+#else
+        return true;
+#endif
+    }
+
+    Future<void> waitForReadable(const transport::BatonHandle& baton) {
+        if (baton) {
+            return baton->addSession(*this, Baton::Type::In);
+        }
+        return _socket.async_wait(GenericSocket::wait_read, UseFuture{});
+    }
+
+    /**
+     * Moves up to 'maxBytes' bytes that were received ahead of the message being sourced into
+     * 'dest', returning how many were moved.
+     */
+    size_t takeReadAhead(char* dest, size_t maxBytes) {
+        const auto n = std::min(maxBytes, _readAhead.size());
+        if (n > 0) {
+            memcpy(dest, _readAhead.data(), n);
+            _readAhead.erase(_readAhead.begin(), _readAhead.begin() + n);
+        }
+        return n;
+    }
+
+    /**
+     * Puts bytes received past the end of a message back in front of any other read-ahead.
+     */
+    void putBackReadAhead(const char* data, size_t size) {
+        if (size > 0) {
+            _readAhead.insert(_readAhead.begin(), data, data + size);
+        }
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
@@ -695,6 +788,9 @@ private:
         Async,
     };
 
+    // Guards the blocking mode and timeouts while they are being changed, since a session which
+    // can source and sink concurrently may have both going on from different threads.
+    stdx::mutex _modeMutex;
     BlockingMode _blockingMode = Unknown;
 
     HostAndPort _remote;
@@ -709,6 +805,10 @@ private:
     bool _ranHandshake = false;
 #endif
 
+    // Bytes received past the end of the last message sourced. Only non-empty when the peer
+    // pipelines messages.
+    std::vector<char> _readAhead;
+
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
 };
@@ -37,7 +37,8 @@ namespace mongo {
 typedef void (*ThreadIdleCallback)();
 
 /**
- * Informs the registered listener that this thread believes it may go idle for an extended period.
+ * Informs the registered listener that this thread believes it may go idle for an extended period,
+ * and gives the blocks in the thread's SharedBufferPool cache back to the allocator.
  * The caller should avoid calling markThreadIdle at a high rate, as it can both be moderately
  * costly itself and in terms of distributed overhead for subsequent malloc/free calls.
  */
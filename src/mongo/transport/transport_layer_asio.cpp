@@ -40,6 +40,7 @@
 
 #include "mongo/base/system_error.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/service_entry_point.h"
@@ -64,6 +65,18 @@ namespace transport {
 
 MONGO_FAIL_POINT_DEFINE(transportLayerASIOasyncConnectTimesOut);
 
+namespace {
+
+// Number of SO_REUSEPORT acceptors, each with its own listener thread, for every TCP address the
+// server listens on. With the default of 1, a single listener thread accepts every connection.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerAcceptorsPerAddress, int, 1);
+
+#ifdef __linux__
+using ReusePortOption = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+}  // namespace
+
 class ASIOReactorTimer final : public ReactorTimer {
 public:
     explicit ASIOReactorTimer(asio::io_context& ctx)
@@ -226,7 +239,8 @@ TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
       useUnixSockets(!params->noUnixSocket),
 #endif
       enableIPv6(params->enableIPv6),
-      maxConns(params->maxConns) {
+      maxConns(params->maxConns),
+      acceptorsPerAddress(static_cast<size_t>(std::max(1, listenerAcceptorsPerAddress))) {
 }
 
 TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
@@ -640,6 +654,13 @@ Status TransportLayerASIO::setup() {
     _listenerPort = _listenerOptions.port;
     WrappedResolver resolver(*_acceptorReactor);
 
+#ifndef __linux__
+    if (_listenerOptions.acceptorsPerAddress > 1) {
+        warning() << "Multiple acceptors per address are only supported on Linux; accepting "
+                     "connections with a single listener thread";
+    }
+#endif
+
     for (auto& ip : listenAddrs) {
         std::error_code ec;
         if (ip.empty()) {
@@ -670,22 +691,18 @@ Status TransportLayerASIO::setup() {
                 fassertFailedNoTrace(40488);
             }
 
-            GenericAcceptor acceptor(*_acceptorReactor);
-            acceptor.open(addr->protocol());
-            acceptor.set_option(GenericAcceptor::reuse_address(true));
-            if (addr.family() == AF_INET6) {
-                acceptor.set_option(asio::ip::v6_only(true));
-            }
-
-            acceptor.non_blocking(true, ec);
-            if (ec) {
-                return errorCodeToStatus(ec);
+            size_t numAcceptors = 1;
+#ifdef __linux__
+            if (addr.family() == AF_INET || addr.family() == AF_INET6) {
+                numAcceptors = _listenerOptions.acceptorsPerAddress;
             }
+#endif
 
-            acceptor.bind(*addr, ec);
-            if (ec) {
-                return errorCodeToStatus(ec);
+            auto swAcceptor = _makeAcceptor(*_acceptorReactor, *addr, numAcceptors > 1);
+            if (!swAcceptor.isOK()) {
+                return swAcceptor.getStatus();
             }
+            auto& acceptor = swAcceptor.getValue();
 
 #ifndef _WIN32
             if (addr.family() == AF_UNIX) {
@@ -714,7 +731,27 @@ Status TransportLayerASIO::setup() {
 
             sockaddr_storage sa;
             memcpy(&sa, addr->data(), addr->size());
+
+            // Bind the additional acceptors to the address the first one ended up with, which
+            // carries the real port if an ephemeral port was requested.
+            auto boundEndpoint = acceptor.local_endpoint(ec);
+            if (ec) {
+                return errorCodeToStatus(ec);
+            }
             _acceptors.emplace_back(SockAddr(sa, addr->size()), std::move(acceptor));
+
+            for (size_t i = 1; i < numAcceptors; ++i) {
+                if (_reusePortReactors.size() < i) {
+                    _reusePortReactors.push_back(std::make_shared<ASIOReactor>());
+                }
+                auto swExtraAcceptor =
+                    _makeAcceptor(*_reusePortReactors[i - 1], boundEndpoint, true);
+                if (!swExtraAcceptor.isOK()) {
+                    return swExtraAcceptor.getStatus();
+                }
+                _acceptors.emplace_back(SockAddr(sa, addr->size()),
+                                        std::move(swExtraAcceptor.getValue()));
+            }
         }
     }
 
@@ -753,6 +790,38 @@ Status TransportLayerASIO::setup() {
     return Status::OK();
 }
 
+template <typename Endpoint>
+StatusWith<TransportLayerASIO::GenericAcceptor> TransportLayerASIO::_makeAcceptor(
+    ASIOReactor& reactor, const Endpoint& endpoint, bool reusePort) {
+    std::error_code ec;
+    GenericAcceptor acceptor(reactor);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(GenericAcceptor::reuse_address(true));
+    if (reusePort) {
+#ifdef __linux__
+        acceptor.set_option(ReusePortOption(true), ec);
+        if (ec) {
+            return errorCodeToStatus(ec);
+        }
+#endif
+    }
+    if (endpointToSockAddr(endpoint).getType() == AF_INET6) {
+        acceptor.set_option(asio::ip::v6_only(true));
+    }
+
+    acceptor.non_blocking(true, ec);
+    if (ec) {
+        return errorCodeToStatus(ec);
+    }
+
+    acceptor.bind(endpoint, ec);
+    if (ec) {
+        return errorCodeToStatus(ec);
+    }
+
+    return {std::move(acceptor)};
+}
+
 Status TransportLayerASIO::start() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _running.store(true);
@@ -770,6 +839,16 @@ Status TransportLayerASIO::start() {
             }
         });
 
+        for (size_t i = 0; i < _reusePortReactors.size(); ++i) {
+            _reusePortListenerThreads.emplace_back([ this, i, reactor = _reusePortReactors[i] ] {
+                const std::string threadName = str::stream() << "listener-" << (i + 1);
+                setThreadName(threadName);
+                while (_running.load()) {
+                    reactor->run();
+                }
+            });
+        }
+
         const char* ssl = "";
 #ifdef MONGO_CONFIG_SSL
         if (_sslMode() != SSLParams::SSLMode_disabled) {
@@ -777,6 +856,10 @@ Status TransportLayerASIO::start() {
         }
 #endif
         log() << "waiting for connections on port " << _listenerPort << ssl;
+        if (!_reusePortReactors.empty()) {
+            log() << "accepting connections with " << _reusePortReactors.size() + 1
+                  << " listener threads per address";
+        }
     } else {
         invariant(_acceptors.empty());
     }
@@ -813,6 +896,14 @@ void TransportLayerASIO::shutdown() {
         _acceptorReactor->stop();
         _listenerThread.join();
     }
+
+    for (auto& reactor : _reusePortReactors) {
+        reactor->stop();
+    }
+    for (auto& thread : _reusePortListenerThreads) {
+        thread.join();
+    }
+    _reusePortListenerThreads.clear();
 }
 
 ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
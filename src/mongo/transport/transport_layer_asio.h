@@ -107,6 +107,8 @@ public:
         Mode transportMode = Mode::kSynchronous;  // whether accepted sockets should be put into
                                                   // non-blocking mode after they're accepted
         size_t maxConns = DEFAULT_MAX_CONN;       // maximum number of active connections
+        size_t acceptorsPerAddress = 1;  // SO_REUSEPORT acceptors, each with its own thread, per
+                                         // TCP address; only used on Linux
     };
 
     TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
@@ -147,6 +149,16 @@ private:
 
     void _acceptConnection(GenericAcceptor& acceptor);
 
+    /**
+     * Opens and binds an acceptor for "endpoint" on "reactor". If "reusePort" is true, other
+     * acceptors may bind to the same address, and the kernel spreads incoming connections over
+     * all of them.
+     */
+    template <typename Endpoint>
+    StatusWith<GenericAcceptor> _makeAcceptor(ASIOReactor& reactor,
+                                              const Endpoint& endpoint,
+                                              bool reusePort);
+
     template <typename Endpoint>
     StatusWith<ASIOSessionHandle> _doSyncConnect(Endpoint endpoint,
                                                  const HostAndPort& peer,
@@ -184,6 +196,11 @@ private:
     std::shared_ptr<ASIOReactor> _egressReactor;
     std::shared_ptr<ASIOReactor> _acceptorReactor;
 
+    // With more than one acceptor per address, the additional acceptors of each TCP address are
+    // spread over these reactors. Each of them is run by its own listener thread, so that
+    // accepting connections is not limited to a single core.
+    std::vector<std::shared_ptr<ASIOReactor>> _reusePortReactors;
+
 #ifdef MONGO_CONFIG_SSL
     std::unique_ptr<asio::ssl::context> _ingressSSLContext;
     std::unique_ptr<asio::ssl::context> _egressSSLContext;
@@ -194,6 +211,9 @@ private:
     // Only used if _listenerOptions.async is false.
     stdx::thread _listenerThread;
 
+    // Threads running _reusePortReactors, in the same order.
+    std::vector<stdx::thread> _reusePortListenerThreads;
+
     ServiceEntryPoint* const _sep = nullptr;
     AtomicWord<bool> _running{false};
     Options _listenerOptions;
@@ -87,8 +87,12 @@ public:
     }
 
     void waitForConnect() {
+        waitForConnections(1);
+    }
+
+    void waitForConnections(size_t count) {
         stdx::unique_lock<stdx::mutex> lock(_mutex);
-        _cv.wait(lock, [&] { return !_sessions.empty(); });
+        _cv.wait(lock, [&] { return _sessions.size() >= count; });
     }
 
 private:
@@ -161,6 +165,44 @@ TEST(TransportLayerASIO, PortZeroConnect) {
     tla.shutdown();
 }
 
+#ifdef __linux__
+TEST(TransportLayerASIO, ReusePortAcceptorsConnect) {
+    ServiceEntryPointUtil sepu;
+
+    auto options = [] {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerASIO::Options opts(&params);
+        opts.port = 0;
+        opts.acceptorsPerAddress = 4;
+        return opts;
+    }();
+
+    transport::TransportLayerASIO tla(options, &sepu);
+    sepu.setTransportLayer(&tla);
+
+    ASSERT_OK(tla.setup());
+    ASSERT_OK(tla.start());
+    int port = tla.listenerPort();
+    ASSERT_GT(port, 0);
+
+    // Every connection is accepted, whichever of the acceptors the kernel hands it to.
+    const size_t kConnections = 16;
+    std::vector<std::unique_ptr<SimpleConnectionThread>> connectThreads;
+    for (size_t i = 0; i < kConnections; ++i) {
+        connectThreads.emplace_back(stdx::make_unique<SimpleConnectionThread>(port));
+    }
+    sepu.waitForConnections(kConnections);
+    ASSERT_EQ(kConnections, sepu.numOpenSessions());
+
+    for (auto& thread : connectThreads) {
+        thread->stop();
+    }
+    sepu.endAllSessions({});
+    tla.shutdown();
+}
+#endif
+
 class TimeoutSEP : public ServiceEntryPoint {
 public:
     void endAllSessions(transport::Session::TagMask tags) override {
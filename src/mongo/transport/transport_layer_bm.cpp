@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_layer_uring.h"
+#include "mongo/util/net/sock.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Echoes every message received on a session back to it from a thread per session, so that the
+ * benchmarks below compare only the cost of moving bytes through each transport layer.
+ */
+class EchoServiceEntryPoint : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {
+        stdx::thread([session] {
+            while (true) {
+                auto swMessage = session->sourceMessage();
+                if (!swMessage.isOK() || !session->sinkMessage(swMessage.getValue()).isOK()) {
+                    return;
+                }
+            }
+        }).detach();
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        return 0;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+};
+
+enum class TransportKind { kAsio, kUring };
+
+/**
+ * Returns the port of a running echo server of the given kind, starting it on first use. The
+ * servers live until the process exits.
+ */
+int echoServerPort(TransportKind kind) {
+    static EchoServiceEntryPoint sep;
+
+    static const int asioPort = [] {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerASIO::Options opts(&params);
+        opts.port = 0;
+        opts.mode = transport::TransportLayerASIO::Options::kIngress;
+        auto tl = new transport::TransportLayerASIO(opts, &sep);
+        uassertStatusOK(tl->setup());
+        uassertStatusOK(tl->start());
+        return tl->listenerPort();
+    }();
+
+    static const int uringPort = [] {
+        if (!transport::TransportLayerUring::isSupported()) {
+            return 0;
+        }
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerUring::Options opts(&params);
+        opts.port = 0;
+        auto tl = new transport::TransportLayerUring(opts, &sep);
+        uassertStatusOK(tl->setup());
+        uassertStatusOK(tl->start());
+        return tl->listenerPort();
+    }();
+
+    return kind == TransportKind::kAsio ? asioPort : uringPort;
+}
+
+/**
+ * Measures request/response round trips of an OP_MSG carrying state.range(0) bytes of padding,
+ * with every benchmark thread driving its own connection.
+ */
+void runEchoRoundTrips(benchmark::State& state, TransportKind kind) {
+    const int port = echoServerPort(kind);
+    if (port == 0) {
+        state.SkipWithError("io_uring is not supported by this kernel");
+        return;
+    }
+
+    Socket socket;
+    SockAddr addr("127.0.0.1", port, AF_INET);
+    if (!socket.connect(addr)) {
+        state.SkipWithError("failed to connect to the echo server");
+        return;
+    }
+
+    const auto request =
+        OpMsgRequest::fromDBAndBody(
+            "admin", BSON("echo" << 1 << "padding" << std::string(state.range(0), 'x')))
+            .serialize();
+    std::string reply(request.size(), '\0');
+
+    for (auto keepRunning : state) {
+        socket.send(request.buf(), request.size(), "echo");
+        socket.recv(&reply[0], reply.size());
+    }
+
+    state.SetBytesProcessed(state.iterations() * request.size() * 2);
+}
+
+void BM_AsioEchoRoundTrip(benchmark::State& state) {
+    runEchoRoundTrips(state, TransportKind::kAsio);
+}
+
+void BM_UringEchoRoundTrip(benchmark::State& state) {
+    runEchoRoundTrips(state, TransportKind::kUring);
+}
+
+BENCHMARK(BM_AsioEchoRoundTrip)
+    ->ThreadRange(1, 4 * ProcessInfo::getNumAvailableCores())
+    ->Arg(64)
+    ->Arg(16 * 1024)
+    ->Arg(1024 * 1024)
+    ->UseRealTime();
+
+BENCHMARK(BM_UringEchoRoundTrip)
+    ->ThreadRange(1, 4 * ProcessInfo::getNumAvailableCores())
+    ->Arg(64)
+    ->Arg(16 * 1024)
+    ->Arg(1024 * 1024)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -26,11 +26,14 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/transport/transport_layer_manager.h"
 
 #include "mongo/base/status.h"
+#include "mongo/config.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -38,6 +41,11 @@
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
+#ifdef MONGO_CONFIG_HAVE_IO_URING
+#include "mongo/transport/service_executor_uring.h"
+#include "mongo/transport/transport_layer_uring.h"
+#endif
+#include "mongo/util/log.h"
 #include "mongo/util/net/ssl_types.h"
 #include "mongo/util/time_support.h"
 #include <limits>
@@ -131,6 +139,34 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     std::unique_ptr<TransportLayer> transportLayer;
     auto sep = ctx->getServiceEntryPoint();
 
+#ifdef MONGO_CONFIG_HAVE_IO_URING
+    if (config->transportLayer == "uring") {
+        uassert(ErrorCodes::InvalidOptions,
+                "The io_uring transport layer is not supported by this kernel",
+                TransportLayerUring::isSupported());
+
+        // io_uring only handles ingress, so egress connections go through an ASIO transport
+        // layer, which must come first for TransportLayerManager::connect() to use it.
+        transport::TransportLayerASIO::Options egressOpts(config);
+        egressOpts.mode = transport::TransportLayerASIO::Options::kEgress;
+        egressOpts.ipList.clear();
+
+        transport::TransportLayerUring::Options uringOpts(config);
+        auto transportLayerUring = stdx::make_unique<TransportLayerUring>(uringOpts, sep);
+        if (config->serviceExecutor != "synchronous") {
+            warning() << "Ignoring serviceExecutor " << config->serviceExecutor
+                      << ", the io_uring transport layer uses its own service executor";
+        }
+        ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorUring>(
+            ctx, transportLayerUring->ringNodes(), uringOpts.bindToNumaNodes));
+
+        std::vector<std::unique_ptr<TransportLayer>> retVector;
+        retVector.emplace_back(stdx::make_unique<TransportLayerASIO>(egressOpts, nullptr));
+        retVector.emplace_back(std::move(transportLayerUring));
+        return stdx::make_unique<TransportLayerManager>(std::move(retVector));
+    }
+#endif
+
     transport::TransportLayerASIO::Options opts(config);
     if (config->serviceExecutor == "adaptive") {
         opts.transportMode = transport::Mode::kAsynchronous;
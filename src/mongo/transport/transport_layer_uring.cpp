@@ -0,0 +1,1063 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include <cstring>
+#include <deque>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mongo/config.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/rpc/message.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/net/socket_utils.h"
+#include "mongo/util/net/ssl_options.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Number of rings, each with its own thread, per NUMA node.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringRingsPerNode, int, 1);
+
+// Whether ring threads (and the service executor's workers) are bound to their node's CPUs.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringBindThreadsToNumaNodes, bool, true);
+
+// Size of each ring's submission queue.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringQueueDepth, int, 4096);
+
+// Number and size of the provided buffers each ring receives into. Every received chunk is
+// copied out into its message right away, so these only need to cover one batch of completions.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringReceiveBufferCount, int, 1024);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringReceiveBufferSizeBytes, int, 16 * 1024);
+
+// How many received messages, and how many bytes of them, a connection buffers before its session
+// reads them. Past either bound the ring stops receiving on the connection until the session has
+// caught up, so a client that pipelines requests without reading replies can't exhaust memory.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringMaxQueuedMessagesPerConnection, int, 16);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(uringMaxQueuedBytesPerConnection, int, 16 * 1024 * 1024);
+
+constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+thread_local int currentRing = -1;
+
+Status errnoToStatus(StringData what, int err) {
+    return Status(ErrorCodes::SocketException,
+                  str::stream() << what << " failed: " << errnoWithDescription(err));
+}
+
+Status closedByPeerStatus() {
+    return Status(ErrorCodes::HostUnreachable, "Connection closed by peer");
+}
+
+uint64_t toUserData(const void* op) {
+    return reinterpret_cast<uint64_t>(op);
+}
+
+}  // namespace
+
+/**
+ * Something a ring has submitted to the kernel. The address of the Operation is the user data of
+ * its submission, which lets completions be dispatched back to it.
+ */
+struct TransportLayerUring::Operation {
+    enum class Type { kAccept, kRecv, kSend, kWake, kCancel };
+
+    explicit Operation(Type type) : type(type) {}
+
+    const Type type;
+
+    // kAccept: the listening socket.
+    int listenerFd = -1;
+
+    // kRecv: the connection receiving. The ring owns the connection while the receive is armed.
+    Connection* connection = nullptr;
+
+    // kSend: the connection, the message being sent, how much of it the kernel has taken so far,
+    // and the promise to complete once it has taken all of it.
+    std::shared_ptr<Connection> sendConnection;
+    Message message;
+    size_t offset = 0;
+    Promise<void> promise;
+};
+
+/**
+ * The state of an accepted socket, shared between its UringSession and the ring it belongs to.
+ */
+struct TransportLayerUring::Connection {
+    Connection(Ring* ring,
+               int fd,
+               HostAndPort local,
+               HostAndPort remote,
+               size_t maxQueuedMessages,
+               size_t maxQueuedBytes)
+        : ring(ring),
+          fd(fd),
+          local(std::move(local)),
+          remote(std::move(remote)),
+          maxQueuedMessages(maxQueuedMessages),
+          maxQueuedBytes(maxQueuedBytes) {
+        recvOp.connection = this;
+    }
+
+    /**
+     * Hands a complete message to the session, completing a pending asyncSourceMessage() if
+     * there is one. Pauses receiving once the session has fallen too far behind.
+     */
+    void deliver(Message message) {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        if (sourcePending) {
+            sourcePending = false;
+            auto promise = std::move(sourcePromise);
+            lk.unlock();
+            promise.emplaceValue(std::move(message));
+            return;
+        }
+        readyBytes += message.size();
+        ready.push_back(std::move(message));
+        if (!ended && (ready.size() >= maxQueuedMessages || readyBytes >= maxQueuedBytes)) {
+            recvPaused = true;
+        }
+        lk.unlock();
+        readyCondition.notify_one();
+    }
+
+    /**
+     * Records that no more messages will arrive, and why. Only the first status is kept.
+     */
+    void fail(Status reason) {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        if (status.isOK()) {
+            status = std::move(reason);
+        }
+        if (sourcePending) {
+            sourcePending = false;
+            auto promise = std::move(sourcePromise);
+            auto failure = status;
+            lk.unlock();
+            promise.setError(std::move(failure));
+            return;
+        }
+        lk.unlock();
+        readyCondition.notify_all();
+    }
+
+    /**
+     * Shuts the socket down, which makes the ring's pending receive complete so that it closes
+     * the connection. Safe to call from any thread. Returns true if receiving was paused, in which
+     * case the caller must have the ring resume it for the connection to be closed.
+     */
+    bool shutdownSocket() {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        ended = true;
+        if (!closed) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        const bool wasPaused = recvPaused;
+        recvPaused = false;
+        return wasPaused;
+    }
+
+    Ring* const ring;
+    const int fd;
+    const HostAndPort local;
+    const HostAndPort remote;
+    const size_t maxQueuedMessages;
+    const size_t maxQueuedBytes;
+
+    // Guards the members below, up to the ones owned by the ring thread.
+    stdx::mutex mutex;
+    stdx::condition_variable readyCondition;
+    std::deque<Message> ready;
+    size_t readyBytes = 0;
+    bool recvPaused = false;  // Set once 'ready' is full, cleared by whoever drains it.
+    Promise<Message> sourcePromise;
+    bool sourcePending = false;
+    Status status = Status::OK();
+    bool ended = false;
+    bool closed = false;
+
+    // Only used by the ring thread.
+    Operation recvOp{Operation::Type::kRecv};
+    bool recvArmed = false;
+    bool recvCancelPending = false;
+    bool recvDone = false;  // The socket was closed by the peer, shut down or failed.
+    size_t sendsInFlight = 0;
+    char header[kHeaderSize];
+    size_t headerFilled = 0;
+    SharedBuffer body;
+    size_t messageLength = 0;  // Zero while the header of the next message is being received.
+    size_t bodyFilled = 0;
+};
+
+class TransportLayerUring::UringSession final : public Session {
+    MONGO_DISALLOW_COPYING(UringSession);
+
+public:
+    UringSession(TransportLayerUring* tl, std::shared_ptr<Connection> conn)
+        : _tl(tl), _conn(std::move(conn)) {}
+
+    ~UringSession() {
+        end();
+    }
+
+    TransportLayer* getTransportLayer() const override {
+        return _tl;
+    }
+
+    const HostAndPort& remote() const override {
+        return _conn->remote;
+    }
+
+    const HostAndPort& local() const override {
+        return _conn->local;
+    }
+
+    void end() override;
+
+    StatusWith<Message> sourceMessage() override {
+        stdx::unique_lock<stdx::mutex> lk(_conn->mutex);
+        auto haveResult = [&] { return !_conn->ready.empty() || !_conn->status.isOK(); };
+        if (_timeout) {
+            if (!_conn->readyCondition.wait_for(lk, _timeout->toSystemDuration(), haveResult)) {
+                return Status(ErrorCodes::NetworkTimeout, "Socket operation timed out");
+            }
+        } else {
+            _conn->readyCondition.wait(lk, haveResult);
+        }
+        return _popReady(std::move(lk));
+    }
+
+    Future<Message> asyncSourceMessage(const transport::BatonHandle& baton = nullptr) override {
+        stdx::unique_lock<stdx::mutex> lk(_conn->mutex);
+        if (!_conn->ready.empty() || !_conn->status.isOK()) {
+            return Future<Message>::makeReady(_popReady(std::move(lk)));
+        }
+
+        invariant(!_conn->sourcePending);
+        auto pf = makePromiseFuture<Message>();
+        _conn->sourcePromise = std::move(pf.promise);
+        _conn->sourcePending = true;
+        return std::move(pf.future);
+    }
+
+    Status sinkMessage(Message message) override;
+
+    Future<void> asyncSinkMessage(Message message,
+                                  const transport::BatonHandle& baton = nullptr) override;
+
+    void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
+        stdx::unique_lock<stdx::mutex> lk(_conn->mutex);
+        if (!_conn->sourcePending) {
+            return;
+        }
+        _conn->sourcePending = false;
+        auto promise = std::move(_conn->sourcePromise);
+        lk.unlock();
+        promise.setError({ErrorCodes::CallbackCanceled, "Callback was canceled"});
+    }
+
+    void setTimeout(boost::optional<Milliseconds> timeout) override {
+        _timeout = timeout;
+    }
+
+    bool isConnected() override {
+        stdx::lock_guard<stdx::mutex> lk(_conn->mutex);
+        return !_conn->closed && !_conn->ended && _conn->status.isOK();
+    }
+
+private:
+    /**
+     * Takes the oldest received message, resuming receiving if that drained a paused connection.
+     */
+    StatusWith<Message> _popReady(stdx::unique_lock<stdx::mutex> lk);
+
+    TransportLayerUring* const _tl;
+    const std::shared_ptr<Connection> _conn;
+    boost::optional<Milliseconds> _timeout;
+};
+
+/**
+ * An io_uring instance and the thread that drives it. Each ring accepts connections on every
+ * listener, and owns the connections it accepted until they are closed.
+ */
+class TransportLayerUring::Ring {
+    MONGO_DISALLOW_COPYING(Ring);
+
+public:
+    Ring(TransportLayerUring* tl, int id, NumaNode node) : _tl(tl), _id(id), _node(node) {}
+
+    ~Ring() {
+        if (_eventFd >= 0) {
+            ::close(_eventFd);
+        }
+    }
+
+    Status start() {
+        auto swUring = IoUring::create(uringQueueDepth,
+                                       uringReceiveBufferCount,
+                                       uringReceiveBufferSizeBytes);
+        if (!swUring.isOK()) {
+            return swUring.getStatus();
+        }
+        _uring = std::move(swUring.getValue());
+
+        _eventFd = ::eventfd(0, EFD_CLOEXEC);
+        if (_eventFd < 0) {
+            return errnoToStatus("eventfd", errno);
+        }
+
+        for (auto&& listener : _tl->_listeners) {
+            auto op = stdx::make_unique<Operation>(Operation::Type::kAccept);
+            op->listenerFd = listener.second;
+            _acceptOps.push_back(std::move(op));
+        }
+
+        _thread = stdx::thread([this] { _run(); });
+        return Status::OK();
+    }
+
+    void stop() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stopping = true;
+        }
+        _wake();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /**
+     * Has the ring start receiving on a connection again once its session has drained the messages
+     * it had fallen behind on.
+     */
+    void resumeRecv(std::shared_ptr<Connection> conn) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_stopping) {
+                return;
+            }
+            _pendingResumes.push_back(std::move(conn));
+        }
+        _wake();
+    }
+
+    /**
+     * Queues a message to be sent on the next turn of the ring. Callers must not have more than
+     * one send outstanding per connection.
+     */
+    Future<void> send(std::shared_ptr<Connection> conn, Message message) {
+        auto pf = makePromiseFuture<void>();
+        auto op = stdx::make_unique<Operation>(Operation::Type::kSend);
+        op->sendConnection = std::move(conn);
+        op->message = std::move(message);
+        op->promise = std::move(pf.promise);
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_stopping) {
+                op->promise.setError(TransportLayer::ShutdownStatus);
+                return std::move(pf.future);
+            }
+            _pendingSends.push_back(std::move(op));
+        }
+        _wake();
+        return std::move(pf.future);
+    }
+
+private:
+    void _run() {
+        setThreadName(str::stream() << "uring" << _id);
+        currentRing = _id;
+        if (_tl->_listenerOptions.bindToNumaNodes) {
+            auto status = bindCurrentThreadToNumaNode(_node);
+            if (!status.isOK()) {
+                warning() << status;
+            }
+        }
+
+        for (auto&& op : _acceptOps) {
+            _armAccept(op.get());
+        }
+        _armWake();
+
+        while (true) {
+            std::vector<std::unique_ptr<Operation>> sends;
+            std::vector<std::shared_ptr<Connection>> resumes;
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                if (_stopping) {
+                    break;
+                }
+                sends.swap(_pendingSends);
+                resumes.swap(_pendingResumes);
+            }
+
+            // Everything queued since the last turn goes to the kernel in the same system call
+            // that waits for the next completions.
+            for (auto&& op : sends) {
+                _startSend(std::move(op));
+            }
+            for (auto&& conn : resumes) {
+                _resumeRecv(conn.get());
+            }
+            fassert(50945, _uring->submit(1));
+
+            _uring->forEachCompletion([this](const io_uring_cqe& cqe) { _onCompletion(cqe); });
+        }
+
+        _closeAll();
+    }
+
+    void _wake() {
+        if (!_wakePending.swap(true)) {
+            const uint64_t one = 1;
+            if (::write(_eventFd, &one, sizeof(one)) < 0) {
+                severe() << "Failed to wake io_uring thread: " << errnoWithDescription();
+                fassertFailed(50946);
+            }
+        }
+    }
+
+    io_uring_sqe* _getSqe() {
+        auto sqe = _uring->getSqe();
+        while (!sqe) {
+            // The submission queue is full; hand what's there to the kernel to make room.
+            fassert(50947, _uring->submit(0));
+            sqe = _uring->getSqe();
+        }
+        return sqe;
+    }
+
+    void _armAccept(Operation* op) {
+        IoUring::prepAccept(_getSqe(), op->listenerFd, _multishotAccept, toUserData(op));
+    }
+
+    void _armRecv(Connection* conn) {
+        IoUring::prepRecv(_getSqe(), conn->fd, _multishotRecv, toUserData(&conn->recvOp));
+        conn->recvArmed = true;
+    }
+
+    void _armWake() {
+        IoUring::prepRead(
+            _getSqe(), _eventFd, &_eventFdValue, sizeof(_eventFdValue), toUserData(&_wakeOp));
+    }
+
+    void _onCompletion(const io_uring_cqe& cqe) {
+        auto op = reinterpret_cast<Operation*>(cqe.user_data);
+        switch (op->type) {
+            case Operation::Type::kAccept:
+                return _onAccept(op, cqe);
+            case Operation::Type::kRecv:
+                return _onRecv(op->connection, cqe);
+            case Operation::Type::kSend:
+                return _onSend(op, cqe);
+            case Operation::Type::kWake:
+                _wakePending.store(false);
+                return _armWake();
+            case Operation::Type::kCancel:
+                // Whether or not the receive was still armed, its own completion says so.
+                return;
+        }
+        MONGO_UNREACHABLE;
+    }
+
+    void _onAccept(Operation* op, const io_uring_cqe& cqe) {
+        const bool more = cqe.flags & IORING_CQE_F_MORE;
+        if (cqe.res >= 0) {
+            _addConnection(cqe.res);
+        } else if (!_tl->_running.load()) {
+            return;
+        } else if (cqe.res == -EINVAL && _multishotAccept) {
+            LOG(1) << "Multishot accept is not supported, falling back to single accepts";
+            _multishotAccept = false;
+        } else {
+            warning() << "Error accepting new connection: " << errnoWithDescription(-cqe.res);
+        }
+
+        if (!more) {
+            _armAccept(op);
+        }
+    }
+
+    void _addConnection(int fd) {
+        sockaddr_storage localStorage, remoteStorage;
+        socklen_t localSize = sizeof(localStorage);
+        socklen_t remoteSize = sizeof(remoteStorage);
+        if (::getsockname(fd, reinterpret_cast<sockaddr*>(&localStorage), &localSize) != 0 ||
+            ::getpeername(fd, reinterpret_cast<sockaddr*>(&remoteStorage), &remoteSize) != 0) {
+            LOG(1) << "Dropping new connection: " << errnoWithDescription();
+            ::close(fd);
+            return;
+        }
+
+        const SockAddr localAddr(localStorage, localSize);
+        if (localAddr.getType() == AF_INET || localAddr.getType() == AF_INET6) {
+            const int on = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            ::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+            setSocketKeepAliveParams(fd);
+        }
+
+        auto conn = std::make_shared<Connection>(this,
+                                                 fd,
+                                                 HostAndPort(localAddr),
+                                                 HostAndPort(SockAddr(remoteStorage, remoteSize)),
+                                                 _tl->_listenerOptions.maxQueuedMessages,
+                                                 _tl->_listenerOptions.maxQueuedBytes);
+        _connections.emplace(conn.get(), conn);
+        _armRecv(conn.get());
+
+        _tl->_sep->startSession(std::make_shared<UringSession>(_tl, std::move(conn)));
+    }
+
+    void _onRecv(Connection* conn, const io_uring_cqe& cqe) {
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+        if (cqe.res > 0) {
+            invariant(cqe.flags & IORING_CQE_F_BUFFER);
+            const auto bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            auto status = _consume(conn, _uring->buffer(bufferId), cqe.res);
+            _uring->recycleBuffer(bufferId);
+            if (!status.isOK()) {
+                // The receive completes once the socket is shut down, which closes the connection.
+                conn->fail(std::move(status));
+                conn->shutdownSocket();
+            }
+        } else if (cqe.res == -ENOBUFS) {
+            // Every provided buffer was in use. They have all been recycled by now, so re-arm.
+        } else if (cqe.res == -ECANCELED) {
+            // Receiving was paused below, and is re-armed if the session has caught up since.
+        } else if (cqe.res == -EINVAL && _multishotRecv) {
+            LOG(1) << "Multishot receive is not supported, falling back to single receives";
+            _multishotRecv = false;
+        } else {
+            conn->recvArmed = false;
+            conn->recvDone = true;
+            conn->fail(cqe.res == 0 ? closedByPeerStatus() : errnoToStatus("recv", -cqe.res));
+            return _maybeClose(conn);
+        }
+
+        bool paused;
+        {
+            stdx::lock_guard<stdx::mutex> lk(conn->mutex);
+            paused = conn->recvPaused;
+        }
+
+        if (more) {
+            // The session has fallen behind. Stop the multishot receive rather than buffering
+            // whatever the client keeps sending; it is re-armed once the session drains 'ready'.
+            if (paused && !conn->recvCancelPending) {
+                IoUring::prepCancel(_getSqe(), toUserData(&conn->recvOp), toUserData(&_cancelOp));
+                conn->recvCancelPending = true;
+            }
+            return;
+        }
+
+        conn->recvCancelPending = false;
+        if (paused) {
+            conn->recvArmed = false;
+        } else {
+            _armRecv(conn);
+        }
+    }
+
+    void _resumeRecv(Connection* conn) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(conn->mutex);
+            if (conn->closed || conn->recvPaused) {
+                return;
+            }
+        }
+        // If the receive is still armed, its final completion re-arms it.
+        if (!conn->recvArmed && !conn->recvDone) {
+            _armRecv(conn);
+        }
+    }
+
+    /**
+     * Appends received bytes to the message being assembled, delivering each one completed.
+     */
+    Status _consume(Connection* conn, const char* data, size_t len) {
+        while (len > 0) {
+            if (conn->messageLength == 0) {
+                const auto n = std::min(len, kHeaderSize - conn->headerFilled);
+                memcpy(conn->header + conn->headerFilled, data, n);
+                conn->headerFilled += n;
+                data += n;
+                len -= n;
+                if (conn->headerFilled < kHeaderSize) {
+                    break;
+                }
+
+                const auto msgLen = size_t(MSGHEADER::ConstView(conn->header).getMessageLength());
+                if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+                    StringBuilder sb;
+                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
+                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+                    const auto str = sb.str();
+                    LOG(0) << str;
+                    return Status(ErrorCodes::ProtocolError, str);
+                }
+
+                conn->body = SharedBuffer::allocate(msgLen);
+                memcpy(conn->body.get(), conn->header, kHeaderSize);
+                conn->headerFilled = 0;
+                conn->messageLength = msgLen;
+                conn->bodyFilled = kHeaderSize;
+            } else {
+                const auto n = std::min(len, conn->messageLength - conn->bodyFilled);
+                memcpy(conn->body.get() + conn->bodyFilled, data, n);
+                conn->bodyFilled += n;
+                data += n;
+                len -= n;
+            }
+
+            if (conn->bodyFilled == conn->messageLength) {
+                networkCounter.hitPhysicalIn(conn->messageLength);
+                conn->messageLength = 0;
+                conn->deliver(Message(std::move(conn->body)));
+            }
+        }
+        return Status::OK();
+    }
+
+    void _startSend(std::unique_ptr<Operation> op) {
+        auto conn = op->sendConnection.get();
+        {
+            stdx::lock_guard<stdx::mutex> lk(conn->mutex);
+            if (conn->closed) {
+                op->promise.setError(TransportLayer::TicketSessionClosedStatus);
+                return;
+            }
+        }
+        ++conn->sendsInFlight;
+        _submitSend(op.get());
+        _sendsInFlight.emplace(op.get(), std::move(op));
+    }
+
+    void _submitSend(Operation* op) {
+        IoUring::prepSend(_getSqe(),
+                          op->sendConnection->fd,
+                          op->message.buf() + op->offset,
+                          op->message.size() - op->offset,
+                          toUserData(op));
+    }
+
+    void _onSend(Operation* op, const io_uring_cqe& cqe) {
+        if (cqe.res > 0) {
+            op->offset += cqe.res;
+            if (op->offset < op->message.size()) {
+                return _submitSend(op);
+            }
+        }
+
+        auto it = _sendsInFlight.find(op);
+        invariant(it != _sendsInFlight.end());
+        auto owned = std::move(it->second);
+        _sendsInFlight.erase(it);
+
+        auto conn = op->sendConnection.get();
+        --conn->sendsInFlight;
+        if (cqe.res > 0) {
+            networkCounter.hitPhysicalOut(op->message.size());
+            _maybeClose(conn);
+            op->promise.emplaceValue();
+        } else {
+            if (conn->shutdownSocket() && !conn->recvArmed && !conn->recvDone) {
+                // Receiving was paused; re-arm it so that it sees the shutdown and closes.
+                _armRecv(conn);
+            }
+            _maybeClose(conn);
+            op->promise.setError(cqe.res == 0 ? closedByPeerStatus()
+                                              : errnoToStatus("send", -cqe.res));
+        }
+    }
+
+    /**
+     * Closes a connection once the kernel no longer references its socket.
+     */
+    void _maybeClose(Connection* conn) {
+        if (!conn->recvDone || conn->sendsInFlight) {
+            return;
+        }
+        _close(conn, TransportLayer::TicketSessionClosedStatus);
+        _connections.erase(conn);
+    }
+
+    void _close(Connection* conn, Status reason) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(conn->mutex);
+            if (conn->closed) {
+                return;
+            }
+            conn->closed = true;
+            ::close(conn->fd);
+        }
+        conn->fail(std::move(reason));
+    }
+
+    void _closeAll() {
+        // Destroying the ring cancels whatever is still in flight, so fail it all here.
+        for (auto&& entry : _connections) {
+            _close(entry.first, TransportLayer::ShutdownStatus);
+        }
+        for (auto&& entry : _sendsInFlight) {
+            entry.second->promise.setError(TransportLayer::ShutdownStatus);
+        }
+        std::vector<std::unique_ptr<Operation>> sends;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            sends.swap(_pendingSends);
+        }
+        for (auto&& op : sends) {
+            op->promise.setError(TransportLayer::ShutdownStatus);
+        }
+        _sendsInFlight.clear();
+        _connections.clear();
+        _uring.reset();
+    }
+
+    TransportLayerUring* const _tl;
+    const int _id;
+    const NumaNode _node;
+
+    std::unique_ptr<IoUring> _uring;
+    std::vector<std::unique_ptr<Operation>> _acceptOps;
+    Operation _wakeOp{Operation::Type::kWake};
+    Operation _cancelOp{Operation::Type::kCancel};
+    int _eventFd = -1;
+    uint64_t _eventFdValue = 0;
+    AtomicWord<bool> _wakePending{false};
+
+    stdx::mutex _mutex;
+    std::vector<std::unique_ptr<Operation>> _pendingSends;
+    std::vector<std::shared_ptr<Connection>> _pendingResumes;
+    bool _stopping = false;
+
+    // Only used by the ring thread.
+    stdx::unordered_map<Connection*, std::shared_ptr<Connection>> _connections;
+    stdx::unordered_map<Operation*, std::unique_ptr<Operation>> _sendsInFlight;
+    bool _multishotAccept = true;
+    bool _multishotRecv = true;
+
+    stdx::thread _thread;
+};
+
+void TransportLayerUring::UringSession::end() {
+    cancelAsyncOperations();
+    if (_conn->shutdownSocket()) {
+        _conn->ring->resumeRecv(_conn);
+    }
+}
+
+StatusWith<Message> TransportLayerUring::UringSession::_popReady(
+    stdx::unique_lock<stdx::mutex> lk) {
+    if (_conn->ready.empty()) {
+        return _conn->status;
+    }
+    auto message = std::move(_conn->ready.front());
+    _conn->ready.pop_front();
+    _conn->readyBytes -= message.size();
+
+    if (_conn->ready.empty() && _conn->recvPaused) {
+        _conn->recvPaused = false;
+        lk.unlock();
+        _conn->ring->resumeRecv(_conn);
+    }
+    return {std::move(message)};
+}
+
+Status TransportLayerUring::UringSession::sinkMessage(Message message) {
+    auto future = _conn->ring->send(_conn, std::move(message));
+    if (!_timeout) {
+        return std::move(future).getNoThrow();
+    }
+
+    struct SendResult {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        boost::optional<Status> status;
+    };
+    auto result = std::make_shared<SendResult>();
+    std::move(future).getAsync([result](Status status) {
+        stdx::lock_guard<stdx::mutex> lk(result->mutex);
+        result->status = std::move(status);
+        result->cv.notify_one();
+    });
+
+    stdx::unique_lock<stdx::mutex> lk(result->mutex);
+    if (!result->cv.wait_for(
+            lk, _timeout->toSystemDuration(), [&] { return static_cast<bool>(result->status); })) {
+        // Part of the message may already be on the wire, so the connection can't be reused.
+        lk.unlock();
+        end();
+        return Status(ErrorCodes::NetworkTimeout, "Socket operation timed out");
+    }
+    return *result->status;
+}
+
+Future<void> TransportLayerUring::UringSession::asyncSinkMessage(
+    Message message, const transport::BatonHandle& baton) {
+    return _conn->ring->send(_conn, std::move(message));
+}
+
+TransportLayerUring::Options::Options(const ServerGlobalParams* params)
+    : port(params->port),
+      ipList(params->bind_ips),
+      useUnixSockets(!params->noUnixSocket),
+      enableIPv6(params->enableIPv6),
+      ringsPerNode(static_cast<size_t>(std::max(1, uringRingsPerNode))),
+      bindToNumaNodes(uringBindThreadsToNumaNodes),
+      maxQueuedMessages(static_cast<size_t>(std::max(1, uringMaxQueuedMessagesPerConnection))),
+      maxQueuedBytes(static_cast<size_t>(std::max(1, uringMaxQueuedBytesPerConnection))) {}
+
+bool TransportLayerUring::isSupported() {
+    return IoUring::isSupported();
+}
+
+int TransportLayerUring::currentRingId() {
+    return currentRing;
+}
+
+TransportLayerUring::TransportLayerUring(const Options& opts, ServiceEntryPoint* sep)
+    : _sep(sep), _listenerOptions(opts) {
+    // Only nodes with CPUs this process may run on get rings, so that binding ring threads never
+    // widens a restriction placed by taskset, numactl or a cgroup cpuset.
+    auto nodes = getNumaTopology();
+    if (auto allowedCpus = getCurrentThreadCpus()) {
+        auto restricted = restrictNumaTopology(nodes, *allowedCpus);
+        if (!restricted.empty()) {
+            nodes = std::move(restricted);
+        }
+    }
+
+    for (auto&& node : nodes) {
+        for (size_t i = 0; i < _listenerOptions.ringsPerNode; ++i) {
+            _ringNodes.push_back(node);
+        }
+    }
+}
+
+TransportLayerUring::~TransportLayerUring() {
+    shutdown();
+}
+
+StatusWith<SessionHandle> TransportLayerUring::connect(HostAndPort peer,
+                                                       ConnectSSLMode sslMode,
+                                                       Milliseconds timeout) {
+    return Status(ErrorCodes::IllegalOperation,
+                  "The io_uring transport layer does not support egress connections");
+}
+
+Future<SessionHandle> TransportLayerUring::asyncConnect(HostAndPort peer,
+                                                        ConnectSSLMode sslMode,
+                                                        const ReactorHandle& reactor,
+                                                        Milliseconds timeout) {
+    return Future<SessionHandle>::makeReady(connect(std::move(peer), sslMode, timeout));
+}
+
+Status TransportLayerUring::setup() {
+#ifdef MONGO_CONFIG_SSL
+    if (getSSLGlobalParams().sslMode.load() != SSLParams::SSLMode_disabled) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "The io_uring transport layer does not support SSL connections");
+    }
+#endif
+
+    std::vector<std::string> listenAddrs;
+    if (_listenerOptions.ipList.empty()) {
+        listenAddrs = {"127.0.0.1"};
+        if (_listenerOptions.enableIPv6) {
+            listenAddrs.emplace_back("::1");
+        }
+    } else {
+        listenAddrs = _listenerOptions.ipList;
+    }
+
+    if (_listenerOptions.useUnixSockets) {
+        listenAddrs.emplace_back(makeUnixSockPath(_listenerOptions.port));
+    }
+
+    _listenerPort = _listenerOptions.port;
+    const auto familyHint = _listenerOptions.enableIPv6 ? AF_UNSPEC : AF_INET;
+
+    for (auto& ip : listenAddrs) {
+        if (ip.empty()) {
+            warning() << "Skipping empty bind address";
+            continue;
+        }
+
+        auto addrs = SockAddr::createAll(ip, _listenerPort, familyHint);
+        if (addrs.empty()) {
+            warning() << "Found no addresses for " << ip;
+            continue;
+        }
+
+        for (auto& addr : addrs) {
+            if (addr.getType() == AF_UNIX) {
+                if (::unlink(addr.getAddr().c_str()) == -1 && errno != ENOENT) {
+                    error() << "Failed to unlink socket file " << addr.getAddr() << " "
+                            << errnoWithDescription(errno);
+                    fassertFailedNoTrace(50948);
+                }
+            }
+            if (addr.getType() == AF_INET6 && !_listenerOptions.enableIPv6) {
+                error() << "Specified ipv6 bind address, but ipv6 is disabled";
+                fassertFailedNoTrace(50949);
+            }
+
+            int fd = ::socket(addr.getType(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                return errnoToStatus("socket", errno);
+            }
+            _listeners.emplace_back(addr, fd);
+
+            const int on = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (addr.getType() == AF_INET6) {
+                ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on));
+            }
+
+            if (::bind(fd, addr.raw(), addr.addressSize) != 0) {
+                return errnoToStatus(str::stream() << "bind to " << addr.toString(), errno);
+            }
+
+            if (addr.getType() == AF_UNIX) {
+                if (::chmod(addr.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) ==
+                    -1) {
+                    error() << "Failed to chmod socket file " << addr.getAddr() << " "
+                            << errnoWithDescription(errno);
+                    fassertFailedNoTrace(50950);
+                }
+            }
+
+            if (_listenerOptions.port == 0 &&
+                (addr.getType() == AF_INET || addr.getType() == AF_INET6)) {
+                if (_listenerPort != _listenerOptions.port) {
+                    return Status(ErrorCodes::BadValue,
+                                  "Port 0 (ephemeral port) is not allowed when"
+                                  " listening on multiple IP interfaces");
+                }
+                sockaddr_storage bound;
+                socklen_t boundSize = sizeof(bound);
+                if (::getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &boundSize) != 0) {
+                    return errnoToStatus("getsockname", errno);
+                }
+                _listenerPort = SockAddr(bound, boundSize).getPort();
+            }
+        }
+    }
+
+    if (_listeners.empty()) {
+        return Status(ErrorCodes::SocketException, "No available addresses/ports to bind to");
+    }
+
+    return Status::OK();
+}
+
+Status TransportLayerUring::start() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _running.store(true);
+
+    for (auto&& listener : _listeners) {
+        if (::listen(listener.second, serverGlobalParams.listenBacklog) != 0) {
+            return errnoToStatus(str::stream() << "listen on " << listener.first.toString(),
+                                 errno);
+        }
+    }
+
+    for (size_t i = 0; i < _ringNodes.size(); ++i) {
+        _rings.push_back(stdx::make_unique<Ring>(this, static_cast<int>(i), _ringNodes[i]));
+        auto status = _rings.back()->start();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    log() << "waiting for connections on port " << _listenerPort << " using io_uring with "
+          << _rings.size() << " rings";
+    return Status::OK();
+}
+
+void TransportLayerUring::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _running.store(false);
+
+    // Shutting the listeners down fails the accepts the rings have armed on them.
+    for (auto&& listener : _listeners) {
+        ::shutdown(listener.second, SHUT_RDWR);
+    }
+
+    // The rings stay allocated until destruction since sessions may still refer to them.
+    for (auto&& ring : _rings) {
+        ring->stop();
+    }
+
+    for (auto&& listener : _listeners) {
+        ::close(listener.second);
+        auto& addr = listener.first;
+        if (addr.getType() == AF_UNIX && !addr.isAnonymousUNIXSocket()) {
+            auto path = addr.getAddr();
+            log() << "removing socket file: " << path;
+            if (::unlink(path.c_str()) != 0) {
+                const auto ewd = errnoWithDescription();
+                warning() << "Unable to remove UNIX socket " << path << ": " << ewd;
+            }
+        }
+    }
+    _listeners.clear();
+}
+
+ReactorHandle TransportLayerUring::getReactor(WhichReactor which) {
+    // Rings are driven by their own threads and can't run arbitrary work.
+    return nullptr;
+}
+
+}  // namespace transport
+}  // namespace mongo
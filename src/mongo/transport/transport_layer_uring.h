@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/net/sockaddr.h"
+#include "mongo/util/numa_topology.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+/**
+ * An ingress-only TransportLayer built on Linux io_uring.
+ *
+ * Accepted connections are spread over a small number of rings, each owned by a thread bound to a
+ * NUMA node. A ring keeps a multishot receive armed on every one of its connections, so incoming
+ * bytes land in the ring's provided buffers without any per-request system call, and replies queued
+ * by any thread are submitted to the kernel in batches on the ring's next turn.
+ *
+ * Sessions support both the synchronous and asynchronous Session APIs; ServiceExecutorUring runs
+ * the state machines of each ring's sessions on worker threads bound to the ring's node. SSL and
+ * egress connections are not supported, and are expected to be handled by a TransportLayerASIO
+ * living next to this one in the TransportLayerManager.
+ */
+class TransportLayerUring final : public TransportLayer {
+    MONGO_DISALLOW_COPYING(TransportLayerUring);
+
+public:
+    struct Options {
+        explicit Options(const ServerGlobalParams* params);
+        Options() = default;
+
+        int port = ServerGlobalParams::DefaultDBPort;  // port to bind to
+        std::vector<std::string> ipList;               // addresses to bind to
+        bool useUnixSockets = true;                    // whether to allow UNIX sockets in ipList
+        bool enableIPv6 = false;                       // whether to allow IPv6 sockets in ipList
+        size_t ringsPerNode = 1;                       // rings (and threads) per NUMA node
+        bool bindToNumaNodes = true;  // whether ring threads are bound to their node's CPUs
+
+        // How many received messages, and how many bytes of them, a connection buffers before
+        // its session reads them. Receiving pauses once either is reached.
+        size_t maxQueuedMessages = 16;
+        size_t maxQueuedBytes = 16 * 1024 * 1024;
+    };
+
+    /**
+     * Returns whether the running kernel supports the io_uring features this TransportLayer needs.
+     */
+    static bool isSupported();
+
+    TransportLayerUring(const Options& opts, ServiceEntryPoint* sep);
+
+    ~TransportLayerUring();
+
+    StatusWith<SessionHandle> connect(HostAndPort peer,
+                                      ConnectSSLMode sslMode,
+                                      Milliseconds timeout) final;
+
+    Future<SessionHandle> asyncConnect(HostAndPort peer,
+                                       ConnectSSLMode sslMode,
+                                       const ReactorHandle& reactor,
+                                       Milliseconds timeout) final;
+
+    Status setup() final;
+
+    Status start() final;
+
+    void shutdown() final;
+
+    ReactorHandle getReactor(WhichReactor which) final;
+
+    int listenerPort() const {
+        return _listenerPort;
+    }
+
+    /**
+     * Returns the NUMA node of each ring, indexed by ring id.
+     */
+    const std::vector<NumaNode>& ringNodes() const {
+        return _ringNodes;
+    }
+
+    /**
+     * Returns the id of the ring owned by the calling thread, or -1 if it doesn't own one.
+     */
+    static int currentRingId();
+
+private:
+    class Ring;
+    class UringSession;
+    struct Connection;
+    struct Operation;
+
+    ServiceEntryPoint* const _sep;
+    const Options _listenerOptions;
+
+    std::vector<NumaNode> _ringNodes;
+    std::vector<std::pair<SockAddr, int>> _listeners;
+    int _listenerPort = 0;
+
+    stdx::mutex _mutex;
+    std::vector<std::unique_ptr<Ring>> _rings;
+    AtomicWord<bool> _running{false};
+};
+
+}  // namespace transport
+}  // namespace mongo
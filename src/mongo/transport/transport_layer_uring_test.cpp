@@ -0,0 +1,310 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include <cstring>
+
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Echoes every message received on a session back to it, using the synchronous Session API on a
+ * thread per session.
+ */
+class EchoServiceEntryPoint : public ServiceEntryPoint {
+public:
+    ~EchoServiceEntryPoint() {
+        endAllSessions({});
+    }
+
+    void startSession(transport::SessionHandle session) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sessions.push_back(session);
+        _threads.emplace_back([this, session] {
+            while (true) {
+                auto swMessage = session->sourceMessage();
+                if (!swMessage.isOK()) {
+                    _recordEnd(swMessage.getStatus());
+                    return;
+                }
+                auto status = session->sinkMessage(swMessage.getValue());
+                if (!status.isOK()) {
+                    _recordEnd(std::move(status));
+                    return;
+                }
+            }
+        });
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        std::vector<transport::SessionHandle> sessions;
+        std::vector<stdx::thread> threads;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            sessions.swap(_sessions);
+            threads.swap(_threads);
+        }
+        for (auto&& session : sessions) {
+            session->end();
+        }
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _sessions.size();
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+    Status waitForSessionEnd() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return !_endStatuses.empty(); });
+        return _endStatuses.front();
+    }
+
+private:
+    void _recordEnd(Status status) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _endStatuses.push_back(std::move(status));
+        _cv.notify_all();
+    }
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::vector<transport::SessionHandle> _sessions;
+    std::vector<stdx::thread> _threads;
+    std::vector<Status> _endStatuses;
+};
+
+class TransportLayerUringTest : public unittest::Test {
+protected:
+    void setUp() override {
+        if (!transport::TransportLayerUring::isSupported()) {
+            return;
+        }
+
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerUring::Options opts(&params);
+        opts.port = 0;
+        opts.bindToNumaNodes = false;
+        opts.maxQueuedMessages = 2;  // Makes pipelining pause and resume receiving.
+
+        _tl = stdx::make_unique<transport::TransportLayerUring>(opts, &_sep);
+        ASSERT_OK(_tl->setup());
+        ASSERT_OK(_tl->start());
+        ASSERT_GT(_tl->listenerPort(), 0);
+    }
+
+    void tearDown() override {
+        _sep.endAllSessions({});
+        if (_tl) {
+            _tl->shutdown();
+        }
+    }
+
+    bool supported() const {
+        if (!_tl) {
+            log() << "Skipping test, io_uring is not supported by this kernel";
+        }
+        return static_cast<bool>(_tl);
+    }
+
+    void connect(Socket* socket) {
+        SockAddr sa{"127.0.0.1", _tl->listenerPort(), AF_INET};
+        ASSERT(socket->connect(sa));
+    }
+
+    static Message makeMessage(size_t padding) {
+        auto request = OpMsgRequest::fromDBAndBody(
+            "admin", BSON("echo" << 1 << "padding" << std::string(padding, 'x')));
+        return request.serialize();
+    }
+
+    static void assertReceives(Socket* socket, const Message& expected) {
+        std::string reply(expected.size(), '\0');
+        socket->recv(&reply[0], reply.size());
+        ASSERT_EQ(0, memcmp(reply.data(), expected.buf(), expected.size()));
+    }
+
+    EchoServiceEntryPoint _sep;
+    std::unique_ptr<transport::TransportLayerUring> _tl;
+};
+
+TEST_F(TransportLayerUringTest, EchoesMessage) {
+    if (!supported()) {
+        return;
+    }
+
+    Socket socket;
+    connect(&socket);
+
+    auto message = makeMessage(10);
+    socket.send(message.buf(), message.size(), "echo");
+    assertReceives(&socket, message);
+}
+
+TEST_F(TransportLayerUringTest, AssemblesMessagesLargerThanReceiveBuffers) {
+    if (!supported()) {
+        return;
+    }
+
+    Socket socket;
+    connect(&socket);
+
+    auto message = makeMessage(1024 * 1024);
+    socket.send(message.buf(), message.size(), "echo");
+    assertReceives(&socket, message);
+}
+
+TEST_F(TransportLayerUringTest, SplitsPipelinedMessages) {
+    if (!supported()) {
+        return;
+    }
+
+    Socket socket;
+    connect(&socket);
+
+    auto first = makeMessage(10);
+    auto second = makeMessage(100);
+    std::string both(first.buf(), first.size());
+    both.append(second.buf(), second.size());
+
+    // Also send the header of the next message in pieces to cover partial headers.
+    socket.send(both.data(), both.size(), "echo");
+    socket.send(first.buf(), 3, "echo");
+    socket.send(first.buf() + 3, first.size() - 3, "echo");
+
+    assertReceives(&socket, first);
+    assertReceives(&socket, second);
+    assertReceives(&socket, first);
+}
+
+TEST_F(TransportLayerUringTest, ServesPipelineDeeperThanReceiveQueue) {
+    if (!supported()) {
+        return;
+    }
+
+    Socket socket;
+    connect(&socket);
+
+    const size_t kMessages = 50;
+    auto message = makeMessage(100);
+    for (size_t i = 0; i < kMessages; ++i) {
+        socket.send(message.buf(), message.size(), "echo");
+    }
+    for (size_t i = 0; i < kMessages; ++i) {
+        assertReceives(&socket, message);
+    }
+}
+
+TEST_F(TransportLayerUringTest, RejectsInvalidMessageLength) {
+    if (!supported()) {
+        return;
+    }
+
+    Socket socket;
+    connect(&socket);
+
+    char header[16] = {};
+    header[0] = 4;  // A message can't be shorter than its header.
+    socket.send(header, sizeof(header), "invalid");
+    ASSERT_EQ(ErrorCodes::ProtocolError, _sep.waitForSessionEnd());
+}
+
+TEST_F(TransportLayerUringTest, PeerCloseEndsSession) {
+    if (!supported()) {
+        return;
+    }
+
+    {
+        Socket socket;
+        connect(&socket);
+        auto message = makeMessage(10);
+        socket.send(message.buf(), message.size(), "echo");
+        assertReceives(&socket, message);
+    }
+
+    ASSERT_EQ(ErrorCodes::HostUnreachable, _sep.waitForSessionEnd());
+}
+
+TEST_F(TransportLayerUringTest, PeerCloseWhileReceivingIsPausedEndsSession) {
+    if (!supported()) {
+        return;
+    }
+
+    {
+        Socket socket;
+        connect(&socket);
+
+        // Fill the receive queue so that receiving pauses, then go away without reading the
+        // replies, so that sending them fails after the peer's EOF has been received.
+        auto message = makeMessage(100);
+        for (size_t i = 0; i < 50; ++i) {
+            socket.send(message.buf(), message.size(), "echo");
+        }
+        assertReceives(&socket, message);
+    }
+
+    // Depending on which comes first, the session sees the EOF or the failed send.
+    ASSERT_NOT_OK(_sep.waitForSessionEnd());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/error_codes.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+/**
+ * The class an operation belongs to when it queues for a storage engine ticket. Waiters of a higher
+ * class are admitted first, and waiters of a lower class gain priority as they age so that they
+ * are not starved.
+ */
+enum class AdmissionPriority {
+    kLow = 0,  // Batch and background work such as TTL deletes, range deletion and index builds.
+    kNormal,
+    kHigh,  // Latency-sensitive work.
+};
+
+const int kNumAdmissionPriorities = static_cast<int>(AdmissionPriority::kHigh) + 1;
+
+inline StringData toString(AdmissionPriority priority) {
+    switch (priority) {
+        case AdmissionPriority::kLow:
+            return "low"_sd;
+        case AdmissionPriority::kNormal:
+            return "normal"_sd;
+        case AdmissionPriority::kHigh:
+            return "high"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+inline StatusWith<AdmissionPriority> parseAdmissionPriority(StringData name) {
+    for (int i = 0; i < kNumAdmissionPriorities; ++i) {
+        const auto priority = static_cast<AdmissionPriority>(i);
+        if (name == toString(priority)) {
+            return priority;
+        }
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "Unknown admission priority '" << name
+                          << "'; expected 'low', 'normal' or 'high'"};
+}
+
+}  // namespace mongo
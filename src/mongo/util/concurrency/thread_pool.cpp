@@ -34,6 +34,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
@@ -47,6 +48,11 @@ namespace {
 // Counter used to assign unique names to otherwise-unnamed thread pools.
 AtomicInt32 nextUnnamedThreadPoolId{1};
 
+// The work-stealing pool that the current thread is a worker of, if any, and the index of its
+// queue in that pool. Tasks scheduled from a worker go on the worker's own queue.
+thread_local const ThreadPool* currentWorkStealingPool = nullptr;
+thread_local size_t currentWorkerSlot = 0;
+
 /**
  * Sets defaults and checks bounds limits on "options", and returns it.
  *
@@ -75,7 +81,14 @@ ThreadPool::Options cleanUpOptions(ThreadPool::Options&& options) {
 
 }  // namespace
 
-ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {}
+ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {
+    if (_options.workStealing) {
+        for (size_t i = 0; i < _options.maxThreads; ++i) {
+            _workerQueues.emplace_back(stdx::make_unique<WorkerQueue>());
+            _freeWorkerSlots.push_back(_options.maxThreads - i - 1);
+        }
+    }
+}
 
 ThreadPool::~ThreadPool() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
@@ -89,7 +102,7 @@ ThreadPool::~ThreadPool() {
         fassertFailed(28704);
     }
     invariant(_threads.empty());
-    invariant(_pendingTasks.empty());
+    invariant(_numPendingTasks_inlock() == 0);
 }
 
 void ThreadPool::startup() {
@@ -101,8 +114,8 @@ void ThreadPool::startup() {
     }
     _setState_inlock(running);
     invariant(_threads.empty());
-    const size_t numToStart =
-        std::min(_options.maxThreads, std::max(_options.minThreads, _pendingTasks.size()));
+    const size_t numToStart = std::min(_options.maxThreads,
+                                       std::max(_options.minThreads, _numPendingTasks_inlock()));
     for (size_t i = 0; i < numToStart; ++i) {
         _startWorkerThread_inlock();
     }
@@ -118,6 +131,7 @@ void ThreadPool::_shutdown_inlock() {
         case preStart:
         case running:
             _setState_inlock(joinRequired);
+            _shutdownRequested.store(true);
             _workAvailable.notify_all();
             return;
         case joinRequired:
@@ -157,7 +171,7 @@ void ThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
     });
     _setState_inlock(joining);
     ++_numIdleThreads;
-    if (!_pendingTasks.empty()) {
+    if (_numPendingTasks_inlock()) {
         lk->unlock();
         _drainPendingTasks();
         lk->lock();
@@ -165,6 +179,7 @@ void ThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
     --_numIdleThreads;
     ThreadList threadsToJoin;
     swap(threadsToJoin, _threads);
+    _numThreads.store(0);
     lk->unlock();
     for (auto& t : threadsToJoin) {
         t.join();
@@ -182,6 +197,17 @@ void ThreadPool::_drainPendingTasks() {
                                                      << _nextThreadId++;
         setThreadName(threadName);
         _options.onCreateThread(threadName);
+        if (_options.workStealing) {
+            Task task;
+            while (_numQueuedTasks.load()) {
+                if (_popTask(0, &task)) {
+                    _runTask(std::move(task));
+                } else {
+                    stdx::this_thread::yield();
+                }
+            }
+            return;
+        }
         stdx::unique_lock<stdx::mutex> lock(_mutex);
         while (!_pendingTasks.empty()) {
             _doOneTask(&lock);
@@ -191,6 +217,10 @@ void ThreadPool::_drainPendingTasks() {
 }
 
 Status ThreadPool::schedule(Task task) {
+    if (_options.workStealing) {
+        return _scheduleWorkStealing(std::move(task));
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     switch (_state) {
         case joinRequired:
@@ -219,8 +249,95 @@ Status ThreadPool::schedule(Task task) {
     return Status::OK();
 }
 
+Status ThreadPool::_scheduleWorkStealing(Task task) {
+    // Count the task before checking for shutdown, so that join() keeps draining the queues until
+    // the task has either been pushed or been refused.
+    _numQueuedTasks.fetchAndAdd(1);
+    if (_shutdownRequested.load()) {
+        _numQueuedTasks.subtractAndFetch(1);
+        return Status(ErrorCodes::ShutdownInProgress,
+                      str::stream() << "Shutdown of thread pool " << _options.poolName
+                                    << " in progress");
+    }
+
+    const size_t slot = currentWorkStealingPool == this
+        ? currentWorkerSlot
+        : _nextWorkerQueue.fetchAndAdd(1) % _workerQueues.size();
+    auto& queue = *_workerQueues[slot];
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+
+    _wakeWorkStealingWorker();
+    return Status::OK();
+}
+
+void ThreadPool::_wakeWorkStealingWorker() {
+    // Workers count themselves as parked before their last check for queued tasks, so either a
+    // parked worker is seen here or the worker sees the task before it parks.
+    if (_numParkedThreads.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+        return;
+    }
+
+    // A worker which is neither parked nor running a task is looking for one, and will find this
+    // task. Otherwise all workers are busy, so the pool grows if it can.
+    const auto numThreads = _numThreads.load();
+    if (_numActiveTasks.load() < numThreads || numThreads >= _options.maxThreads) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_numActiveTasks.load() >= _threads.size()) {
+        _startWorkerThread_inlock();
+        _lastFullUtilizationDate = Date_t::now();
+    }
+}
+
+bool ThreadPool::_popTask(size_t firstQueue, Task* task) {
+    for (size_t i = 0; i < _workerQueues.size(); ++i) {
+        auto& queue = *_workerQueues[(firstQueue + i) % _workerQueues.size()];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        *task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+
+        // Count the task as active before it stops counting as queued, so that waitForIdle()
+        // never sees the pool idle while the task is in hand.
+        _numActiveTasks.fetchAndAdd(1);
+        _numQueuedTasks.subtractAndFetch(1);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::_runTask(Task task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        task();
+        task = nullptr;
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+
+    if (_numActiveTasks.subtractAndFetch(1) == 0 && _numQueuedTasks.load() == 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _poolIsIdle.notify_all();
+    }
+}
+
 void ThreadPool::waitForIdle() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_options.workStealing) {
+        _poolIsIdle.wait(lk, [this] { return !_numQueuedTasks.load() && !_numActiveTasks.load(); });
+        return;
+    }
     // If there are any pending tasks, or non-idle threads, the pool is not idle.
     while (!_pendingTasks.empty() || _numIdleThreads < _threads.size()) {
         _poolIsIdle.wait(lk);
@@ -233,18 +350,31 @@ ThreadPool::Stats ThreadPool::getStats() const {
     result.options = _options;
     result.numThreads = _threads.size();
     result.numIdleThreads = _numIdleThreads;
-    result.numPendingTasks = _pendingTasks.size();
+    if (_options.workStealing) {
+        result.numIdleThreads =
+            _threads.size() - std::min<size_t>(_threads.size(), _numActiveTasks.load());
+    }
+    result.numPendingTasks = _numPendingTasks_inlock();
     result.lastFullUtilizationDate = _lastFullUtilizationDate;
     return result;
 }
 
-void ThreadPool::_workerThreadBody(ThreadPool* pool, const std::string& threadName) {
+void ThreadPool::_workerThreadBody(ThreadPool* pool,
+                                   const std::string& threadName,
+                                   size_t workerSlot) {
     setThreadName(threadName);
     pool->_options.onCreateThread(threadName);
     const auto poolName = pool->_options.poolName;
     LOG(1) << "starting thread in pool " << poolName;
     try {
-        pool->_consumeTasks();
+        if (pool->_options.workStealing) {
+            currentWorkStealingPool = pool;
+            currentWorkerSlot = workerSlot;
+            pool->_consumeTasksWorkStealing(workerSlot);
+            currentWorkStealingPool = nullptr;
+        } else {
+            pool->_consumeTasks();
+        }
     } catch (...) {
         severe() << "Exception reached top of stack in thread pool " << poolName << ": "
                  << exceptionToStatus();
@@ -319,8 +449,86 @@ void ThreadPool::_consumeTasks() {
         fassertFailedNoTrace(28701);
     }
 
-    // This thread is ending because it was idle for too long.  Find self in _threads, remove self
-    // from _threads, detach self.
+    // This thread is ending because it was idle for too long.
+    _retireThisThread_inlock();
+}
+
+void ThreadPool::_consumeTasksWorkStealing(size_t workerSlot) {
+    Task task;
+    while (true) {
+        if (_popTask(workerSlot, &task)) {
+            // Pass the wakeup on while tasks remain queued. A schedule() call which counted a
+            // parked thread that had already been woken relies on this to get its task run.
+            if (_numQueuedTasks.load()) {
+                _wakeWorkStealingWorker();
+            }
+            _runTask(std::move(task));
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_state != running) {
+            break;
+        }
+
+        // Count this thread as parked before the last check for queued tasks; see
+        // _wakeWorkStealingWorker().
+        _numParkedThreads.fetchAndAdd(1);
+        if (_numQueuedTasks.load()) {
+            _numParkedThreads.subtractAndFetch(1);
+            continue;
+        }
+
+        if (_threads.size() <= _options.minThreads) {
+            LOG(3) << "waiting for work; I am one of " << _threads.size() << " thread(s);"
+                   << " the minimum number of threads is " << _options.minThreads;
+            MONGO_IDLE_THREAD_BLOCK;
+            _workAvailable.wait(lk);
+            _numParkedThreads.subtractAndFetch(1);
+            continue;
+        }
+
+        // This thread is eligible for retirement if it stays parked for maxIdleThreadAge.
+        const auto retirementDate = Date_t::now() + _options.maxIdleThreadAge;
+        bool timedOut;
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            timedOut = _workAvailable.wait_until(lk, retirementDate.toSystemTimePoint()) ==
+                stdx::cv_status::timeout;
+        }
+        if (!timedOut || _state != running || _threads.size() <= _options.minThreads) {
+            _numParkedThreads.subtractAndFetch(1);
+            continue;
+        }
+
+        // Stop counting this thread before the last check for queued tasks, so that a concurrent
+        // schedule() either sees that it must start a thread or is seen here.
+        _numThreads.subtractAndFetch(1);
+        _numParkedThreads.subtractAndFetch(1);
+        if (_numQueuedTasks.load()) {
+            _numThreads.fetchAndAdd(1);
+            continue;
+        }
+
+        LOG(1) << "Reaping this thread after it was idle for " << _options.maxIdleThreadAge;
+        _freeWorkerSlots.push_back(workerSlot);
+        _retireThisThread_inlock();
+        return;
+    }
+
+    // The pool is shutting down, so this thread lends a hand in draining the queues and returns so
+    // that it can be joined.
+    while (_numQueuedTasks.load()) {
+        if (_popTask(workerSlot, &task)) {
+            _runTask(std::move(task));
+        } else {
+            stdx::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::_retireThisThread_inlock() {
+    // Find self in _threads, remove self from _threads, detach self.
     for (size_t i = 0; i < _threads.size(); ++i) {
         auto& t = _threads[i];
         if (t.get_id() != stdx::this_thread::get_id()) {
@@ -329,6 +537,7 @@ void ThreadPool::_consumeTasks() {
         t.detach();
         t.swap(_threads.back());
         _threads.pop_back();
+        _numThreads.store(_threads.size());
         return;
     }
     severe().stream() << "Could not find this thread, with id " << stdx::this_thread::get_id()
@@ -381,14 +590,32 @@ void ThreadPool::_startWorkerThread_inlock() {
     }
     invariant(_threads.size() < _options.maxThreads);
     const std::string threadName = str::stream() << _options.threadNamePrefix << _nextThreadId++;
+    size_t workerSlot = 0;
+    if (_options.workStealing) {
+        invariant(!_freeWorkerSlots.empty());
+        workerSlot = _freeWorkerSlots.back();
+        _freeWorkerSlots.pop_back();
+    }
     try {
-        _threads.emplace_back([this, threadName] { _workerThreadBody(this, threadName); });
+        _threads.emplace_back(
+            [this, threadName, workerSlot] { _workerThreadBody(this, threadName, workerSlot); });
+        _numThreads.store(_threads.size());
         ++_numIdleThreads;
     } catch (const std::exception& ex) {
         error() << "Failed to start " << threadName << "; " << _threads.size()
                 << " other thread(s) still running in pool " << _options.poolName
                 << "; caught exception: " << redact(ex.what());
+        if (_options.workStealing) {
+            _freeWorkerSlots.push_back(workerSlot);
+        }
+    }
+}
+
+size_t ThreadPool::_numPendingTasks_inlock() const {
+    if (_options.workStealing) {
+        return _numQueuedTasks.load();
     }
+    return _pendingTasks.size();
 }
 
 void ThreadPool::_setState_inlock(const LifecycleState newState) {
@@ -29,10 +29,12 @@
 #pragma once
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -82,6 +84,16 @@ public:
         // a thread.
         Milliseconds maxIdleThreadAge = Seconds{30};
 
+        // If true, each worker thread has its own queue of pending tasks, and workers that run out
+        // of tasks steal from the queues of other workers before parking. Scheduling and running
+        // tasks then no longer contends on a single pool-wide mutex.
+        //
+        // Tasks scheduled from a worker thread go on that worker's queue, and other tasks are
+        // spread over all queues, so tasks are no longer guaranteed to start in the order in
+        // which they were scheduled. In this mode, threads beyond minThreads are reaped once they
+        // have been parked for maxIdleThreadAge.
+        bool workStealing = false;
+
         // This function is run before each worker thread begins consuming tasks.
         using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
         OnCreateThreadFn onCreateThread = [](const std::string&) {};
@@ -140,6 +152,14 @@ private:
     using TaskList = std::deque<Task>;
     using ThreadList = std::vector<stdx::thread>;
 
+    /**
+     * Pending tasks of one worker thread, when the pool is configured for work stealing.
+     */
+    struct WorkerQueue {
+        stdx::mutex mutex;
+        TaskList tasks;
+    };
+
     /**
      * Representation of the stage of life of a thread pool.
      *
@@ -162,7 +182,9 @@ private:
      * As such, it is advisable to pass the pool pointer as an explicit argument, rather
      * than as the implicit "this" argument.
      */
-    static void _workerThreadBody(ThreadPool* pool, const std::string& threadName);
+    static void _workerThreadBody(ThreadPool* pool,
+                                  const std::string& threadName,
+                                  size_t workerSlot);
 
     /**
      * Starts a worker thread, unless _options.maxThreads threads are already running or
@@ -175,6 +197,44 @@ private:
      */
     void _consumeTasks();
 
+    /**
+     * The run loop of a worker thread when the pool is configured for work stealing. The worker
+     * takes tasks from the queue in "workerSlot" first, and from the other queues after that.
+     */
+    void _consumeTasksWorkStealing(size_t workerSlot);
+
+    /**
+     * Removes the calling worker thread from _threads and detaches it.
+     */
+    void _retireThisThread_inlock();
+
+    /**
+     * Implementation of schedule() when the pool is configured for work stealing.
+     */
+    Status _scheduleWorkStealing(Task task);
+
+    /**
+     * Wakes a parked worker thread to run a newly scheduled task, or starts another worker thread
+     * if all of them are busy.
+     */
+    void _wakeWorkStealingWorker();
+
+    /**
+     * Takes the next task, looking at _workerQueues starting at "firstQueue". Returns false if all
+     * of the queues are empty.
+     */
+    bool _popTask(size_t firstQueue, Task* task);
+
+    /**
+     * Runs a task taken by _popTask().
+     */
+    void _runTask(Task task);
+
+    /**
+     * Returns the number of tasks waiting to be executed by the pool.
+     */
+    size_t _numPendingTasks_inlock() const;
+
     /**
      * Implementation of shutdown once _mutex is locked.
      */
@@ -239,6 +299,33 @@ private:
 
     // The last time that _pendingTasks.size() grew to be at least _threads.size().
     Date_t _lastFullUtilizationDate;
+
+    // The members below are only used when the pool is configured for work stealing. In that mode
+    // tasks wait in _workerQueues rather than in _pendingTasks.
+
+    // One queue per possible worker thread. The vector itself is not modified after construction.
+    std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
+
+    // Indexes into _workerQueues that no running worker thread owns.
+    std::vector<size_t> _freeWorkerSlots;
+
+    // Set once shutdown has been requested, so that schedule() can fail without taking _mutex.
+    AtomicBool _shutdownRequested{false};
+
+    // Number of tasks in _workerQueues, plus tasks being pushed onto them.
+    AtomicUInt64 _numQueuedTasks;
+
+    // Number of tasks being run.
+    AtomicUInt64 _numActiveTasks;
+
+    // Number of worker threads waiting on _workAvailable.
+    AtomicUInt64 _numParkedThreads;
+
+    // Mirror of _threads.size(), for use without holding _mutex.
+    AtomicUInt64 _numThreads;
+
+    // Round-robin counter for spreading tasks scheduled from outside the pool over _workerQueues.
+    AtomicUInt64 _nextWorkerQueue;
 };
 
 }  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 32;  // max number of threads scheduling onto the pool
+const int kTasksPerBatch = 64;
+const size_t kPoolThreads = 8;
+
+/**
+ * Each benchmark thread schedules a batch of tasks onto a shared pool and waits for them all to
+ * run, so a single iteration measures both scheduling and running under contention.
+ */
+template <bool workStealing>
+void BM_ThreadPoolScheduleAndRun(benchmark::State& state) {
+    static std::unique_ptr<ThreadPool> pool;
+
+    if (state.thread_index == 0) {
+        ThreadPool::Options options;
+        options.poolName = "ThreadPoolBM";
+        options.minThreads = kPoolThreads;
+        options.maxThreads = kPoolThreads;
+        options.workStealing = workStealing;
+        pool = stdx::make_unique<ThreadPool>(options);
+        pool->startup();
+    }
+
+    AtomicInt32 remaining;
+    for (auto keepRunning : state) {
+        remaining.store(kTasksPerBatch);
+        for (int i = 0; i < kTasksPerBatch; ++i) {
+            invariant(pool->schedule([&remaining] { remaining.subtractAndFetch(1); }));
+        }
+        while (remaining.load()) {
+            stdx::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+
+    if (state.thread_index == 0) {
+        pool->shutdown();
+        pool->join();
+        pool.reset();
+    }
+}
+
+/**
+ * Each benchmark thread starts a task which schedules the rest of the batch from inside the pool,
+ * as executors do when a callback schedules its continuation.
+ */
+template <bool workStealing>
+void BM_ThreadPoolScheduleFromTask(benchmark::State& state) {
+    static std::unique_ptr<ThreadPool> pool;
+
+    if (state.thread_index == 0) {
+        ThreadPool::Options options;
+        options.poolName = "ThreadPoolBM";
+        options.minThreads = kPoolThreads;
+        options.maxThreads = kPoolThreads;
+        options.workStealing = workStealing;
+        pool = stdx::make_unique<ThreadPool>(options);
+        pool->startup();
+    }
+
+    AtomicInt32 remaining;
+    for (auto keepRunning : state) {
+        remaining.store(kTasksPerBatch);
+        invariant(pool->schedule([&remaining] {
+            for (int i = 1; i < kTasksPerBatch; ++i) {
+                invariant(pool->schedule([&remaining] { remaining.subtractAndFetch(1); }));
+            }
+            remaining.subtractAndFetch(1);
+        }));
+        while (remaining.load()) {
+            stdx::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+
+    if (state.thread_index == 0) {
+        pool->shutdown();
+        pool->join();
+        pool.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ThreadPoolScheduleAndRun, false)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_ThreadPoolScheduleAndRun, true)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_ThreadPoolScheduleFromTask, false)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_ThreadPoolScheduleFromTask, true)->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -33,7 +33,9 @@
 #include <boost/optional.hpp>
 
 #include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/barrier.h"
@@ -55,6 +57,15 @@ MONGO_INITIALIZER(ThreadPoolCommonTests)(InitializerContext*) {
     return Status::OK();
 }
 
+MONGO_INITIALIZER(ThreadPoolWorkStealingCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("ThreadPoolWorkStealingCommon", []() {
+        ThreadPool::Options options;
+        options.workStealing = true;
+        return stdx::make_unique<ThreadPool>(options);
+    });
+    return Status::OK();
+}
+
 class ThreadPoolTest : public unittest::Test {
 protected:
     ThreadPool& makePool(ThreadPool::Options options) {
@@ -177,6 +188,72 @@ TEST_F(ThreadPoolTest, MaxPoolSize20MinPoolSize15) {
         << "Failed to reap excess threads after " << durationCount<Milliseconds>(reapTime) << "ms";
 }
 
+TEST_F(ThreadPoolTest, WorkStealingMaxPoolSize20MinPoolSize15) {
+    ThreadPool::Options options;
+    options.minThreads = 15;
+    options.maxThreads = 20;
+    options.maxIdleThreadAge = Milliseconds(100);
+    options.workStealing = true;
+    auto& pool = makePool(options);
+    pool.startup();
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    for (size_t i = 0U; i < 30U; ++i) {
+        ASSERT_OK(pool.schedule([this] { blockingWork(); })) << i;
+    }
+    while (count1 < 20U) {
+        cv1.wait(lk);
+    }
+    ASSERT_EQ(20U, count1);
+    auto stats = pool.getStats();
+    ASSERT_EQ(20U, stats.numThreads);
+    ASSERT_EQ(0U, stats.numIdleThreads);
+    ASSERT_EQ(10U, stats.numPendingTasks);
+    flag2 = true;
+    cv2.notify_all();
+    while (count1 < 30U) {
+        cv1.wait(lk);
+    }
+    lk.unlock();
+    pool.waitForIdle();
+    stats = pool.getStats();
+    ASSERT_EQ(0U, stats.numPendingTasks);
+    Timer reapTimer;
+    for (size_t i = 0; i < 100 && (stats = pool.getStats()).numThreads > options.minThreads; ++i) {
+        sleepmillis(50);
+    }
+    const Microseconds reapTime(reapTimer.micros());
+    ASSERT_EQ(options.minThreads, stats.numThreads)
+        << "Failed to reap excess threads after " << durationCount<Milliseconds>(reapTime) << "ms";
+}
+
+TEST_F(ThreadPoolTest, WorkStealingRunsTasksScheduledFromTasks) {
+    ThreadPool::Options options;
+    options.minThreads = 4;
+    options.maxThreads = 4;
+    options.workStealing = true;
+    auto& pool = makePool(options);
+    pool.startup();
+
+    // Each task schedules more tasks onto its own worker's queue, which the other workers have to
+    // steal from to share the load.
+    AtomicUInt32 numRun;
+    stdx::function<void(int)> fanOut = [&](int depth) {
+        numRun.fetchAndAdd(1);
+        if (depth == 0) {
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_OK(pool.schedule([&fanOut, depth] { fanOut(depth - 1); }));
+        }
+    };
+    ASSERT_OK(pool.schedule([&fanOut] { fanOut(5); }));
+    pool.waitForIdle();
+
+    // 1 + 4 + 16 + 64 + 256 + 1024 tasks.
+    ASSERT_EQ(1365U, numRun.load());
+    ASSERT_EQ(0U, pool.getStats().numPendingTasks);
+}
+
 DEATH_TEST(ThreadPoolTest, MaxThreadsTooFewDies, "but the maximum must be at least 1") {
     ThreadPool::Options options;
     options.maxThreads = 0;
@@ -31,13 +31,16 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
+const Milliseconds TicketHolder::kPriorityAgingInterval{100};
+
 #if defined(__linux__)
 namespace {
 
@@ -58,14 +61,6 @@ void check(int ret) {
         return;
     failWithErrno(errno);
 }
-
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
-}
 }  // namespace
 
 TicketHolder::TicketHolder(int num) : _outof(num) {
@@ -86,45 +81,34 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+bool TicketHolder::_takeTicket(WithLock) {
+    return tryAcquire();
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
-        }
-
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
+void TicketHolder::_retireOrPostTicket() {
+    int toRetire = _toRetire.load();
+    while (toRetire > 0) {
+        const int prev = _toRetire.compareAndSwap(toRetire, toRetire - 1);
+        if (prev == toRetire)
+            return;
+        toRetire = prev;
     }
-    return true;
-}
 
-void TicketHolder::release() {
     check(sem_post(&_sem));
 }
 
+void TicketHolder::_returnTicket() {
+    _retireOrPostTicket();
+
+    // A waiter publishes itself in _numQueued before it tries to take a ticket under _mutex, so
+    // either it sees this ticket or we see it.
+    if (_numQueued.load() == 0)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _dispatch(lk);
+}
+
 Status TicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
 
@@ -138,13 +122,23 @@ Status TicketHolder::resize(int newSize) {
                                     << "; given "
                                     << newSize);
 
+    // Growing first cancels the retirement of tickets still held since an earlier shrink.
     while (_outof.load() < newSize) {
-        release();
+        const int toRetire = _toRetire.load();
+        if (toRetire > 0) {
+            if (_toRetire.compareAndSwap(toRetire, toRetire - 1) != toRetire)
+                continue;
+        } else {
+            _returnTicket();
+        }
         _outof.fetchAndAdd(1);
     }
 
+    // Shrinking takes the free tickets and retires the others as they are released, rather than
+    // waiting for them behind the queued callers.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        if (!tryAcquire())
+            _toRetire.addAndFetch(1);
         _outof.subtractAndFetch(1);
     }
 
@@ -158,12 +152,8 @@ int TicketHolder::available() const {
     return val;
 }
 
-int TicketHolder::used() const {
-    return outof() - available();
-}
-
-int TicketHolder::outof() const {
-    return _outof.load();
+int TicketHolder::_pendingRetirements() const {
+    return _toRetire.load();
 }
 
 #else
@@ -177,79 +167,183 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
-    }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
-    }
+bool TicketHolder::_takeTicket(WithLock) {
+    return _tryAcquire();
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _num++;
-    }
-    _newTicket.notify_one();
+void TicketHolder::_returnTicket() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _num++;
+    _dispatch(lk);
 }
 
 Status TicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
+    // When shrinking below the tickets in use, _num goes negative and the tickets are retired as
+    // they are released.
     int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
     _outof.store(newSize);
     _num = _outof.load() - used;
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    _dispatch(lk);
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    return _num;
-}
-
-int TicketHolder::used() const {
-    return outof() - _num;
+    return std::max(_num, 0);
 }
 
-int TicketHolder::outof() const {
-    return _outof.load();
+int TicketHolder::_pendingRetirements() const {
+    return std::max(-_num, 0);
 }
 
 bool TicketHolder::_tryAcquire() {
     if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
         return false;
     }
     _num--;
     return true;
 }
 #endif
+
+void TicketHolder::waitForTicket(OperationContext* opCtx) {
+    waitForTicketUntil(opCtx, Date_t::max());
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    return _waitForTicketUntil(
+        opCtx, opCtx ? opCtx->getAdmissionPriority() : AdmissionPriority::kNormal, until);
+}
+
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                       AdmissionPriority priority,
+                                       Date_t until) {
+    // Only take a ticket directly when nobody is queued ahead of us.
+    if (_numQueued.load() == 0 && tryAcquire())
+        return true;
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Waiter waiter(priority, Date_t::now());
+    auto& queue = _queues[static_cast<int>(priority)];
+    waiter.position = queue.insert(queue.end(), &waiter);
+    _numQueued.addAndFetch(1);
+    ++_queueStats[static_cast<int>(priority)].queued;
+
+    // A ticket may have been returned before we were queued.
+    _dispatch(lk);
+
+    const auto hasTicket = [&] { return waiter.hasTicket; };
+    bool acquired;
+    try {
+        if (opCtx) {
+            acquired =
+                opCtx->waitForConditionOrInterruptUntil(waiter.granted, lk, until, hasTicket);
+        } else if (until == Date_t::max()) {
+            waiter.granted.wait(lk, hasTicket);
+            acquired = true;
+        } else {
+            acquired = waiter.granted.wait_until(lk, until.toSystemTimePoint(), hasTicket);
+        }
+    } catch (...) {
+        _abandon(lk, &waiter);
+        throw;
+    }
+
+    if (!acquired)
+        _abandon(lk, &waiter);
+    return acquired;
+}
+
+void TicketHolder::_dispatch(WithLock lk) {
+    if (_numQueued.load() == 0)
+        return;
+
+    const Date_t now = Date_t::now();
+    while (_numQueued.load() > 0 && _takeTicket(lk)) {
+        Waiter* waiter = _nextWaiter(lk, now);
+        auto& stats = _queueStats[static_cast<int>(waiter->priority)];
+        _queues[static_cast<int>(waiter->priority)].erase(waiter->position);
+        _numQueued.subtractAndFetch(1);
+        ++stats.admitted;
+        stats.timeQueued += now - waiter->enqueued;
+
+        waiter->hasTicket = true;
+        waiter->granted.notify_one();
+    }
+}
+
+TicketHolder::Waiter* TicketHolder::_nextWaiter(WithLock, Date_t now) const {
+    Waiter* next = nullptr;
+    Milliseconds nextScore{0};
+    // Ties go to the higher priority, which is visited first.
+    for (int i = kNumAdmissionPriorities - 1; i >= 0; --i) {
+        if (_queues[i].empty())
+            continue;
+        Waiter* head = _queues[i].front();
+        const Milliseconds score = (now - head->enqueued) + kPriorityAgingInterval * i;
+        if (!next || score > nextScore) {
+            next = head;
+            nextScore = score;
+        }
+    }
+    invariant(next);
+    return next;
+}
+
+void TicketHolder::_abandon(WithLock lk, Waiter* waiter) {
+    if (!waiter->hasTicket) {
+        _queues[static_cast<int>(waiter->priority)].erase(waiter->position);
+        _numQueued.subtractAndFetch(1);
+        return;
+    }
+
+#if defined(__linux__)
+    _retireOrPostTicket();
+#else
+    _num++;
+#endif
+    _dispatch(lk);
+}
+
+void TicketHolder::release() {
+    _released.addAndFetch(1);
+    _returnTicket();
+}
+
+int TicketHolder::used() const {
+    return outof() + _pendingRetirements() - available();
+}
+
+int TicketHolder::outof() const {
+    return _outof.load();
+}
+
+int TicketHolder::waiting() const {
+    return _numQueued.load();
+}
+
+int TicketHolder::waiting(AdmissionPriority priority) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _queues[static_cast<int>(priority)].size();
+}
+
+long long TicketHolder::totalReleased() const {
+    return _released.load();
+}
+
+void TicketHolder::appendQueueStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    BSONObjBuilder queues(builder->subobjStart("queues"));
+    for (int i = 0; i < kNumAdmissionPriorities; ++i) {
+        const auto& stats = _queueStats[i];
+        BSONObjBuilder bob(queues.subobjStart(toString(static_cast<AdmissionPriority>(i))));
+        bob.append("waiting", static_cast<int>(_queues[i].size()));
+        bob.append("totalQueued", stats.queued);
+        bob.append("totalAdmitted", stats.admitted);
+        bob.append("totalTimeQueuedMillis", durationCount<Milliseconds>(stats.timeQueued));
+        bob.done();
+    }
+    queues.done();
 }
+}  // namespace mongo
@@ -30,15 +30,31 @@
 #include <semaphore.h>
 #endif
 
+#include <list>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * A counting semaphore for storage engine tickets.
+ *
+ * Callers that cannot get a ticket right away queue by the admission priority of their operation.
+ * Released tickets are handed directly to the queued waiter with the highest priority, and while
+ * anyone is queued new callers cannot take a ticket ahead of them. Each priority class counts as
+ * kPriorityAgingInterval of waiting time, so a waiter overtakes the waiters of the class above its
+ * own once it has been queued that much longer than them.
+ */
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
@@ -48,10 +64,14 @@ public:
 
     bool tryAcquire();
 
+    static const Milliseconds kPriorityAgingInterval;
+
     /**
      * Attempts to acquire a ticket. Blocks until a ticket is acquired or the OperationContext
-     * 'opCtx' is killed, throwing an AssertionException.
-     * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
+     * 'opCtx' is killed, throwing an AssertionException. The wait is queued with the admission
+     * priority of 'opCtx'.
+     * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible and has normal
+     * priority.
      */
     void waitForTicket(OperationContext* opCtx);
     void waitForTicket() {
@@ -69,8 +89,21 @@ public:
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
+
+    /**
+     * Like waitForTicketUntil() without an OperationContext, but queues with 'priority'.
+     */
+    bool waitForTicketUntil(AdmissionPriority priority, Date_t until) {
+        return _waitForTicketUntil(nullptr, priority, until);
+    }
+
     void release();
 
+    /**
+     * Changes the number of tickets to 'newSize' without blocking. When shrinking below the number
+     * of tickets in use, the excess tickets are retired as they are released, so used() can exceed
+     * outof() until then.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -79,20 +112,103 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of callers currently queued for a ticket, in total or with 'priority'.
+     */
+    int waiting() const;
+    int waiting(AdmissionPriority priority) const;
+
+    /**
+     * Returns the number of tickets released since construction. Tickets added by resize() are
+     * not counted, so the difference between two readings is the number of completed holds.
+     */
+    long long totalReleased() const;
+
+    /**
+     * Appends, per admission priority, the number of callers queued now, the number that have
+     * queued and been admitted in total, and the total time they spent queued.
+     */
+    void appendQueueStats(BSONObjBuilder* builder) const;
+
 private:
+    struct Waiter {
+        Waiter(AdmissionPriority priority, Date_t enqueued)
+            : priority(priority), enqueued(enqueued) {}
+
+        const AdmissionPriority priority;
+        const Date_t enqueued;
+        std::list<Waiter*>::iterator position;
+        stdx::condition_variable granted;
+        bool hasTicket = false;
+    };
+
+    struct QueueStats {
+        long long queued = 0;
+        long long admitted = 0;
+        Milliseconds timeQueued{0};
+    };
+
+    bool _waitForTicketUntil(OperationContext* opCtx, AdmissionPriority priority, Date_t until);
+
+    /**
+     * Takes a free ticket without queueing, or returns false if there is none.
+     */
+    bool _takeTicket(WithLock);
+
+    /**
+     * Returns a ticket to the free pool and hands free tickets to queued waiters.
+     */
+    void _returnTicket();
+
+    /**
+     * Hands free tickets to queued waiters in priority order until either runs out.
+     */
+    void _dispatch(WithLock);
+
+    Waiter* _nextWaiter(WithLock, Date_t now) const;
+
+    /**
+     * Removes a waiter whose wait ended without a ticket, or passes on the ticket it was handed
+     * as the wait was ending.
+     */
+    void _abandon(WithLock, Waiter* waiter);
+
+    /**
+     * Returns the number of tickets in use that a shrinking resize() retires when released.
+     */
+    int _pendingRetirements() const;
+
+    AtomicInt64 _released;
+
+    // Only changed with _mutex held, but read without it to skip the queue when it is empty.
+    AtomicInt32 _numQueued;
+
+    // Protects the queues and their statistics, as well as _num where semaphores are not used.
+    mutable stdx::mutex _mutex;
+    std::list<Waiter*> _queues[kNumAdmissionPriorities];
+    QueueStats _queueStats[kNumAdmissionPriorities];
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
     AtomicInt32 _outof;
     stdx::mutex _resizeMutex;
+
+    // Tickets in use to retire instead of returning them. Only increased under _resizeMutex.
+    AtomicInt32 _toRetire;
+
+    /**
+     * Retires a released ticket if a shrinking resize() is pending, or otherwise posts it back to
+     * the semaphore. Does not hand it to queued waiters, so it is safe to call with _mutex held.
+     */
+    void _retireOrPostTicket();
 #else
     bool _tryAcquire();
 
     AtomicInt32 _outof;
+    // Negative while tickets in use are waiting to be retired after a shrinking resize().
     int _num;
-    stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
 #endif
 };
 
@@ -31,12 +31,22 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
 
+void waitUntilQueued(const TicketHolder& holder, AdmissionPriority priority, int count) {
+    while (holder.waiting(priority) != count) {
+        sleepmillis(1);
+    }
+}
+
 TEST(TicketholderTest, BasicTimeout) {
     TicketHolder holder(1);
     ASSERT_EQ(holder.used(), 0);
@@ -71,4 +81,136 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, CountsReleasedTicketsButNotResizes) {
+    TicketHolder holder(5);
+    ASSERT_EQ(holder.totalReleased(), 0);
+
+    ASSERT(holder.tryAcquire());
+    ASSERT(holder.waitForTicketUntil(Date_t::now()));
+    holder.release();
+    holder.release();
+    ASSERT_EQ(holder.totalReleased(), 2);
+
+    ASSERT_OK(holder.resize(6));
+    ASSERT_EQ(holder.outof(), 6);
+    ASSERT_EQ(holder.totalReleased(), 2);
+}
+
+TEST(TicketholderTest, ShrinkingBelowTicketsInUseDoesNotBlock) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.outof(), 5);
+    ASSERT_EQ(holder.used(), 8);
+    ASSERT_EQ(holder.available(), 0);
+
+    // The first three tickets released are retired.
+    for (int i = 0; i < 3; i++) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.used(), 5);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 4);
+    ASSERT_EQ(holder.available(), 1);
+}
+
+TEST(TicketholderTest, GrowingCancelsPendingRetirements) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 10; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(6));
+    ASSERT_OK(holder.resize(8));
+    ASSERT_EQ(holder.outof(), 8);
+    ASSERT_EQ(holder.used(), 10);
+    ASSERT_EQ(holder.available(), 0);
+
+    ASSERT_OK(holder.resize(12));
+    ASSERT_EQ(holder.used(), 10);
+    ASSERT_EQ(holder.available(), 2);
+
+    for (int i = 0; i < 10; i++) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.available(), 12);
+}
+
+TEST(TicketholderTest, WaitingCountIsClearedAfterTimeout) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+    ASSERT_EQ(holder.waiting(), 0);
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    ASSERT_EQ(holder.waiting(), 0);
+    for (int i = 0; i < 5; ++i) {
+        holder.release();
+    }
+}
+
+TEST(TicketholderTest, HigherPriorityWaiterIsAdmittedFirst) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    stdx::thread low([&] { holder.waitForTicketUntil(AdmissionPriority::kLow, Date_t::max()); });
+    waitUntilQueued(holder, AdmissionPriority::kLow, 1);
+    stdx::thread high([&] { holder.waitForTicketUntil(AdmissionPriority::kHigh, Date_t::max()); });
+    waitUntilQueued(holder, AdmissionPriority::kHigh, 1);
+
+    // Nobody can take a ticket ahead of the queue.
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+    high.join();
+    ASSERT_EQ(holder.waiting(AdmissionPriority::kLow), 1);
+
+    holder.release();
+    low.join();
+    ASSERT_EQ(holder.waiting(), 0);
+
+    BSONObjBuilder bob;
+    holder.appendQueueStats(&bob);
+    const BSONObj queues = bob.obj()["queues"].Obj();
+    ASSERT_EQ(queues["high"]["totalAdmitted"].numberLong(), 1);
+    ASSERT_EQ(queues["low"]["totalAdmitted"].numberLong(), 1);
+    ASSERT_EQ(queues["normal"]["totalQueued"].numberLong(), 0);
+
+    for (int i = 0; i < 5; ++i) {
+        holder.release();
+    }
+}
+
+TEST(TicketholderTest, LowPriorityWaiterAgesPastHigherPriority) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    stdx::thread low([&] { holder.waitForTicketUntil(AdmissionPriority::kLow, Date_t::max()); });
+    waitUntilQueued(holder, AdmissionPriority::kLow, 1);
+    sleepFor(TicketHolder::kPriorityAgingInterval * 3);
+    stdx::thread high([&] { holder.waitForTicketUntil(AdmissionPriority::kHigh, Date_t::max()); });
+    waitUntilQueued(holder, AdmissionPriority::kHigh, 1);
+
+    holder.release();
+    low.join();
+    ASSERT_EQ(holder.waiting(AdmissionPriority::kHigh), 1);
+
+    holder.release();
+    high.join();
+
+    for (int i = 0; i < 5; ++i) {
+        holder.release();
+    }
+}
 }  // namespace
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/latency_histogram.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+int LatencyHistogram::_getBucket(uint64_t micros) {
+    // Bucket 0 holds [0, 2), and bucket n > 0 holds [2^n, 2^(n+1)).
+    if (micros < 2) {
+        return 0;
+    }
+    return 63 - countLeadingZeros64(micros);
+}
+
+uint64_t LatencyHistogram::getBucketLowerBound(Microseconds latency) {
+    const int bucket = _getBucket(std::max<int64_t>(durationCount<Microseconds>(latency), 0));
+    return bucket == 0 ? 0 : (1ULL << bucket);
+}
+
+void LatencyHistogram::increment(Microseconds latency) {
+    const uint64_t micros = std::max<int64_t>(durationCount<Microseconds>(latency), 0);
+    _buckets[_getBucket(micros)].fetchAndAdd(1);
+    _sum.fetchAndAdd(micros);
+    _count.fetchAndAdd(1);
+}
+
+void LatencyHistogram::append(StringData key,
+                              bool includeHistogram,
+                              BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(key));
+    if (includeHistogram) {
+        BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+        for (int i = 0; i < kMaxBuckets; i++) {
+            const uint64_t count = _buckets[i].load();
+            if (count == 0)
+                continue;
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", static_cast<long long>(i == 0 ? 0 : (1ULL << i)));
+            entryBuilder.append("count", static_cast<long long>(count));
+            entryBuilder.doneFast();
+        }
+        arrayBuilder.doneFast();
+    }
+    histogramBuilder.append("latency", static_cast<long long>(_sum.load()));
+    histogramBuilder.append("ops", static_cast<long long>(_count.load()));
+    histogramBuilder.doneFast();
+}
+
+}  // namespace mongo
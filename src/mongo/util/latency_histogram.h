@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A fixed-size histogram of latencies in microseconds, bucketed by powers of two.
+ *
+ * Unlike OperationLatencyHistogram, this class is thread-safe: increment() may be called
+ * concurrently with other calls to increment() and append(). Reported values may be mutually
+ * inconsistent by the few increments that race with an append(), which is acceptable for
+ * serverStatus reporting.
+ */
+class LatencyHistogram {
+    MONGO_DISALLOW_COPYING(LatencyHistogram);
+
+public:
+    static constexpr int kMaxBuckets = 64;
+
+    LatencyHistogram() = default;
+
+    /**
+     * Records one observation of 'latency'.
+     */
+    void increment(Microseconds latency);
+
+    /**
+     * Appends a document of the form {histogram: [{micros, count}, ...], latency, ops} to
+     * 'builder' under 'key'. Buckets with a count of zero are omitted. The histogram array is only
+     * appended if 'includeHistogram' is true.
+     */
+    void append(StringData key, bool includeHistogram, BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the total number of observations recorded.
+     */
+    uint64_t getCount() const {
+        return _count.load();
+    }
+
+    /**
+     * Returns the inclusive lower bound, in microseconds, of the bucket 'latency' falls into.
+     */
+    static uint64_t getBucketLowerBound(Microseconds latency);
+
+private:
+    static int _getBucket(uint64_t micros);
+
+    std::array<AtomicUInt64, kMaxBuckets> _buckets;
+    AtomicUInt64 _count;
+    AtomicUInt64 _sum;
+};
+
+}  // namespace mongo
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/latency_histogram.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(LatencyHistogram, BucketLowerBounds) {
+    ASSERT_EQUALS(0U, LatencyHistogram::getBucketLowerBound(Microseconds(0)));
+    ASSERT_EQUALS(0U, LatencyHistogram::getBucketLowerBound(Microseconds(1)));
+    ASSERT_EQUALS(2U, LatencyHistogram::getBucketLowerBound(Microseconds(2)));
+    ASSERT_EQUALS(2U, LatencyHistogram::getBucketLowerBound(Microseconds(3)));
+    ASSERT_EQUALS(1024U, LatencyHistogram::getBucketLowerBound(Microseconds(1500)));
+    ASSERT_EQUALS(0U, LatencyHistogram::getBucketLowerBound(Microseconds(-5)));
+}
+
+TEST(LatencyHistogram, AppendReportsCountsAndTotalLatency) {
+    LatencyHistogram hist;
+    hist.increment(Microseconds(1));
+    hist.increment(Microseconds(3));
+    hist.increment(Milliseconds(2));
+    hist.increment(Milliseconds(3));
+    ASSERT_EQUALS(4U, hist.getCount());
+
+    BSONObjBuilder outBuilder;
+    hist.append("waits", true, &outBuilder);
+    BSONObj out = outBuilder.obj();
+
+    ASSERT_EQUALS(out["waits"]["ops"].Long(), 4);
+    ASSERT_EQUALS(out["waits"]["latency"].Long(), 1 + 3 + 2000 + 3000);
+
+    // 2000 micros falls into [1024, 2048) and 3000 micros into [2048, 4096).
+    std::vector<BSONElement> buckets = out["waits"]["histogram"].Array();
+    ASSERT_EQUALS(4U, buckets.size());
+    ASSERT_BSONOBJ_EQ(buckets[0].Obj(), BSON("micros" << 0LL << "count" << 1LL));
+    ASSERT_BSONOBJ_EQ(buckets[1].Obj(), BSON("micros" << 2LL << "count" << 1LL));
+    ASSERT_BSONOBJ_EQ(buckets[2].Obj(), BSON("micros" << 1024LL << "count" << 1LL));
+    ASSERT_BSONOBJ_EQ(buckets[3].Obj(), BSON("micros" << 2048LL << "count" << 1LL));
+}
+
+TEST(LatencyHistogram, AppendWithoutHistogram) {
+    LatencyHistogram hist;
+    hist.increment(Microseconds(10));
+
+    BSONObjBuilder outBuilder;
+    hist.append("waits", false, &outBuilder);
+    BSONObj out = outBuilder.obj();
+
+    ASSERT_FALSE(out["waits"].Obj().hasField("histogram"));
+    ASSERT_EQUALS(out["waits"]["ops"].Long(), 1);
+}
+
+}  // namespace
+}  // namespace mongo
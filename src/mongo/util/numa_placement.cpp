@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+// Spreads service worker threads and oplog writer threads over the NUMA nodes of the machine and
+// binds each of them to its node's CPUs.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaAwarePlacement, bool, false);
+
+// Only the first failure to bind a thread is logged as a warning, since every new connection
+// thread would otherwise log the same one.
+AtomicWord<bool> bindFailureLogged{false};
+
+NumaPlacement* makeMachinePlacement() {
+    auto topology = getNumaTopology();
+    auto allowedCpus = getCurrentThreadCpus();
+    if (!allowedCpus) {
+        allowedCpus.emplace();
+        for (auto&& node : topology) {
+            allowedCpus->insert(allowedCpus->end(), node.cpus.begin(), node.cpus.end());
+        }
+    }
+
+    auto placement = new NumaPlacement(topology, *allowedCpus);
+    if (numaAwarePlacement) {
+        if (placement->nodes().empty()) {
+            warning() << "Not placing threads on NUMA nodes, since none of the CPUs this process "
+                         "may run on belong to a NUMA node";
+        } else if (placement->nodes().size() < topology.size()) {
+            log() << "Placing threads on " << placement->nodes().size() << " of the "
+                  << topology.size() << " NUMA nodes, since the CPU affinity of this process "
+                  << "excludes the others";
+        }
+    }
+    return placement;
+}
+
+/**
+ * Keeps the calling thread counted against the node it was bound to until the thread exits.
+ */
+class ThreadBinding {
+public:
+    ~ThreadBinding() {
+        if (_node) {
+            _node->boundThreads.subtractAndFetch(1);
+        }
+    }
+
+    void set(NumaPlacement::Node* node) {
+        if (_node) {
+            _node->boundThreads.subtractAndFetch(1);
+        }
+        _node = node;
+        _node->boundThreads.addAndFetch(1);
+    }
+
+private:
+    NumaPlacement::Node* _node = nullptr;
+};
+
+thread_local ThreadBinding threadBinding;
+
+class NumaServerStatusSection final : public ServerStatusSection {
+public:
+    NumaServerStatusSection() : ServerStatusSection("numa") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder section;
+        section.append("placementEnabled", numaAwarePlacement);
+
+        BSONArrayBuilder nodes(section.subarrayStart("nodes"));
+        for (auto&& node : NumaPlacement::get().nodes()) {
+            BSONObjBuilder nodeBuilder(nodes.subobjStart());
+            nodeBuilder.append("id", node->node.id);
+            nodeBuilder.append("cpus", static_cast<int>(node->node.cpus.size()));
+            nodeBuilder.append("boundThreads", node->boundThreads.load());
+        }
+        nodes.doneFast();
+        return section.obj();
+    }
+} numaServerStatusSection;
+
+}  // namespace
+
+// Reads the process's CPU affinity from the main thread before any thread has been bound.
+MONGO_INITIALIZER_WITH_PREREQUISITES(NumaPlacementInit, ("EndStartupOptionStorage"))
+(InitializerContext*) {
+    NumaPlacement::get();
+    return Status::OK();
+}
+
+NumaPlacement::NumaPlacement(std::vector<NumaNode> topology,
+                             const std::vector<int>& allowedCpus) {
+    for (auto&& node : restrictNumaTopology(std::move(topology), allowedCpus)) {
+        _nodes.emplace_back(stdx::make_unique<Node>(std::move(node)));
+    }
+}
+
+NumaPlacement& NumaPlacement::get() {
+    static NumaPlacement* placement = makeMachinePlacement();
+    return *placement;
+}
+
+NumaPlacement::Node* NumaPlacement::nextNode() {
+    if (_nodes.empty()) {
+        return nullptr;
+    }
+    return _nodes[_nextNode.fetchAndAdd(1) % _nodes.size()].get();
+}
+
+bool isNumaAwarePlacementEnabled() {
+    return numaAwarePlacement;
+}
+
+boost::optional<int> bindCurrentThreadToNextNumaNode() {
+    if (!numaAwarePlacement) {
+        return boost::none;
+    }
+
+    auto node = NumaPlacement::get().nextNode();
+    if (!node) {
+        return boost::none;
+    }
+
+    auto status = bindCurrentThreadToNumaNode(node->node);
+    if (!status.isOK()) {
+        if (!bindFailureLogged.swap(true)) {
+            warning() << "Failed to bind thread to NUMA node " << node->node.id << ": " << status;
+        } else {
+            LOG(1) << "Failed to bind thread to NUMA node " << node->node.id << ": " << status;
+        }
+        return boost::none;
+    }
+
+    threadBinding.set(node);
+    return node->node.id;
+}
+
+}  // namespace mongo
@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/numa_topology.h"
+
+namespace mongo {
+
+/**
+ * Returns whether threads are spread over and bound to NUMA nodes, as configured by the
+ * numaAwarePlacement startup parameter.
+ */
+bool isNumaAwarePlacementEnabled();
+
+/**
+ * If NUMA-aware placement is enabled, binds the calling thread to the CPUs of the next NUMA node,
+ * in round-robin order, and returns that node's id. Returns boost::none if placement is disabled
+ * or binding fails.
+ *
+ * Threads should call this before they allocate anything, so that under the default first-touch
+ * memory policy their stacks and per-thread allocator caches come from their own node's memory.
+ * A thread is counted against its node in serverStatus until it exits.
+ */
+boost::optional<int> bindCurrentThreadToNextNumaNode();
+
+/**
+ * The NUMA nodes threads are spread over, in round-robin order, and how many threads are bound
+ * to each. Only the CPUs the process may run on take part, so that binding a thread never widens
+ * a restriction placed by taskset, numactl or a cgroup cpuset; nodes left without CPUs are skipped.
+ */
+class NumaPlacement {
+    MONGO_DISALLOW_COPYING(NumaPlacement);
+
+public:
+    struct Node {
+        explicit Node(NumaNode node) : node(std::move(node)) {}
+
+        const NumaNode node;
+        AtomicInt64 boundThreads;
+    };
+
+    NumaPlacement(std::vector<NumaNode> topology, const std::vector<int>& allowedCpus);
+
+    /**
+     * Returns the placement built at startup from this machine's topology and the process's CPU
+     * affinity.
+     */
+    static NumaPlacement& get();
+
+    /**
+     * Returns the node the next thread should be bound to, or nullptr if no node has a CPU the
+     * process may run on.
+     */
+    Node* nextNode();
+
+    const std::vector<std::unique_ptr<Node>>& nodes() const {
+        return _nodes;
+    }
+
+private:
+    std::vector<std::unique_ptr<Node>> _nodes;
+    AtomicUInt64 _nextNode;
+};
+
+}  // namespace mongo
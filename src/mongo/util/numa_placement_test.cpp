@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<NumaNode> makeTopology(int numNodes, int cpusPerNode) {
+    std::vector<NumaNode> nodes(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        nodes[i].id = i;
+        for (int cpu = 0; cpu < cpusPerNode; ++cpu) {
+            nodes[i].cpus.push_back(i * cpusPerNode + cpu);
+        }
+    }
+    return nodes;
+}
+
+TEST(NumaPlacement, HandsOutNodesRoundRobin) {
+    NumaPlacement placement(makeTopology(3, 2), {0, 1, 2, 3, 4, 5});
+    ASSERT_EQ(3U, placement.nodes().size());
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_EQ(i % 3, placement.nextNode()->node.id);
+    }
+}
+
+TEST(NumaPlacement, SkipsNodesOutsideTheAffinity) {
+    // As if started under "taskset -c 1,4".
+    NumaPlacement placement(makeTopology(3, 2), {1, 4});
+    ASSERT_EQ(2U, placement.nodes().size());
+
+    auto first = placement.nextNode();
+    ASSERT_EQ(0, first->node.id);
+    ASSERT(std::vector<int>({1}) == first->node.cpus);
+
+    auto second = placement.nextNode();
+    ASSERT_EQ(2, second->node.id);
+    ASSERT(std::vector<int>({4}) == second->node.cpus);
+
+    ASSERT_EQ(first, placement.nextNode());
+}
+
+TEST(NumaPlacement, NoNodeWithoutAllowedCpus) {
+    NumaPlacement placement(makeTopology(2, 2), {});
+    ASSERT(placement.nodes().empty());
+    ASSERT(placement.nextNode() == nullptr);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+#include "mongo/stdx/thread.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+NumaNode makeSingleNode() {
+    NumaNode node;
+    const auto numCpus = std::max(1u, stdx::thread::hardware_concurrency());
+    for (unsigned cpu = 0; cpu < numCpus; ++cpu) {
+        node.cpus.push_back(static_cast<int>(cpu));
+    }
+    return node;
+}
+
+StatusWith<int> parseCpuNumber(StringData str) {
+    if (str.empty() || str.size() > 9 ||
+        !std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "invalid CPU number '" << str << "' in cpulist");
+    }
+    return std::stoi(str.toString());
+}
+
+}  // namespace
+
+StatusWith<std::vector<int>> parseCpuList(StringData cpuList) {
+    std::vector<int> cpus;
+    while (!cpuList.empty()) {
+        auto comma = cpuList.find(',');
+        auto range = cpuList.substr(0, comma);
+        cpuList = comma == std::string::npos ? StringData() : cpuList.substr(comma + 1);
+
+        auto dash = range.find('-');
+        auto swFirst = parseCpuNumber(range.substr(0, dash));
+        if (!swFirst.isOK()) {
+            return swFirst.getStatus();
+        }
+        int last = swFirst.getValue();
+        if (dash != std::string::npos) {
+            auto swLast = parseCpuNumber(range.substr(dash + 1));
+            if (!swLast.isOK()) {
+                return swLast.getStatus();
+            }
+            last = swLast.getValue();
+            if (last < swFirst.getValue()) {
+                return Status(ErrorCodes::FailedToParse,
+                              str::stream() << "invalid CPU range '" << range << "' in cpulist");
+            }
+        }
+        for (int cpu = swFirst.getValue(); cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return {std::move(cpus)};
+}
+
+std::vector<NumaNode> getNumaTopology() {
+    return getNumaTopology("/sys/devices/system/node");
+}
+
+std::vector<NumaNode> getNumaTopology(const std::string& nodeDir) {
+    std::vector<NumaNode> nodes;
+#ifdef __linux__
+    if (auto dir = ::opendir(nodeDir.c_str())) {
+        while (auto entry = ::readdir(dir)) {
+            StringData name(entry->d_name);
+            if (!name.startsWith("node") || !parseCpuNumber(name.substr(4)).isOK()) {
+                continue;
+            }
+
+            std::ifstream cpuListFile(nodeDir + "/" + name.toString() + "/cpulist");
+            std::string cpuList;
+            if (!std::getline(cpuListFile, cpuList)) {
+                continue;
+            }
+            auto swCpus = parseCpuList(cpuList);
+            if (!swCpus.isOK() || swCpus.getValue().empty()) {
+                continue;
+            }
+
+            NumaNode node;
+            node.id = parseCpuNumber(name.substr(4)).getValue();
+            node.cpus = std::move(swCpus.getValue());
+            nodes.push_back(std::move(node));
+        }
+        ::closedir(dir);
+    }
+#endif
+
+    if (nodes.empty()) {
+        nodes.push_back(makeSingleNode());
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) {
+        return a.id < b.id;
+    });
+    return nodes;
+}
+
+std::vector<NumaNode> restrictNumaTopology(std::vector<NumaNode> nodes,
+                                           const std::vector<int>& allowedCpus) {
+    std::vector<NumaNode> restricted;
+    for (auto&& node : nodes) {
+        auto notAllowed = [&](int cpu) {
+            return std::find(allowedCpus.begin(), allowedCpus.end(), cpu) == allowedCpus.end();
+        };
+        node.cpus.erase(std::remove_if(node.cpus.begin(), node.cpus.end(), notAllowed),
+                        node.cpus.end());
+        if (!node.cpus.empty()) {
+            restricted.push_back(std::move(node));
+        }
+    }
+    return restricted;
+}
+
+boost::optional<std::vector<int>> getCurrentThreadCpus() {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (::sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        return boost::none;
+    }
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuSet)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+#else
+    return boost::none;
+#endif
+}
+
+Status bindCurrentThreadToNumaNode(const NumaNode& node) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : node.cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    if (::sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "failed to bind thread to NUMA node " << node.id << ": "
+                                    << errnoWithDescription());
+    }
+#endif
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A NUMA node and the CPUs that belong to it.
+ */
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+/**
+ * Returns the NUMA nodes of this machine which have CPUs, ordered by node id. Machines without
+ * NUMA, or platforms where the topology can't be discovered, report a single node 0 holding every
+ * CPU.
+ */
+std::vector<NumaNode> getNumaTopology();
+
+/**
+ * Like getNumaTopology(), but reads the node directories from 'nodeDir' instead of
+ * /sys/devices/system/node. Exposed for testing.
+ */
+std::vector<NumaNode> getNumaTopology(const std::string& nodeDir);
+
+/**
+ * Returns 'nodes' with the CPUs of each node limited to 'allowedCpus', leaving out the nodes which
+ * have none of them.
+ */
+std::vector<NumaNode> restrictNumaTopology(std::vector<NumaNode> nodes,
+                                           const std::vector<int>& allowedCpus);
+
+/**
+ * Returns the CPUs the calling thread may run on, which reflects taskset, numactl and cgroup
+ * cpusets. Returns boost::none on platforms without thread affinity support.
+ */
+boost::optional<std::vector<int>> getCurrentThreadCpus();
+
+/**
+ * Parses a Linux cpulist string such as "0-3,8,10-11" into the list of CPUs it names.
+ */
+StatusWith<std::vector<int>> parseCpuList(StringData cpuList);
+
+/**
+ * Restricts the calling thread to run only on the CPUs of the given node. This is a no-op
+ * returning OK on platforms without thread affinity support.
+ */
+Status bindCurrentThreadToNumaNode(const NumaNode& node);
+
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_topology.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+void writeNode(const unittest::TempDir& nodeDir, const std::string& name, const std::string& cpus) {
+    const auto dir = boost::filesystem::path(nodeDir.path()) / name;
+    boost::filesystem::create_directory(dir);
+    std::ofstream((dir / "cpulist").string()) << cpus << "\n";
+}
+
+TEST(NumaTopology, ParseCpuList) {
+    ASSERT(std::vector<int>({0}) == parseCpuList("0").getValue());
+    ASSERT(std::vector<int>({0, 1, 2, 3}) == parseCpuList("0-3").getValue());
+    ASSERT(std::vector<int>({0, 1, 8, 10, 11}) == parseCpuList("0-1,8,10-11").getValue());
+    ASSERT(std::vector<int>() == parseCpuList("").getValue());
+}
+
+TEST(NumaTopology, ParseCpuListRejectsGarbage) {
+    ASSERT_EQ(ErrorCodes::FailedToParse, parseCpuList("a").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, parseCpuList("3-1").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, parseCpuList("1,,2").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, parseCpuList("-1").getStatus());
+}
+
+TEST(NumaTopology, ReadsNodeDirectories) {
+    unittest::TempDir nodeDir("numa_topology_test");
+    writeNode(nodeDir, "node0", "0-1");
+    writeNode(nodeDir, "node10", "4");
+    writeNode(nodeDir, "node2", "2,3");
+    writeNode(nodeDir, "node3", "");  // A node with memory but no CPUs.
+    writeNode(nodeDir, "nodex", "5");
+    writeNode(nodeDir, "power", "6");
+
+    auto nodes = getNumaTopology(nodeDir.path());
+    ASSERT_EQ(3U, nodes.size());
+    ASSERT_EQ(0, nodes[0].id);
+    ASSERT(std::vector<int>({0, 1}) == nodes[0].cpus);
+    ASSERT_EQ(2, nodes[1].id);
+    ASSERT(std::vector<int>({2, 3}) == nodes[1].cpus);
+    ASSERT_EQ(10, nodes[2].id);
+    ASSERT(std::vector<int>({4}) == nodes[2].cpus);
+}
+
+TEST(NumaTopology, MissingNodeDirectoryReportsSingleNode) {
+    unittest::TempDir nodeDir("numa_topology_test");
+    auto nodes = getNumaTopology(nodeDir.path() + "/missing");
+    ASSERT_EQ(1U, nodes.size());
+    ASSERT_EQ(0, nodes[0].id);
+    ASSERT_FALSE(nodes[0].cpus.empty());
+}
+
+TEST(NumaTopology, RestrictKeepsOnlyAllowedCpus) {
+    std::vector<NumaNode> nodes(3);
+    for (int i = 0; i < 3; ++i) {
+        nodes[i].id = i;
+        nodes[i].cpus = {2 * i, 2 * i + 1};
+    }
+
+    auto restricted = restrictNumaTopology(nodes, {1, 4, 5});
+    ASSERT_EQ(2U, restricted.size());
+    ASSERT_EQ(0, restricted[0].id);
+    ASSERT(std::vector<int>({1}) == restricted[0].cpus);
+    ASSERT_EQ(2, restricted[1].id);
+    ASSERT(std::vector<int>({4, 5}) == restricted[1].cpus);
+
+    ASSERT(restrictNumaTopology(nodes, {}).empty());
+}
+
+TEST(NumaTopology, EveryNodeHasCpus) {
+    auto nodes = getNumaTopology();
+    ASSERT_FALSE(nodes.empty());
+    for (auto&& node : nodes) {
+        ASSERT_FALSE(node.cpus.empty());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
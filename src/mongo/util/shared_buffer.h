@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <cstring>
 
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -51,6 +54,21 @@ public:
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes), bytes);
     }
 
+    /**
+     * Like allocate(), but takes the memory from the calling thread's SharedBufferPool. The
+     * capacity is rounded up to the pool's size class, and the memory goes back to the pool of
+     * whichever thread releases the last reference. Sizes too large to pool are allocated as by
+     * allocate().
+     */
+    static SharedBuffer allocatePooled(size_t bytes) {
+        size_t blockSize;
+        void* block = SharedBufferPool::allocate(sizeof(Holder) + bytes, &blockSize);
+        if (!block) {
+            return allocate(bytes);
+        }
+        return SharedBuffer(new (block) Holder(1U, blockSize - sizeof(Holder), true));
+    }
+
     /**
      * Resizes the buffer, copying the current contents.
      *
@@ -62,6 +80,14 @@ public:
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
 
+        if (_holder && _holder->isPooled()) {
+            // Pooled memory can't be handed to mongoRealloc(), so move to another pooled buffer.
+            auto tmp = SharedBuffer::allocatePooled(size);
+            memcpy(tmp.get(), get(), std::min(size, capacity()));
+            swap(tmp);
+            return;
+        }
+
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
 
@@ -93,15 +119,15 @@ public:
      * Users of this type must maintain the "used" size separately.
      */
     size_t capacity() const {
-        return _holder ? _holder->_capacity : 0;
+        return _holder ? _holder->capacity() : 0;
     }
 
 private:
     class Holder {
     public:
-        explicit Holder(AtomicUInt32::WordType initial, size_t capacity)
-            : _refCount(initial), _capacity(capacity) {
-            invariant(capacity == _capacity);
+        explicit Holder(AtomicUInt32::WordType initial, size_t capacity, bool pooled = false)
+            : _refCount(initial), _capacity(capacity | (pooled ? kPooledFlag : 0)) {
+            invariant(capacity < kPooledFlag);
         }
 
         // these are called automatically by boost::intrusive_ptr
@@ -111,13 +137,28 @@ private:
 
         friend void intrusive_ptr_release(Holder* h) {
             if (h->_refCount.subtractAndFetch(1) == 0) {
+                const bool pooled = h->isPooled();
+                const size_t blockSize = sizeof(Holder) + h->capacity();
+
                 // We placement new'ed a Holder in takeOwnership above,
                 // so we must destroy the object here.
                 h->~Holder();
-                free(h);
+                if (pooled) {
+                    SharedBufferPool::free(h, blockSize);
+                } else {
+                    free(h);
+                }
             }
         }
 
+        size_t capacity() const {
+            return _capacity & ~kPooledFlag;
+        }
+
+        bool isPooled() const {
+            return _capacity & kPooledFlag;
+        }
+
         char* data() {
             return reinterpret_cast<char*>(this + 1);
         }
@@ -130,6 +171,9 @@ private:
             return _refCount.load() > 1;
         }
 
+        // The top bit of _capacity marks memory that came from SharedBufferPool.
+        static constexpr uint32_t kPooledFlag = 1U << 31;
+
         AtomicUInt32 _refCount;
         uint32_t _capacity;
     };
@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <array>
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumSizeClasses = 11;
+MONGO_STATIC_ASSERT((SharedBufferPool::kMinBlockSize << (kNumSizeClasses - 1)) ==
+                    SharedBufferPool::kMaxBlockSize);
+
+size_t sizeClassFor(size_t bytes) {
+    size_t sizeClass = 0;
+    while ((SharedBufferPool::kMinBlockSize << sizeClass) < bytes) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+size_t blockSizeOf(size_t sizeClass) {
+    return SharedBufferPool::kMinBlockSize << sizeClass;
+}
+
+struct ThreadCache {
+    ~ThreadCache();
+
+    void release();
+
+    struct FreeList {
+        std::array<void*, SharedBufferPool::kMaxCachedBlocksPerClass> blocks;
+        size_t count;
+    };
+
+    std::array<FreeList, kNumSizeClasses> freeLists;
+    size_t cachedBytes;
+};
+
+thread_local ThreadCache threadCache;
+
+// Set once the calling thread's cache has been destroyed, since buffers may still be released by
+// thread_local objects destroyed after it.
+thread_local bool threadCacheDestroyed = false;
+
+ThreadCache::~ThreadCache() {
+    threadCacheDestroyed = true;
+    release();
+}
+
+void ThreadCache::release() {
+    for (auto&& freeList : freeLists) {
+        for (size_t i = 0; i < freeList.count; ++i) {
+            std::free(freeList.blocks[i]);
+        }
+        freeList.count = 0;
+    }
+    cachedBytes = 0;
+}
+
+}  // namespace
+
+void* SharedBufferPool::allocate(size_t bytes, size_t* blockSize) {
+    if (bytes > kMaxBlockSize) {
+        return nullptr;
+    }
+
+    const auto sizeClass = sizeClassFor(bytes);
+    *blockSize = blockSizeOf(sizeClass);
+
+    if (!threadCacheDestroyed) {
+        auto& freeList = threadCache.freeLists[sizeClass];
+        if (freeList.count > 0) {
+            threadCache.cachedBytes -= *blockSize;
+            return freeList.blocks[--freeList.count];
+        }
+    }
+    return mongoMalloc(*blockSize);
+}
+
+void SharedBufferPool::free(void* block, size_t blockSize) {
+    const auto sizeClass = sizeClassFor(blockSize);
+    dassert(blockSizeOf(sizeClass) == blockSize);
+
+    if (!threadCacheDestroyed) {
+        auto& freeList = threadCache.freeLists[sizeClass];
+        if (freeList.count < kMaxCachedBlocksPerClass &&
+            threadCache.cachedBytes + blockSize <= kMaxCachedBytesPerThread) {
+            threadCache.cachedBytes += blockSize;
+            freeList.blocks[freeList.count++] = block;
+            return;
+        }
+    }
+    std::free(block);
+}
+
+void SharedBufferPool::releaseCurrentThreadCache() {
+    if (!threadCacheDestroyed) {
+        threadCache.release();
+    }
+}
+
+size_t SharedBufferPool::cachedBytesForCurrentThread() {
+    return threadCacheDestroyed ? 0 : threadCache.cachedBytes;
+}
+
+}  // namespace mongo
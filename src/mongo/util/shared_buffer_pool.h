@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+/**
+ * Per-thread caches of released memory blocks, grouped in power-of-two size classes from
+ * kMinBlockSize to kMaxBlockSize bytes. This backs SharedBuffer::allocatePooled(), which is used
+ * for the buffers of messages going over the network: reusing a block that was recently freed by
+ * the same thread avoids both the allocator and the page faults of touching fresh memory.
+ *
+ * Every thread keeps at most kMaxCachedBlocksPerClass blocks of each class and at most
+ * kMaxCachedBytesPerThread bytes overall, which is only a few blocks: with a thread per
+ * connection, anything larger adds up to memory the allocator can neither see nor release. Blocks
+ * released beyond those limits, and blocks released while a thread is exiting, go back to the
+ * allocator, as does a thread's whole cache when it exits or goes idle.
+ */
+class SharedBufferPool {
+public:
+    static constexpr size_t kMinBlockSize = 1024;
+    static constexpr size_t kMaxBlockSize = 1024 * 1024;
+    static constexpr size_t kMaxCachedBlocksPerClass = 2;
+    static constexpr size_t kMaxCachedBytesPerThread = 32 * 1024;
+
+    /**
+     * Returns a block of at least 'bytes' bytes and stores its actual size in '*blockSize', or
+     * returns nullptr if 'bytes' is larger than kMaxBlockSize.
+     */
+    static void* allocate(size_t bytes, size_t* blockSize);
+
+    /**
+     * Hands back a block returned by allocate(), possibly on a different thread.
+     */
+    static void free(void* block, size_t blockSize);
+
+    /**
+     * Gives every block cached by the calling thread back to the allocator. Called when the
+     * thread goes idle, through markThreadIdle().
+     */
+    static void releaseCurrentThreadCache();
+
+    /**
+     * Returns the number of bytes cached by the calling thread.
+     */
+    static size_t cachedBytesForCurrentThread();
+};
+
+}  // namespace mongo
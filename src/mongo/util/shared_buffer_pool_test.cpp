@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+namespace {
+
+TEST(SharedBufferPool, ReleasedBufferIsReused) {
+    auto buffer = SharedBuffer::allocatePooled(100);
+    const auto ptr = buffer.get();
+    const auto cachedBefore = SharedBufferPool::cachedBytesForCurrentThread();
+
+    buffer = {};
+    ASSERT_EQ(SharedBufferPool::cachedBytesForCurrentThread(),
+              cachedBefore + SharedBufferPool::kMinBlockSize);
+
+    auto reused = SharedBuffer::allocatePooled(200);
+    ASSERT_EQ(reused.get(), ptr);
+    ASSERT_EQ(SharedBufferPool::cachedBytesForCurrentThread(), cachedBefore);
+}
+
+TEST(SharedBufferPool, CapacityIsRoundedUpToSizeClass) {
+    auto buffer = SharedBuffer::allocatePooled(1500);
+    ASSERT_GTE(buffer.capacity(), 1500U);
+    ASSERT_LT(buffer.capacity(), 2048U);
+}
+
+TEST(SharedBufferPool, LargeBuffersAreNotPooled) {
+    const auto cachedBefore = SharedBufferPool::cachedBytesForCurrentThread();
+    auto buffer = SharedBuffer::allocatePooled(SharedBufferPool::kMaxBlockSize * 2);
+    ASSERT_EQ(buffer.capacity(), SharedBufferPool::kMaxBlockSize * 2);
+
+    buffer = {};
+    ASSERT_EQ(SharedBufferPool::cachedBytesForCurrentThread(), cachedBefore);
+}
+
+TEST(SharedBufferPool, ReallocPreservesContents) {
+    auto buffer = SharedBuffer::allocatePooled(10);
+    memcpy(buffer.get(), "0123456789", 10);
+
+    buffer.realloc(5000);
+    ASSERT_GTE(buffer.capacity(), 5000U);
+    ASSERT_EQ(0, memcmp(buffer.get(), "0123456789", 10));
+
+    buffer.realloc(SharedBufferPool::kMaxBlockSize * 2);
+    ASSERT_EQ(buffer.capacity(), SharedBufferPool::kMaxBlockSize * 2);
+    ASSERT_EQ(0, memcmp(buffer.get(), "0123456789", 10));
+}
+
+TEST(SharedBufferPool, CachedBlocksAreBounded) {
+    const auto cachedBefore = SharedBufferPool::cachedBytesForCurrentThread();
+    std::vector<SharedBuffer> buffers;
+    for (size_t i = 0; i < 4 * SharedBufferPool::kMaxCachedBlocksPerClass; ++i) {
+        buffers.push_back(SharedBuffer::allocatePooled(100));
+    }
+
+    buffers.clear();
+    ASSERT_LTE(SharedBufferPool::cachedBytesForCurrentThread(),
+               cachedBefore +
+                   SharedBufferPool::kMaxCachedBlocksPerClass * SharedBufferPool::kMinBlockSize);
+    ASSERT_LTE(SharedBufferPool::cachedBytesForCurrentThread(),
+               SharedBufferPool::kMaxCachedBytesPerThread);
+}
+
+TEST(SharedBufferPool, ReleasingTheThreadCacheEmptiesIt) {
+    SharedBuffer::allocatePooled(100);
+    SharedBuffer::allocatePooled(5000);
+    ASSERT_GT(SharedBufferPool::cachedBytesForCurrentThread(), 0U);
+
+    SharedBufferPool::releaseCurrentThreadCache();
+    ASSERT_EQ(SharedBufferPool::cachedBytesForCurrentThread(), 0U);
+}
+
+TEST(SharedBufferPool, BufferReturnsToTheReleasingThread) {
+    auto buffer = SharedBuffer::allocatePooled(100);
+    const auto cachedBefore = SharedBufferPool::cachedBytesForCurrentThread();
+
+    size_t cachedByOtherThread = 0;
+    stdx::thread([&] {
+        buffer = {};
+        cachedByOtherThread = SharedBufferPool::cachedBytesForCurrentThread();
+    }).join();
+
+    ASSERT_EQ(cachedByOtherThread, SharedBufferPool::kMinBlockSize);
+    ASSERT_EQ(SharedBufferPool::cachedBytesForCurrentThread(), cachedBefore);
+}
+
+}  // namespace
+}  // namespace mongo